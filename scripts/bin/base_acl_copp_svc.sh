@@ -18,5 +18,11 @@
 if [ -f /etc/sonic/base_acl_nocreate ] ; then
    exit 0
 fi
+
+# Native loader commits the whole configuration in one transaction.
+# The Python loader is kept as a fallback - a failed commit is rolled back.
+if [ -x /usr/bin/base_acl_cfg_load ] && /usr/bin/base_acl_cfg_load ; then
+   exit 0
+fi
 base_create_acl_entries.py
 
@@ -49,6 +49,8 @@ filter_name2val_map = {
     'INNER_VLAN_CFI': 'INNER_VLAN_CFI_VALUE',
     'L4_SRC_PORT': 'L4_SRC_PORT_VALUE',
     'L4_DST_PORT': 'L4_DST_PORT_VALUE',
+    'L4_SRC_PORT_RANGE': 'L4_SRC_PORT_RANGE_VALUE',
+    'L4_DST_PORT_RANGE': 'L4_DST_PORT_RANGE_VALUE',
     'ETHER_TYPE': 'ETHER_TYPE_VALUE',
     'IP_PROTOCOL': 'IP_PROTOCOL_VALUE',
     'DSCP': 'DSCP_VALUE',
@@ -157,6 +159,14 @@ entry_attr_map = {
     'match/L4_DST_PORT_VALUE/data': ('leaf', 'uint16_t'),
     'match/L4_DST_PORT_VALUE/mask': ('leaf', 'uint16_t'),
 
+    'match/L4_SRC_PORT_RANGE_VALUE': ('container', 'min'),
+    'match/L4_SRC_PORT_RANGE_VALUE/min': ('leaf', 'uint16_t'),
+    'match/L4_SRC_PORT_RANGE_VALUE/max': ('leaf', 'uint16_t'),
+
+    'match/L4_DST_PORT_RANGE_VALUE': ('container', 'min'),
+    'match/L4_DST_PORT_RANGE_VALUE/min': ('leaf', 'uint16_t'),
+    'match/L4_DST_PORT_RANGE_VALUE/max': ('leaf', 'uint16_t'),
+
     'match/ETHER_TYPE_VALUE': ('container', 'data'),
     'match/ETHER_TYPE_VALUE/data': ('leaf', 'uint16_t'),
     'match/ETHER_TYPE_VALUE/mask': ('leaf', 'uint16_t'),
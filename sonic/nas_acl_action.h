@@ -75,6 +75,14 @@ class nas_acl_action_t
         void set_pkt_action_val (const nas_acl_common_data_list_t& data_list);
         void set_ndi_counter_ids (const nas::ndi_obj_id_table_t & ndi_obj_id_table);
 
+        // Single value actions set and read directly, without the common
+        // data list - T is the type of the NDI action value (eg. uint16_t)
+        template <typename T>
+        void set_action_val (ndi_acl_action_values_type_t values_type,
+                             const T& val) noexcept;
+        template <typename T>
+        void get_action_val (T& val) const noexcept;
+
         void get_u8_action_val (nas_acl_common_data_list_t& data_list) const;
         void get_u16_action_val (nas_acl_common_data_list_t& data_list) const;
         void get_u32_action_val (nas_acl_common_data_list_t& data_list) const;
@@ -90,10 +98,17 @@ class nas_acl_action_t
 
         nas_obj_id_t  counter_id () const noexcept {return _nas_oid;}
 
+        // Port and port-list actions are dropped in the NPUs that have
+        // none of their ports
+        bool is_npu_specific () const noexcept;
+        nas::npu_set_t get_npu_list () const;
+
         bool copy_action_ndi (ndi_acl_action_list_t& ndi_alist,
                               npu_id_t npu_id, nas::mem_alloc_helper_t& m) const;
 
         bool operator!= (const nas_acl_action_t& second) const;
+        // Digest of the action - equal for actions that are not !=
+        uint64_t cfg_hash () const noexcept;
 
     private:
         void _set_opaque_data (const nas_acl_common_data_list_t& data_list);
@@ -133,4 +148,22 @@ inline const char* nas_acl_action_t::name () const noexcept
     return type_name (action_type());
 }
 
+// All NDI action values start at the top of the values union
+template <typename T>
+inline void nas_acl_action_t::set_action_val (ndi_acl_action_values_type_t values_type,
+                                              const T& val) noexcept
+{
+    static_assert (sizeof (T) <= sizeof (_a_info.values),
+                   "Action value does not fit in NDI action");
+
+    _a_info.values_type = values_type;
+    memcpy (&_a_info.values, &val, sizeof (T));
+}
+
+template <typename T>
+inline void nas_acl_action_t::get_action_val (T& val) const noexcept
+{
+    memcpy (&val, &_a_info.values, sizeof (T));
+}
+
 #endif
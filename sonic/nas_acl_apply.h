@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*!
+ * \file   nas_acl_apply.h
+ * \brief  NAS ACL declarative apply of the complete set of Entries of a Table
+ */
+
+#ifndef _NAS_ACL_APPLY_H_
+#define _NAS_ACL_APPLY_H_
+
+#include "std_error_codes.h"
+#include "cps_api_object.h"
+#include "nas_acl_switch.h"
+
+/*
+ * An Apply takes the desired Entries of a Table - BASE_ACL_ENTRY_OBJ objects
+ * in the Entry Create format - and reconciles the Table to them:
+ *  - A desired Entry with an Entry ID key is paired with the Entry of that ID.
+ *  - A desired Entry without an ID is paired with an unpaired Entry of the
+ *    same content, or failing that with an unpaired Entry of the same priority.
+ *  - Unpaired Entries of the Table are deleted and unpaired desired Entries
+ *    are created.
+ *  - Paired Entries are compared with the Filter and Action operator!= and
+ *    only the attributes that differ are modified. An unchanged Entry makes
+ *    no NDI call.
+ *
+ * Deletes are applied first to release resources, then modifies and creates.
+ * If any of them fails the ones already applied are undone.
+ *
+ * Over CPS the desired Entries are carried in a Set of BASE_ACL_APPLY_OBJ,
+ * each Entry object serialized into a BASE_ACL_APPLY_ENTRY attribute.
+ */
+
+typedef struct _nas_acl_apply_stats_t {
+    size_t    created;
+    size_t    modified;
+    size_t    deleted;
+    size_t    unchanged;
+} nas_acl_apply_stats_t;
+
+// Must be called with the ACL lock held.
+// If prev is not NULL and the Table is changed, prev is filled with the
+// Table ID key and the previous Entries of the Table - an Apply of prev
+// restores the Table.
+t_std_error nas_acl_table_apply (nas_acl_switch&        sw,
+                                 nas_obj_id_t           table_id,
+                                 cps_api_object_list_t  desired,
+                                 bool                   rolling_back,
+                                 nas_acl_apply_stats_t* stats,
+                                 cps_api_object_t       prev = NULL) noexcept;
+
+#endif
@@ -0,0 +1,88 @@
+
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+/*!
+ * \file   nas_acl_async.h
+ * \brief  NAS ACL asynchronous Entry programming
+ */
+
+#ifndef _NAS_ACL_ASYNC_H_
+#define _NAS_ACL_ASYNC_H_
+
+#include "cps_api_object.h"
+#include "cps_api_operation.h"
+#include "std_error_codes.h"
+#include "nas_types.h"
+#include "nas_acl_utl.h"
+#include <memory>
+
+/*
+ * In async mode the CPS handler only validates an Entry write - the Entry
+ * is parsed against its Table, its ID is reserved and the previous state
+ * is saved for rollback. Programming the NPUs is queued to a worker thread
+ * and the handler returns.
+ *
+ * The worker runs the queued writes one at a time, in order, with the lock
+ * of the Entry's Table on the Entry's switch held - the CPS thread
+ * validates the next writes meanwhile.
+ * A write to an Entry waits for the queued writes of that Entry, so that
+ * it is validated against the programmed Entry. Writes to other objects
+ * wait until the queue is empty. Rollback of a queued write is queued.
+ *
+ * An Entry reports PENDING while it has queued writes, and FAILED if its
+ * last write failed, in the BASE_ACL_ENTRY_PROGRAM_STATUS attribute.
+ * Failures are also published in the change event. A failed write is not
+ * rolled back since its CPS transaction has already ended.
+ */
+#define NAS_ACL_ASYNC_ENV           "DN_ACL_ASYNC"
+#define NAS_ACL_ASYNC_MAX_FAILED    1024
+
+typedef enum {
+    NAS_ACL_ASYNC_STATUS_OK = 0,
+    NAS_ACL_ASYNC_STATUS_PENDING,
+    NAS_ACL_ASYNC_STATUS_FAILED,
+} nas_acl_async_status_t;
+
+// Enable async mode if NAS_ACL_ASYNC_ENV is set to 1
+void nas_acl_async_init () noexcept;
+
+// Disabling waits for the queued writes
+bool nas_acl_async_enable (bool enable) noexcept;
+bool nas_acl_async_is_enabled () noexcept;
+
+// Queue a validated Entry write - the object is owned by the queue unless
+// false is returned. The ID guard of a created Entry is released just
+// before it is created. Called with the NAS ACL lock held.
+bool nas_acl_async_queue (cps_api_object_t                     obj,
+                          cps_api_operation_types_t            op,
+                          bool                                 rollback,
+                          nas_switch_id_t                      switch_id,
+                          nas_obj_id_t                         table_id,
+                          nas_obj_id_t                         entry_id,
+                          std::unique_ptr<nas_acl_id_guard_t>  idg) noexcept;
+
+// Wait for the queued writes of an Entry or of all Entries.
+// Called without the NAS ACL lock.
+void nas_acl_async_wait_entry (nas_switch_id_t switch_id, nas_obj_id_t table_id,
+                               nas_obj_id_t entry_id) noexcept;
+void nas_acl_async_drain () noexcept;
+
+nas_acl_async_status_t nas_acl_async_entry_status (nas_switch_id_t switch_id,
+                                                   nas_obj_id_t    table_id,
+                                                   nas_obj_id_t    entry_id,
+                                                   t_std_error*    err_p = NULL) noexcept;
+
+#endif
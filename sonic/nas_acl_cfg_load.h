@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_cfg_load.h
+ * \brief  NAS ACL boot time loader for the default ACL configuration
+ */
+
+#ifndef _NAS_ACL_CFG_LOAD_H_
+#define _NAS_ACL_CFG_LOAD_H_
+
+#include "nas_types.h"
+#include "std_error_codes.h"
+#include "cps_api_operation.h"
+#include "nas_ndi_obj_id_table.h"
+
+/*
+ * The default ACL configuration (CoPP) is kept in two XML files -
+ *  - Master list: Tables per stage and the Entries in each Table, along
+ *    with the CPU queue and packet action of each Entry.
+ *  - Detail list: Allowed filters of each Table and the Match/Action
+ *    values of each Entry.
+ *
+ * Both files are parsed once and a Create is built for every Table,
+ * Counter and Entry, into a single CPS transaction. IDs of Tables and
+ * Counters are chosen up front so that Entries can refer to them within
+ * the same transaction.
+ */
+#define NAS_ACL_CFG_PATH           "/etc/sonic"
+#define NAS_ACL_CFG_PATH_ENV       "DN_ACL_CFG_PATH"
+#define NAS_ACL_CFG_MASTER_FILE    "nas_master_list.xml"
+#define NAS_ACL_CFG_DETAIL_FILE    "nas_detail_list.xml"
+#define NAS_ACL_CFG_ENTRY_PRIO     512
+
+// Resolves a CPU queue number to the QoS Queue ID and its NDI IDs
+typedef bool (* nas_acl_cfg_cpu_q_fn_ptr_t) (uint_t                   queue_num,
+                                             nas_obj_id_t*            queue_id,
+                                             nas::ndi_obj_id_table_t& ndi_ids);
+
+typedef struct _nas_acl_cfg_load_stats_t {
+    size_t    tables;
+    size_t    counters;
+    size_t    entries;
+} nas_acl_cfg_load_stats_t;
+
+// Configuration directory - from the environment if set
+const char* nas_acl_cfg_path () noexcept;
+
+// First Table ID above all the Tables in a Table Get response
+nas_obj_id_t nas_acl_cfg_free_table_id (cps_api_object_list_t table_list) noexcept;
+
+// Parse the master and detail lists in cfg_path and append a Create for
+// every Table, Counter and Entry to the transaction.
+// Table IDs are assigned from first_table_id upwards.
+t_std_error nas_acl_cfg_build (const char*                   cfg_path,
+                               nas_obj_id_t                  first_table_id,
+                               nas_acl_cfg_cpu_q_fn_ptr_t    cpu_q_fn,
+                               cps_api_transaction_params_t* params,
+                               nas_acl_cfg_load_stats_t*     stats) noexcept;
+
+#endif
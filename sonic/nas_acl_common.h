@@ -28,6 +28,7 @@
 #include "nas_types.h"
 #include "nas_base_utils.h"
 #include "nas_ndi_obj_id_table.h"
+#include <vector>
 
 #define NAS_ACL_COMMON_DATA_ARR_LEN    128
 
@@ -39,6 +40,7 @@
 /** NAS ACL Error codes */
 #define    NAS_ACL_E_NONE           (int)STD_ERR_OK
 #define    NAS_ACL_E_MEM            (int)STD_ERR (ACL, NOMEM, 0)
+#define    NAS_ACL_E_FULL           (int)STD_ERR (ACL, NOMEM, 1) // No room in NPU or Table quota
 
 #define    NAS_ACL_E_MISSING_KEY    (int)STD_ERR (ACL, CFG, 1)
 #define    NAS_ACL_E_MISSING_ATTR   (int)STD_ERR (ACL, CFG, 2)
@@ -55,19 +57,70 @@
 
 #define    NAS_ACL_E_FAIL           (int)STD_ERR (ACL, FAIL, 0) // All other run time failures
 
-typedef struct _nas_acl_common_data_t {
-    union {
-        uint8_t                  u8;
-        uint16_t                 u16;
-        uint32_t                 u32;
-        uint64_t                 u64;
-        nas_obj_id_t             obj_id;
-        hal_ifindex_t            ifindex;
-    };
-    nas::ifindex_list_t      ifindex_list;
-    nas::ndi_obj_id_table_t  ndi_obj_id_table;
-    std::vector<uint8_t>     bytes;
-} nas_acl_common_data_t;
+/*
+ * Value of a single CPS attribute on its way between a CPS object and
+ * a Filter/Action.
+ *
+ * Scalars and byte strings of up to NAS_ACL_COMMON_DATA_INLINE_LEN bytes
+ * (IP and MAC addresses) are held inline. Only longer byte strings,
+ * interface lists and NDI object ID tables are allocated from the heap,
+ * and only the one that is actually in use.
+ */
+#define NAS_ACL_COMMON_DATA_INLINE_LEN  16
+
+class nas_acl_common_data_t
+{
+    public:
+        union {
+            uint8_t                  u8;
+            uint16_t                 u16;
+            uint32_t                 u32;
+            uint64_t                 u64;
+            nas_obj_id_t             obj_id;
+            hal_ifindex_t            ifindex;
+        };
+
+        nas_acl_common_data_t () noexcept : u64 {0} {}
+        nas_acl_common_data_t (const nas_acl_common_data_t& rhs);
+        nas_acl_common_data_t (nas_acl_common_data_t&& rhs) noexcept;
+        nas_acl_common_data_t& operator= (const nas_acl_common_data_t& rhs);
+        nas_acl_common_data_t& operator= (nas_acl_common_data_t&& rhs) noexcept;
+        ~nas_acl_common_data_t () { _clear (); }
+
+        const uint8_t* bytes_data () const noexcept;
+        size_t         bytes_size () const noexcept;
+        void           set_bytes (const void* data, size_t len);
+        void           fill_bytes (uint8_t val, size_t len);
+
+        // Accessing a list through the non-const version switches the value to it
+        nas::ifindex_list_t&            ifindex_list ();
+        const nas::ifindex_list_t&      ifindex_list () const noexcept;
+        nas::ndi_obj_id_table_t&        ndi_obj_id_table ();
+        const nas::ndi_obj_id_table_t&  ndi_obj_id_table () const noexcept;
+
+    private:
+        typedef enum {
+            _NONE,
+            _INLINE_BYTES,
+            _HEAP_BYTES,
+            _IFINDEX_LIST,
+            _NDI_OBJ_ID_TABLE,
+        } _kind_t;
+
+        uint8_t  _kind = _NONE;
+        uint8_t  _len = 0;  // Length of the inline bytes
+
+        union {
+            uint8_t                   _inline [NAS_ACL_COMMON_DATA_INLINE_LEN];
+            std::vector<uint8_t>*     _heap_bytes;
+            nas::ifindex_list_t*      _ifindex_list;
+            nas::ndi_obj_id_table_t*  _ndi_obj_id_table;
+        };
+
+        void _clear () noexcept;
+        void _copy (const nas_acl_common_data_t& rhs);
+        void _move (nas_acl_common_data_t& rhs) noexcept;
+};
 
 typedef std::vector<nas_acl_common_data_t> nas_acl_common_data_list_t;
 
@@ -88,10 +141,33 @@ typedef enum NAS_ACL_DATA_TYPE_t {
 
 inline constexpr nas_switch_id_t NAS_ACL_DEFAULT_SWITCH_ID () { return 0;}
 
+// FNV-1a digest of an object's configuration - compared against the
+// digest in the warm restart checkpoint
+#define NAS_ACL_HASH_INIT    0xcbf29ce484222325ULL
+
+inline uint64_t nas_acl_hash_bytes (uint64_t hash, const void* data,
+                                    size_t len) noexcept
+{
+    auto p = static_cast<const uint8_t*> (data);
+
+    for (size_t idx = 0; idx < len; idx++) {
+        hash = (hash ^ p[idx]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+inline uint64_t nas_acl_hash_val (uint64_t hash, const T& val) noexcept
+{
+    return nas_acl_hash_bytes (hash, &val, sizeof (T));
+}
+
 const char* nas_acl_obj_data_type_to_str (NAS_ACL_DATA_TYPE_t obj_data_type);
 const char* nas_acl_filter_type_name (BASE_ACL_MATCH_TYPE_t type) noexcept;
 bool nas_acl_filter_is_type_valid (BASE_ACL_MATCH_TYPE_t f_type) noexcept;
+bool nas_acl_filter_type_from_name (const char* name, BASE_ACL_MATCH_TYPE_t* type) noexcept;
 const char* nas_acl_action_type_name (BASE_ACL_ACTION_TYPE_t type) noexcept;
 bool nas_acl_action_is_type_valid (BASE_ACL_ACTION_TYPE_t type) noexcept;
+bool nas_acl_action_type_from_name (const char* name, BASE_ACL_ACTION_TYPE_t* type) noexcept;
 
 #endif /* _NAS_ACL_COMMON_H_ */
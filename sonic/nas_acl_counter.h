@@ -62,6 +62,7 @@ public:
 
     bool is_pkt_count_enabled() const noexcept {return _enable_pkt_count;}
     bool is_byte_count_enabled() const noexcept {return _enable_byte_count;}
+    const std::set<nas_obj_id_t>& refs() const noexcept {return _refs;}
 
     //////// Modifiers ////////
     void set_counter_id (nas_obj_id_t id);
@@ -30,8 +30,10 @@
 #include "dell-base-acl.h"
 #include "nas_base_utils.h"
 #include "nas_acl_switch_list.h"
+#include "nas_acl_lock.h"
 #include "nas_acl_common.h"
 #include <pthread.h>
+#include <vector>
 
 // Possible Longest attr hierarchy -
 // ACTION-List-Attr . Action-ListIndex . Action-Value-Attr . Value-Inner-ListIndex . Action-Value-Child-Attr
@@ -82,14 +84,62 @@ typedef enum {
     NAS_ACL_ATTR_EXTRACT_SUCCESS,
 } nas_acl_attr_extract_t;
 
-typedef std::vector<nas_acl_map_data_t> nas_acl_map_data_list_t;
+// Most child attributes under any Match/Action Value attribute
+#define NAS_ACL_MAX_CHILD_ATTRS 2
 
+/* Fixed size child attribute list so that the map tables are constexpr */
+typedef struct _nas_acl_map_data_list_t {
+    size_t                  count;
+    nas_acl_map_data_t      data [NAS_ACL_MAX_CHILD_ATTRS];
+
+    size_t size () const noexcept {return count;}
+    const nas_acl_map_data_t* begin () const noexcept {return data;}
+    const nas_acl_map_data_t* end () const noexcept {return data + count;}
+} nas_acl_map_data_list_t;
+
+/*
+ * Direct decode/encode of fixed width Match/Action values between the raw
+ * CPS attributes and the NDI structure - see nas_acl_cps_codec.h.
+ * attrs holds the child attributes of an EMBEDDED value, otherwise
+ * the value attribute itself.
+ */
+typedef void (* nas_acl_filter_decode_fn_ptr_t) (nas_acl_filter_t&              filter,
+                                                 const nas_acl_map_data_t&      val_info,
+                                                 const nas_acl_map_data_list_t& child_list,
+                                                 const cps_api_object_attr_t*   attrs,
+                                                 const char*                    name);
+
+typedef bool (* nas_acl_filter_encode_fn_ptr_t) (const nas_acl_filter_t&        filter,
+                                                 cps_api_object_t               obj,
+                                                 nas::attr_list_t&              parent_list,
+                                                 const nas_acl_map_data_list_t& child_list);
+
+typedef void (* nas_acl_action_decode_fn_ptr_t) (nas_acl_action_t&              action,
+                                                 const nas_acl_map_data_t&      val_info,
+                                                 const nas_acl_map_data_list_t& child_list,
+                                                 const cps_api_object_attr_t*   attrs,
+                                                 const char*                    name);
+
+typedef bool (* nas_acl_action_encode_fn_ptr_t) (const nas_acl_action_t&        action,
+                                                 cps_api_object_t               obj,
+                                                 nas::attr_list_t&              parent_list,
+                                                 const nas_acl_map_data_list_t& child_list);
+
+/*
+ * Filter and Action map tables are arrays indexed by the Match/Action type,
+ * in the model enum order. Each slot repeats its type so that the order is
+ * verified at compile time.
+ */
 typedef struct _nas_acl_filter_info_t {
-    std::string                 name;
+    BASE_ACL_MATCH_TYPE_t       type;
+    const char*                 name;
     nas_acl_map_data_t          val;
     nas_acl_map_data_list_t     child_list;
     nas_acl_filter_get_fn_ptr_t get_fn;
     nas_acl_filter_set_fn_ptr_t set_fn;
+    // NULL if the value goes through get_fn/set_fn and the common data list
+    nas_acl_filter_decode_fn_ptr_t decode_fn;
+    nas_acl_filter_encode_fn_ptr_t encode_fn;
 } nas_acl_filter_info_t;
 
 typedef void (nas_acl_action_t:: *nas_acl_action_get_fn_ptr_t)
@@ -99,21 +149,20 @@ typedef void (nas_acl_action_t::* nas_acl_action_set_fn_ptr_t)
     (const nas_acl_common_data_list_t&);
 
 typedef struct _nas_acl_action_info_t {
-    std::string                 name;
+    BASE_ACL_ACTION_TYPE_t      type;
+    const char*                 name;
     nas_acl_map_data_t          val;
     nas_acl_map_data_list_t     child_list;
     nas_acl_action_get_fn_ptr_t get_fn;
     nas_acl_action_set_fn_ptr_t set_fn;
+    // NULL if the value goes through get_fn/set_fn and the common data list
+    nas_acl_action_decode_fn_ptr_t decode_fn;
+    nas_acl_action_encode_fn_ptr_t encode_fn;
 } nas_acl_action_info_t;
 
-typedef const std::unordered_map <BASE_ACL_MATCH_TYPE_t,
-        nas_acl_filter_info_t, std::hash<int>> nas_acl_filter_map_t;
-
-typedef const std::unordered_map <BASE_ACL_ACTION_TYPE_t,
-    nas_acl_action_info_t, std::hash<int>> nas_acl_action_map_t;
-
-nas_acl_filter_map_t& nas_acl_get_filter_map () noexcept;
-nas_acl_action_map_t& nas_acl_get_action_map () noexcept;
+// Returns NULL for an unknown Match/Action type
+const nas_acl_filter_info_t* nas_acl_get_filter_info (BASE_ACL_MATCH_TYPE_t type) noexcept;
+const nas_acl_action_info_t* nas_acl_get_action_info (BASE_ACL_ACTION_TYPE_t type) noexcept;
 
 cps_api_return_code_t nas_acl_cps_api_read (void * context,
                                             cps_api_get_params_t * param,
@@ -127,8 +176,58 @@ cps_api_return_code_t nas_acl_cps_api_rollback (void * context,
                                                 cps_api_transaction_params_t * param,
                                                 size_t index_of_element_being_updated) noexcept;
 
-cps_api_object_attr_t nas_acl_get_attr (const cps_api_object_it_t& it,
-                                        cps_api_attr_id_t attr_id, bool* is_dupl) noexcept;
+/*
+ * Index of the attributes at one level of a CPS object - typically a
+ * Match or Action list element - built in a single pass. Each attribute ID
+ * maps to its first occurrence and repeated IDs are flagged as duplicates.
+ * A list element holds only a handful of distinct attributes, so the index
+ * is a small vector that is reused across elements by calling build () again.
+ */
+class nas_acl_attr_index_t
+{
+    public:
+        void build (const cps_api_object_it_t& it);
+
+        cps_api_object_attr_t find (cps_api_attr_id_t attr_id) const noexcept;
+        bool is_dupl (cps_api_attr_id_t attr_id) const noexcept;
+
+        // Iterator to the first attribute at the indexed level
+        const cps_api_object_it_t& begin () const noexcept {return _it;}
+
+    private:
+        struct _slot_t {
+            cps_api_attr_id_t     attr_id;
+            cps_api_object_attr_t attr;
+            bool                  dupl;
+        };
+
+        const _slot_t* _find_slot (cps_api_attr_id_t attr_id) const noexcept;
+
+        cps_api_object_it_t   _it;
+        std::vector<_slot_t>  _slots;
+};
+
+inline const nas_acl_attr_index_t::_slot_t*
+nas_acl_attr_index_t::_find_slot (cps_api_attr_id_t attr_id) const noexcept
+{
+    for (const auto& slot: _slots) {
+        if (slot.attr_id == attr_id) return &slot;
+    }
+    return NULL;
+}
+
+inline cps_api_object_attr_t
+nas_acl_attr_index_t::find (cps_api_attr_id_t attr_id) const noexcept
+{
+    auto slot_p = _find_slot (attr_id);
+    return (slot_p != NULL) ? slot_p->attr : NULL;
+}
+
+inline bool nas_acl_attr_index_t::is_dupl (cps_api_attr_id_t attr_id) const noexcept
+{
+    auto slot_p = _find_slot (attr_id);
+    return (slot_p != NULL) && slot_p->dupl;
+}
 
 t_std_error           nas_acl_get_table (cps_api_get_params_t *param, size_t index,
                                          cps_api_object_t filter_obj) noexcept;
@@ -144,18 +243,55 @@ t_std_error           nas_acl_stats_info_get (cps_api_get_params_t *param,
                                               size_t                index,
                                               const nas_acl_counter_t&  counter) noexcept;
 
+t_std_error           nas_acl_get_perf_stats (cps_api_get_params_t *param, size_t index,
+                                              cps_api_object_t filter_obj) noexcept;
+
+t_std_error           nas_acl_get_pool_stats (cps_api_get_params_t *param, size_t index,
+                                              cps_api_object_t filter_obj) noexcept;
+
 nas_acl_write_operation_map_t *
 nas_acl_get_table_operation_map (cps_api_operation_types_t op) noexcept;
 
 nas_acl_write_operation_map_t *
 nas_acl_get_entry_operation_map (cps_api_operation_types_t op) noexcept;
 
+// Validate and queue NPU programming - see nas_acl_async.h
+nas_acl_write_operation_map_t *
+nas_acl_get_entry_async_op_map (cps_api_operation_types_t op) noexcept;
+
 nas_acl_write_operation_map_t *
 nas_acl_get_counter_operation_map (cps_api_operation_types_t op) noexcept;
 
 nas_acl_write_operation_map_t *
 nas_acl_get_stats_op_map (cps_api_operation_types_t op) noexcept;
 
+nas_acl_write_operation_map_t *
+nas_acl_get_perf_stats_op_map (cps_api_operation_types_t op) noexcept;
+
+nas_acl_write_operation_map_t *
+nas_acl_get_apply_op_map (cps_api_operation_types_t op) noexcept;
+
+nas_acl_write_operation_map_t *
+nas_acl_get_validate_op_map (cps_api_operation_types_t op) noexcept;
+
+// Parse the attributes of a Table Create object into table
+void nas_acl_parse_table_obj (cps_api_object_t obj, nas_acl_table& table);
+
+// Parse the attributes of a Counter Create object into counter
+void nas_acl_parse_counter_obj (cps_api_object_t obj, nas_acl_counter_t& counter);
+
+// Parse the attributes of an Entry object into entry.
+// Returns true if the Entry's NPU list was set.
+bool nas_acl_parse_entry_obj (cps_api_object_t obj, nas_acl_entry& entry);
+
+// Fill the key and all the configured attributes of an Entry object
+bool nas_acl_fill_entry_obj (cps_api_object_t obj, const nas_acl_entry& entry);
+
+// Fill the given attributes of an Entry into the prev object of a write
+// whose key is already set - see nas_acl_undo.h
+bool nas_acl_fill_entry_prev (cps_api_object_t prev, const nas_acl_entry& entry,
+                              const nas::attr_set_t& attrs, bool npu_modified);
+
 void nas_acl_set_match_list (const cps_api_object_t     obj,
                              const cps_api_object_it_t& it,
                              nas_acl_entry&             entry);
@@ -164,7 +300,8 @@ void nas_acl_set_match_attr (const cps_api_object_t     obj,
                              nas_acl_entry&             entry,
                              BASE_ACL_MATCH_TYPE_t      match_type_val,
                              nas::attr_list_t           parent_attr_id_list,
-                             bool                       reset);
+                             bool                       reset,
+                             const nas_acl_attr_index_t* index = NULL);
 
 bool
 nas_acl_fill_match_attr_list (cps_api_object_t obj, const nas_acl_entry& entry);
@@ -187,7 +324,8 @@ void nas_acl_set_action_attr (const cps_api_object_t     obj,
                               nas_acl_entry&             entry,
                               BASE_ACL_ACTION_TYPE_t     match_type_val,
                               nas::attr_list_t&          parent_attr_id_list,
-                              bool                       reset);
+                              bool                       reset,
+                              const nas_acl_attr_index_t* index = NULL);
 
 bool
 nas_acl_fill_action_attr_list (cps_api_object_t obj, const nas_acl_entry& entry);
@@ -199,15 +337,36 @@ nas_acl_copy_data_to_obj (cps_api_object_t               obj,
                           const nas_acl_map_data_list_t& child_list,
                           nas_acl_common_data_list_t&    common_data_list);
 
+// With an index of the Match/Action list element the value attribute and
+// its children are looked up from the element instead of from the top of obj.
+// parent_list always holds the full attr hierarchy from the top of obj.
 nas_acl_common_data_list_t
 nas_acl_copy_data_from_obj (cps_api_object_t                obj,
                             nas::attr_list_t&               parent_list,
                             const nas_acl_map_data_t&       val_info,
                             const nas_acl_map_data_list_t&  child_list,
-                            const std::string&              name);
-
-int nas_acl_lock () noexcept;
-
-int nas_acl_unlock () noexcept;
+                            const char*                     name,
+                            const nas_acl_attr_index_t*     index = NULL);
+
+// Look up the raw attributes of a Match/Action value for the direct decoders
+// - the children of an EMBEDDED value or else the value attribute itself.
+// Missing optional attributes are returned as NULL.
+void
+nas_acl_get_attrs_from_obj (cps_api_object_t                obj,
+                            nas::attr_list_t&               parent_list,
+                            const nas_acl_map_data_t&       val_info,
+                            const nas_acl_map_data_list_t&  child_list,
+                            const char*                     name,
+                            const nas_acl_attr_index_t*     index,
+                            cps_api_object_attr_t*          attrs);
+
+// Transaction lock mode - the NAS ACL lock is held across all the ACL
+// objects of a CPS transaction instead of being taken per object
+#define NAS_ACL_TXN_LOCK_ENV "DN_ACL_TXN_LOCK"
+
+// Enable the mode if NAS_ACL_TXN_LOCK_ENV is set to 1
+void nas_acl_txn_lock_init () noexcept;
+void nas_acl_txn_lock_enable (bool enable) noexcept;
+bool nas_acl_txn_lock_is_enabled () noexcept;
 
 #endif
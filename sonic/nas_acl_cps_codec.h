@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_cps_codec.h
+ * \brief  Direct decode/encode of fixed width Match/Action values
+ *         between CPS attributes and the NDI filter/action structures
+ */
+
+#ifndef _NAS_ACL_CPS_CODEC_H_
+#define _NAS_ACL_CPS_CODEC_H_
+
+#include "nas_acl_cps.h"
+#include "nas_acl_filter.h"
+#include "nas_acl_action.h"
+#include <string.h>
+#include <limits>
+#include <string>
+
+/*
+ * CPS encoding of a Match/Action value type.
+ * The primary template handles byte string values - IP and MAC addresses.
+ */
+template <typename T>
+struct nas_acl_cps_val_t
+{
+    static void decode (cps_api_object_attr_t attr, T& val) noexcept {
+        memcpy (&val, cps_api_object_attr_data_bin (attr), sizeof (T));
+    }
+
+    static bool encode (cps_api_object_t obj, nas::attr_list_t& attr_list,
+                        const T& val) noexcept {
+        return cps_api_object_e_add (obj, attr_list.data (), attr_list.size (),
+                                     cps_api_object_ATTR_T_BIN, &val, sizeof (T));
+    }
+
+    // Optional mask not provided - match all bits
+    static void fill_all (T& val, const nas_acl_map_data_t&) noexcept {
+        memset (&val, 0xff, sizeof (T));
+    }
+
+    static bool in_range (const T&, const nas_acl_map_data_t&) noexcept {
+        return true;
+    }
+
+    static std::string to_string (const T&) {
+        return "-";
+    }
+};
+
+template <typename T>
+struct nas_acl_cps_uint_val_t
+{
+    static void fill_all (T& val, const nas_acl_map_data_t& info) noexcept {
+        val = (info.range.max != 0) ? info.range.max : std::numeric_limits<T>::max ();
+    }
+
+    static bool in_range (const T& val, const nas_acl_map_data_t& info) noexcept {
+        return ((info.range.max == 0) ||
+                (val >= info.range.min && val <= info.range.max));
+    }
+
+    static std::string to_string (const T& val) {
+        return std::to_string (val);
+    }
+};
+
+// 8-bit values are carried as 1 byte binary attributes
+template <>
+struct nas_acl_cps_val_t<uint8_t>: nas_acl_cps_uint_val_t<uint8_t>
+{
+    static void decode (cps_api_object_attr_t attr, uint8_t& val) noexcept {
+        val = *((uint8_t *) cps_api_object_attr_data_bin (attr));
+    }
+
+    static bool encode (cps_api_object_t obj, nas::attr_list_t& attr_list,
+                        const uint8_t& val) noexcept {
+        return cps_api_object_e_add (obj, attr_list.data (), attr_list.size (),
+                                     cps_api_object_ATTR_T_BIN, &val, sizeof (uint8_t));
+    }
+};
+
+template <>
+struct nas_acl_cps_val_t<uint16_t>: nas_acl_cps_uint_val_t<uint16_t>
+{
+    static void decode (cps_api_object_attr_t attr, uint16_t& val) noexcept {
+        val = cps_api_object_attr_data_u16 (attr);
+    }
+
+    static bool encode (cps_api_object_t obj, nas::attr_list_t& attr_list,
+                        const uint16_t& val) noexcept {
+        return cps_api_object_e_add (obj, attr_list.data (), attr_list.size (),
+                                     cps_api_object_ATTR_T_U16, &val, sizeof (uint16_t));
+    }
+};
+
+template <>
+struct nas_acl_cps_val_t<uint32_t>: nas_acl_cps_uint_val_t<uint32_t>
+{
+    static void decode (cps_api_object_attr_t attr, uint32_t& val) noexcept {
+        val = cps_api_object_attr_data_u32 (attr);
+    }
+
+    static bool encode (cps_api_object_t obj, nas::attr_list_t& attr_list,
+                        const uint32_t& val) noexcept {
+        return cps_api_object_e_add (obj, attr_list.data (), attr_list.size (),
+                                     cps_api_object_ATTR_T_U32, &val, sizeof (uint32_t));
+    }
+};
+
+// Decode one attribute looked up by nas_acl_get_attrs_from_obj ().
+// A NULL attr is a missing optional attribute.
+template <typename T>
+inline void nas_acl_cps_decode_val (cps_api_object_attr_t      attr,
+                                    const nas_acl_map_data_t&  info,
+                                    const char*                name,
+                                    T&                         val)
+{
+    typedef nas_acl_cps_val_t<T> cps_val;
+
+    if (attr == NULL) {
+        cps_val::fill_all (val, info);
+        return;
+    }
+
+    if (cps_api_object_attr_len (attr) != sizeof (T)) {
+        throw nas::base_exception { NAS_ACL_E_ATTR_LEN, __PRETTY_FUNCTION__,
+                std::string {"Failed to extract "} + name
+                + ": Size mismatch for attribute " + std::to_string (info.attr_id)
+                + " - expected: " + std::to_string (sizeof (T))
+                + " received: " + std::to_string (cps_api_object_attr_len (attr)) };
+    }
+
+    cps_val::decode (attr, val);
+
+    if (!cps_val::in_range (val, info)) {
+        throw nas::base_exception { NAS_ACL_E_ATTR_VAL, __PRETTY_FUNCTION__,
+                std::string {"Failed to extract "} + name
+                + ": Invalid value for Attribute " + std::to_string (info.attr_id)
+                + ": Received " + cps_val::to_string (val)
+                + " Allowed range " + std::to_string (info.range.min)
+                + " - " +  std::to_string (info.range.max)};
+    }
+}
+
+template <typename T>
+inline bool nas_acl_cps_encode_child (cps_api_object_t   obj,
+                                      nas::attr_list_t&  parent_list,
+                                      cps_api_attr_id_t  attr_id,
+                                      const T&           val) noexcept
+{
+    parent_list.push_back (attr_id);
+    bool rc = nas_acl_cps_val_t<T>::encode (obj, parent_list, val);
+    parent_list.pop_back ();
+
+    return rc;
+}
+
+/*
+ * Value and Mask filter - an EMBEDDED value with the data and
+ * optional mask as its two children.
+ */
+template <typename T, ndi_acl_filter_values_type_t V>
+void nas_acl_filter_decode (nas_acl_filter_t&              filter,
+                            const nas_acl_map_data_t&      /* val_info */,
+                            const nas_acl_map_data_list_t& child_list,
+                            const cps_api_object_attr_t*   attrs,
+                            const char*                    name)
+{
+    T data, mask;
+
+    nas_acl_cps_decode_val (attrs[0], child_list.data[0], name, data);
+    nas_acl_cps_decode_val (attrs[1], child_list.data[1], name, mask);
+
+    filter.set_filter_val (V, data, mask);
+}
+
+template <typename T>
+bool nas_acl_filter_encode (const nas_acl_filter_t&        filter,
+                            cps_api_object_t               obj,
+                            nas::attr_list_t&              parent_list,
+                            const nas_acl_map_data_list_t& child_list)
+{
+    T data, mask;
+
+    filter.get_filter_val (data, mask);
+
+    return (nas_acl_cps_encode_child (obj, parent_list, child_list.data[0].attr_id, data) &&
+            nas_acl_cps_encode_child (obj, parent_list, child_list.data[1].attr_id, mask));
+}
+
+// Single value action - the value attribute holds the data
+template <typename T, ndi_acl_action_values_type_t V>
+void nas_acl_action_decode (nas_acl_action_t&              action,
+                            const nas_acl_map_data_t&      val_info,
+                            const nas_acl_map_data_list_t& /* child_list */,
+                            const cps_api_object_attr_t*   attrs,
+                            const char*                    name)
+{
+    T val;
+
+    nas_acl_cps_decode_val (attrs[0], val_info, name, val);
+
+    action.set_action_val (V, val);
+}
+
+template <typename T>
+bool nas_acl_action_encode (const nas_acl_action_t&        action,
+                            cps_api_object_t               obj,
+                            nas::attr_list_t&              parent_list,
+                            const nas_acl_map_data_list_t& /* child_list */)
+{
+    T val;
+
+    action.get_action_val (val);
+
+    return nas_acl_cps_val_t<T>::encode (obj, parent_list, val);
+}
+
+#endif
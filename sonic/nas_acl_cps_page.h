@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*!
+ * \file   nas_acl_cps_page.h
+ * \brief  Paged GET of ACL Entries, Counters and Stats
+ */
+
+#ifndef _NAS_ACL_CPS_PAGE_H_
+#define _NAS_ACL_CPS_PAGE_H_
+
+#include "nas_types.h"
+#include "cps_api_operation.h"
+#include "cps_api_object.h"
+
+/*
+ * A GET of all Entries, Counters or Stats may carry a LIMIT attribute in
+ * its filter object. At most LIMIT objects are returned. If more objects
+ * are left, the last one returned carries a CURSOR attribute. The next
+ * GET sends that CURSOR back in its filter object to continue after it.
+ *
+ * The cursor is the key of the last object returned. Objects are walked
+ * in switch, Table and object ID order, so the cursor stays valid across
+ * creates and deletes. An object created behind the cursor is not
+ * returned. A deleted object is simply skipped.
+ */
+typedef struct _nas_acl_get_cursor_t {
+    nas_switch_id_t switch_id;
+    nas_obj_id_t    table_id;
+    nas_obj_id_t    obj_id;
+} nas_acl_get_cursor_t;
+
+class nas_acl_get_page_t
+{
+    public:
+        nas_acl_get_page_t (cps_api_object_t filter_obj,
+                            cps_api_attr_id_t limit_attr,
+                            cps_api_attr_id_t cursor_attr) noexcept;
+
+        // False if the filter carried a malformed cursor
+        bool valid () const noexcept {return _valid;}
+
+        // Where to start walking each level - past the cursor when
+        // the walk resumes in this switch or Table
+        template <typename M>
+        typename M::const_iterator first_switch (const M& switches) const;
+        template <typename M>
+        typename M::const_iterator first_table (const M& tables,
+                                                nas_switch_id_t switch_id) const;
+        template <typename M>
+        typename M::const_iterator first_obj (const M& objs,
+                                              nas_switch_id_t switch_id,
+                                              nas_obj_id_t table_id) const;
+
+        // Called before adding an object - false once the page is full
+        bool take () noexcept;
+        void added (nas_switch_id_t switch_id, nas_obj_id_t table_id,
+                    nas_obj_id_t obj_id) noexcept;
+        // The page filled up with objects left to walk
+        bool more () const noexcept {return _more;}
+
+        // Adds the cursor to the last object of the page if there are more
+        bool finish (cps_api_object_list_t list) const noexcept;
+
+    private:
+        cps_api_attr_id_t     _cursor_attr;
+        size_t                _limit = 0; // 0 - No limit
+        size_t                _count = 0;
+        bool                  _resume = false;
+        bool                  _valid = true;
+        bool                  _more = false;
+        nas_acl_get_cursor_t  _cursor {};
+        nas_acl_get_cursor_t  _last {};
+};
+
+template <typename M>
+typename M::const_iterator
+nas_acl_get_page_t::first_switch (const M& switches) const
+{
+    return (_resume) ? switches.lower_bound (_cursor.switch_id) : switches.begin ();
+}
+
+template <typename M>
+typename M::const_iterator
+nas_acl_get_page_t::first_table (const M& tables, nas_switch_id_t switch_id) const
+{
+    return (_resume && switch_id == _cursor.switch_id) ?
+        tables.lower_bound (_cursor.table_id) : tables.begin ();
+}
+
+template <typename M>
+typename M::const_iterator
+nas_acl_get_page_t::first_obj (const M& objs, nas_switch_id_t switch_id,
+                               nas_obj_id_t table_id) const
+{
+    return (_resume && switch_id == _cursor.switch_id &&
+            table_id == _cursor.table_id) ?
+        objs.upper_bound (_cursor.obj_id) : objs.begin ();
+}
+
+#endif /* _NAS_ACL_CPS_PAGE_H_ */
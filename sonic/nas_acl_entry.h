@@ -33,7 +33,10 @@
 #include "nas_ndi_obj_id_table.h"
 #include "nas_base_obj.h"
 #include "nas_ndi_acl.h"
+#include "nas_acl_pool.h"
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 class nas_acl_switch;
 class nas_acl_table;
@@ -41,16 +44,30 @@ class nas_acl_table;
 class nas_acl_entry final : public nas::base_obj_t
 {
     public:
-        typedef std::unordered_map<BASE_ACL_MATCH_TYPE_t, nas_acl_filter_t, std::hash<int>> filter_list_t;
+        // Filter and Action nodes are allocated from the table's pool
+        typedef std::unordered_map<BASE_ACL_MATCH_TYPE_t, nas_acl_filter_t, std::hash<int>,
+                                   std::equal_to<BASE_ACL_MATCH_TYPE_t>,
+                                   nas_acl_pool_allocator_t<std::pair<const BASE_ACL_MATCH_TYPE_t,
+                                                                      nas_acl_filter_t>>> filter_list_t;
         typedef filter_list_t::iterator  filter_iter_t;
         typedef filter_list_t::const_iterator  const_filter_iter_t;
 
-        typedef std::unordered_map<BASE_ACL_ACTION_TYPE_t, nas_acl_action_t, std::hash<int>> action_list_t;
+        typedef std::unordered_map<BASE_ACL_ACTION_TYPE_t, nas_acl_action_t, std::hash<int>,
+                                   std::equal_to<BASE_ACL_ACTION_TYPE_t>,
+                                   nas_acl_pool_allocator_t<std::pair<const BASE_ACL_ACTION_TYPE_t,
+                                                                      nas_acl_action_t>>> action_list_t;
         typedef action_list_t::iterator  action_iter_t;
         typedef action_list_t::const_iterator  const_action_iter_t;
 
+        typedef std::vector<ndi_obj_id_t> ndi_entry_id_list_t;
+
         nas::ndi_obj_id_table_t ndi_entry_ids;
 
+        // An entry with port range filters is programmed as one NDI entry
+        // per value/mask prefix combination. The first NDI entry in each
+        // NPU is tracked in ndi_entry_ids and the rest here.
+        std::unordered_map<npu_id_t, ndi_entry_id_list_t> ndi_expn_entry_ids;
+
         ////// Constructor /////
         nas_acl_entry (const nas_acl_table* table_p);
 
@@ -75,7 +92,13 @@ class nas_acl_entry final : public nas::base_obj_t
         nas_acl_counter_t* get_counter ();
 
         bool is_npu_set (npu_id_t npu_id) const noexcept;
+        bool has_port_range () const noexcept;
+        ndi_entry_id_list_t ndi_entry_id_list (npu_id_t npu_id) const;
         bool following_table_npus  () const noexcept {return _following_table_npus;}
+        // Rows the Entry needs in each of its NPUs, and the rows it is
+        // programmed with in an NPU
+        size_t hw_rows () const;
+        size_t hw_rows_in_npu (npu_id_t npu_id) const noexcept;
         void dbg_dump () const;
 
         //////// Modifiers ////////
@@ -104,6 +127,9 @@ class nas_acl_entry final : public nas::base_obj_t
         void commit_create (bool rolling_back) override;
         nas::attr_set_t commit_modify (base_obj_t& entry_orig,
                                        bool rolling_back) override;
+        // Validation of a commit before any NDI call, except the
+        // hardware admission. entry_orig is nullptr for a Create.
+        void prepare_commit (const nas_acl_entry* entry_orig);
 
         bool push_create_obj_to_npu (npu_id_t npu_id, void* ndi_obj) override;
 
@@ -132,19 +158,44 @@ class nas_acl_entry final : public nas::base_obj_t
         ndi_acl_priority_t           _priority = 0;
 
         nas::npu_set_t               _filter_npus;
+        nas::npu_set_t               _action_npus;
         bool                         _following_table_npus = true;
 
+        // Declared before the lists so that it outlives them
+        std::shared_ptr<nas_acl_pool_t> _pool;
         filter_list_t                _flist;
         action_list_t                _alist;
 
         nas_obj_id_t                 _counter_id = 0;
         bool                         _enable_counter = false;
 
+        // NDI entries of a port range reprogram, kept in the original
+        // entry to be removed if the modify is rolled back
+        std::unordered_map<npu_id_t, ndi_entry_id_list_t> _rollbk_expn_entry_ids;
+
+        nas::npu_set_t _flist_npus () const;
+        nas::npu_set_t _alist_npus () const;
+        void _prune_action_npus ();
         void _validate_counter_npus () const;
+        void _admit_hw (const nas_acl_entry* entry_orig) const;
         bool _copy_all_filters_ndi (ndi_acl_entry_t &ndi_acl_entry,
                                     npu_id_t npu_id,
+                                    const nas_acl_port_prefix_list_t& prefixes,
                                     nas::mem_alloc_helper_t& mem_trakr) const;
 
+        std::vector<nas_acl_port_prefix_list_t> _port_range_expn () const;
+        bool _push_create_expn_to_npu (npu_id_t npu_id,
+                                       const nas_acl_port_prefix_list_t& prefixes,
+                                       ndi_obj_id_t& ndi_entry_id) const;
+        void _save_ndi_entry_ids (npu_id_t npu_id,
+                                  const ndi_entry_id_list_t& id_list);
+        bool _is_port_range_modified (const nas_acl_entry& entry_old) const noexcept;
+        void _reprogram_port_range_ndi (nas_acl_entry& entry_old,
+                                        nas::npu_set_t  npu_list,
+                                        nas::rollback_trakr_t& r_trakr,
+                                        bool rolling_back);
+        void _rollback_port_range_ndi (npu_id_t npu_id);
+
         ndi_acl_action_list_t _copy_all_actions_ndi (npu_id_t npu_id,
                                                      nas::mem_alloc_helper_t& mem_trakr) const;
 
@@ -0,0 +1,91 @@
+
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+/*!
+ * \file   nas_acl_event.h
+ * \brief  NAS ACL coalesced change notification events
+ */
+
+#ifndef _NAS_ACL_EVENT_H_
+#define _NAS_ACL_EVENT_H_
+
+#include "dell-base-acl.h"
+#include "cps_api_object.h"
+#include "cps_api_operation.h"
+#include "nas_types.h"
+#include "std_error_codes.h"
+#include <stdint.h>
+
+/*
+ * Table, Entry and Counter changes are published as BASE_ACL_EVENT_OBJ
+ * events with the OBSERVED qualifier, instead of one event per change.
+ *
+ * Changes of a CPS transaction are held back until its last ACL object is
+ * committed, and dropped if the transaction fails. Committed changes are
+ * collected in a batch which is published by a separate thread once the
+ * batching window has passed since the first change of the batch. A batch
+ * holds the net change of each object - a Create followed by a Delete is
+ * dropped, a Delete followed by a Create is a Set and a Create followed by
+ * a Set stays a Create.
+ *
+ * Writes that failed after their CPS transaction ended - see
+ * nas_acl_async.h - are published in the failure list of the event, with
+ * the latest error of each object.
+ *
+ * Every event has a sequence number. A batch that exceeds
+ * NAS_ACL_EVENT_MAX_CHANGES objects is published with the overflow flag
+ * and without its changes - subscribers then have to read the ACL objects
+ * again.
+ */
+#define NAS_ACL_EVENT_WINDOW_MS_DEF    100
+#define NAS_ACL_EVENT_WINDOW_MS_ENV    "DN_ACL_EVENT_WINDOW_MS"
+#define NAS_ACL_EVENT_MAX_CHANGES      2048
+
+typedef bool (*nas_acl_event_publish_fn_ptr_t) (cps_api_object_t obj);
+
+// Connect to the CPS event service and start the publisher thread
+bool nas_acl_event_init () noexcept;
+
+// Replace the publisher - NULL disables events
+void nas_acl_event_publish_fn_set (nas_acl_event_publish_fn_ptr_t fn) noexcept;
+
+void nas_acl_event_window_set (uint32_t window_ms) noexcept;
+uint32_t nas_acl_event_window_get () noexcept;
+
+// Record a committed change of an ACL object. Called by the handlers
+// with the NAS ACL lock held.
+void nas_acl_event_note (BASE_ACL_OBJECTS_t        obj_type,
+                         cps_api_operation_types_t op,
+                         nas_obj_id_t              table_id,
+                         nas_obj_id_t              obj_id) noexcept;
+
+// Record a write that failed after its CPS transaction ended
+void nas_acl_event_note_failure (BASE_ACL_OBJECTS_t        obj_type,
+                                 cps_api_operation_types_t op,
+                                 nas_obj_id_t              table_id,
+                                 nas_obj_id_t              obj_id,
+                                 t_std_error               rc) noexcept;
+
+// Bracket the handler call for an object of a CPS transaction.
+// The transaction changes move to the batch when its last ACL object
+// ends successfully.
+void nas_acl_event_txn_begin (const void* txn, bool rollback) noexcept;
+void nas_acl_event_txn_end (const void* txn, bool success, bool last) noexcept;
+
+// Publish the current batch without waiting for the batching window
+void nas_acl_event_flush () noexcept;
+
+#endif
@@ -30,6 +30,7 @@
 #include "nas_base_utils.h"
 #include "nas_ndi_acl.h"
 #include "nas_acl_common.h"
+#include "nas_acl_port_range.h"
 #include <string.h>
 #include <vector>
 
@@ -45,18 +46,47 @@ class nas_acl_filter_t
             return nas_acl_filter_type_name (type);
         }
 
+        // Port filters are programmed only in the NPUs of their ports -
+        // an Entry with them matches nothing in the other NPUs
         static bool is_npu_specific (BASE_ACL_MATCH_TYPE_t f_type) noexcept {
             return (f_type == BASE_ACL_MATCH_TYPE_IN_PORTS ||
-                    f_type == BASE_ACL_MATCH_TYPE_IN_PORT);
+                    f_type == BASE_ACL_MATCH_TYPE_IN_PORT ||
+                    f_type == BASE_ACL_MATCH_TYPE_OUT_PORTS ||
+                    f_type == BASE_ACL_MATCH_TYPE_OUT_PORT);
+        }
+
+        // Port range filters are not programmed as is - they are expanded
+        // into value/mask prefixes of the corresponding L4 port filter
+        static bool is_port_range (BASE_ACL_MATCH_TYPE_t f_type) noexcept {
+            return (f_type == BASE_ACL_MATCH_TYPE_L4_SRC_PORT_RANGE ||
+                    f_type == BASE_ACL_MATCH_TYPE_L4_DST_PORT_RANGE);
+        }
+
+        // Filter type that the NDI table and entries are programmed with
+        static BASE_ACL_MATCH_TYPE_t ndi_filter_type (BASE_ACL_MATCH_TYPE_t f_type) noexcept {
+            switch (f_type) {
+                case BASE_ACL_MATCH_TYPE_L4_SRC_PORT_RANGE:
+                    return BASE_ACL_MATCH_TYPE_L4_SRC_PORT;
+                case BASE_ACL_MATCH_TYPE_L4_DST_PORT_RANGE:
+                    return BASE_ACL_MATCH_TYPE_L4_DST_PORT;
+                default:
+                    return f_type;
+            }
         }
 
         const char* name () const noexcept;
         void dbg_dump () const;
 
         nas_acl_filter_t (BASE_ACL_MATCH_TYPE_t t);
+        nas_acl_filter_t (const nas_acl_filter_t& rhs);
+        nas_acl_filter_t (nas_acl_filter_t&& rhs) noexcept;
+        nas_acl_filter_t& operator= (const nas_acl_filter_t& rhs);
+        nas_acl_filter_t& operator= (nas_acl_filter_t&& rhs) noexcept;
+        ~nas_acl_filter_t () { _release_ports (); }
 
-        BASE_ACL_MATCH_TYPE_t filter_type () const noexcept {return _f_info.filter_type;}
+        BASE_ACL_MATCH_TYPE_t filter_type () const noexcept {return _filter_type;}
         bool is_npu_specific () const noexcept;
+        bool is_port_range () const noexcept;
 
         void get_u8_filter_val (nas_acl_common_data_list_t& val_list) const;
         void get_u16_filter_val (nas_acl_common_data_list_t& val_list) const;
@@ -91,25 +121,79 @@ class nas_acl_filter_t
         void set_filter_ifindex_list (const nas_acl_common_data_list_t& val_list);
         void set_filter_ifindex (const nas_acl_common_data_list_t& val_list);
 
+        // Value and Mask filters set and read directly, without the common
+        // data list - T is the type of the NDI filter value (eg. uint16_t)
+        template <typename T>
+        void set_filter_val (ndi_acl_filter_values_type_t values_type,
+                             const T& data, const T& mask) noexcept;
+        template <typename T>
+        void get_filter_val (T& data, T& mask) const noexcept;
+
         bool copy_filter_ndi (ndi_acl_entry_filter_t* ndi_filter_p,
                               npu_id_t npu_id, nas::mem_alloc_helper_t& m) const;
 
+        nas_acl_port_prefix_list_t port_range_expand () const;
+        void copy_filter_ndi_prefix (ndi_acl_entry_filter_t* ndi_filter_p,
+                                     const nas_acl_port_prefix_t& prefix) const noexcept;
+
         bool operator!= (const nas_acl_filter_t& second) const noexcept;
+        // Digest of the filter - equal for filters that are not !=
+        uint64_t cfg_hash () const noexcept;
+
+        // IPv4 and IPv6 address filters - address and mask in network order
+        bool is_ip_addr () const noexcept;
+        size_t ip_addr_len () const noexcept {return _len;}
+        const uint8_t* ip_addr () const noexcept {return _val;}
+        const uint8_t* ip_mask () const noexcept {return _val + _len;}
+        // True if every address this filter matches is matched by prefix
+        bool is_within (const nas_acl_filter_t& prefix) const noexcept;
 
     private:
         // Estimated number of ports in a filter of type In ports or Out ports
         static constexpr size_t port_count_estm = 5;
 
-        ndi_acl_entry_filter_t   _f_info;
-        nas::ifindex_list_t   _ifindex_list;
+        // Widest value that has a mask
+        static constexpr size_t max_val_len = sizeof (dn_ipv6_addr_t);
+
+        // Filters are kept in this compact form for the life of the entry
+        // and expanded to the NDI filter only when pushed to the NPU
+        BASE_ACL_MATCH_TYPE_t  _filter_type;
+        uint8_t                _values_type = 0; // ndi_acl_filter_values_type_t
+        uint8_t                _len = 0;         // Width of the value and of the mask
+
+        union {
+            // Value followed by mask, _len bytes each.
+            // Value bits outside the mask are always cleared.
+            uint8_t                    _val [2 * max_val_len];
+
+            // IP type or IP frag
+            uint32_t                   _enum_val;
+
+            struct {
+                uint16_t               min;
+                uint16_t               max;
+            }                          _range;
+
+            // Port and Port list filters
+            struct {
+                ndi_port_t             ndi_port;
+                nas::ifindex_list_t*   ifindex_list;
+            }                          _port;
+        };
+
+        bool _has_ports () const noexcept {
+            return (_values_type == NDI_ACL_FILTER_PORT ||
+                    _values_type == NDI_ACL_FILTER_PORTLIST);
+        }
+        nas::ifindex_list_t& _ports (ndi_acl_filter_values_type_t values_type);
+        void _release_ports () noexcept;
+        void _copy_val (const nas_acl_filter_t& rhs);
+        void _reset_val (ndi_acl_filter_values_type_t values_type) noexcept;
+        void _set_val (ndi_acl_filter_values_type_t values_type,
+                       const void* data, const void* mask, size_t len) noexcept;
+        void _fill_ndi (ndi_acl_entry_filter_t* ndi_filter_p) const noexcept;
 };
 
-inline const nas::ifindex_list_t&
-nas_acl_filter_t::get_filter_if_list () const noexcept
-{
-    return _ifindex_list;
-}
-
 inline const char* nas_acl_filter_t::name () const noexcept
 {
     return nas_acl_filter_type_name (filter_type());
@@ -119,4 +203,25 @@ inline bool nas_acl_filter_t::is_npu_specific () const noexcept
 {
     return (nas_acl_filter_t::is_npu_specific (filter_type ()));
 }
+
+inline bool nas_acl_filter_t::is_port_range () const noexcept
+{
+    return (nas_acl_filter_t::is_port_range (filter_type ()));
+}
+
+template <typename T>
+inline void nas_acl_filter_t::set_filter_val (ndi_acl_filter_values_type_t values_type,
+                                              const T& data, const T& mask) noexcept
+{
+    static_assert (sizeof (T) <= max_val_len, "Filter value too wide");
+
+    _set_val (values_type, &data, &mask, sizeof (T));
+}
+
+template <typename T>
+inline void nas_acl_filter_t::get_filter_val (T& data, T& mask) const noexcept
+{
+    memcpy (&data, _val, sizeof (T));
+    memcpy (&mask, _val + sizeof (T), sizeof (T));
+}
 #endif
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*!
+ * \file   nas_acl_index.h
+ * \brief  Secondary indexes of the ACL Entries in a Table
+ */
+
+#ifndef _NAS_ACL_INDEX_H_
+#define _NAS_ACL_INDEX_H_
+
+#include "nas_types.h"
+#include "nas_acl_filter.h"
+#include "nas_acl_action.h"
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+class nas_acl_entry;
+
+// Ordered so that a walk of the IDs can be resumed from a cursor
+typedef std::set<nas_obj_id_t> nas_acl_entry_id_set_t;
+
+// Table ID and Entry ID of an Entry in a switch
+typedef std::pair<nas_obj_id_t, nas_obj_id_t> nas_acl_entry_ref_t;
+typedef std::vector<nas_acl_entry_ref_t> nas_acl_entry_ref_list_t;
+
+/*
+ * Kept by the switch for each Table and updated as Entries are saved and
+ * removed, so a filtered GET only visits the Entries that can match.
+ * Lookups by Filter or Action digest return candidates - digests can
+ * collide, so the caller compares each candidate with the query.
+ */
+class nas_acl_entry_index_t
+{
+    public:
+        void add (const nas_acl_entry& entry);
+        void remove (const nas_acl_entry& entry) noexcept;
+
+        // Entries that may have this Filter or Action
+        const nas_acl_entry_id_set_t& filter_entries (const nas_acl_filter_t& filter)
+            const noexcept;
+        const nas_acl_entry_id_set_t& action_entries (const nas_acl_action_t& action)
+            const noexcept;
+        // Entries with a port Filter or a port or LAG Action on the interface
+        const nas_acl_entry_id_set_t& ifindex_entries (hal_ifindex_t ifindex)
+            const noexcept;
+        // Entries with an IP address Filter of the prefix's type within it
+        nas_acl_entry_id_set_t ip_prefix_entries (const nas_acl_filter_t& prefix) const;
+
+    private:
+        typedef std::unordered_map<uint64_t, nas_acl_entry_id_set_t> digest_index_t;
+        // Address bytes in network order - Entries within a prefix are
+        // the contiguous run between its lowest and highest address
+        typedef std::multimap<std::vector<uint8_t>, nas_obj_id_t> ip_index_t;
+
+        digest_index_t  _filters;
+        digest_index_t  _actions;
+        std::unordered_map<hal_ifindex_t, nas_acl_entry_id_set_t> _ifindexes;
+        std::map<BASE_ACL_MATCH_TYPE_t, ip_index_t>  _ip_addrs;
+
+        static const nas_acl_entry_id_set_t _no_entries;
+};
+
+/*
+ * Kept by the switch across all its Tables - the Entries with a port Filter
+ * or a port or LAG Action on each interface, so that an interface event
+ * finds the Entries to reprogram without a scan of every Table.
+ */
+class nas_acl_if_index_t
+{
+    public:
+        void add (const nas_acl_entry& entry);
+        void remove (const nas_acl_entry& entry) noexcept;
+
+        // In Table ID and Entry ID order
+        nas_acl_entry_ref_list_t entries (hal_ifindex_t ifindex) const;
+
+    private:
+        std::unordered_map<hal_ifindex_t, std::set<nas_acl_entry_ref_t>> _refs;
+};
+
+#endif /* _NAS_ACL_INDEX_H_ */
@@ -31,10 +31,27 @@ extern "C" {
 
 /**
  * Initializes the NAS ACL module, Registers with CPS serivice
+ * The warm restart checkpoint is kept only if DN_ACL_WARM_RESTART is set to 1.
  * @Return   Standard Error Code
  */
 t_std_error nas_acl_init(void);
 
+/**
+ * Initializes the NAS ACL module after a restart of the NAS process
+ * that left the NPU programmed. ACL objects replayed through CPS take over
+ * the NDI objects saved in the warm restart checkpoint, instead of
+ * programming them again.
+ * @Return   Standard Error Code
+ */
+t_std_error nas_acl_init_warm(void);
+
+/**
+ * Signals the end of the configuration replay after a warm restart.
+ * NDI objects from the checkpoint that were not replayed are removed.
+ * @Return   Standard Error Code
+ */
+t_std_error nas_acl_warm_reconcile_done(void);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_intf.h
+ * \brief  NAS ACL reprogram of the Entries that refer to an interface
+ */
+
+#ifndef _NAS_ACL_INTF_H_
+#define _NAS_ACL_INTF_H_
+
+#include "std_error_codes.h"
+#include "nas_acl_switch.h"
+#include <stdint.h>
+
+/*
+ * Port Filters and port or LAG Actions keep the NPU port or LAG NDI IDs
+ * that their ifindexes resolved to when the Entry was written. When an
+ * interface changes, the Entries that refer to it are found through the
+ * interface index of the switch and their Filters and Actions on that
+ * interface are resolved again. Only the Entries that come out different
+ * are modified in NDI, and only in the Filters or Actions that changed -
+ * a LAG member change re-pushes just the redirect Actions to the LAG.
+ *
+ * The Entries are independent - one that fails to resolve or program is
+ * left as it was and the rest of the batch is still reprogrammed.
+ *
+ * Interface change events (eg. LAG membership) are queued and refreshed
+ * by a separate thread. Repeated changes of an interface are coalesced,
+ * and at most NAS_ACL_INTF_REFRESH_MAX interfaces are refreshed in each
+ * refresh interval - so a flapping LAG cannot hold the Table locks away
+ * from the other writes.
+ */
+#define NAS_ACL_INTF_REFRESH_MS_DEF    100
+#define NAS_ACL_INTF_REFRESH_MS_ENV    "DN_ACL_INTF_REFRESH_MS"
+#define NAS_ACL_INTF_REFRESH_MAX       16
+
+typedef struct _nas_acl_intf_stats_t {
+    size_t    reprogrammed;
+    size_t    unchanged;
+    size_t    failed;
+} nas_acl_intf_stats_t;
+
+// Must be called with the Table locks of the Entries held.
+// Returns NAS_ACL_E_FAIL if any of the Entries failed.
+t_std_error nas_acl_intf_reprogram_entries (nas_acl_switch&                 sw,
+                                            hal_ifindex_t                   ifindex,
+                                            const nas_acl_entry_ref_list_t& entries,
+                                            nas_acl_intf_stats_t*           stats) noexcept;
+
+// Takes the locks of the switch for the lookup and the reprogram
+t_std_error nas_acl_intf_reprogram (nas_switch_id_t       switch_id,
+                                    hal_ifindex_t         ifindex,
+                                    nas_acl_intf_stats_t* stats) noexcept;
+
+// Subscribe to interface change events and start the refresh thread
+bool nas_acl_intf_init () noexcept;
+
+// Queue a change of the interface for refresh in the default switch
+void nas_acl_intf_note_change (hal_ifindex_t ifindex) noexcept;
+
+// Refresh up to NAS_ACL_INTF_REFRESH_MAX queued interfaces now.
+// Called without the NAS ACL lock. Returns the interfaces taken from
+// the queue - the ones no Entry refers to need no lock.
+size_t nas_acl_intf_refresh_pending () noexcept;
+
+void nas_acl_intf_refresh_interval_set (uint32_t interval_ms) noexcept;
+uint32_t nas_acl_intf_refresh_interval_get () noexcept;
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*!
+ * \file   nas_acl_lock.h
+ * \brief  NAS ACL lock hierarchy
+ */
+
+#ifndef _NAS_ACL_LOCK_H_
+#define _NAS_ACL_LOCK_H_
+
+#include "nas_types.h"
+#include <pthread.h>
+#include <mutex>
+
+/*
+ * Lock order - a thread only takes locks further down this list than
+ * the ones it already holds:
+ *
+ *  1. NAS ACL lock   nas_acl_lock ()             Exclusive for work on the
+ *                                                whole ACL state, shared for
+ *                                                everything else.
+ *  2. Switch lock    nas_acl_switch::lock ()     Exclusive to create, modify
+ *                                                or delete Tables of the
+ *                                                switch, shared for work in
+ *                                                existing Tables.
+ *  3. Table locks    nas_acl_switch::table_lock  Guard the Entries, Counters,
+ *                                                ID generators, slab pool and
+ *                                                hardware usage of a Table.
+ *                                                Several Table locks are
+ *                                                taken in ascending Table ID.
+ *  4. Leaf locks     Switch list, warm checkpoint, event batch, async
+ *                    queue, NPU hardware usage, interface index,
+ *                    interface refresh queue and undo journal. Only the
+ *                    NDI and latency histogram locks are taken while one
+ *                    of them is held.
+ *  5. NDI lock       nas_acl_ndi_mutex ()        Held across each NDI ACL
+ *                                                call, which NDI does not
+ *                                                take concurrently.
+ *  6. Latency histogram lock - innermost of all.
+ *
+ * Entries only refer to Counters of their own Table, so Entry and Counter
+ * writes need the lock of a single Table. Writes to different Tables run
+ * in parallel up to their NDI calls, which are serialized.
+ */
+
+// Exclusive requests are preferred over new shared ones - shared locks
+// must not be taken recursively
+class nas_acl_rwlock_t
+{
+    public:
+        nas_acl_rwlock_t () noexcept;
+        ~nas_acl_rwlock_t ();
+
+        nas_acl_rwlock_t (const nas_acl_rwlock_t&) = delete;
+        nas_acl_rwlock_t& operator= (const nas_acl_rwlock_t&) = delete;
+
+        int lock () noexcept {return pthread_rwlock_wrlock (&_lock);}
+        int lock_shared () noexcept {return pthread_rwlock_rdlock (&_lock);}
+        int unlock () noexcept {return pthread_rwlock_unlock (&_lock);}
+
+    private:
+        pthread_rwlock_t _lock;
+};
+
+typedef enum {
+    NAS_ACL_LOCK_ALL,       /* NAS ACL lock exclusive */
+    NAS_ACL_LOCK_SWITCH,    /* Switch lock exclusive */
+    NAS_ACL_LOCK_TABLES,    /* Switch lock shared and all its Table locks */
+    NAS_ACL_LOCK_TABLE,     /* Switch lock shared and one Table lock */
+} nas_acl_lock_level_t;
+
+class nas_acl_switch;
+
+// Locks taken for a request - in the lock order and released in reverse.
+// Nothing is allocated, so taking them cannot fail.
+class nas_acl_lock_scope_t
+{
+    public:
+        nas_acl_lock_scope_t (nas_acl_lock_level_t level = NAS_ACL_LOCK_ALL,
+                              nas_switch_id_t      switch_id = 0,
+                              nas_obj_id_t         table_id = 0) noexcept
+            : _level (level), _switch_id (switch_id), _table_id (table_id) {}
+
+        nas_acl_lock_level_t level () const noexcept {return _level;}
+
+        void lock () noexcept;
+        void unlock () noexcept;
+
+    private:
+        nas_acl_lock_level_t       _level;
+        nas_switch_id_t            _switch_id;
+        nas_obj_id_t               _table_id;
+
+        // Set while the switch lock is held
+        nas_acl_switch*            _switch_p = nullptr;
+        // Lock of the single Table of NAS_ACL_LOCK_TABLE
+        std::mutex*                _table_lock_p = nullptr;
+};
+
+int nas_acl_lock () noexcept;
+
+int nas_acl_lock_shared () noexcept;
+
+int nas_acl_unlock () noexcept;
+
+std::mutex& nas_acl_ndi_mutex () noexcept;
+
+#endif
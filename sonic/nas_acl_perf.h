@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_perf.h
+ * \brief  NAS ACL CPS and NDI latency histograms
+ */
+
+#ifndef _NAS_ACL_PERF_H_
+#define _NAS_ACL_PERF_H_
+
+#include "ds_common_types.h"
+#include "std_error_codes.h"
+#include "nas_acl_lock.h"
+#include <stdint.h>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <functional>
+
+/*
+ * Latencies are recorded in nanoseconds into log2 buckets.
+ * Bucket 0 counts zero latencies, bucket N counts latencies in the
+ * range [2^(N-1), 2^N) and the last bucket counts everything above.
+ *
+ * Requests record under shared or Table locks, so all histograms are
+ * updated and read with the leaf _perf_mutex of nas_acl_perf.cpp held
+ * (latency histogram lock in nas_acl_lock.h).
+ */
+#define NAS_ACL_PERF_HIST_BUCKETS  32
+
+typedef enum {
+    NAS_ACL_PERF_OBJ_TABLE,
+    NAS_ACL_PERF_OBJ_ENTRY,
+    NAS_ACL_PERF_OBJ_COUNTER,
+    NAS_ACL_PERF_OBJ_STATS,
+    NAS_ACL_PERF_OBJ_MAX
+} nas_acl_perf_obj_t;
+
+typedef enum {
+    NAS_ACL_PERF_OP_CREATE,
+    NAS_ACL_PERF_OP_SET,
+    NAS_ACL_PERF_OP_DELETE,
+    NAS_ACL_PERF_OP_GET,
+    NAS_ACL_PERF_OP_MAX
+} nas_acl_perf_op_t;
+
+typedef enum {
+    NAS_ACL_PERF_PHASE_TOTAL,     /* Lock wait + handler */
+    NAS_ACL_PERF_PHASE_LOCK_WAIT,
+    NAS_ACL_PERF_PHASE_PARSE,     /* CPS object to NAS object */
+    NAS_ACL_PERF_PHASE_COMMIT,    /* NAS object to NDI */
+    NAS_ACL_PERF_PHASE_SAVE,      /* Update local cache */
+    NAS_ACL_PERF_PHASE_MAX
+} nas_acl_perf_phase_t;
+
+typedef struct _nas_acl_perf_hist_t {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t bucket[NAS_ACL_PERF_HIST_BUCKETS];
+} nas_acl_perf_hist_t;
+
+uint64_t nas_acl_perf_now_ns () noexcept;
+
+size_t nas_acl_perf_bucket (uint64_t ns) noexcept;
+
+void nas_acl_perf_hist_record (nas_acl_perf_hist_t& hist, uint64_t ns) noexcept;
+
+void nas_acl_perf_record (nas_acl_perf_obj_t obj, nas_acl_perf_op_t op,
+                          nas_acl_perf_phase_t phase, uint64_t ns) noexcept;
+
+void nas_acl_perf_ndi_record (npu_id_t npu_id, uint64_t ns) noexcept;
+
+/*
+ * Walk all non-empty histograms. Names are of the form
+ * "<object>/<operation>/<phase>" for CPS and "ndi/npu-<id>" for NDI.
+ */
+typedef std::function<void (const std::string& name,
+                            const nas_acl_perf_hist_t& hist)> nas_acl_perf_walk_fn_t;
+
+void nas_acl_perf_walk (const nas_acl_perf_walk_fn_t& fn);
+
+void nas_acl_perf_reset () noexcept;
+
+void nas_acl_perf_dump () noexcept;
+
+/*
+ * Times one CPS request. Created before taking the NAS ACL lock,
+ * made active once the lock is acquired and ended before it is released.
+ * Phase timers started while a request is active are recorded against it.
+ * Requests with an object or operation of _MAX are not recorded.
+ */
+class nas_acl_perf_req_t
+{
+    public:
+        nas_acl_perf_req_t (nas_acl_perf_obj_t obj, nas_acl_perf_op_t op) noexcept;
+
+        void lock_acquired () noexcept;
+        void end () noexcept;
+
+    private:
+        nas_acl_perf_obj_t _obj;
+        nas_acl_perf_op_t  _op;
+        uint64_t           _start_ns;
+        bool               _active = false;
+};
+
+/*
+ * Times consecutive phases of the active request - each call to next ()
+ * closes the running phase. The running phase is recorded on destruction
+ * unless stopped, so phases aborted by an exception are still counted.
+ */
+class nas_acl_perf_phase_timer_t
+{
+    public:
+        nas_acl_perf_phase_timer_t (nas_acl_perf_phase_t phase) noexcept;
+        ~nas_acl_perf_phase_timer_t () { stop (); }
+
+        void next (nas_acl_perf_phase_t phase) noexcept;
+        void stop () noexcept;
+
+    private:
+        nas_acl_perf_phase_t _phase;
+        uint64_t             _start_ns;
+        bool                 _running = true;
+};
+
+/*
+ * Invoke an NDI ACL API and record its latency against the NPU.
+ * All NDI ACL APIs take the NPU ID as the first argument. Calls are
+ * serialized by the NDI lock and timed once it is taken.
+ */
+template <typename F, typename... Args>
+inline t_std_error nas_acl_perf_ndi_call (F ndi_fn, npu_id_t npu_id, Args&&... args)
+{
+    uint64_t    start_ns;
+    uint64_t    end_ns;
+    t_std_error rc;
+
+    {
+        std::lock_guard<std::mutex> lock (nas_acl_ndi_mutex ());
+
+        start_ns = nas_acl_perf_now_ns ();
+        rc = ndi_fn (npu_id, std::forward<Args> (args)...);
+        end_ns = nas_acl_perf_now_ns ();
+    }
+
+    nas_acl_perf_ndi_record (npu_id, end_ns - start_ns);
+    return rc;
+}
+
+#endif
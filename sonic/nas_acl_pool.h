@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_pool.h
+ * \brief  NAS ACL per-table slab pools for Entries and their Filters/Actions
+ */
+
+#ifndef _NAS_ACL_POOL_H_
+#define _NAS_ACL_POOL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Allocations are rounded up to a size class and served from slabs of
+ * same-sized blocks. Freed blocks go back on the size class free list and
+ * are handed out again to the next allocation of that size - an erased
+ * Entry map node is reused by the next Entry inserted in the table.
+ * Slabs are only returned to the heap when the table is deleted.
+ *
+ * Slabs start small and double in size, so that tables with a handful of
+ * entries do not hold on to large slabs.
+ *
+ * Pools are used with the lock of their Table held - they are not thread safe.
+ */
+#define NAS_ACL_POOL_CLASS_SIZE    16   /* Size class granularity */
+#define NAS_ACL_POOL_MAX_BLOCK     512  /* Larger allocations go to the heap */
+#define NAS_ACL_POOL_MIN_SLAB      8    /* Blocks in the first slab of a class */
+#define NAS_ACL_POOL_MAX_SLAB      256  /* Blocks in the largest slab */
+
+typedef struct _nas_acl_pool_stats_t {
+    size_t   block_size;
+    size_t   slabs;
+    size_t   blocks_total;
+    size_t   blocks_in_use;
+    uint64_t allocs;        /* Allocations served by this size class */
+    uint64_t reused;        /* Of these, the ones served from freed blocks */
+} nas_acl_pool_stats_t;
+
+class nas_acl_pool_t
+{
+    public:
+        nas_acl_pool_t () = default;
+        nas_acl_pool_t (const nas_acl_pool_t&) = delete;
+        nas_acl_pool_t& operator= (const nas_acl_pool_t&) = delete;
+
+        void* alloc (size_t size);
+        void  free (void* p, size_t size) noexcept;
+
+        // Stats of each size class that has allocated a slab
+        std::vector<nas_acl_pool_stats_t> stats () const;
+
+        // Allocations too large for the pool
+        uint64_t heap_allocs () const noexcept {return _heap_allocs;}
+
+    private:
+        struct _block_t {
+            _block_t*  next;
+        };
+
+        struct _size_class_t {
+            _block_t*                              free_list = nullptr;
+            uint8_t*                               fresh_p = nullptr;
+            size_t                                 fresh_left = 0;
+            std::vector<std::unique_ptr<uint8_t[]>> slabs;
+            size_t                                 blocks_total = 0;
+            size_t                                 blocks_in_use = 0;
+            uint64_t                               allocs = 0;
+            uint64_t                               reused = 0;
+        };
+
+        static constexpr size_t _num_classes =
+            NAS_ACL_POOL_MAX_BLOCK / NAS_ACL_POOL_CLASS_SIZE;
+
+        _size_class_t  _classes [_num_classes];
+        uint64_t       _heap_allocs = 0;
+
+        void _add_slab (_size_class_t& sc, size_t block_size);
+};
+
+/*
+ * Standard allocator on top of a pool, for the containers of a table.
+ * Without a pool it falls back to the heap.
+ */
+template <typename T>
+class nas_acl_pool_allocator_t
+{
+    public:
+        typedef T value_type;
+
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        nas_acl_pool_allocator_t (nas_acl_pool_t* pool = nullptr) noexcept
+            : _pool (pool) {}
+
+        template <typename U>
+        nas_acl_pool_allocator_t (const nas_acl_pool_allocator_t<U>& rhs) noexcept
+            : _pool (rhs.pool ()) {}
+
+        T* allocate (size_t n)
+        {
+            return static_cast<T*> ((_pool != nullptr) ? _pool->alloc (n * sizeof (T))
+                                                       : ::operator new (n * sizeof (T)));
+        }
+
+        void deallocate (T* p, size_t n) noexcept
+        {
+            if (_pool != nullptr) {
+                _pool->free (p, n * sizeof (T));
+            } else {
+                ::operator delete (p);
+            }
+        }
+
+        nas_acl_pool_t* pool () const noexcept {return _pool;}
+
+    private:
+        nas_acl_pool_t*  _pool;
+};
+
+template <typename T, typename U>
+inline bool operator== (const nas_acl_pool_allocator_t<T>& lhs,
+                        const nas_acl_pool_allocator_t<U>& rhs) noexcept
+{
+    return (lhs.pool () == rhs.pool ());
+}
+
+template <typename T, typename U>
+inline bool operator!= (const nas_acl_pool_allocator_t<T>& lhs,
+                        const nas_acl_pool_allocator_t<U>& rhs) noexcept
+{
+    return (lhs.pool () != rhs.pool ());
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_port_range.h
+ * \brief  NAS ACL L4 port range to value/mask prefix expansion
+ */
+
+#ifndef _NAS_ACL_PORT_RANGE_H_
+#define _NAS_ACL_PORT_RANGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Value/Mask pair matching a power-of-2 aligned block of L4 ports
+typedef struct _nas_acl_port_prefix_t {
+    uint16_t data;
+    uint16_t mask;
+} nas_acl_port_prefix_t;
+
+typedef std::vector<nas_acl_port_prefix_t> nas_acl_port_prefix_list_t;
+
+// Worst case number of prefixes for a 16-bit range (eg. 1 - 65534)
+#define NAS_ACL_PORT_RANGE_MAX_PREFIXES  30
+
+/*
+ * Expand the L4 port range [min, max] into the smallest list of value/mask
+ * prefixes whose union is exactly the range.
+ * An empty list is returned if min is greater than max.
+ */
+nas_acl_port_prefix_list_t nas_acl_port_range_expand (uint16_t min,
+                                                      uint16_t max);
+
+/*
+ * Number of NDI entries needed to program a cross product of
+ * the given prefix expansions. Returns 1 for an empty list.
+ */
+size_t nas_acl_port_range_expn_count (const std::vector<nas_acl_port_prefix_list_t>&
+                                      expn_list) noexcept;
+
+/*
+ * Pick the prefix from each expansion that makes up the NDI entry at
+ * position expn_idx in the cross product.
+ */
+void nas_acl_port_range_expn_at (const std::vector<nas_acl_port_prefix_list_t>&
+                                 expn_list, size_t expn_idx,
+                                 nas_acl_port_prefix_list_t& out) noexcept;
+
+#endif
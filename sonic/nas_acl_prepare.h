@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*!
+ * \file   nas_acl_prepare.h
+ * \brief  NAS ACL validation of a CPS change list before any NDI call
+ */
+
+#ifndef _NAS_ACL_PREPARE_H_
+#define _NAS_ACL_PREPARE_H_
+
+#include "std_error_codes.h"
+#include "cps_api_object.h"
+#include <stddef.h>
+
+/*
+ * Before the first ACL object of a transaction with several ACL objects is
+ * written, the whole change list is validated against the cache and the
+ * hardware usage accounting. An object late in the list that would fail
+ * then fails the transaction before any NDI call, rather than after the
+ * objects before it were programmed and have to be rolled back.
+ *
+ * The list is walked in order over an overlay of the cache that tracks the
+ * Tables, Counters and Entries created and deleted by the objects before:
+ *  - Table and Counter Create with their ID are parsed into scratch copies
+ *    that the Entries after them are checked against, so a Table created
+ *    with its Counters and Entries in one transaction is checked whole.
+ *  - Entry Create and Set are parsed into a scratch Entry - which checks the
+ *    Match filters allowed by the Table and the Counter of the Entry - and
+ *    go through the checks of a commit that need no NDI call.
+ *  - Table, Counter and Entry Create need a free ID, Entry Set and Delete
+ *    an existing Entry.
+ *  - Rows taken and freed by the Entries are summed per Table and per NPU
+ *    and checked against the Table quota and the NPU capacity.
+ * Tables and Counters created without ID and the objects that depend on
+ * them, Entry Set after an earlier write of the Entry, and incremental
+ * Match/Action updates are left to their own write.
+ *
+ * Nothing is written to the cache or NDI. Transactions are only validated
+ * when the pass is enabled, since it parses every Entry twice. The same
+ * check is always offered as a dry run: a Set of BASE_ACL_VALIDATE_OBJ with the ACL objects serialized
+ * in BASE_ACL_VALIDATE_OBJECT attributes - their operation in their key -
+ * returns the result in BASE_ACL_VALIDATE_STATUS, _FAILED_INDEX, _CHECKED
+ * and _DEFERRED attributes.
+ */
+#define NAS_ACL_PREPARE_ENV  "DN_ACL_PREPARE"
+
+typedef struct _nas_acl_prepare_result_t {
+    t_std_error  rc;            /* Error of the first object that would fail */
+    size_t       fail_index;    /* Its index in the list */
+    size_t       checked;       /* ACL objects validated */
+    size_t       deferred;      /* ACL objects left to their own write */
+} nas_acl_prepare_result_t;
+
+// Must be called with the NAS ACL lock held exclusively.
+// Validates the objects of the list from start_index on.
+bool nas_acl_prepare_list (cps_api_object_list_t     list,
+                           size_t                    start_index,
+                           nas_acl_prepare_result_t* result) noexcept;
+
+// Enable the validation of transactions if NAS_ACL_PREPARE_ENV is set to 1
+void nas_acl_prepare_init () noexcept;
+void nas_acl_prepare_enable (bool enable) noexcept;
+bool nas_acl_prepare_is_enabled () noexcept;
+
+#endif
@@ -29,9 +29,22 @@
 #include "nas_acl_counter.h"
 #include "nas_acl_entry.h"
 #include "nas_acl_table.h"
+#include "nas_acl_pool.h"
+#include "nas_acl_lock.h"
+#include "nas_acl_index.h"
 #include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
+/*
+ * NDI has no ACL capability query - the capacity of each NPU is set by
+ * the platform through set_hw_capacity () or else from these variables.
+ * Capacity 0 is unlimited, leaving NDI to report a full TCAM.
+ */
+#define NAS_ACL_HW_MAX_ROWS_ENV      "DN_ACL_NPU_MAX_ROWS"
+#define NAS_ACL_HW_MAX_COUNTERS_ENV  "DN_ACL_NPU_MAX_COUNTERS"
+
 class nas_acl_switch : public nas::base_switch_t
 {
     public:
@@ -45,14 +58,20 @@ class nas_acl_switch : public nas::base_switch_t
         typedef table_list_t::iterator table_iter_t;
         typedef table_list_t::const_iterator const_table_iter_t;
 
-        typedef std::map<nas_obj_id_t, nas_acl_entry> entry_list_t;
+        // Entry nodes are allocated from the per-table pool
+        typedef std::map<nas_obj_id_t, nas_acl_entry, std::less<nas_obj_id_t>,
+                         nas_acl_pool_allocator_t<std::pair<const nas_obj_id_t,
+                                                            nas_acl_entry>>> entry_list_t;
         typedef entry_list_t::iterator entry_iter_t;
         typedef entry_list_t::const_iterator const_entry_iter_t;
 
         typedef std::map<nas_obj_id_t, nas_acl_counter_t> counter_list_t;
+        // Counters keyed by Table ID and Counter ID
+        typedef std::map<std::pair<nas_obj_id_t, nas_obj_id_t>,
+                         nas_acl_counter_t> staged_counter_list_t;
 
         ///// Constructor ////
-        nas_acl_switch (nas_obj_id_t id): nas::base_switch_t (id) {};
+        nas_acl_switch (nas_obj_id_t id);
 
         ///////// Accessors ///////
         // ACL Table Get
@@ -66,26 +85,60 @@ class nas_acl_switch : public nas::base_switch_t
         nas_acl_entry*        find_entry (nas_obj_id_t tbl_id,
                                           nas_obj_id_t entry_id) noexcept;
         const entry_list_t&   entry_list (nas_obj_id_t tbl_id) const;
+        const nas_acl_entry_index_t& entry_index (nas_obj_id_t tbl_id) const;
+        // Entries of all the Tables that refer to the interface
+        nas_acl_entry_ref_list_t if_entries (hal_ifindex_t ifindex) const;
 
         nas_acl_counter_t&    get_counter (nas_obj_id_t tbl_id,
                                            nas_obj_id_t counter_id);
         nas_acl_counter_t*    find_counter (nas_obj_id_t tbl_id,
                                             nas_obj_id_t counter_id) noexcept;
         const counter_list_t& counter_list (nas_obj_id_t tbl_id) const;
+        // Counters not in the cache that get_counter and find_counter return
+        // first - set only by nas_acl_prepare_list, under the exclusive lock,
+        // for the Counters of the transaction it validates
+        void stage_counters (staged_counter_list_t* counters) noexcept
+        { _staged_counters = counters; }
+
+        // Slab pool for the Entries of a table - NULL if the table is not saved
+        std::shared_ptr<nas_acl_pool_t> table_pool (nas_obj_id_t tbl_id) const noexcept;
+
+        // Locks - see the lock order in nas_acl_lock.h
+        nas_acl_rwlock_t&     lock () noexcept {return _lock;}
+        // NULL if the table is not saved
+        std::mutex*           table_lock (nas_obj_id_t tbl_id) noexcept;
+
+        ///// Hardware resources - counted as objects are saved and removed
+        nas_acl_hw_usage_t    hw_capacity (npu_id_t npu_id) const noexcept;
+        nas_acl_hw_usage_t    npu_hw_usage (npu_id_t npu_id) const noexcept;
+        nas_acl_hw_usage_t    table_hw_usage (nas_obj_id_t tbl_id,
+                                              npu_id_t npu_id) const noexcept;
+        // Room left for the table in the NPU - SIZE_MAX if unlimited
+        nas_acl_hw_usage_t    hw_headroom (const nas_acl_table& table,
+                                           npu_id_t npu_id) const noexcept;
+        // Throws NAS_ACL_E_FULL if the table has no room for more in the NPU
+        void                  hw_admit (const nas_acl_table& table, npu_id_t npu_id,
+                                        const nas_acl_hw_usage_t& more) const;
 
         ///////// Modifiers //////////
         ///// ACL Table list
         nas_acl_table& save_table (nas_acl_table&& tbl_temp) noexcept;
         void remove_table (nas_obj_id_t id) noexcept;
+        void set_hw_capacity (npu_id_t npu_id, const nas_acl_hw_usage_t& cap) noexcept;
+
         nas_obj_id_t alloc_table_id () {return _tableid_gen.alloc_id ();}
         bool reserve_table_id (nas_obj_id_t id);
         void release_table_id (nas_obj_id_t table_id) noexcept
         { _tableid_gen.release_id (table_id); }
 
         ///// ACL entry  list
-        nas_acl_entry&  save_entry (nas_acl_entry&& entry_temp) noexcept;
+        // The replaced or removed Entry is moved into the optional
+        // out parameter instead of being destroyed
+        nas_acl_entry&  save_entry (nas_acl_entry&& entry_temp,
+                                    nas_acl_entry* entry_replaced = nullptr) noexcept;
         void remove_entry_from_table (nas_obj_id_t table_id,
-                                      nas_obj_id_t entry_id) noexcept;
+                                      nas_obj_id_t entry_id,
+                                      nas_acl_entry* entry_removed = nullptr) noexcept;
         nas_obj_id_t alloc_entry_id_in_table (nas_obj_id_t table_id);
         bool reserve_entry_id_in_table (nas_obj_id_t table_id, nas_obj_id_t id);
         void release_entry_id_in_table (nas_obj_id_t table_id,
@@ -102,12 +155,27 @@ class nas_acl_switch : public nas::base_switch_t
 
     private:
 
+        typedef std::unordered_map<npu_id_t, nas_acl_hw_usage_t> hw_usage_list_t;
+
         struct acl_table_container_t
         {
+            acl_table_container_t ()
+                : _pool (std::make_shared<nas_acl_pool_t> ()),
+                  _acl_entries (entry_list_t::allocator_type (_pool.get ())) {}
+
+            std::mutex           _lock;
+            // Declared before the Entries so that it outlives them
+            std::shared_ptr<nas_acl_pool_t>  _pool;
             nas::id_generator_t  _entry_id_gen {NAS_ACL_ENTRY_ID_MAX};
             entry_list_t     _acl_entries;
+            nas_acl_entry_index_t  _entry_index;
             nas::id_generator_t  _counter_id_gen {NAS_ACL_ENTRY_ID_MAX};
             counter_list_t     _acl_counters;
+            hw_usage_list_t    _hw_usage;
+            // What each Entry and Counter was charged - their NDI IDs
+            // are gone by the time they are removed
+            std::unordered_map<nas_obj_id_t, hw_usage_list_t>  _entry_hw_usage;
+            std::unordered_map<nas_obj_id_t, hw_usage_list_t>  _counter_hw_usage;
         };
 
         typedef std::unordered_map<nas_obj_id_t, acl_table_container_t>
@@ -117,6 +185,30 @@ class nas_acl_switch : public nas::base_switch_t
         table_container_list_t  _table_containers;
 
         nas::id_generator_t          _tableid_gen {NAS_ACL_TABLE_ID_MAX};
+
+        nas_acl_rwlock_t             _lock;
+
+        staged_counter_list_t*       _staged_counters = nullptr;
+
+        // Switch totals are updated under Table locks - so they have
+        // a leaf lock of their own
+        mutable std::mutex           _hw_mutex;
+        hw_usage_list_t              _npu_hw_usage;
+        hw_usage_list_t              _npu_hw_capacity;
+        nas_acl_hw_usage_t           _hw_default_capacity {0, 0};
+
+        // Updated as Entries of any Table are saved - a leaf lock too
+        mutable std::mutex           _if_mutex;
+        nas_acl_if_index_t           _if_index;
+
+        void _hw_account (acl_table_container_t& container, npu_id_t npu_id,
+                          const nas_acl_hw_usage_t& usage, bool add) noexcept;
+        void _hw_charge (acl_table_container_t& container, hw_usage_list_t& charged,
+                         hw_usage_list_t&& usage) noexcept;
+        void _hw_account_entry (acl_table_container_t& container,
+                                const nas_acl_entry& entry, bool add) noexcept;
+        void _hw_account_counter (acl_table_container_t& container,
+                                  const nas_acl_counter_t& counter, bool add) noexcept;
 };
 
 #endif
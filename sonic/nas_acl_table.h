@@ -33,6 +33,13 @@
 
 class nas_acl_switch;
 
+// TCAM rows and Counters in an NPU. An Entry takes a row for each
+// expansion of its port ranges.
+typedef struct _nas_acl_hw_usage_t {
+    size_t rows;
+    size_t counters;
+} nas_acl_hw_usage_t;
+
 /**
 * @class NAS ACL Table
 * @brief ACL Table class derived from Base Object
@@ -68,12 +75,16 @@ class nas_acl_table final : public nas::base_obj_t
         void       allowed_filters_c_cpy (size_t filter_count,
                                           BASE_ACL_MATCH_TYPE_t* filter_list) const noexcept;
         ndi_obj_id_t  get_ndi_obj_id (npu_id_t  npu_id) const;
+        // Rows and Counters the Table may use in each NPU - 0 is unlimited
+        const nas_acl_hw_usage_t& hw_quota () const noexcept {return _hw_quota;}
 
         //////// Modifiers ////////
         void set_table_id (nas_obj_id_t id);
         void set_stage (uint_t stage);
         void set_priority (ndi_acl_priority_t p);
         void set_allowed_filter (uint_t filter_id);
+        void set_max_rows (uint_t rows);
+        void set_max_counters (uint_t counters);
 
         // Override all base class routines that handle NPU change request
         // to disallow change when table has entries
@@ -104,6 +115,7 @@ class nas_acl_table final : public nas::base_obj_t
         // Create-only attributes
         BASE_ACL_STAGE_t   _stage = BASE_ACL_STAGE_INGRESS;
         filter_set_t      _allowed_filters;
+        nas_acl_hw_usage_t _hw_quota {0, 0};
 
         // Read-write attributes
         ndi_acl_priority_t    _priority = 0;
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_undo.h
+ * \brief  NAS ACL undo journal of the Entries changed by a CPS transaction
+ */
+
+#ifndef _NAS_ACL_UNDO_H_
+#define _NAS_ACL_UNDO_H_
+
+#include "cps_api_object.h"
+#include "cps_api_operation.h"
+#include "nas_base_utils.h"
+#include "nas_acl_entry.h"
+#include <memory>
+
+/*
+ * Entry Modify and Delete save the previous Entry in an undo journal
+ * rather than serializing it into the CPS prev object of the write - a
+ * write is rarely rolled back. The prev object only carries the Entry key,
+ * so that CPS routes the rollback as before, and the journal fills in the
+ * saved attributes when the rollback is invoked.
+ *
+ * Filling the prev object needs only the saved Entry's own lists, not its
+ * Table - which the transaction may have deleted meanwhile.
+ *
+ * The journal holds the records of a single CPS transaction and is dropped
+ * when the transaction ends - its prev objects are freed by CPS then. It
+ * ends when the last object of the change list is written, when a write
+ * fails with nothing before it to roll back, or when the rollback has
+ * undone the first ACL object. If other objects follow the last ACL
+ * object, a rollback can still come after it - the prev objects are then
+ * filled from the journal before it is dropped.
+ *
+ * The async worker's writes are never rolled back and are not journaled.
+ *
+ * Saved Entries allocate from the pool of their Table, so they are freed
+ * with the Table lock held.
+ */
+
+// The attributes of old_entry to be restored - a Modify restores only the
+// ones it modified. If the record cannot be kept, prev is filled now.
+void nas_acl_undo_save (cps_api_object_t                prev,
+                        std::unique_ptr<nas_acl_entry>  old_entry_p,
+                        const nas::attr_set_t&          attrs,
+                        bool                            npu_modified) noexcept;
+
+// Fill prev from its record, if it has one, before the rollback of its write
+void nas_acl_undo_fill (cps_api_object_t prev) noexcept;
+
+// Drop the records of the transaction, filling their prev objects first
+// if fill_prev is set. Table locks are taken unless the caller holds the
+// NAS ACL lock exclusively.
+void nas_acl_undo_reset (bool lock_tables, bool fill_prev = false) noexcept;
+
+size_t nas_acl_undo_size () noexcept;
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_warm.h
+ * \brief  NAS ACL warm restart checkpoint and reconcile
+ */
+
+#ifndef _NAS_ACL_WARM_H_
+#define _NAS_ACL_WARM_H_
+
+#include "nas_types.h"
+#include "nas_acl_entry.h"
+#include "nas_acl_table.h"
+#include "nas_acl_counter.h"
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Every Table, Counter and Entry saved in the switch cache is checkpointed
+ * along with its NDI IDs and a digest of its configuration, to a memory
+ * mapped file. The file is in tmpfs - it survives a restart of the NAS
+ * process but not a reboot, which also resets the NPU.
+ *
+ * After a warm restart the configuration is replayed through CPS. Objects
+ * whose digest matches the checkpoint adopt the NDI objects already in the
+ * NPU instead of creating them again - matching Entries keep forwarding
+ * and matching Counters keep their statistics. Objects that differ are
+ * reprogrammed. NDI objects of the old run that are not replayed are
+ * removed when the application signals the end of the replay.
+ *
+ * The file is a header followed by fixed size records - one per NDI object
+ * of a NAS object in an NPU. Records are rewritten in place as objects are
+ * saved and freed when objects are removed.
+ *
+ * The checkpoint is only kept if warm restart is enabled, by setting
+ * NAS_ACL_WARM_ENV to 1, or after a warm restart.
+ */
+#define NAS_ACL_WARM_ENV           "DN_ACL_WARM_RESTART"
+#define NAS_ACL_WARM_FILE          "/var/run/nas_acl_warm.ckpt"
+#define NAS_ACL_WARM_MAGIC         0x4e41574dU    /* NAWM */
+#define NAS_ACL_WARM_VERSION       1
+#define NAS_ACL_WARM_MIN_RECORDS   1024
+
+typedef enum {
+    NAS_ACL_WARM_OBJ_FREE = 0,
+    NAS_ACL_WARM_OBJ_TABLE,
+    NAS_ACL_WARM_OBJ_COUNTER,
+    NAS_ACL_WARM_OBJ_ENTRY,
+} nas_acl_warm_obj_t;
+
+typedef struct _nas_acl_warm_hdr_t {
+    uint32_t  magic;
+    uint16_t  version;
+    uint16_t  rec_size;
+    uint32_t  rec_count;
+    uint32_t  reserved;
+} nas_acl_warm_hdr_t;
+
+typedef struct _nas_acl_warm_rec_t {
+    uint8_t   obj_type;     /* nas_acl_warm_obj_t - written last */
+    uint8_t   reserved;
+    uint16_t  ndi_idx;      /* Position in the Entry's port range expansion */
+    uint32_t  npu_id;
+    uint32_t  switch_id;
+    uint32_t  reserved2;
+    uint64_t  table_id;
+    uint64_t  obj_id;
+    uint64_t  cfg_hash;
+    uint64_t  ndi_id;
+} nas_acl_warm_rec_t;
+
+// Open NAS_ACL_WARM_FILE if warm restart is enabled or warm is set
+void nas_acl_warm_init (bool warm) noexcept;
+
+// Open the checkpoint - loading the previous run's objects if warm
+bool nas_acl_warm_open (const char* path, bool warm) noexcept;
+void nas_acl_warm_close () noexcept;
+bool nas_acl_warm_is_reconciling () noexcept;
+
+// Remove NDI objects of the previous run not replayed
+void nas_acl_warm_reconcile () noexcept;
+
+// Configuration digest of an object in an NPU
+uint64_t nas_acl_warm_table_hash (const nas_acl_table& table) noexcept;
+uint64_t nas_acl_warm_counter_hash (const nas_acl_counter_t& counter,
+                                    npu_id_t npu_id) noexcept;
+uint64_t nas_acl_warm_entry_hash (const nas_acl_entry& entry,
+                                  npu_id_t npu_id) noexcept;
+
+// Take over the NDI objects of the previous run if the digest matches.
+// Returns false if the object has to be created in the NPU.
+bool nas_acl_warm_adopt (nas_acl_warm_obj_t obj_type, nas_switch_id_t switch_id,
+                         nas_obj_id_t table_id, nas_obj_id_t obj_id,
+                         npu_id_t npu_id, uint64_t cfg_hash,
+                         std::vector<ndi_obj_id_t>& ndi_ids) noexcept;
+
+// Checkpoint the NDI objects of a saved object - replacing earlier records
+void nas_acl_warm_save (const nas_acl_table& table) noexcept;
+void nas_acl_warm_save (const nas_acl_counter_t& counter) noexcept;
+void nas_acl_warm_save (const nas_acl_entry& entry) noexcept;
+void nas_acl_warm_remove (nas_acl_warm_obj_t obj_type, nas_switch_id_t switch_id,
+                          nas_obj_id_t table_id, nas_obj_id_t obj_id) noexcept;
+
+#endif
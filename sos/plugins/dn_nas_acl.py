@@ -31,3 +31,4 @@ class DN_nas_acl(Plugin, DebianPlugin):
         self.add_cmd_output("/opt/dell/os10/bin/cps_get_oid.py base-acl/entry")
         self.add_cmd_output("/opt/dell/os10/bin/cps_get_oid.py base-acl/counter")
         self.add_cmd_output("/opt/dell/os10/bin/cps_get_oid.py base-acl/stats")
+        self.add_cmd_output("/opt/dell/os10/bin/cps_get_oid.py base-acl/perf-stats")
@@ -120,7 +120,7 @@ void nas_acl_action_t::set_ipv4_action_val (const nas_acl_common_data_list_t& da
 {
     // IPv4 value can be considered as an array of bytes - copy from the bytes array
     _a_info.values_type = NDI_ACL_ACTION_IPV4_ADDR;
-    memcpy ((uint8_t*)&_a_info.values.ipv4, data_list.at(0).bytes.data(),
+    memcpy ((uint8_t*)&_a_info.values.ipv4, data_list.at(0).bytes_data (),
             sizeof (_a_info.values.ipv4));
 }
 
@@ -129,10 +129,7 @@ void nas_acl_action_t::get_ipv4_action_val (nas_acl_common_data_list_t& data_lis
     nas_acl_common_data_t data;
 
     // IPv4 value can be considered as an array of bytes - copy this into the bytes array
-    auto& val = _a_info.values.ipv4;
-    auto val_u8 = (uint8_t*) &val;
-
-    data.bytes.insert (data.bytes.begin(), val_u8, val_u8 + sizeof (val));
+    data.set_bytes (&_a_info.values.ipv4, sizeof (_a_info.values.ipv4));
     data_list.push_back (data);
 }
 
@@ -140,7 +137,7 @@ void nas_acl_action_t::set_ipv6_action_val (const nas_acl_common_data_list_t& da
 {
     // IPv6 value can be considered as an array of bytes - copy from the bytes array
     _a_info.values_type = NDI_ACL_ACTION_IPV6_ADDR;
-    memcpy ((uint8_t*)&_a_info.values.ipv6, data_list.at(0).bytes.data(),
+    memcpy ((uint8_t*)&_a_info.values.ipv6, data_list.at(0).bytes_data (),
             sizeof (_a_info.values.ipv6));
 }
 
@@ -149,25 +146,21 @@ void nas_acl_action_t::get_ipv6_action_val (nas_acl_common_data_list_t& data_lis
     nas_acl_common_data_t data;
 
     // IPv6 value can be considered as an array of bytes - copy this into the bytes array
-    auto& val = _a_info.values.ipv6;
-    auto val_u8 = (uint8_t*) (&val);
-
-    data.bytes.insert (data.bytes.begin(), val_u8, val_u8+sizeof (val));
+    data.set_bytes (&_a_info.values.ipv6, sizeof (_a_info.values.ipv6));
     data_list.push_back (data);
 }
 
 void nas_acl_action_t::set_mac_action_val (const nas_acl_common_data_list_t& data_list)
 {
     _a_info.values_type = NDI_ACL_ACTION_MAC_ADDR;
-    memcpy (_a_info.values.mac, data_list.at(0).bytes.data(), HAL_MAC_ADDR_LEN);
+    memcpy (_a_info.values.mac, data_list.at(0).bytes_data (), HAL_MAC_ADDR_LEN);
 }
 
 void nas_acl_action_t::get_mac_action_val (nas_acl_common_data_list_t& data_list) const
 {
     nas_acl_common_data_t data;
-    const uint8_t* val = _a_info.values.mac;
 
-    data.bytes.insert (data.bytes.begin(), val, val+HAL_MAC_ADDR_LEN);
+    data.set_bytes (_a_info.values.mac, HAL_MAC_ADDR_LEN);
     data_list.push_back (data);
 }
 
@@ -179,7 +172,7 @@ void nas_acl_action_t::_set_opaque_data (const nas_acl_common_data_list_t& data_
     for (uint_t iter_obj=0; iter_obj<num_objs; iter_obj++) {
         auto elem_num = iter_obj * elem_per_obj;
         _nas2ndi_oid_tbl [data_list.at(elem_num).obj_id] =
-                std::move (data_list.at (elem_num+1).ndi_obj_id_table);
+                data_list.at (elem_num+1).ndi_obj_id_table ();
     }
 }
 
@@ -203,7 +196,7 @@ void nas_acl_action_t::get_opaque_data_action_val (nas_acl_common_data_list_t& d
         data_list.push_back (data0);
 
         nas_acl_common_data_t data1;
-        data1.ndi_obj_id_table = nas2ndi_oid_pair.second;
+        data1.ndi_obj_id_table () = nas2ndi_oid_pair.second;
         data_list.push_back (data1);
     }
 }
@@ -249,8 +242,8 @@ void nas_acl_action_t::set_action_ifindex_list (const nas_acl_common_data_list_t
 {
     _a_info.values_type  = NDI_ACL_ACTION_PORTLIST;
 
-    for (auto match_data: val_list) {
-        for (auto port: match_data.ifindex_list) {
+    for (const auto& match_data: val_list) {
+        for (auto port: match_data.ifindex_list ()) {
             if (nas_acl_utl_is_ifidx_type_lag(port)) {
                 NAS_ACL_LOG_ERR("LAG port %d is not allowed to be added to port list", port);
                 continue;
@@ -267,7 +260,7 @@ void nas_acl_action_t::get_action_ifindex_list (nas_acl_common_data_list_t& val_
     if (_ifindex_list.size () != 0) {
 
         for (auto ifindex: _ifindex_list) {
-            if_list_data.ifindex_list.push_back (ifindex);
+            if_list_data.ifindex_list ().push_back (ifindex);
         }
 
         val_list.push_back (if_list_data);
@@ -338,6 +331,32 @@ bool nas_acl_action_t::_ndi_copy_obj_id_list (ndi_acl_entry_action_t& ndi_action
     return found;
 }
 
+bool nas_acl_action_t::is_npu_specific () const noexcept
+{
+    return (_a_info.values_type == NDI_ACL_ACTION_PORT ||
+            _a_info.values_type == NDI_ACL_ACTION_PORTLIST);
+}
+
+nas::npu_set_t nas_acl_action_t::get_npu_list () const
+{
+    nas::npu_set_t  action_npu_list;
+
+    if (_a_info.values_type == NDI_ACL_ACTION_PORT) {
+        action_npu_list.add (_a_info.values.ndi_port.npu_id);
+    }
+
+    if (_a_info.values_type == NDI_ACL_ACTION_PORTLIST) {
+        for (auto ifindex: _ifindex_list) {
+            // Convert to NPU and port
+            interface_ctrl_t  intf_ctrl {};
+            nas_acl_utl_ifidx_to_ndi_port (ifindex, &intf_ctrl);
+            action_npu_list.add (intf_ctrl.npu_id);
+        }
+    }
+
+    return action_npu_list;
+}
+
 bool nas_acl_action_t::copy_action_ndi (ndi_acl_action_list_t& ndi_alist,
                                         npu_id_t npu_id,
                                         nas::mem_alloc_helper_t& mem_trakr) const
@@ -448,6 +467,39 @@ bool nas_acl_action_t::operator!= (const nas_acl_action_t& rhs) const
     return false;
 }
 
+uint64_t nas_acl_action_t::cfg_hash () const noexcept
+{
+    uint64_t hash = nas_acl_hash_val (NAS_ACL_HASH_INIT, action_type ());
+    uint64_t tbl_hash = 0;
+
+    switch (_a_info.values_type)
+    {
+        case NDI_ACL_ACTION_PORT:
+            return nas_acl_hash_bytes (hash, _ifindex_list.data (),
+                                       _ifindex_list.size () * sizeof (_ifindex_list[0]));
+
+        case NDI_ACL_ACTION_OBJ_ID:
+            hash = nas_acl_hash_val (hash, _nas_oid);
+            /* Intentional Fall through */
+        case NDI_ACL_ACTION_OBJ_ID_LIST:
+            // Unordered map - combine the digest of each mapping
+            for (const auto& oid_kv: _nas2ndi_oid_tbl) {
+                uint64_t oid_hash = nas_acl_hash_val (NAS_ACL_HASH_INIT, oid_kv.first);
+                for (const auto& ndi_kv: oid_kv.second) {
+                    tbl_hash += nas_acl_hash_val (nas_acl_hash_val (oid_hash, ndi_kv.first),
+                                                  ndi_kv.second);
+                }
+            }
+            return nas_acl_hash_val (hash, tbl_hash);
+
+        case NDI_ACL_ACTION_NO_VALUE:
+            return hash;
+
+        default:
+            return nas_acl_hash_val (hash, _a_info);
+    }
+}
+
 static const char* _get_pkt_action_name (BASE_ACL_PACKET_ACTION_TYPE_t  type) noexcept
 {
     auto it = _pkt_action_name_map.find (type);
@@ -0,0 +1,585 @@
+
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+/*!
+ * \file   nas_acl_apply.cpp
+ * \brief  NAS ACL declarative apply - reconcile a Table to its desired Entries
+ */
+#include "dell-base-acl.h"
+#include "event_log.h"
+#include "std_error_codes.h"
+#include "nas_acl_log.h"
+#include "nas_acl_apply.h"
+#include "nas_acl_cps.h"
+#include "nas_acl_cps_key.h"
+#include "nas_acl_switch_list.h"
+#include "nas_acl_utl.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_event.h"
+#include "nas_base_utils.h"
+#include "cps_api_object_key.h"
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+static t_std_error
+nas_acl_apply_set (cps_api_object_t obj,
+                   cps_api_object_t prev,
+                   bool             is_rollbk_op) noexcept;
+
+static nas_acl_write_operation_map_t nas_acl_apply_op_map [] = {
+    {cps_api_oper_SET, nas_acl_apply_set},
+};
+
+// Desired Entry and the Table Entry it is paired with
+struct _apply_want_t {
+    nas_acl_entry  entry;
+    bool           has_eid;
+    bool           paired;
+    nas_obj_id_t   live_id;
+};
+
+// Change already applied - undone if a later change fails
+struct _apply_undo_t {
+    cps_api_operation_types_t       op;
+    nas_obj_id_t                    entry_id;
+    // Entry before a Modify or Delete
+    std::unique_ptr<nas_acl_entry>  old_entry_p;
+};
+
+nas_acl_write_operation_map_t *
+nas_acl_get_apply_op_map (cps_api_operation_types_t op) noexcept
+{
+    uint32_t                  index;
+    uint32_t                  count;
+
+    count = sizeof (nas_acl_apply_op_map) / sizeof (nas_acl_apply_op_map [0]);
+
+    for (index = 0; index < count; index++) {
+        if (nas_acl_apply_op_map [index].op == op) {
+            return (&nas_acl_apply_op_map [index]);
+        }
+    }
+    return NULL;
+}
+
+static bool _npus_equal (const nas::npu_set_t& lhs, const nas::npu_set_t& rhs) noexcept
+{
+    if (lhs.size () != rhs.size ()) {
+        return false;
+    }
+    for (auto npu_id: lhs) {
+        if (!rhs.contains (npu_id)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Filter or Action lists of two Entries hold the same values
+template <typename L>
+static bool _list_equal (const L& lhs, const L& rhs)
+{
+    if (lhs.size () != rhs.size ()) {
+        return false;
+    }
+    for (const auto& kv: lhs) {
+        auto it = rhs.find (kv.first);
+        if (it == rhs.end () || kv.second != it->second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool _is_unchanged (const nas_acl_entry& want, const nas_acl_entry& live)
+{
+    if (want.priority () != live.priority () ||
+        want.following_table_npus () != live.following_table_npus ()) {
+        return false;
+    }
+    if (!want.following_table_npus () &&
+        !_npus_equal (want.nas::base_obj_t::npu_list (),
+                      live.nas::base_obj_t::npu_list ())) {
+        return false;
+    }
+    return (_list_equal (want.get_filter_list (), live.get_filter_list ()) &&
+            _list_equal (want.get_action_list (), live.get_action_list ()));
+}
+
+// Digest of the content compared by _is_unchanged - used to pair
+// desired Entries without ID
+static uint64_t _content_hash (const nas_acl_entry& entry) noexcept
+{
+    uint64_t hash = nas_acl_hash_val (NAS_ACL_HASH_INIT, entry.priority ());
+    uint64_t flist_hash = 0;
+    uint64_t alist_hash = 0;
+
+    // Unordered lists - combine the digest of each element
+    for (const auto& f_kv: entry.get_filter_list ()) {
+        flist_hash += f_kv.second.cfg_hash ();
+    }
+    for (const auto& a_kv: entry.get_action_list ()) {
+        alist_hash += a_kv.second.cfg_hash ();
+    }
+    return nas_acl_hash_val (nas_acl_hash_val (hash, flist_hash), alist_hash);
+}
+
+// Copy the content of want that differs into entry - only those
+// attributes are marked dirty and pushed to NDI by the commit
+static void _apply_content (nas_acl_entry& entry, const nas_acl_entry& want)
+{
+    if (want.priority () != entry.priority ()) {
+        entry.set_priority (want.priority ());
+    }
+
+    if (!_list_equal (want.get_filter_list (), entry.get_filter_list ())) {
+        entry.reset_filter ();
+        for (const auto& f_kv: want.get_filter_list ()) {
+            nas_acl_filter_t filter (f_kv.second);
+            entry.add_filter (filter, false);
+        }
+    }
+
+    if (!_list_equal (want.get_action_list (), entry.get_action_list ())) {
+        entry.reset_action ();
+        for (const auto& a_kv: want.get_action_list ()) {
+            nas_acl_action_t action (a_kv.second);
+            entry.add_action (action, false);
+        }
+    }
+
+    if (!want.following_table_npus () &&
+        (entry.following_table_npus () ||
+         !_npus_equal (want.nas::base_obj_t::npu_list (),
+                       entry.nas::base_obj_t::npu_list ()))) {
+        bool reset = true;
+        for (auto npu_id: want.nas::base_obj_t::npu_list ()) {
+            entry.add_npu (npu_id, reset);
+            reset = false;
+        }
+    }
+}
+
+// Entry ID 0 allocates a new ID
+static nas_obj_id_t _apply_create (nas_acl_switch&      sw,
+                                   const nas_acl_table& table,
+                                   nas_obj_id_t         entry_id,
+                                   const nas_acl_entry& want,
+                                   bool                 rolling_back)
+{
+    nas_acl_entry new_entry (&table);
+    _apply_content (new_entry, want);
+
+    nas_acl_id_guard_t  idg (sw, BASE_ACL_ENTRY_OBJ, table.table_id ());
+    if (entry_id != 0) {
+        if (!idg.reserve_guarded_id (entry_id)) {
+            throw nas::base_exception {NAS_ACL_E_KEY_VAL, __PRETTY_FUNCTION__,
+                                       std::string {"Entry ID already taken "} +
+                                       std::to_string (entry_id)};
+        }
+    } else {
+        entry_id = idg.alloc_guarded_id ();
+    }
+    new_entry.set_entry_id (entry_id);
+
+    new_entry.commit_create (rolling_back);
+
+    // WARNING !!! CANNOT throw error or exception beyond this point
+    // since entry is already committed to SAI
+    sw.save_entry (std::move (new_entry));
+    idg.unguard ();
+
+    return entry_id;
+}
+
+static void _apply_modify (nas_acl_switch&      sw,
+                           nas_obj_id_t         table_id,
+                           nas_obj_id_t         entry_id,
+                           const nas_acl_entry& want,
+                           bool                 rolling_back)
+{
+    nas_acl_entry& old_entry = sw.get_entry (table_id, entry_id);
+    nas_acl_entry  new_entry (old_entry);
+
+    _apply_content (new_entry, want);
+    new_entry.commit_modify (old_entry, rolling_back);
+
+    // WARNING !!! CANNOT throw error or exception beyond this point
+    // since entry is already committed to SAI
+    sw.save_entry (std::move (new_entry));
+}
+
+// Returns a copy of the deleted Entry
+static std::unique_ptr<nas_acl_entry> _apply_delete (nas_acl_switch& sw,
+                                                     nas_obj_id_t    table_id,
+                                                     nas_obj_id_t    entry_id,
+                                                     bool            rolling_back)
+{
+    nas_acl_entry& entry = sw.get_entry (table_id, entry_id);
+    std::unique_ptr<nas_acl_entry> old_entry_p {new nas_acl_entry (entry)};
+
+    entry.commit_delete (rolling_back);
+
+    // WARNING !!! CANNOT throw error or exception beyond this point
+    // since entry is already deleted in SAI
+    sw.remove_entry_from_table (table_id, entry_id);
+
+    return old_entry_p;
+}
+
+static void _apply_undo (nas_acl_switch&              sw,
+                         nas_obj_id_t                 table_id,
+                         std::vector<_apply_undo_t>&  undo_list) noexcept
+{
+    for (auto it = undo_list.rbegin (); it != undo_list.rend (); ++it) {
+
+        NAS_ACL_LOG_BRIEF ("** ROLLBACK **: Op %d, Table Id: %ld, Entry Id: %ld",
+                           it->op, table_id, it->entry_id);
+        try {
+            switch (it->op) {
+                case cps_api_oper_CREATE:
+                    _apply_delete (sw, table_id, it->entry_id, true);
+                    break;
+
+                case cps_api_oper_SET:
+                    _apply_modify (sw, table_id, it->entry_id, *it->old_entry_p, true);
+                    break;
+
+                case cps_api_oper_DELETE:
+                    _apply_create (sw, sw.get_table (table_id), it->entry_id,
+                                   *it->old_entry_p, true);
+                    break;
+
+                default:
+                    break;
+            }
+        } catch (nas::base_exception& e) {
+            NAS_ACL_LOG_ERR ("Undo of Entry %ld failed - Err_code: 0x%x, fn: %s (), %s",
+                             it->entry_id, e.err_code, e.err_fn.c_str (),
+                             e.err_msg.c_str ());
+        } catch (std::out_of_range& e) {
+            NAS_ACL_LOG_ERR ("Undo of Entry %ld failed - Out of Range exception %s",
+                             it->entry_id, e.what ());
+        }
+    }
+    undo_list.clear ();
+}
+
+// Previous Entries of the Table, for the rollback of an Apply
+static void _apply_save_prev (cps_api_object_t                    prev,
+                              nas_obj_id_t                        table_id,
+                              const nas_acl_switch::entry_list_t& live_list)
+{
+    if (!nas_acl_cps_key_set_obj_id (prev, BASE_ACL_APPLY_TABLE_ID, table_id)) {
+        throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                   "Failed to set Table ID in Key"};
+    }
+
+    for (const auto& live_kv: live_list) {
+
+        cps_api_object_guard og (cps_api_object_create ());
+
+        if (!og.valid () || !nas_acl_fill_entry_obj (og.get (), live_kv.second) ||
+            !cps_api_object_attr_add (prev, BASE_ACL_APPLY_ENTRY,
+                                      cps_api_object_array (og.get ()),
+                                      cps_api_object_to_array_len (og.get ()))) {
+            throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                       std::string {"Failed to save Entry "} +
+                                       std::to_string (live_kv.first)};
+        }
+    }
+}
+
+t_std_error nas_acl_table_apply (nas_acl_switch&        sw,
+                                 nas_obj_id_t           table_id,
+                                 cps_api_object_list_t  desired,
+                                 bool                   rolling_back,
+                                 nas_acl_apply_stats_t* stats,
+                                 cps_api_object_t       prev) noexcept
+{
+    nas_acl_apply_stats_t       counts {};
+    std::vector<_apply_undo_t>  undo_list;
+
+    try {
+        nas_acl_perf_phase_timer_t perf (NAS_ACL_PERF_PHASE_PARSE);
+        const nas_acl_table& table = sw.get_table (table_id);
+        const auto&          live_list = sw.entry_list (table_id);
+        size_t               count = cps_api_object_list_size (desired);
+
+        NAS_ACL_LOG_BRIEF ("%sSwitch Id: %d, Table Id: %ld, Desired Entries: %ld",
+                           (rolling_back) ? "** ROLLBACK **: " : "",
+                           sw.id (), table_id, count);
+
+        std::vector<_apply_want_t>        want_list;
+        std::unordered_set<nas_obj_id_t>  want_ids;
+        std::unordered_set<nas_obj_id_t>  paired_ids;
+
+        want_list.reserve (count);
+
+        // Parse the desired Entries - those with an ID pair up by ID
+        for (size_t idx = 0; idx < count; idx++) {
+
+            cps_api_object_t obj = cps_api_object_list_get (desired, idx);
+            nas_obj_id_t     id;
+
+            if (nas_acl_cps_key_get_obj_id (obj, BASE_ACL_ENTRY_TABLE_ID, &id) &&
+                id != table_id) {
+                throw nas::base_exception {NAS_ACL_E_INCONSISTENT, __PRETTY_FUNCTION__,
+                                           std::string {"Desired Entry in Table "} +
+                                           std::to_string (id)};
+            }
+
+            want_list.push_back ({nas_acl_entry (&table), false, false, 0});
+            auto& want = want_list.back ();
+            nas_acl_parse_entry_obj (obj, want.entry);
+
+            if (!nas_acl_cps_key_get_obj_id (obj, BASE_ACL_ENTRY_ID, &id)) {
+                continue;
+            }
+            if (!want_ids.insert (id).second) {
+                throw nas::base_exception {NAS_ACL_E_DUPLICATE, __PRETTY_FUNCTION__,
+                                           std::string {"Duplicate desired Entry ID "} +
+                                           std::to_string (id)};
+            }
+            want.entry.set_entry_id (id);
+            want.has_eid = true;
+
+            if (live_list.find (id) != live_list.end ()) {
+                want.paired = true;
+                want.live_id = id;
+                paired_ids.insert (id);
+            }
+        }
+
+        // Entries without ID pair up with an unpaired Entry of the same
+        // content, or else of the same priority
+        std::unordered_multimap<uint64_t, nas_obj_id_t> unpaired;
+
+        for (const auto& live_kv: live_list) {
+            if (paired_ids.count (live_kv.first) == 0) {
+                unpaired.emplace (_content_hash (live_kv.second), live_kv.first);
+            }
+        }
+        for (auto& want: want_list) {
+            if (want.has_eid) continue;
+
+            auto range = unpaired.equal_range (_content_hash (want.entry));
+            for (auto it = range.first; it != range.second; ++it) {
+                if (_is_unchanged (want.entry, live_list.at (it->second))) {
+                    want.paired = true;
+                    want.live_id = it->second;
+                    paired_ids.insert (it->second);
+                    unpaired.erase (it);
+                    break;
+                }
+            }
+        }
+
+        std::unordered_multimap<ndi_acl_priority_t, nas_obj_id_t> unpaired_prio;
+
+        for (const auto& kv: unpaired) {
+            unpaired_prio.emplace (live_list.at (kv.second).priority (), kv.second);
+        }
+        for (auto& want: want_list) {
+            if (want.has_eid || want.paired) continue;
+
+            auto it = unpaired_prio.find (want.entry.priority ());
+            if (it != unpaired_prio.end ()) {
+                want.paired = true;
+                want.live_id = it->second;
+                paired_ids.insert (it->second);
+                unpaired_prio.erase (it);
+            }
+        }
+
+        // Changes needed to reach the desired Entries
+        std::vector<nas_obj_id_t>    del_list;
+        std::vector<_apply_want_t*>  mod_list;
+        std::vector<_apply_want_t*>  create_list;
+        size_t                       replaced = 0;
+
+        for (const auto& live_kv: live_list) {
+            if (paired_ids.count (live_kv.first) == 0) {
+                del_list.push_back (live_kv.first);
+            }
+        }
+        for (auto& want: want_list) {
+            if (!want.paired) {
+                create_list.push_back (&want);
+                continue;
+            }
+
+            const nas_acl_entry& live = live_list.at (want.live_id);
+
+            if (_is_unchanged (want.entry, live)) {
+                counts.unchanged++;
+                continue;
+            }
+            if (want.entry.following_table_npus () != live.following_table_npus ()) {
+                // The NPU list of an Entry cannot go back to following
+                // the Table - replace the Entry under the same ID
+                del_list.push_back (want.live_id);
+                want.entry.set_entry_id (want.live_id);
+                want.has_eid = true;
+                create_list.push_back (&want);
+                replaced++;
+                continue;
+            }
+            mod_list.push_back (&want);
+        }
+
+        // Creates with an ID first so that an allocated ID cannot take it
+        std::stable_partition (create_list.begin (), create_list.end (),
+                               [] (const _apply_want_t* want_p) {
+                                   return want_p->has_eid;
+                               });
+
+        if (prev != NULL &&
+            !(del_list.empty () && mod_list.empty () && create_list.empty ())) {
+            _apply_save_prev (prev, table_id, live_list);
+        }
+
+        perf.next (NAS_ACL_PERF_PHASE_COMMIT);
+        undo_list.reserve (del_list.size () + mod_list.size () + create_list.size ());
+
+        for (auto entry_id: del_list) {
+            auto old_entry_p = _apply_delete (sw, table_id, entry_id, rolling_back);
+            undo_list.push_back ({cps_api_oper_DELETE, entry_id, std::move (old_entry_p)});
+        }
+
+        for (auto want_p: mod_list) {
+            std::unique_ptr<nas_acl_entry> old_entry_p {
+                new nas_acl_entry (sw.get_entry (table_id, want_p->live_id))};
+
+            _apply_modify (sw, table_id, want_p->live_id, want_p->entry, rolling_back);
+            undo_list.push_back ({cps_api_oper_SET, want_p->live_id,
+                                  std::move (old_entry_p)});
+        }
+
+        for (auto want_p: create_list) {
+            auto entry_id = _apply_create (sw, table,
+                                           (want_p->has_eid) ? want_p->entry.entry_id () : 0,
+                                           want_p->entry, rolling_back);
+            undo_list.push_back ({cps_api_oper_CREATE, entry_id, nullptr});
+        }
+        perf.stop ();
+
+        // A replaced Entry - Delete and Create of the same ID - is a Set
+        for (const auto& undo: undo_list) {
+            nas_acl_event_note (BASE_ACL_ENTRY_OBJ, undo.op, table_id, undo.entry_id);
+        }
+
+        counts.created  = create_list.size () - replaced;
+        counts.deleted  = del_list.size () - replaced;
+        counts.modified = mod_list.size () + replaced;
+
+        NAS_ACL_LOG_BRIEF ("Apply successful. Table Id: %ld, Created: %ld, Modified: %ld, "
+                           "Deleted: %ld, Unchanged: %ld", table_id, counts.created,
+                           counts.modified, counts.deleted, counts.unchanged);
+
+    } catch (nas::base_exception& e) {
+
+        NAS_ACL_LOG_ERR ("Err_code: 0x%x, fn: %s (), %s", e.err_code,
+                         e.err_fn.c_str (), e.err_msg.c_str ());
+        _apply_undo (sw, table_id, undo_list);
+        return e.err_code;
+
+    } catch (std::out_of_range& e) {
+        NAS_ACL_LOG_ERR ("###########  Out of Range exception %s", e.what ());
+        _apply_undo (sw, table_id, undo_list);
+        return NAS_ACL_E_FAIL;
+    }
+
+    if (stats != NULL) {
+        *stats = counts;
+    }
+    return NAS_ACL_E_NONE;
+}
+
+static t_std_error nas_acl_apply_set (cps_api_object_t obj,
+                                      cps_api_object_t prev,
+                                      bool             is_rollbk_op) noexcept
+{
+    nas_switch_id_t switch_id;
+    nas_obj_id_t    table_id;
+
+    nas_acl_cps_key_get_switch_id (obj, NAS_ACL_SWITCH_ATTR, &switch_id);
+
+    if (prev != NULL) {
+        cps_api_object_set_key (prev, cps_api_object_key (obj));
+    }
+
+    if (!nas_acl_cps_key_get_obj_id (obj, BASE_ACL_APPLY_TABLE_ID, &table_id)) {
+        if (is_rollbk_op) {
+            // The Apply being rolled back did not change the Table
+            return NAS_ACL_E_NONE;
+        }
+        NAS_ACL_LOG_ERR ("Table ID is a mandatory key for Apply");
+        return NAS_ACL_E_MISSING_KEY;
+    }
+
+    // Desired Entries are serialized Entry objects
+    cps_api_object_list_guard lg (cps_api_object_list_create ());
+    if (lg.get () == NULL) {
+        return NAS_ACL_E_MEM;
+    }
+
+    cps_api_object_it_t it;
+    for (cps_api_object_it_begin (obj, &it);
+         cps_api_object_it_valid (&it); cps_api_object_it_next (&it)) {
+
+        if (cps_api_object_attr_id (it.attr) != BASE_ACL_APPLY_ENTRY) {
+            continue;
+        }
+
+        cps_api_object_t entry_obj = cps_api_object_list_create_obj_and_append (lg.get ());
+        if (entry_obj == NULL) {
+            return NAS_ACL_E_MEM;
+        }
+        if (!cps_api_array_to_object (cps_api_object_attr_data_bin (it.attr),
+                                      cps_api_object_attr_len (it.attr), entry_obj)) {
+            NAS_ACL_LOG_ERR ("Bad Entry object in Apply of Table %ld", table_id);
+            return NAS_ACL_E_ATTR_VAL;
+        }
+    }
+
+    nas_acl_apply_stats_t stats {};
+    t_std_error           rc;
+
+    try {
+        rc = nas_acl_table_apply (nas_acl_get_switch (switch_id), table_id,
+                                  lg.get (), is_rollbk_op, &stats, prev);
+    } catch (nas::base_exception& e) {
+        NAS_ACL_LOG_ERR ("Err_code: 0x%x, fn: %s (), %s", e.err_code,
+                         e.err_fn.c_str (), e.err_msg.c_str ());
+        return e.err_code;
+    }
+
+    if (rc != NAS_ACL_E_NONE) {
+        return rc;
+    }
+
+    // Counts of the changes are returned in the object
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_APPLY_CREATED, stats.created);
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_APPLY_MODIFIED, stats.modified);
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_APPLY_DELETED, stats.deleted);
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_APPLY_UNCHANGED, stats.unchanged);
+
+    return NAS_ACL_E_NONE;
+}
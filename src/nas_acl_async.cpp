@@ -0,0 +1,283 @@
+
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+/*!
+ * \file   nas_acl_async.cpp
+ * \brief  NAS ACL asynchronous Entry programming
+ */
+#include "dell-base-acl.h"
+#include "event_log.h"
+#include "std_error_codes.h"
+#include "nas_acl_log.h"
+#include "nas_acl_async.h"
+#include "nas_acl_cps.h"
+#include "nas_acl_event.h"
+#include "nas_acl_perf.h"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct _async_job_t {
+    cps_api_object_t                     obj;
+    cps_api_operation_types_t            op;
+    bool                                 rollback;
+    nas_switch_id_t                      switch_id;
+    nas_obj_id_t                         table_id;
+    nas_obj_id_t                         entry_id;
+    std::unique_ptr<nas_acl_id_guard_t>  idg;
+} _async_job_t;
+
+typedef struct _async_entry_t {
+    size_t       pending;
+    t_std_error  err;
+} _async_entry_t;
+
+// Entries with the same IDs on different switches are tracked apart
+typedef std::tuple<nas_switch_id_t, nas_obj_id_t, nas_obj_id_t> _async_key_t;
+
+// Never destroyed - the detached worker thread waits on them until exit
+static std::mutex&               _async_mutex = *(new std::mutex);
+static std::condition_variable&  _async_cv = *(new std::condition_variable);
+static std::condition_variable&  _async_done_cv = *(new std::condition_variable);
+
+static bool                                   _async_enabled = false;
+static bool                                   _async_started = false;
+static bool                                   _async_busy = false;
+static std::deque<_async_job_t>               _async_queue;
+static std::map<_async_key_t, _async_entry_t> _async_entries;
+static size_t                                 _async_failed = 0;
+
+// Called with the async mutex held
+static void _async_done (const _async_job_t& job, t_std_error rc) noexcept
+{
+    auto it = _async_entries.find (_async_key_t {job.switch_id, job.table_id,
+                                                      job.entry_id});
+
+    if (it == _async_entries.end ()) {
+        return;
+    }
+
+    auto& rec = it->second;
+    rec.pending--;
+
+    if (rc != NAS_ACL_E_NONE) {
+        if (rec.err == NAS_ACL_E_NONE) {
+            _async_failed++;
+        }
+        rec.err = rc;
+    }
+
+    if (rec.pending == 0 &&
+        (rec.err == NAS_ACL_E_NONE || _async_failed > NAS_ACL_ASYNC_MAX_FAILED)) {
+        if (rec.err != NAS_ACL_E_NONE) {
+            NAS_ACL_LOG_ERR ("Too many failed Entries - status of Switch Id %d, "
+                             "Table Id %ld, Entry Id %ld dropped", job.switch_id,
+                             job.table_id, job.entry_id);
+            _async_failed--;
+        }
+        _async_entries.erase (it);
+    }
+}
+
+static t_std_error _async_run (_async_job_t& job) noexcept
+{
+    auto op_map = nas_acl_get_entry_operation_map (job.op);
+
+    if (op_map == NULL) {
+        return NAS_ACL_E_UNSUPPORTED;
+    }
+
+    nas_acl_perf_req_t perf (NAS_ACL_PERF_OBJ_ENTRY,
+                             (job.op == cps_api_oper_CREATE) ? NAS_ACL_PERF_OP_CREATE :
+                             (job.op == cps_api_oper_DELETE) ? NAS_ACL_PERF_OP_DELETE :
+                             NAS_ACL_PERF_OP_SET);
+    nas_acl_lock_scope_t scope (NAS_ACL_LOCK_TABLE, job.switch_id, job.table_id);
+    scope.lock ();
+    perf.lock_acquired ();
+
+    // Free the ID reserved for the Entry so that Create can take it
+    job.idg.reset ();
+    // State before the write was saved when it was validated - nothing
+    // rolls back the worker's write, so it has no prev
+    auto rc = op_map->fn (job.obj, NULL, job.rollback);
+
+    perf.end ();
+    scope.unlock ();
+
+    if (rc != NAS_ACL_E_NONE) {
+        NAS_ACL_LOG_ERR ("%sOp %d failed for Switch Id: %d, Table Id: %ld, "
+                         "Entry Id: %ld, Err 0x%x",
+                         (job.rollback) ? "** ROLLBACK **: " : "", job.op,
+                         job.switch_id, job.table_id, job.entry_id, rc);
+        nas_acl_event_note_failure (BASE_ACL_ENTRY_OBJ, job.op, job.table_id,
+                                    job.entry_id, rc);
+    }
+
+    return rc;
+}
+
+static void _async_worker_main () noexcept
+{
+    std::unique_lock<std::mutex> lock (_async_mutex);
+
+    while (true) {
+        _async_cv.wait (lock, [] {return !_async_queue.empty ();});
+
+        auto job = std::move (_async_queue.front ());
+        _async_queue.pop_front ();
+        _async_busy = true;
+
+        lock.unlock ();
+        auto rc = _async_run (job);
+        cps_api_object_delete (job.obj);
+        lock.lock ();
+
+        _async_done (job, rc);
+        _async_busy = false;
+        _async_done_cv.notify_all ();
+    }
+}
+
+void nas_acl_async_init () noexcept
+{
+    const char* async_str = getenv (NAS_ACL_ASYNC_ENV);
+
+    if (async_str != NULL && strcmp (async_str, "1") == 0) {
+        nas_acl_async_enable (true);
+    }
+}
+
+bool nas_acl_async_enable (bool enable) noexcept
+{
+    if (!enable) {
+        {
+            std::lock_guard<std::mutex> lock (_async_mutex);
+            _async_enabled = false;
+        }
+        nas_acl_async_drain ();
+
+        NAS_ACL_LOG_BRIEF ("Async Entry programming disabled");
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock (_async_mutex);
+
+    if (!_async_started) {
+        try {
+            std::thread worker (_async_worker_main);
+            worker.detach ();
+
+        } catch (std::exception& e) {
+            NAS_ACL_LOG_ERR ("Failed to start async Entry worker: %s", e.what ());
+            return false;
+        }
+        _async_started = true;
+    }
+
+    _async_enabled = true;
+
+    NAS_ACL_LOG_BRIEF ("Async Entry programming enabled");
+    return true;
+}
+
+bool nas_acl_async_is_enabled () noexcept
+{
+    std::lock_guard<std::mutex> lock (_async_mutex);
+
+    return _async_enabled;
+}
+
+bool nas_acl_async_queue (cps_api_object_t                     obj,
+                          cps_api_operation_types_t            op,
+                          bool                                 rollback,
+                          nas_switch_id_t                      switch_id,
+                          nas_obj_id_t                         table_id,
+                          nas_obj_id_t                         entry_id,
+                          std::unique_ptr<nas_acl_id_guard_t>  idg) noexcept
+{
+    std::lock_guard<std::mutex> lock (_async_mutex);
+
+    try {
+        _async_queue.push_back (_async_job_t {obj, op, rollback, switch_id,
+                                              table_id, entry_id, std::move (idg)});
+    } catch (std::exception& e) {
+        NAS_ACL_LOG_ERR ("Failed to queue Entry write: %s", e.what ());
+        return false;
+    }
+
+    try {
+        auto& rec = _async_entries [_async_key_t {switch_id, table_id, entry_id}];
+
+        if (rec.err != NAS_ACL_E_NONE) {
+            _async_failed--;
+        }
+        rec.pending++;
+        rec.err = NAS_ACL_E_NONE;
+
+    } catch (std::exception& e) {
+        // Entry runs without a status - nothing waits for it
+        NAS_ACL_LOG_ERR ("Failed to track Entry write: %s", e.what ());
+    }
+
+    _async_cv.notify_one ();
+    return true;
+}
+
+void nas_acl_async_wait_entry (nas_switch_id_t switch_id, nas_obj_id_t table_id,
+                               nas_obj_id_t entry_id) noexcept
+{
+    std::unique_lock<std::mutex> lock (_async_mutex);
+    _async_key_t key {switch_id, table_id, entry_id};
+
+    _async_done_cv.wait (lock, [&key] {
+        auto it = _async_entries.find (key);
+        return (it == _async_entries.end () || it->second.pending == 0);
+    });
+}
+
+void nas_acl_async_drain () noexcept
+{
+    std::unique_lock<std::mutex> lock (_async_mutex);
+
+    _async_done_cv.wait (lock, [] {return (_async_queue.empty () && !_async_busy);});
+}
+
+nas_acl_async_status_t nas_acl_async_entry_status (nas_switch_id_t switch_id,
+                                                   nas_obj_id_t    table_id,
+                                                   nas_obj_id_t    entry_id,
+                                                   t_std_error*    err_p) noexcept
+{
+    std::lock_guard<std::mutex> lock (_async_mutex);
+
+    auto it = _async_entries.find (_async_key_t {switch_id, table_id, entry_id});
+
+    if (err_p != NULL) {
+        *err_p = (it != _async_entries.end ()) ? it->second.err : NAS_ACL_E_NONE;
+    }
+
+    if (it == _async_entries.end ()) {
+        return NAS_ACL_ASYNC_STATUS_OK;
+    }
+    return ((it->second.pending > 0) ? NAS_ACL_ASYNC_STATUS_PENDING :
+            (it->second.err != NAS_ACL_E_NONE) ? NAS_ACL_ASYNC_STATUS_FAILED :
+            NAS_ACL_ASYNC_STATUS_OK);
+}
@@ -0,0 +1,900 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_cfg_load.cpp
+ * \brief  NAS ACL boot time loader for the default ACL configuration
+ */
+
+#include "dell-base-acl.h"
+#include "nas_acl_cfg_load.h"
+#include "nas_acl_cps.h"
+#include "nas_acl_cps_key.h"
+#include "nas_acl_log.h"
+#include "nas_base_utils.h"
+#include "cps_api_object_key.h"
+#include "cps_class_map.h"
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/*
+ * Element tree of an XML file - only what the configuration files use:
+ * elements, attributes, text, comments and the XML declaration.
+ */
+typedef struct _cfg_xml_node_t {
+    std::string                                      tag;
+    std::vector<std::pair<std::string, std::string>> attrs;
+    std::string                                      text;
+    std::vector<_cfg_xml_node_t>                     children;
+    const std::string*                               file;
+    size_t                                           line;
+
+    const char* attr (const char* name) const noexcept
+    {
+        for (const auto& a: attrs) {
+            if (a.first == name) return a.second.c_str ();
+        }
+        return NULL;
+    }
+} _cfg_xml_node_t;
+
+class _cfg_xml_parser_t
+{
+    public:
+        _cfg_xml_parser_t (const std::string& file, const std::string& buf)
+            : _file (file), _p (buf.c_str ()), _end (buf.c_str () + buf.size ()) {}
+
+        void parse (_cfg_xml_node_t& root)
+        {
+            _skip_misc ();
+            _parse_element (root);
+            _skip_misc ();
+            if (_p != _end) {
+                _error ("Content after the root element");
+            }
+        }
+
+    private:
+        const std::string&  _file;
+        const char*         _p;
+        const char*         _end;
+        size_t              _line = 1;
+
+        [[noreturn]] void _error (const char* msg) const
+        {
+            throw nas::base_exception {NAS_ACL_E_ATTR_VAL, __PRETTY_FUNCTION__,
+                                       _file + ":" + std::to_string (_line) +
+                                       ": " + msg};
+        }
+
+        bool _starts (const char* s) const noexcept
+        {
+            size_t len = strlen (s);
+            return ((size_t) (_end - _p) >= len && strncmp (_p, s, len) == 0);
+        }
+
+        void _advance (size_t len) noexcept
+        {
+            for (; len > 0 && _p != _end; len--, _p++) {
+                if (*_p == '\n') _line++;
+            }
+        }
+
+        void _skip_until (const char* s)
+        {
+            while (_p != _end && !_starts (s)) _advance (1);
+            if (_p == _end) {
+                _error ("Unterminated markup");
+            }
+            _advance (strlen (s));
+        }
+
+        void _skip_space () noexcept
+        {
+            while (_p != _end && isspace ((unsigned char) *_p)) _advance (1);
+        }
+
+        // Whitespace, comments, declaration and DOCTYPE outside of elements
+        void _skip_misc ()
+        {
+            for (;;) {
+                _skip_space ();
+                if (_starts ("<!--")) {
+                    _skip_until ("-->");
+                } else if (_starts ("<?")) {
+                    _skip_until ("?>");
+                } else if (_starts ("<!")) {
+                    _skip_until (">");
+                } else {
+                    return;
+                }
+            }
+        }
+
+        std::string _parse_name ()
+        {
+            const char* start = _p;
+            while (_p != _end && (isalnum ((unsigned char) *_p) ||
+                                  strchr ("_-.:", *_p) != NULL)) {
+                _p++;
+            }
+            if (start == _p) {
+                _error ("Expected a name");
+            }
+            return std::string (start, _p);
+        }
+
+        void _append_text (std::string& out, const char* start, const char* end)
+        {
+            static const struct {const char* ref; char ch;} entities [] = {
+                {"&lt;", '<'}, {"&gt;", '>'}, {"&amp;", '&'},
+                {"&quot;", '"'}, {"&apos;", '\''},
+            };
+
+            while (start != end) {
+                if (*start != '&') {
+                    out.push_back (*start++);
+                    continue;
+                }
+                bool found = false;
+                for (const auto& e: entities) {
+                    size_t len = strlen (e.ref);
+                    if ((size_t) (end - start) >= len &&
+                        strncmp (start, e.ref, len) == 0) {
+                        out.push_back (e.ch);
+                        start += len;
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) {
+                    _error ("Unsupported character reference");
+                }
+            }
+        }
+
+        void _parse_element (_cfg_xml_node_t& node)
+        {
+            if (!_starts ("<")) {
+                _error ("Expected an element");
+            }
+            node.file = &_file;
+            node.line = _line;
+            _advance (1);
+            node.tag = _parse_name ();
+
+            for (;;) {
+                _skip_space ();
+                if (_starts ("/>")) {
+                    _advance (2);
+                    return;
+                }
+                if (_starts (">")) {
+                    _advance (1);
+                    break;
+                }
+                std::string name = _parse_name ();
+                _skip_space ();
+                if (!_starts ("=")) {
+                    _error ("Expected '=' after attribute name");
+                }
+                _advance (1);
+                _skip_space ();
+                if (_p == _end || (*_p != '"' && *_p != '\'')) {
+                    _error ("Expected a quoted attribute value");
+                }
+                char quote = *_p;
+                _advance (1);
+                const char* start = _p;
+                while (_p != _end && *_p != quote) _advance (1);
+                if (_p == _end) {
+                    _error ("Unterminated attribute value");
+                }
+                std::string value;
+                _append_text (value, start, _p);
+                _advance (1);
+                node.attrs.emplace_back (std::move (name), std::move (value));
+            }
+
+            // Content - text, child elements and comments
+            for (;;) {
+                const char* start = _p;
+                while (_p != _end && *_p != '<') _advance (1);
+                _append_text (node.text, start, _p);
+
+                if (_p == _end) {
+                    _error ("Unterminated element");
+                }
+                if (_starts ("<!--")) {
+                    _skip_until ("-->");
+                } else if (_starts ("</")) {
+                    _advance (2);
+                    if (_parse_name () != node.tag) {
+                        _error ("Mismatched end tag");
+                    }
+                    _skip_space ();
+                    if (!_starts (">")) {
+                        _error ("Expected '>'");
+                    }
+                    _advance (1);
+                    break;
+                } else {
+                    node.children.emplace_back ();
+                    _parse_element (node.children.back ());
+                }
+            }
+
+            // Only leaf elements carry a value
+            size_t first = node.text.find_first_not_of (" \t\r\n");
+            if (first == std::string::npos) {
+                node.text.clear ();
+            } else {
+                node.text = node.text.substr (first,
+                        node.text.find_last_not_of (" \t\r\n") - first + 1);
+            }
+        }
+};
+
+static void _cfg_xml_load (const std::string& path, _cfg_xml_node_t& root)
+{
+    FILE* fp = fopen (path.c_str (), "r");
+    if (fp == NULL) {
+        throw nas::base_exception {NAS_ACL_E_FAIL, __PRETTY_FUNCTION__,
+                                   "Failed to open " + path};
+    }
+
+    std::string buf;
+    char        chunk [4096];
+    size_t      len;
+
+    while ((len = fread (chunk, 1, sizeof (chunk), fp)) > 0) {
+        buf.append (chunk, len);
+    }
+    fclose (fp);
+
+    _cfg_xml_parser_t (path, buf).parse (root);
+}
+
+[[noreturn]] static void _cfg_error (const _cfg_xml_node_t& node,
+                                     const std::string& msg)
+{
+    throw nas::base_exception {NAS_ACL_E_ATTR_VAL, __PRETTY_FUNCTION__,
+                               *node.file + ":" + std::to_string (node.line) +
+                               ": <" + node.tag + ">: " + msg};
+}
+
+static const char* _cfg_attr (const _cfg_xml_node_t& node, const char* name)
+{
+    auto val = node.attr (name);
+    if (val == NULL) {
+        _cfg_error (node, std::string ("Missing attribute ") + name);
+    }
+    return val;
+}
+
+/*
+ * Enum names accepted for Match/Action values, by value attribute
+ */
+typedef struct _cfg_enum_t {
+    cps_api_attr_id_t  attr_id;
+    const char*        name;
+    uint32_t           val;
+} _cfg_enum_t;
+
+static const _cfg_enum_t _cfg_enum_map [] =
+{
+    {BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE, "ANY",         BASE_ACL_MATCH_IP_TYPE_ANY},
+    {BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE, "IP",          BASE_ACL_MATCH_IP_TYPE_IP},
+    {BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE, "NON_IP",      BASE_ACL_MATCH_IP_TYPE_NON_IP},
+    {BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE, "IPV4ANY",     BASE_ACL_MATCH_IP_TYPE_IPV4ANY},
+    {BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE, "NON_IPV4",    BASE_ACL_MATCH_IP_TYPE_NON_IPV4},
+    {BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE, "IPV6ANY",     BASE_ACL_MATCH_IP_TYPE_IPV6ANY},
+    {BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE, "NON_IPV6",    BASE_ACL_MATCH_IP_TYPE_NON_IPV6},
+    {BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE, "ARP",         BASE_ACL_MATCH_IP_TYPE_ARP},
+    {BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE, "ARP_REQUEST", BASE_ACL_MATCH_IP_TYPE_ARP_REQUEST},
+    {BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE, "ARP_REPLY",   BASE_ACL_MATCH_IP_TYPE_ARP_REPLY},
+
+    {BASE_ACL_ENTRY_MATCH_IP_FRAG_VALUE, "ANY",              BASE_ACL_MATCH_IP_FRAG_ANY},
+    {BASE_ACL_ENTRY_MATCH_IP_FRAG_VALUE, "NON_FRAG",         BASE_ACL_MATCH_IP_FRAG_NON_FRAG},
+    {BASE_ACL_ENTRY_MATCH_IP_FRAG_VALUE, "NON_FRAG_OR_HEAD", BASE_ACL_MATCH_IP_FRAG_NON_FRAG_OR_HEAD},
+    {BASE_ACL_ENTRY_MATCH_IP_FRAG_VALUE, "HEAD",             BASE_ACL_MATCH_IP_FRAG_HEAD},
+    {BASE_ACL_ENTRY_MATCH_IP_FRAG_VALUE, "NON_HEAD",         BASE_ACL_MATCH_IP_FRAG_NON_HEAD},
+
+    {BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE, "DROP",
+        BASE_ACL_PACKET_ACTION_TYPE_DROP},
+    {BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE, "FORWARD",
+        BASE_ACL_PACKET_ACTION_TYPE_FORWARD},
+    {BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE, "COPY_TO_CPU",
+        BASE_ACL_PACKET_ACTION_TYPE_COPY_TO_CPU},
+    {BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE, "COPY_TO_CPU_CANCEL",
+        BASE_ACL_PACKET_ACTION_TYPE_COPY_TO_CPU_CANCEL},
+    {BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE, "TRAP_TO_CPU",
+        BASE_ACL_PACKET_ACTION_TYPE_TRAP_TO_CPU},
+    {BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE, "COPY_TO_CPU_AND_FORWARD",
+        BASE_ACL_PACKET_ACTION_TYPE_COPY_TO_CPU_AND_FORWARD},
+    {BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE, "COPY_TO_CPU_CANCEL_AND_DROP",
+        BASE_ACL_PACKET_ACTION_TYPE_COPY_TO_CPU_CANCEL_AND_DROP},
+    {BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE, "COPY_TO_CPU_CANCEL_AND_FORWARD",
+        BASE_ACL_PACKET_ACTION_TYPE_COPY_TO_CPU_CANCEL_AND_FORWARD},
+};
+
+static bool _cfg_str_to_u64 (cps_api_attr_id_t attr_id, const std::string& str,
+                             uint64_t* val) noexcept
+{
+    for (const auto& e: _cfg_enum_map) {
+        if (e.attr_id == attr_id && str == e.name) {
+            *val = e.val;
+            return true;
+        }
+    }
+
+    if (str.empty () || !isdigit ((unsigned char) str[0])) {
+        return false;
+    }
+
+    char* end = NULL;
+    errno = 0;
+    *val = strtoull (str.c_str (), &end, 0);
+    return (errno == 0 && *end == '\0');
+}
+
+static bool _cfg_str_to_mac (const std::string& str, uint8_t* mac) noexcept
+{
+    unsigned int b[HAL_MAC_ADDR_LEN];
+    char         extra;
+
+    if (sscanf (str.c_str (), "%x:%x:%x:%x:%x:%x%c",
+                &b[0], &b[1], &b[2], &b[3], &b[4], &b[5], &extra) != HAL_MAC_ADDR_LEN) {
+        return false;
+    }
+    for (size_t idx = 0; idx < HAL_MAC_ADDR_LEN; idx++) {
+        if (b[idx] > 0xff) return false;
+        mac[idx] = b[idx];
+    }
+    return true;
+}
+
+// Convert the text of a value element to the attribute's data type
+static void _cfg_str_to_data (const _cfg_xml_node_t&    node,
+                              const nas_acl_map_data_t& info,
+                              nas_acl_common_data_t&    data)
+{
+    uint64_t  val;
+    uint8_t   bytes [NAS_ACL_COMMON_DATA_INLINE_LEN];
+    uint64_t  max = UINT64_MAX;
+
+    switch (info.data_type) {
+        case NAS_ACL_DATA_U8:      max = UINT8_MAX;  break;
+        case NAS_ACL_DATA_U16:     max = UINT16_MAX; break;
+        case NAS_ACL_DATA_U32:
+        case NAS_ACL_DATA_IFINDEX: max = UINT32_MAX; break;
+        default: break;
+    }
+
+    switch (info.data_type) {
+        case NAS_ACL_DATA_U8:
+        case NAS_ACL_DATA_U16:
+        case NAS_ACL_DATA_U32:
+        case NAS_ACL_DATA_U64:
+        case NAS_ACL_DATA_OBJ_ID:
+        case NAS_ACL_DATA_IFINDEX:
+            if (!_cfg_str_to_u64 (info.attr_id, node.text, &val) || val > max) {
+                _cfg_error (node, "Invalid value '" + node.text + "'");
+            }
+            if (info.data_type == NAS_ACL_DATA_U8) data.u8 = val;
+            else if (info.data_type == NAS_ACL_DATA_U16) data.u16 = val;
+            else if (info.data_type == NAS_ACL_DATA_U32) data.u32 = val;
+            else if (info.data_type == NAS_ACL_DATA_IFINDEX) data.ifindex = val;
+            else data.u64 = val;
+            break;
+
+        case NAS_ACL_DATA_BIN:
+            if (!((info.data_len == sizeof (struct in_addr) &&
+                   inet_pton (AF_INET, node.text.c_str (), bytes) == 1) ||
+                  (info.data_len == sizeof (struct in6_addr) &&
+                   inet_pton (AF_INET6, node.text.c_str (), bytes) == 1) ||
+                  (info.data_len == HAL_MAC_ADDR_LEN &&
+                   _cfg_str_to_mac (node.text, bytes)))) {
+                _cfg_error (node, "Invalid address '" + node.text + "'");
+            }
+            data.set_bytes (bytes, info.data_len);
+            break;
+
+        default:
+            _cfg_error (node, std::string ("Value of type ") +
+                        nas_acl_obj_data_type_to_str (info.data_type) +
+                        " not supported in the configuration file");
+    }
+}
+
+static void _cfg_add_data (cps_api_object_t          obj,
+                           nas::attr_list_t&         parent_list,
+                           const _cfg_xml_node_t&    node,
+                           const nas_acl_map_data_t& info)
+{
+    static constexpr nas_acl_map_data_list_t no_child {};
+    nas_acl_common_data_list_t data_list (1);
+
+    _cfg_str_to_data (node, info, data_list[0]);
+
+    if (!nas_acl_copy_data_to_obj (obj, parent_list, info, no_child, data_list)) {
+        throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                   "Failed to add value for <" + node.tag + ">"};
+    }
+}
+
+// Child attribute whose model leaf name matches the element tag
+static const nas_acl_map_data_t*
+_cfg_child_info (const nas_acl_map_data_list_t& child_list, const std::string& tag)
+{
+    for (const auto& child: child_list) {
+        const char* name = cps_attr_id_to_name (child.attr_id);
+        if (name == NULL) continue;
+
+        const char* leaf = strrchr (name, '/');
+        if (tag == ((leaf != NULL) ? leaf + 1 : name)) {
+            return &child;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * <value>NAME</value> for a leaf value, or
+ * <value><data>..</data><mask>..</mask></value> for a container value.
+ * Children not given are left out of the CPS object - as the Python
+ * loader does.
+ */
+static void _cfg_add_xml_value (cps_api_object_t               obj,
+                                nas::attr_list_t&              parent_list,
+                                const nas_acl_map_data_t&      val_info,
+                                const nas_acl_map_data_list_t& child_list,
+                                const _cfg_xml_node_t&         elem)
+{
+    const _cfg_xml_node_t* value = NULL;
+
+    for (const auto& child: elem.children) {
+        if (child.tag == "value") value = &child;
+    }
+
+    parent_list.push_back (val_info.attr_id);
+
+    if (val_info.data_type == NAS_ACL_DATA_NONE) {
+        // No value
+    } else if (value == NULL) {
+        _cfg_error (elem, "Missing <value>");
+    } else if (val_info.data_type != NAS_ACL_DATA_EMBEDDED) {
+        if (!value->children.empty ()) {
+            _cfg_error (*value, "Expected a single value");
+        }
+        _cfg_add_data (obj, parent_list, *value, val_info);
+    } else {
+        if (value->children.empty ()) {
+            _cfg_error (*value, "Expected child elements");
+        }
+        for (const auto& child: value->children) {
+            auto child_info = _cfg_child_info (child_list, child.tag);
+            if (child_info == NULL) {
+                _cfg_error (child, "Unknown element");
+            }
+            parent_list.push_back (child_info->attr_id);
+            _cfg_add_data (obj, parent_list, child, *child_info);
+            parent_list.pop_back ();
+        }
+    }
+
+    parent_list.pop_back ();
+}
+
+// Adds the MATCH/ACTION-List-Attr . ListIndex . TYPE attribute
+static void _cfg_add_list_type (cps_api_object_t  obj,
+                                nas::attr_list_t& parent_list,
+                                cps_api_attr_id_t list_attr,
+                                cps_api_attr_id_t list_index,
+                                cps_api_attr_id_t type_attr,
+                                uint32_t          type)
+{
+    parent_list.clear ();
+    parent_list.push_back (list_attr);
+    parent_list.push_back (list_index);
+    parent_list.push_back (type_attr);
+
+    if (!cps_api_object_e_add (obj, parent_list.data (), parent_list.size (),
+                               cps_api_object_ATTR_T_U32, &type, sizeof (uint32_t))) {
+        throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                   "Failed to add Match/Action type"};
+    }
+    parent_list.pop_back ();
+}
+
+typedef struct _cfg_cpu_q_t {
+    nas_obj_id_t             queue_id;
+    nas::ndi_obj_id_table_t  ndi_ids;
+} _cfg_cpu_q_t;
+
+class _cfg_builder_t
+{
+    public:
+        _cfg_builder_t (cps_api_transaction_params_t* params,
+                        nas_acl_cfg_cpu_q_fn_ptr_t    cpu_q_fn,
+                        nas_obj_id_t                  first_table_id)
+            : _params (params), _cpu_q_fn (cpu_q_fn), _next_table_id (first_table_id)
+        {
+            _parent_list.reserve (NAS_ACL_MAX_ATTR_DEPTH);
+        }
+
+        void load_detail (const _cfg_xml_node_t& root);
+        void load_master (const _cfg_xml_node_t& root);
+
+        nas_acl_cfg_load_stats_t  stats {};
+
+    private:
+        cps_api_transaction_params_t*  _params;
+        nas_acl_cfg_cpu_q_fn_ptr_t     _cpu_q_fn;
+        nas_obj_id_t                   _next_table_id;
+        nas::attr_list_t               _parent_list;
+
+        std::unordered_map<std::string, const _cfg_xml_node_t*>  _table_detail;
+        std::unordered_map<std::string, const _cfg_xml_node_t*>  _entry_detail;
+        std::unordered_map<uint_t, _cfg_cpu_q_t>                 _cpu_q_cache;
+
+        cps_api_object_t _obj_create (cps_api_attr_id_t obj_attr);
+        const _cfg_cpu_q_t& _cpu_q (const _cfg_xml_node_t& node, uint_t queue_num);
+        void _add_action (cps_api_object_t obj, cps_api_attr_id_t list_index,
+                          BASE_ACL_ACTION_TYPE_t type,
+                          nas_acl_common_data_list_t& data_list);
+
+        nas_obj_id_t _table_create (const _cfg_xml_node_t& detail,
+                                    BASE_ACL_STAGE_t stage, uint32_t prio);
+        nas_obj_id_t _counter_create (nas_obj_id_t table_id, nas_obj_id_t counter_id);
+        void _entry_create (const _cfg_xml_node_t& master,
+                            const _cfg_xml_node_t& detail,
+                            nas_obj_id_t table_id, uint32_t prio,
+                            nas_obj_id_t& next_counter_id);
+};
+
+// The new object is owned by the transaction from here on
+cps_api_object_t _cfg_builder_t::_obj_create (cps_api_attr_id_t obj_attr)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj == NULL) {
+        throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                   "Failed to create CPS object"};
+    }
+    // Setting the key resets the operation - so it comes first
+    cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                     cps_api_qualifier_TARGET);
+    if (cps_api_create (_params, obj) != cps_api_ret_code_OK) {
+        cps_api_object_delete (obj);
+        throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                   "Failed to add CPS object to transaction"};
+    }
+    return obj;
+}
+
+void _cfg_builder_t::load_detail (const _cfg_xml_node_t& root)
+{
+    for (const auto& node: root.children) {
+        if (node.tag == "table") {
+            _table_detail[_cfg_attr (node, "tag")] = &node;
+        } else if (node.tag == "entry") {
+            _entry_detail[_cfg_attr (node, "tag")] = &node;
+        } else {
+            _cfg_error (node, "Invalid type of object in detail list");
+        }
+    }
+}
+
+void _cfg_builder_t::load_master (const _cfg_xml_node_t& root)
+{
+    for (const auto& stage_node: root.children) {
+
+        BASE_ACL_STAGE_t stage;
+        if (stage_node.tag == "INGRESS") {
+            stage = BASE_ACL_STAGE_INGRESS;
+        } else if (stage_node.tag == "EGRESS") {
+            stage = BASE_ACL_STAGE_EGRESS;
+        } else {
+            _cfg_error (stage_node, "Invalid stage");
+        }
+
+        for (const auto& table_node: stage_node.children) {
+
+            const char* table_name = _cfg_attr (table_node, "tag");
+            uint64_t    table_prio;
+
+            auto tbl_it = _table_detail.find (table_name);
+            if (tbl_it == _table_detail.end ()) {
+                _cfg_error (table_node, std::string ("Unable to find table ") +
+                            table_name + " in detail list");
+            }
+            if (!_cfg_str_to_u64 (0, _cfg_attr (table_node, "priority"), &table_prio) ||
+                table_prio > UINT32_MAX) {
+                _cfg_error (table_node, "Invalid priority");
+            }
+
+            nas_obj_id_t table_id = _table_create (*tbl_it->second, stage, table_prio);
+            nas_obj_id_t next_counter_id = 1;
+
+            // Entries without a priority count down in list order
+            uint32_t entry_prio = NAS_ACL_CFG_ENTRY_PRIO;
+
+            for (const auto& entry_node: table_node.children) {
+
+                const char* entry_name = _cfg_attr (entry_node, "tag");
+                auto ent_it = _entry_detail.find (entry_name);
+                if (ent_it == _entry_detail.end ()) {
+                    _cfg_error (entry_node, std::string ("Unable to find Entry ") +
+                                entry_name + " in detail list");
+                }
+
+                uint64_t    prio = entry_prio;
+                const char* prio_str = entry_node.attr ("priority");
+                if (prio_str != NULL && (!_cfg_str_to_u64 (0, prio_str, &prio) ||
+                                         prio > UINT32_MAX)) {
+                    _cfg_error (entry_node, "Invalid priority");
+                }
+
+                _entry_create (entry_node, *ent_it->second, table_id, prio,
+                               next_counter_id);
+                entry_prio--;
+            }
+        }
+    }
+}
+
+nas_obj_id_t _cfg_builder_t::_table_create (const _cfg_xml_node_t& detail,
+                                            BASE_ACL_STAGE_t stage, uint32_t prio)
+{
+    nas_obj_id_t     table_id = _next_table_id++;
+    cps_api_object_t obj = _obj_create (BASE_ACL_TABLE_OBJ);
+
+    if (!nas_acl_cps_key_set_obj_id (obj, BASE_ACL_TABLE_ID, table_id) ||
+        !cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, stage) ||
+        !cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, prio)) {
+        throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                   "Failed to fill Table object"};
+    }
+
+    for (const auto& node: detail.children) {
+        if (node.tag != "allow-match") continue;
+
+        BASE_ACL_MATCH_TYPE_t match_type;
+        if (!nas_acl_filter_type_from_name (node.text.c_str (), &match_type)) {
+            _cfg_error (node, "Unknown Match type " + node.text);
+        }
+        if (!cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                          match_type)) {
+            throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                       "Failed to fill Table object"};
+        }
+    }
+
+    NAS_ACL_LOG_DETAIL ("Table %s: ID %lu, Stage %d, Priority %d",
+                        _cfg_attr (detail, "tag"), table_id, stage, prio);
+    stats.tables++;
+    return table_id;
+}
+
+nas_obj_id_t _cfg_builder_t::_counter_create (nas_obj_id_t table_id,
+                                              nas_obj_id_t counter_id)
+{
+    cps_api_object_t obj = _obj_create (BASE_ACL_COUNTER_OBJ);
+
+    if (!nas_acl_cps_key_set_obj_id (obj, BASE_ACL_COUNTER_TABLE_ID, table_id) ||
+        !nas_acl_cps_key_set_obj_id (obj, BASE_ACL_COUNTER_ID, counter_id) ||
+        !cps_api_object_attr_add_u32 (obj, BASE_ACL_COUNTER_TYPES,
+                                      BASE_ACL_COUNTER_TYPE_PACKET)) {
+        throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                   "Failed to fill Counter object"};
+    }
+
+    stats.counters++;
+    return counter_id;
+}
+
+const _cfg_cpu_q_t& _cfg_builder_t::_cpu_q (const _cfg_xml_node_t& node,
+                                            uint_t queue_num)
+{
+    auto it = _cpu_q_cache.find (queue_num);
+    if (it != _cpu_q_cache.end ()) {
+        return it->second;
+    }
+
+    _cfg_cpu_q_t cpu_q {};
+    if (_cpu_q_fn == NULL ||
+        !_cpu_q_fn (queue_num, &cpu_q.queue_id, cpu_q.ndi_ids)) {
+        _cfg_error (node, "Failed to find CPU queue " + std::to_string (queue_num));
+    }
+    return _cpu_q_cache.emplace (queue_num, std::move (cpu_q)).first->second;
+}
+
+void _cfg_builder_t::_add_action (cps_api_object_t            obj,
+                                  cps_api_attr_id_t           list_index,
+                                  BASE_ACL_ACTION_TYPE_t      type,
+                                  nas_acl_common_data_list_t& data_list)
+{
+    auto map_info_p = nas_acl_get_action_info (type);
+
+    _cfg_add_list_type (obj, _parent_list, BASE_ACL_ENTRY_ACTION, list_index,
+                        BASE_ACL_ENTRY_ACTION_TYPE, type);
+    _parent_list.push_back (map_info_p->val.attr_id);
+
+    if (!nas_acl_copy_data_to_obj (obj, _parent_list, map_info_p->val,
+                                   map_info_p->child_list, data_list)) {
+        throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                   std::string ("Failed to add ") + map_info_p->name};
+    }
+}
+
+void _cfg_builder_t::_entry_create (const _cfg_xml_node_t& master,
+                                    const _cfg_xml_node_t& detail,
+                                    nas_obj_id_t table_id, uint32_t prio,
+                                    nas_obj_id_t& next_counter_id)
+{
+    const char*   cpu_q_str = master.attr ("cpu-q");
+    nas_obj_id_t  counter_id = 0;
+
+    // Counter goes ahead of the Entry that refers to it
+    if (cpu_q_str != NULL) {
+        counter_id = _counter_create (table_id, next_counter_id++);
+    }
+
+    cps_api_object_t   obj = _obj_create (BASE_ACL_ENTRY_OBJ);
+    cps_api_attr_id_t  match_index = 0;
+    cps_api_attr_id_t  action_index = 0;
+
+    if (!nas_acl_cps_key_set_obj_id (obj, BASE_ACL_ENTRY_TABLE_ID, table_id) ||
+        !cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, prio)) {
+        throw nas::base_exception {NAS_ACL_E_MEM, __PRETTY_FUNCTION__,
+                                   "Failed to fill Entry object"};
+    }
+
+    for (const auto& node: detail.children) {
+
+        if (node.tag == "match") {
+            BASE_ACL_MATCH_TYPE_t type;
+            if (!nas_acl_filter_type_from_name (_cfg_attr (node, "type"), &type)) {
+                _cfg_error (node, std::string ("Unknown Match type ") + node.attr ("type"));
+            }
+            auto map_info_p = nas_acl_get_filter_info (type);
+
+            _cfg_add_list_type (obj, _parent_list, BASE_ACL_ENTRY_MATCH, match_index++,
+                                BASE_ACL_ENTRY_MATCH_TYPE, type);
+            _cfg_add_xml_value (obj, _parent_list, map_info_p->val,
+                                map_info_p->child_list, node);
+
+        } else if (node.tag == "action") {
+            BASE_ACL_ACTION_TYPE_t type;
+            if (!nas_acl_action_type_from_name (_cfg_attr (node, "type"), &type)) {
+                _cfg_error (node, std::string ("Unknown Action type ") + node.attr ("type"));
+            }
+            auto map_info_p = nas_acl_get_action_info (type);
+
+            _cfg_add_list_type (obj, _parent_list, BASE_ACL_ENTRY_ACTION, action_index++,
+                                BASE_ACL_ENTRY_ACTION_TYPE, type);
+            _cfg_add_xml_value (obj, _parent_list, map_info_p->val,
+                                map_info_p->child_list, node);
+        }
+    }
+
+    if (cpu_q_str != NULL) {
+        uint64_t queue_num;
+        if (!_cfg_str_to_u64 (0, cpu_q_str, &queue_num) || queue_num > UINT32_MAX) {
+            _cfg_error (master, "Invalid cpu-q");
+        }
+        const _cfg_cpu_q_t& cpu_q = _cpu_q (master, queue_num);
+
+        nas_acl_common_data_list_t data_list (2);
+        data_list[0].obj_id = cpu_q.queue_id;
+        data_list[1].ndi_obj_id_table () = cpu_q.ndi_ids;
+        _add_action (obj, action_index++, BASE_ACL_ACTION_TYPE_SET_CPU_QUEUE, data_list);
+
+        const char* pkt_action = master.attr ("action");
+        if (pkt_action != NULL) {
+            uint64_t val;
+            if (!_cfg_str_to_u64 (BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE,
+                                  pkt_action, &val) || val > UINT32_MAX) {
+                _cfg_error (master, std::string ("Invalid action ") + pkt_action);
+            }
+            data_list.resize (1);
+            data_list[0].u32 = val;
+            _add_action (obj, action_index++, BASE_ACL_ACTION_TYPE_PACKET_ACTION,
+                         data_list);
+        }
+
+        data_list.resize (1);
+        data_list[0].obj_id = counter_id;
+        _add_action (obj, action_index++, BASE_ACL_ACTION_TYPE_SET_COUNTER, data_list);
+    }
+
+    NAS_ACL_LOG_DETAIL ("Entry %s: Table %lu, Priority %d, Counter %lu",
+                        _cfg_attr (master, "tag"), table_id, prio, counter_id);
+    stats.entries++;
+}
+
+const char* nas_acl_cfg_path () noexcept
+{
+    const char* path = getenv (NAS_ACL_CFG_PATH_ENV);
+    return (path != NULL) ? path : NAS_ACL_CFG_PATH;
+}
+
+nas_obj_id_t nas_acl_cfg_free_table_id (cps_api_object_list_t table_list) noexcept
+{
+    nas_obj_id_t next_id = 1;
+    size_t       count = cps_api_object_list_size (table_list);
+
+    for (size_t idx = 0; idx < count; idx++) {
+        nas_obj_id_t table_id;
+        if (nas_acl_cps_key_get_obj_id (cps_api_object_list_get (table_list, idx),
+                                        BASE_ACL_TABLE_ID, &table_id) &&
+            table_id >= next_id) {
+            next_id = table_id + 1;
+        }
+    }
+    return next_id;
+}
+
+t_std_error nas_acl_cfg_build (const char*                   cfg_path,
+                               nas_obj_id_t                  first_table_id,
+                               nas_acl_cfg_cpu_q_fn_ptr_t    cpu_q_fn,
+                               cps_api_transaction_params_t* params,
+                               nas_acl_cfg_load_stats_t*     stats) noexcept
+{
+    // Error messages of the element trees refer to the file names
+    std::string detail_file = std::string (cfg_path) + "/" NAS_ACL_CFG_DETAIL_FILE;
+    std::string master_file = std::string (cfg_path) + "/" NAS_ACL_CFG_MASTER_FILE;
+
+    try {
+        _cfg_xml_node_t detail_root;
+        _cfg_xml_node_t master_root;
+
+        _cfg_xml_load (detail_file, detail_root);
+        _cfg_xml_load (master_file, master_root);
+
+        _cfg_builder_t builder (params, cpu_q_fn, first_table_id);
+
+        builder.load_detail (detail_root);
+        builder.load_master (master_root);
+
+        if (stats != NULL) {
+            *stats = builder.stats;
+        }
+
+        NAS_ACL_LOG_BRIEF ("ACL config %s: %zu Tables, %zu Counters, %zu Entries",
+                           cfg_path, builder.stats.tables, builder.stats.counters,
+                           builder.stats.entries);
+
+    } catch (nas::base_exception& e) {
+        NAS_ACL_LOG_ERR ("ACL config load failed - %s", e.err_msg.c_str ());
+        return e.err_code;
+
+    } catch (std::bad_alloc& e) {
+        NAS_ACL_LOG_ERR ("ACL config %s: Out of memory", cfg_path);
+        return NAS_ACL_E_MEM;
+    }
+
+    return NAS_ACL_E_NONE;
+}
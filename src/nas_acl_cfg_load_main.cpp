@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_cfg_load_main.cpp
+ * \brief  Boot time loader of the default ACL configuration (CoPP)
+ *
+ * Native replacement for base_create_acl_entries.py - all the Tables,
+ * Counters and Entries are created in a single CPS transaction.
+ *
+ * Usage: base_acl_cfg_load [-d cfg-dir] [-c cpu-ifindex] [-n] [-t]
+ *   -d  Directory of the master and detail lists (default $DN_ACL_CFG_PATH
+ *       or /etc/sonic)
+ *   -c  CPU port IfIndex - looked up from the interface model if not given
+ *   -n  Parse and build only - do not commit
+ *   -t  Print the time taken by each step
+ */
+
+#include "dell-base-acl.h"
+#include "dell-base-qos.h"
+#include "dell-interface.h"
+#include "ietf-interfaces.h"
+#include "nas_acl_cfg_load.h"
+#include "nas_acl_common.h"
+#include "nas_acl_cps_key.h"
+#include "cps_api_object_key.h"
+#include "cps_class_map.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CFG_LOAD_CPU_IF_TYPE  "base-if:cpu"
+
+static hal_ifindex_t _cpu_ifindex;
+static bool          _cpu_ifindex_valid = false;
+
+static uint64_t _now_ns ()
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static bool _cpu_ifindex_lookup ()
+{
+    cps_api_get_params_t params;
+    bool                 found = false;
+
+    if (cps_api_get_request_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    cps_api_object_t obj = cps_api_object_list_create_obj_and_append (params.filters);
+    if (obj != NULL &&
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj),
+                                         DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_OBJ,
+                                         cps_api_qualifier_TARGET) &&
+        cps_api_get (&params) == cps_api_ret_code_OK) {
+
+        size_t count = cps_api_object_list_size (params.list);
+
+        for (size_t idx = 0; idx < count && !found; idx++) {
+            obj = cps_api_object_list_get (params.list, idx);
+
+            auto type_attr = cps_api_object_attr_get (obj, IF_INTERFACES_INTERFACE_TYPE);
+            auto ifindex_attr = cps_api_object_attr_get (obj,
+                                    DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_IF_INDEX);
+            if (type_attr == NULL || ifindex_attr == NULL) continue;
+
+            if (strncmp (static_cast<const char*> (cps_api_object_attr_data_bin (type_attr)),
+                         CFG_LOAD_CPU_IF_TYPE,
+                         cps_api_object_attr_len (type_attr)) == 0) {
+                _cpu_ifindex = cps_api_object_attr_data_u32 (ifindex_attr);
+                found = true;
+            }
+        }
+    }
+
+    cps_api_get_request_close (&params);
+    return found;
+}
+
+// Multicast queue of the CPU port, as the Python loader used
+static bool _cpu_q_get (uint_t queue_num, nas_obj_id_t* queue_id,
+                        nas::ndi_obj_id_table_t& ndi_ids)
+{
+    if (!_cpu_ifindex_valid) {
+        if (!_cpu_ifindex_lookup ()) {
+            printf ("Failed to find the CPU port\r\n");
+            return false;
+        }
+        _cpu_ifindex_valid = true;
+        printf ("CPU IfIndex %d\r\n", _cpu_ifindex);
+    }
+
+    cps_api_get_params_t params;
+    bool                 found = false;
+
+    if (cps_api_get_request_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    cps_api_object_t obj = cps_api_object_list_create_obj_and_append (params.filters);
+    if (obj != NULL &&
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), BASE_QOS_QUEUE_OBJ,
+                                         cps_api_qualifier_TARGET) &&
+        nas_acl_cps_key_set_u32 (obj, BASE_QOS_QUEUE_PORT_ID, _cpu_ifindex) &&
+        nas_acl_cps_key_set_u32 (obj, BASE_QOS_QUEUE_TYPE, BASE_QOS_QUEUE_TYPE_MULTICAST) &&
+        nas_acl_cps_key_set_u32 (obj, BASE_QOS_QUEUE_QUEUE_NUMBER, queue_num) &&
+        cps_api_get (&params) == cps_api_ret_code_OK &&
+        cps_api_object_list_size (params.list) > 0) {
+
+        obj = cps_api_object_list_get (params.list, 0);
+
+        cps_api_attr_id_t data_attr = BASE_QOS_QUEUE_DATA;
+        auto              id_attr = cps_api_get_key_data (obj, BASE_QOS_QUEUE_ID);
+        if (id_attr == NULL) {
+            id_attr = cps_api_object_attr_get (obj, BASE_QOS_QUEUE_ID);
+        }
+
+        if (id_attr != NULL &&
+            nas::ndi_obj_id_table_cps_unserialize (ndi_ids, obj, &data_attr, 1)) {
+            *queue_id = cps_api_object_attr_data_u64 (id_attr);
+            found = true;
+        }
+    }
+
+    cps_api_get_request_close (&params);
+    return found;
+}
+
+// Waits for NAS to serve ACL Tables and returns the first free Table ID
+static nas_obj_id_t _wait_for_acl ()
+{
+    for (;;) {
+        cps_api_get_params_t params;
+        nas_obj_id_t         table_id = 0;
+
+        if (cps_api_get_request_init (&params) == cps_api_ret_code_OK) {
+
+            cps_api_object_t obj = cps_api_object_list_create_obj_and_append (params.filters);
+            if (obj != NULL &&
+                cps_api_key_from_attr_with_qual (cps_api_object_key (obj),
+                                                 BASE_ACL_TABLE_OBJ,
+                                                 cps_api_qualifier_TARGET) &&
+                cps_api_get (&params) == cps_api_ret_code_OK) {
+                table_id = nas_acl_cfg_free_table_id (params.list);
+            }
+            cps_api_get_request_close (&params);
+        }
+
+        if (table_id != 0) {
+            return table_id;
+        }
+        sleep (1);
+    }
+}
+
+int main (int argc, char** argv)
+{
+    const char* cfg_path = nas_acl_cfg_path ();
+    bool        dry_run = false;
+    bool        timing = false;
+    int         opt;
+
+    while ((opt = getopt (argc, argv, "d:c:nt")) != -1) {
+        switch (opt) {
+            case 'd':
+                cfg_path = optarg;
+                break;
+            case 'c':
+                _cpu_ifindex = strtoul (optarg, NULL, 0);
+                _cpu_ifindex_valid = true;
+                break;
+            case 'n':
+                dry_run = true;
+                break;
+            case 't':
+                timing = true;
+                break;
+            default:
+                printf ("Usage: %s [-d cfg-dir] [-c cpu-ifindex] [-n] [-t]\r\n", argv[0]);
+                return 1;
+        }
+    }
+
+    uint64_t start_ns = _now_ns ();
+    nas_obj_id_t first_table_id = (dry_run) ? 1 : _wait_for_acl ();
+    uint64_t wait_ns = _now_ns ();
+
+    cps_api_transaction_params_t params;
+    nas_acl_cfg_load_stats_t     stats {};
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        printf ("CPS transaction init failed\r\n");
+        return 1;
+    }
+
+    if (nas_acl_cfg_build (cfg_path, first_table_id, _cpu_q_get,
+                           &params, &stats) != STD_ERR_OK) {
+        printf ("ACL INIT - Failed to load %s\r\n", cfg_path);
+        cps_api_transaction_close (&params);
+        return 1;
+    }
+    uint64_t build_ns = _now_ns ();
+
+    // All or nothing - CPS rolls back the objects already created
+    // if any of them fails
+    if (!dry_run && cps_api_commit (&params) != cps_api_ret_code_OK) {
+        printf ("ACL INIT - Commit of %zu objects failed\r\n",
+                cps_api_object_list_size (params.change_list));
+        cps_api_transaction_close (&params);
+        return 1;
+    }
+    uint64_t commit_ns = _now_ns ();
+
+    cps_api_transaction_close (&params);
+
+    printf ("Created %zu Tables, %zu Counters, %zu Entries\r\n",
+            stats.tables, stats.counters, stats.entries);
+
+    if (timing) {
+        printf ("Wait %.3f ms, Build %.3f ms, Commit %.3f ms, Total %.3f ms\r\n",
+                (wait_ns - start_ns) / 1e6, (build_ns - wait_ns) / 1e6,
+                (commit_ns - build_ns) / 1e6, (commit_ns - start_ns) / 1e6);
+    }
+
+    return 0;
+}
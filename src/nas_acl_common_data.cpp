@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_common_data.cpp
+ * \brief  NAS ACL CPS attribute value container
+ */
+
+#include "dell-base-acl.h"
+#include "nas_acl_common.h"
+#include <string.h>
+
+static const nas::ifindex_list_t      _empty_ifindex_list {};
+static const nas::ndi_obj_id_table_t  _empty_ndi_obj_id_table {};
+
+nas_acl_common_data_t::nas_acl_common_data_t (const nas_acl_common_data_t& rhs)
+    : u64 {rhs.u64}
+{
+    _copy (rhs);
+}
+
+nas_acl_common_data_t::nas_acl_common_data_t (nas_acl_common_data_t&& rhs) noexcept
+    : u64 {rhs.u64}
+{
+    _move (rhs);
+}
+
+nas_acl_common_data_t&
+nas_acl_common_data_t::operator= (const nas_acl_common_data_t& rhs)
+{
+    if (this != &rhs) {
+        _clear ();
+        u64 = rhs.u64;
+        _copy (rhs);
+    }
+    return *this;
+}
+
+nas_acl_common_data_t&
+nas_acl_common_data_t::operator= (nas_acl_common_data_t&& rhs) noexcept
+{
+    if (this != &rhs) {
+        _clear ();
+        u64 = rhs.u64;
+        _move (rhs);
+    }
+    return *this;
+}
+
+void nas_acl_common_data_t::_clear () noexcept
+{
+    switch (_kind) {
+        case _HEAP_BYTES:
+            delete _heap_bytes;
+            break;
+        case _IFINDEX_LIST:
+            delete _ifindex_list;
+            break;
+        case _NDI_OBJ_ID_TABLE:
+            delete _ndi_obj_id_table;
+            break;
+        default:
+            break;
+    }
+    _kind = _NONE;
+    _len = 0;
+}
+
+// Expects this to be cleared
+void nas_acl_common_data_t::_copy (const nas_acl_common_data_t& rhs)
+{
+    switch (rhs._kind) {
+        case _INLINE_BYTES:
+            memcpy (_inline, rhs._inline, rhs._len);
+            _len = rhs._len;
+            break;
+        case _HEAP_BYTES:
+            _heap_bytes = new std::vector<uint8_t> (*rhs._heap_bytes);
+            break;
+        case _IFINDEX_LIST:
+            _ifindex_list = new nas::ifindex_list_t (*rhs._ifindex_list);
+            break;
+        case _NDI_OBJ_ID_TABLE:
+            _ndi_obj_id_table = new nas::ndi_obj_id_table_t (*rhs._ndi_obj_id_table);
+            break;
+        default:
+            break;
+    }
+    _kind = rhs._kind;
+}
+
+// Expects this to be cleared - takes over any heap storage of rhs
+void nas_acl_common_data_t::_move (nas_acl_common_data_t& rhs) noexcept
+{
+    memcpy (_inline, rhs._inline, sizeof (_inline));
+    _kind = rhs._kind;
+    _len = rhs._len;
+
+    rhs._kind = _NONE;
+    rhs._len = 0;
+}
+
+const uint8_t* nas_acl_common_data_t::bytes_data () const noexcept
+{
+    switch (_kind) {
+        case _INLINE_BYTES:
+            return _inline;
+        case _HEAP_BYTES:
+            return _heap_bytes->data ();
+        default:
+            return NULL;
+    }
+}
+
+size_t nas_acl_common_data_t::bytes_size () const noexcept
+{
+    switch (_kind) {
+        case _INLINE_BYTES:
+            return _len;
+        case _HEAP_BYTES:
+            return _heap_bytes->size ();
+        default:
+            return 0;
+    }
+}
+
+void nas_acl_common_data_t::set_bytes (const void* data, size_t len)
+{
+    auto data_u8 = static_cast<const uint8_t*> (data);
+
+    _clear ();
+
+    if (len <= sizeof (_inline)) {
+        memcpy (_inline, data_u8, len);
+        _len = len;
+        _kind = _INLINE_BYTES;
+    } else {
+        _heap_bytes = new std::vector<uint8_t> (data_u8, data_u8 + len);
+        _kind = _HEAP_BYTES;
+    }
+}
+
+void nas_acl_common_data_t::fill_bytes (uint8_t val, size_t len)
+{
+    _clear ();
+
+    if (len <= sizeof (_inline)) {
+        memset (_inline, val, len);
+        _len = len;
+        _kind = _INLINE_BYTES;
+    } else {
+        _heap_bytes = new std::vector<uint8_t> (len, val);
+        _kind = _HEAP_BYTES;
+    }
+}
+
+nas::ifindex_list_t& nas_acl_common_data_t::ifindex_list ()
+{
+    if (_kind != _IFINDEX_LIST) {
+        auto list_p = new nas::ifindex_list_t {};
+        _clear ();
+        _ifindex_list = list_p;
+        _kind = _IFINDEX_LIST;
+    }
+    return *_ifindex_list;
+}
+
+const nas::ifindex_list_t& nas_acl_common_data_t::ifindex_list () const noexcept
+{
+    return (_kind == _IFINDEX_LIST) ? *_ifindex_list : _empty_ifindex_list;
+}
+
+nas::ndi_obj_id_table_t& nas_acl_common_data_t::ndi_obj_id_table ()
+{
+    if (_kind != _NDI_OBJ_ID_TABLE) {
+        auto table_p = new nas::ndi_obj_id_table_t {};
+        _clear ();
+        _ndi_obj_id_table = table_p;
+        _kind = _NDI_OBJ_ID_TABLE;
+    }
+    return *_ndi_obj_id_table;
+}
+
+const nas::ndi_obj_id_table_t& nas_acl_common_data_t::ndi_obj_id_table () const noexcept
+{
+    return (_kind == _NDI_OBJ_ID_TABLE) ? *_ndi_obj_id_table : _empty_ndi_obj_id_table;
+}
@@ -29,6 +29,8 @@
 #include "nas_acl_switch.h"
 #include "nas_acl_counter.h"
 #include "nas_acl_table.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_warm.h"
 #include "nas_acl_log.h"
 #include <inttypes.h>
 
@@ -64,6 +66,10 @@ void nas_acl_counter_t::commit_create (bool rolling_back)
         copy_table_npus ();
     }
 
+    for (auto npu_id: npu_list ()) {
+        get_table().get_switch().hw_admit (get_table(), npu_id, {0, 1});
+    }
+
     nas::base_obj_t::commit_create (rolling_back);
 }
 
@@ -87,7 +93,15 @@ nas::attr_set_t nas_acl_counter_t::commit_modify (base_obj_t& counter_orig,
         copy_table_npus();
     }
 
-    diff_counter_type (dynamic_cast <nas_acl_counter_t&> (counter_orig));
+    auto& cntr_orig = dynamic_cast <nas_acl_counter_t&> (counter_orig);
+
+    for (auto npu_id: npu_list ()) {
+        if (!cntr_orig.is_obj_in_npu (npu_id)) {
+            get_table().get_switch().hw_admit (get_table(), npu_id, {0, 1});
+        }
+    }
+
+    diff_counter_type (cntr_orig);
 
     return nas::base_obj_t::commit_modify (counter_orig, rolling_back);
 }
@@ -144,7 +158,18 @@ bool nas_acl_counter_t::push_create_obj_to_npu (npu_id_t npu_id,
     ndi_counter.enable_pkt_count = _enable_pkt_count;
     ndi_counter.enable_byte_count = _enable_byte_count;
 
-    if ((rc = ndi_acl_counter_create (npu_id, &ndi_counter, &ndi_cntr_id))
+    // Replayed after a warm restart - the Counter already in the NPU
+    // is taken over along with its statistics
+    std::vector<ndi_obj_id_t> adopted;
+    if (nas_acl_warm_adopt (NAS_ACL_WARM_OBJ_COUNTER, get_switch().id(), table_id(),
+                            counter_id(), npu_id,
+                            nas_acl_warm_counter_hash (*this, npu_id), adopted)) {
+        _ndi_obj_ids[npu_id] = adopted.front ();
+        return true;
+    }
+
+    if ((rc = nas_acl_perf_ndi_call (ndi_acl_counter_create, npu_id,
+                                     &ndi_counter, &ndi_cntr_id))
             != STD_ERR_OK)
     {
         throw nas::base_exception {rc, __PRETTY_FUNCTION__,
@@ -164,7 +189,8 @@ bool nas_acl_counter_t::push_delete_obj_to_npu (npu_id_t npu_id)
 {
     t_std_error rc = STD_ERR_OK;
 
-    if ((rc = ndi_acl_counter_delete (npu_id, _ndi_obj_ids.at (npu_id)))
+    if ((rc = nas_acl_perf_ndi_call (ndi_acl_counter_delete, npu_id,
+                                     _ndi_obj_ids.at (npu_id)))
         != STD_ERR_OK)
     {
         throw nas::base_exception {rc, __PRETTY_FUNCTION__,
@@ -221,8 +247,8 @@ t_std_error nas_acl_counter_t::get_pkt_count_ndi (npu_id_t npu_id,
         return NAS_ACL_E_INCONSISTENT;
     }
 
-    if ((rc = ndi_acl_counter_get_pkt_count (npu_id, ndi_counter_id,
-                                             pkt_count_p))
+    if ((rc = nas_acl_perf_ndi_call (ndi_acl_counter_get_pkt_count, npu_id,
+                                     ndi_counter_id, pkt_count_p))
         != STD_ERR_OK) {
 
         NAS_ACL_LOG_ERR ("NDI Packet counter Get returned error %d for NPU %d\n",
@@ -242,8 +268,8 @@ t_std_error nas_acl_counter_t::get_byte_count_ndi (npu_id_t npu_id,
         return NAS_ACL_E_INCONSISTENT;
     }
 
-    if ((rc = ndi_acl_counter_get_byte_count (npu_id, ndi_counter_id,
-                                             byte_count_p))
+    if ((rc = nas_acl_perf_ndi_call (ndi_acl_counter_get_byte_count, npu_id,
+                                     ndi_counter_id, byte_count_p))
         != STD_ERR_OK) {
 
         NAS_ACL_LOG_ERR ("NDI Byte counter Get returned error %d for NPU %d\n",
@@ -264,8 +290,8 @@ void nas_acl_counter_t::set_pkt_count_ndi (npu_id_t npu_id,
             "Packet count action not enabled for this ACL Entry"};
     }
 
-    if ((rc = ndi_acl_counter_set_pkt_count (npu_id, ndi_counter_id,
-                                             pkt_count))
+    if ((rc = nas_acl_perf_ndi_call (ndi_acl_counter_set_pkt_count, npu_id,
+                                     ndi_counter_id, pkt_count))
         != STD_ERR_OK) {
 
         throw nas::base_exception {rc, __PRETTY_FUNCTION__,
@@ -285,8 +311,8 @@ void nas_acl_counter_t::set_byte_count_ndi (npu_id_t npu_id,
             "Byte count action not enabled for this ACL Entry"};
     }
 
-    if ((rc = ndi_acl_counter_set_byte_count (npu_id, ndi_counter_id,
-                                              byte_count))
+    if ((rc = nas_acl_perf_ndi_call (ndi_acl_counter_set_byte_count, npu_id,
+                                     ndi_counter_id, byte_count))
         != STD_ERR_OK) {
 
         throw nas::base_exception {rc, __PRETTY_FUNCTION__,
@@ -24,18 +24,219 @@
 #include "std_error_codes.h"
 #include "nas_acl_log.h"
 #include "nas_acl_cps.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_event.h"
+#include "nas_acl_async.h"
+#include "nas_acl_cps_key.h"
+#include "nas_acl_undo.h"
+#include "nas_acl_prepare.h"
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Transaction lock mode - the write thread takes the NAS ACL lock at the
+ * first ACL object of a transaction and holds it until the last ACL object
+ * is written or a write fails. Readers then never see a partly applied
+ * change list. Rollback drops the hold and locks per object as before.
+ */
+static std::atomic<bool>  _txn_lock_enabled {false};
+
+// Transaction that holds the lock - only used by the CPS write thread
+static const void*        _txn_lock_holder = NULL;
+
+static nas_acl_perf_obj_t nas_acl_perf_obj (uint32_t sub_category) noexcept
+{
+    switch (sub_category) {
+        case BASE_ACL_TABLE_OBJ:   return NAS_ACL_PERF_OBJ_TABLE;
+        case BASE_ACL_ENTRY_OBJ:   return NAS_ACL_PERF_OBJ_ENTRY;
+        case BASE_ACL_COUNTER_OBJ: return NAS_ACL_PERF_OBJ_COUNTER;
+        case BASE_ACL_STATS_OBJ:   return NAS_ACL_PERF_OBJ_STATS;
+        default:                   return NAS_ACL_PERF_OBJ_MAX;
+    }
+}
+
+static nas_acl_perf_op_t nas_acl_perf_op (cps_api_operation_types_t op) noexcept
+{
+    switch (op) {
+        case cps_api_oper_CREATE: return NAS_ACL_PERF_OP_CREATE;
+        case cps_api_oper_SET:    return NAS_ACL_PERF_OP_SET;
+        case cps_api_oper_DELETE: return NAS_ACL_PERF_OP_DELETE;
+        default:                  return NAS_ACL_PERF_OP_MAX;
+    }
+}
+
+// True if no ACL object precedes in the transaction
+static bool nas_acl_is_first_obj (cps_api_transaction_params_t *param,
+                                  size_t                        index) noexcept
+{
+    for (size_t prior = 0; prior < index; prior++) {
+        cps_api_object_t obj = cps_api_object_list_get (param->change_list, prior);
+
+        if (obj != NULL && cps_api_key_get_cat (cps_api_object_key (obj))
+                           == cps_api_obj_CAT_BASE_ACL) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// True if no ACL object follows in the transaction
+static bool nas_acl_is_last_obj (cps_api_transaction_params_t *param,
+                                 size_t                        index) noexcept
+{
+    size_t count = cps_api_object_list_size (param->change_list);
+
+    for (size_t next = index + 1; next < count; next++) {
+        cps_api_object_t obj = cps_api_object_list_get (param->change_list, next);
+
+        if (obj != NULL && cps_api_key_get_cat (cps_api_object_key (obj))
+                           == cps_api_obj_CAT_BASE_ACL) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Wait for the queued Entry writes that a write must not overtake.
+// Rollback of an Entry write is queued behind them.
+static void nas_acl_async_wait (uint32_t         sub_category,
+                                cps_api_object_t obj,
+                                bool             rollback) noexcept
+{
+    nas_switch_id_t switch_id;
+    nas_obj_id_t    table_id;
+    nas_obj_id_t    entry_id;
+
+    if (sub_category != BASE_ACL_ENTRY_OBJ) {
+        nas_acl_async_drain ();
+        return;
+    }
+
+    if (!rollback &&
+        nas_acl_cps_key_get_switch_id (obj, NAS_ACL_SWITCH_ATTR, &switch_id) &&
+        nas_acl_cps_key_get_obj_id (obj, BASE_ACL_ENTRY_TABLE_ID, &table_id) &&
+        nas_acl_cps_key_get_obj_id (obj, BASE_ACL_ENTRY_ID, &entry_id)) {
+        nas_acl_async_wait_entry (switch_id, table_id, entry_id);
+    }
+}
+
+static void nas_acl_txn_lock_take (cps_api_transaction_params_t *param) noexcept
+{
+    if (_txn_lock_holder != NULL) {
+        if (_txn_lock_holder != param) {
+            // Previous transaction was neither completed nor rolled back.
+            // This thread still holds the lock, so hand it over.
+            NAS_ACL_LOG_ERR ("Lock held by a stale transaction - taking over");
+            _txn_lock_holder = param;
+        }
+        return;
+    }
+
+    if (!_txn_lock_enabled) {
+        return;
+    }
+
+    // The async worker needs the lock to program queued Entries
+    nas_acl_async_drain ();
+
+    nas_acl_lock ();
+    _txn_lock_holder = param;
+}
+
+static void nas_acl_txn_lock_release (cps_api_transaction_params_t *param) noexcept
+{
+    if (_txn_lock_holder == NULL || _txn_lock_holder != param) {
+        return;
+    }
+
+    _txn_lock_holder = NULL;
+    nas_acl_unlock ();
+}
+
+void nas_acl_txn_lock_init () noexcept
+{
+    const char* txn_lock_str = getenv (NAS_ACL_TXN_LOCK_ENV);
+
+    if (txn_lock_str != NULL && strcmp (txn_lock_str, "1") == 0) {
+        nas_acl_txn_lock_enable (true);
+    }
+}
+
+// Taking the lock waits for the transaction in progress, if any
+void nas_acl_txn_lock_enable (bool enable) noexcept
+{
+    nas_acl_lock ();
+    _txn_lock_enabled = enable;
+    nas_acl_unlock ();
+
+    NAS_ACL_LOG_BRIEF ("Transaction lock mode %s",
+                       (enable) ? "enabled" : "disabled");
+}
+
+bool nas_acl_txn_lock_is_enabled () noexcept
+{
+    return _txn_lock_enabled;
+}
+
+// Locks needed by a request on the object - see nas_acl_lock.h.
+// Requests for a single Table take only that Table's lock.
+static nas_acl_lock_scope_t nas_acl_req_lock_scope (uint32_t         sub_category,
+                                                    cps_api_object_t obj,
+                                                    bool             read) noexcept
+{
+    nas_switch_id_t   switch_id;
+    nas_obj_id_t      table_id;
+    cps_api_attr_id_t table_attr;
+
+    nas_acl_cps_key_get_switch_id (obj, NAS_ACL_SWITCH_ATTR, &switch_id);
+
+    switch (sub_category) {
+        case BASE_ACL_TABLE_OBJ:
+            return nas_acl_lock_scope_t {(read) ? NAS_ACL_LOCK_TABLES :
+                                                  NAS_ACL_LOCK_SWITCH, switch_id};
+
+        case BASE_ACL_POOL_STATS_OBJ:
+            return nas_acl_lock_scope_t {NAS_ACL_LOCK_TABLES, switch_id};
+
+        case BASE_ACL_ENTRY_OBJ:   table_attr = BASE_ACL_ENTRY_TABLE_ID;   break;
+        case BASE_ACL_COUNTER_OBJ: table_attr = BASE_ACL_COUNTER_TABLE_ID; break;
+        case BASE_ACL_STATS_OBJ:   table_attr = BASE_ACL_STATS_TABLE_ID;   break;
+        case BASE_ACL_APPLY_OBJ:   table_attr = BASE_ACL_APPLY_TABLE_ID;   break;
+
+        default:
+            return nas_acl_lock_scope_t {};
+    }
+
+    if (!nas_acl_cps_key_get_obj_id (obj, table_attr, &table_id)) {
+        return nas_acl_lock_scope_t {NAS_ACL_LOCK_TABLES, switch_id};
+    }
+
+    return nas_acl_lock_scope_t {NAS_ACL_LOCK_TABLE, switch_id, table_id};
+}
 
 static inline t_std_error
 nas_acl_exec_write_op (nas_acl_write_operation_map_t *op_map,
                        cps_api_object_t               obj,
                        cps_api_object_t               prev,
-                       bool                           rollback) noexcept
+                       bool                           rollback,
+                       nas_acl_lock_scope_t&          scope,
+                       nas_acl_perf_req_t&            perf) noexcept
 {
     t_std_error rc;
+    bool        lock = (_txn_lock_holder == NULL);
 
-    nas_acl_lock ();
+    if (lock) {
+        scope.lock ();
+    }
+    perf.lock_acquired ();
     rc = op_map->fn (obj, prev, rollback);
-    nas_acl_unlock ();
+    perf.end ();
+    if (lock) {
+        scope.unlock ();
+    }
 
     return rc;
 }
@@ -49,6 +250,10 @@ nas_acl_cps_api_write_internal (void                         *context,
 {
     nas_acl_write_operation_map_t  *p_op_map = NULL;
     bool                            save_prev = !rollback;
+    // Entries are written in place while the transaction holds the lock
+    // - the async worker could not program them before it is released
+    bool                            async = (nas_acl_async_is_enabled () &&
+                                             _txn_lock_holder == NULL);
 
     if (cps_api_key_get_cat (cps_api_object_key (obj))
         != cps_api_obj_CAT_BASE_ACL) {
@@ -65,7 +270,8 @@ nas_acl_cps_api_write_internal (void                         *context,
             break;
 
         case BASE_ACL_ENTRY_OBJ:
-            p_op_map = nas_acl_get_entry_operation_map (op);
+            p_op_map = (async) ? nas_acl_get_entry_async_op_map (op) :
+                                 nas_acl_get_entry_operation_map (op);
             break;
 
         case BASE_ACL_COUNTER_OBJ:
@@ -80,6 +286,21 @@ nas_acl_cps_api_write_internal (void                         *context,
             save_prev = false;
             break;
 
+        case BASE_ACL_PERF_STATS_OBJ:
+            p_op_map = nas_acl_get_perf_stats_op_map (op);
+            save_prev = false;
+            break;
+
+        case BASE_ACL_APPLY_OBJ:
+            p_op_map = nas_acl_get_apply_op_map (op);
+            break;
+
+        case BASE_ACL_VALIDATE_OBJ:
+            // Dry run - changes nothing
+            p_op_map = nas_acl_get_validate_op_map (op);
+            save_prev = false;
+            break;
+
         default:
             return NAS_ACL_E_UNSUPPORTED;
     }
@@ -90,6 +311,12 @@ nas_acl_cps_api_write_internal (void                         *context,
         return NAS_ACL_E_UNSUPPORTED;
     }
 
+    if (async) {
+        nas_acl_async_wait (sub_category, obj, rollback);
+    }
+
+    nas_acl_perf_req_t perf (nas_acl_perf_obj (sub_category),
+                             nas_acl_perf_op (op));
     cps_api_object_t prev = NULL;
 
     if (save_prev) {
@@ -99,7 +326,9 @@ nas_acl_cps_api_write_internal (void                         *context,
         }
     }
 
-    return nas_acl_exec_write_op (p_op_map, obj, prev, rollback);
+    auto scope = nas_acl_req_lock_scope (sub_category, obj, false);
+
+    return nas_acl_exec_write_op (p_op_map, obj, prev, rollback, scope, perf);
 }
 
 cps_api_return_code_t
@@ -126,7 +355,11 @@ nas_acl_cps_api_read (void                 *context,
 
     NAS_ACL_LOG_BRIEF("Sub Category: %d", sub_category);
 
-    nas_acl_lock ();
+    nas_acl_perf_req_t perf (nas_acl_perf_obj (sub_category), NAS_ACL_PERF_OP_GET);
+    auto scope = nas_acl_req_lock_scope (sub_category, filter_obj, true);
+
+    scope.lock ();
+    perf.lock_acquired ();
 
     switch (sub_category) {
 
@@ -144,15 +377,53 @@ nas_acl_cps_api_read (void                 *context,
                                       (BASE_ACL_OBJECTS_t) sub_category);
             break;
 
+        case BASE_ACL_PERF_STATS_OBJ:
+            rc = nas_acl_get_perf_stats (param, index, filter_obj);
+            break;
+
+        case BASE_ACL_POOL_STATS_OBJ:
+            rc = nas_acl_get_pool_stats (param, index, filter_obj);
+            break;
+
         default:
             break;
     }
 
-    nas_acl_unlock ();
+    perf.end ();
+    scope.unlock ();
 
     return static_cast <cps_api_return_code_t> (rc);
 }
 
+// Validate the rest of the transaction before its first ACL object is
+// written, if enabled - see nas_acl_prepare.h. A transaction of a single
+// ACL object is validated by its own write before NDI.
+static t_std_error nas_acl_txn_prepare (cps_api_transaction_params_t *param,
+                                        size_t                        index) noexcept
+{
+    nas_acl_lock_scope_t     scope;
+    nas_acl_prepare_result_t result;
+    bool                     lock = (_txn_lock_holder == NULL);
+
+    if (lock) {
+        // Entries queued by earlier transactions must be in the cache
+        if (nas_acl_async_is_enabled ()) {
+            nas_acl_async_drain ();
+        }
+        scope.lock ();
+    }
+    nas_acl_prepare_list (param->change_list, index, &result);
+    if (lock) {
+        scope.unlock ();
+    }
+
+    if (result.rc != NAS_ACL_E_NONE) {
+        NAS_ACL_LOG_ERR ("Transaction rejected before NDI: object %ld would fail, Err 0x%x",
+                         result.fail_index, result.rc);
+    }
+    return result.rc;
+}
+
 cps_api_return_code_t
 nas_acl_cps_api_write (void                         *context,
                        cps_api_transaction_params_t *param,
@@ -170,7 +441,39 @@ nas_acl_cps_api_write (void                         *context,
 
     op = cps_api_object_type_operation (cps_api_object_key (obj));
 
+    bool last = nas_acl_is_last_obj (param, index);
+    bool first = nas_acl_is_first_obj (param, index);
+
+    if (first) {
+        // Records of a transaction that was not rolled back after a failed
+        // write. A stale transaction lock is held by this thread.
+        nas_acl_undo_reset (_txn_lock_holder == NULL);
+    }
+    nas_acl_txn_lock_take (param);
+
+    if (first && !last && nas_acl_prepare_is_enabled ()) {
+        auto rc = nas_acl_txn_prepare (param, index);
+        if (rc != NAS_ACL_E_NONE) {
+            nas_acl_txn_lock_release (param);
+            return static_cast<cps_api_return_code_t>(rc);
+        }
+    }
+    nas_acl_event_txn_begin (param, false);
     auto rc = nas_acl_cps_api_write_internal (context, param, obj, op, false);
+    nas_acl_event_txn_end (param, (rc == NAS_ACL_E_NONE), last);
+
+    // End of the transaction for the undo journal - see nas_acl_undo.h
+    if (rc != NAS_ACL_E_NONE && first) {
+        nas_acl_undo_reset (_txn_lock_holder == NULL);
+    } else if (rc == NAS_ACL_E_NONE && last) {
+        size_t count = cps_api_object_list_size (param->change_list);
+        nas_acl_undo_reset (_txn_lock_holder == NULL, (index + 1 < count));
+    }
+
+    // CPS rolls back the transaction on failure
+    if (last || rc != NAS_ACL_E_NONE) {
+        nas_acl_txn_lock_release (param);
+    }
     return static_cast<cps_api_return_code_t>(rc);
 }
 
@@ -194,28 +497,43 @@ nas_acl_cps_api_rollback (void                         *context,
     op = ((op == cps_api_oper_CREATE) ? cps_api_oper_DELETE :
           (op == cps_api_oper_DELETE) ? cps_api_oper_CREATE : op);
 
+    // Normally released by the failed write already
+    nas_acl_txn_lock_release (param);
+
+    // Entry Modify and Delete saved only the key in the prev object
+    nas_acl_undo_fill (obj);
+
+    nas_acl_event_txn_begin (param, true);
     auto rc = nas_acl_cps_api_write_internal (context, param, obj, op, true);
+    nas_acl_event_txn_end (param, (rc == NAS_ACL_E_NONE), false);
+
+    // Rollback is done with the first ACL object of the transaction
+    if (nas_acl_is_first_obj (param, index)) {
+        nas_acl_undo_reset (true);
+    }
     return static_cast<cps_api_return_code_t>(rc);
 }
 
-cps_api_object_attr_t nas_acl_get_attr (const cps_api_object_it_t& it,
-                                        cps_api_attr_id_t attr_id,
-                                        bool* is_dupl) noexcept
+void nas_acl_attr_index_t::build (const cps_api_object_it_t& it)
 {
-    auto attr = cps_api_object_it_find (&it, attr_id);
-    *is_dupl = false;
+    _it = it;
+    _slots.clear ();
 
-    if (attr == NULL) {
-        return NULL;
-    }
+    for (cps_api_object_it_t it_attr = it;
+         cps_api_object_it_valid (&it_attr);
+         cps_api_object_it_next (&it_attr)) {
 
-    // Move to the next attribute and try finding again to check for duplicates
-    cps_api_object_it_t  it_temp;
-    cps_api_object_it_from_attr (attr, &it_temp);
-    cps_api_object_it_next (&it_temp);
+        auto attr_id = cps_api_object_attr_id (it_attr.attr);
+        bool found = false;
 
-    if (cps_api_object_it_find (&it_temp, attr_id) != NULL) {
-        *is_dupl = true;
+        for (auto& slot: _slots) {
+            if (slot.attr_id == attr_id) {
+                slot.dupl = found = true;
+                break;
+            }
+        }
+        if (!found) {
+            _slots.push_back ({attr_id, it_attr.attr, false});
+        }
     }
-    return attr;
 }
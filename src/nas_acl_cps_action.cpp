@@ -38,32 +38,39 @@ void nas_acl_set_action_attr (const cps_api_object_t     obj,
                               nas_acl_entry&             entry,
                               BASE_ACL_ACTION_TYPE_t     action_type_val,
                               nas::attr_list_t&          parent_attr_id_list,
-                              bool                       reset)
+                              bool                       reset,
+                              const nas_acl_attr_index_t* index)
 {
-    nas_acl_common_data_list_t common_data_list;
-
-    auto map_kv = nas_acl_get_action_map().find (action_type_val);
+    auto map_info_p = nas_acl_get_action_info (action_type_val);
 
-    if (map_kv == nas_acl_get_action_map().end ()) {
+    if (map_info_p == NULL) {
         throw nas::base_exception {NAS_ACL_E_FAIL, __PRETTY_FUNCTION__,
                                    std::string {"Could not find action ("} +
                                    nas_acl_action_t::type_name (action_type_val)
                                     + " )"+ std::to_string(action_type_val) };
     }
 
-    const nas_acl_action_info_t& map_info = map_kv->second;
+    const nas_acl_action_info_t& map_info = *map_info_p;
     nas_acl_action_t action {action_type_val};
 
     if (map_info.val.data_type != NAS_ACL_DATA_NONE) {
 
         parent_attr_id_list.push_back (map_info.val.attr_id);
-        common_data_list.clear ();
 
-        auto common_data_list =
-            nas_acl_copy_data_from_obj (obj, parent_attr_id_list, map_info.val,
-                                        map_info.child_list, map_info.name);
+        if (map_info.decode_fn != NULL) {
+            cps_api_object_attr_t attrs [NAS_ACL_MAX_CHILD_ATTRS];
+
+            nas_acl_get_attrs_from_obj (obj, parent_attr_id_list, map_info.val,
+                                        map_info.child_list, map_info.name, index, attrs);
+            map_info.decode_fn (action, map_info.val, map_info.child_list,
+                                attrs, map_info.name);
+        } else {
+            auto common_data_list =
+                nas_acl_copy_data_from_obj (obj, parent_attr_id_list, map_info.val,
+                                            map_info.child_list, map_info.name, index);
 
-        (action.*(map_info.set_fn)) (common_data_list);
+            (action.*(map_info.set_fn)) (common_data_list);
+        }
     }
 
     entry.add_action (action, reset);
@@ -162,6 +169,7 @@ void nas_acl_set_action_list (const cps_api_object_t     obj,
     cps_api_object_it_t        it_action_list = it;
     cps_api_attr_id_t          list_index = 0;
     nas::attr_list_t           parent_attr_id_list;
+    nas_acl_attr_index_t       attr_index;
     nas_acl_common_data_list_t common_data_list;
 
     // Parent attr list to build attr hierarchy
@@ -189,15 +197,17 @@ void nas_acl_set_action_list (const cps_api_object_t     obj,
                                        "Missing list container for ACTION in object"};
         }
 
-        bool is_dupl;
-        auto attr_action_type = nas_acl_get_attr (it_action_attr,
-                                                 BASE_ACL_ENTRY_ACTION_TYPE, &is_dupl);
+        // Index the list element once - the Type and the Value
+        // attributes are then looked up from the index
+        attr_index.build (it_action_attr);
+
+        auto attr_action_type = attr_index.find (BASE_ACL_ENTRY_ACTION_TYPE);
 
         if (attr_action_type == NULL) {
             throw nas::base_exception {NAS_ACL_E_MISSING_ATTR, __PRETTY_FUNCTION__,
                                        "Missing ACTION_TYPE attribute"};
         }
-        if (is_dupl) {
+        if (attr_index.is_dupl (BASE_ACL_ENTRY_ACTION_TYPE)) {
             throw nas::base_exception {NAS_ACL_E_DUPLICATE, __PRETTY_FUNCTION__,
                                        "Duplicate ACTION_TYPE attribute"};
         }
@@ -209,7 +219,7 @@ void nas_acl_set_action_list (const cps_api_object_t     obj,
                             nas_acl_action_t::type_name (action_type_val));
 
         nas_acl_set_action_attr (obj, entry, action_type_val,
-                                 parent_attr_id_list, true);
+                                 parent_attr_id_list, true, &attr_index);
     }
 }
 
@@ -220,18 +230,27 @@ bool nas_acl_fill_action_attr (cps_api_object_t obj,
 {
     nas_acl_common_data_list_t common_data_list;
 
-    auto map_kv = nas_acl_get_action_map().find (action_type_val);
+    auto map_info_p = nas_acl_get_action_info (action_type_val);
 
-    if (map_kv == nas_acl_get_action_map().end ()) {
+    if (map_info_p == NULL) {
         return false;
     }
 
-    const nas_acl_action_info_t& map_info = map_kv->second;
+    const nas_acl_action_info_t& map_info = *map_info_p;
 
-    (action.*(map_info.get_fn)) (common_data_list);
+    if (map_info.val.data_type == NAS_ACL_DATA_NONE) {
+        // Action without a value - its type in the key is all there is
+        return true;
+    }
 
     parent_attr_id_list.push_back (map_info.val.attr_id);
 
+    if (map_info.encode_fn != NULL) {
+        return map_info.encode_fn (action, obj, parent_attr_id_list, map_info.child_list);
+    }
+
+    (action.*(map_info.get_fn)) (common_data_list);
+
     if (!nas_acl_copy_data_to_obj (obj, parent_attr_id_list, map_info.val,
                                    map_info.child_list, common_data_list)) {
         NAS_ACL_LOG_ERR ("nas_acl_copy_data_to_obj() failed for Match type %d (%s)",
@@ -261,13 +280,13 @@ nas_acl_fill_action_attr_list (cps_api_object_t obj, const nas_acl_entry& entry)
 
         action_type_val = action_kv.second.action_type ();
 
-        auto map_kv = nas_acl_get_action_map().find (action_type_val);
+        auto map_info_p = nas_acl_get_action_info (action_type_val);
 
-        if (map_kv == nas_acl_get_action_map().end ()) {
+        if (map_info_p == NULL) {
             return false;
         }
 
-        const nas_acl_action_info_t& map_info = map_kv->second;
+        const nas_acl_action_info_t& map_info = *map_info_p;
 
         parent_attr_id_list.clear ();
 
@@ -21,62 +21,45 @@
  * \brief  This file contains ACL Entry Action Map table initiazation
  */
 #include "nas_acl_cps.h"
+#include "nas_acl_cps_codec.h"
 #include "nas_vlan_consts.h"
 #include "nas_qos_consts.h"
 #include "nas_acl_common.h"
+#include <string.h>
 
 /*
-    nas_acl_map_data_t          val;
-    nas_acl_map_data_list_t     child_list;
-    nas_acl_action_get_fn_ptr_t get_fn;
-    nas_acl_action_set_fn_ptr_t set_fn;
+ * Indexed by BASE_ACL_ACTION_TYPE_t starting from the type of the first slot.
+ * Slots must stay in enum order with no gaps - checked at compile time below.
  */
-static const nas_acl_action_map_t _action_map =
+static constexpr nas_acl_action_info_t _action_map [] =
 {
-    {BASE_ACL_ACTION_TYPE_PACKET_ACTION,
+    {
+        BASE_ACL_ACTION_TYPE_REDIRECT_PORT,
+        "ACTION_TYPE_REDIRECT_PORT",
         {
-            "ACTION_TYPE_PACKET_ACTION",
-            {
-                BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE,
-                NAS_ACL_DATA_U32,
-                sizeof (uint32_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
-            {
-                {},
-            },
-            &nas_acl_action_t::get_pkt_action_val,
-            &nas_acl_action_t::set_pkt_action_val,
+            BASE_ACL_ENTRY_ACTION_REDIRECT_PORT_VALUE,
+            NAS_ACL_DATA_IFINDEX,
+            sizeof(uint32_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
+            {},
         },
+        {},
+        &nas_acl_action_t::get_action_ifindex,
+        &nas_acl_action_t::set_action_ifindex,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_ACTION_TYPE_REDIRECT_PORT,
+    {
+        BASE_ACL_ACTION_TYPE_REDIRECT_IP_NEXTHOP,
+        "ACTION_TYPE_REDIRECT_IP_NEXTHOP",
         {
-            "ACTION_TYPE_REDIRECT_PORT",
-            {
-                BASE_ACL_ENTRY_ACTION_REDIRECT_PORT_VALUE,
-                NAS_ACL_DATA_IFINDEX,
-                sizeof(uint32_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
-            {
-                {},
-            },
-            &nas_acl_action_t::get_action_ifindex,
-            &nas_acl_action_t::set_action_ifindex,
+            BASE_ACL_ENTRY_ACTION_IP_NEXTHOP_GROUP_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
         },
-    },
-
-    {BASE_ACL_ACTION_TYPE_REDIRECT_IP_NEXTHOP,
         {
-            "ACTION_TYPE_REDIRECT_IP_NEXTHOP",
-            {
-                BASE_ACL_ENTRY_ACTION_IP_NEXTHOP_GROUP_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            2,
             {
                 {
                     BASE_ACL_ENTRY_ACTION_IP_NEXTHOP_GROUP_VALUE_ID,
@@ -93,31 +76,55 @@ static const nas_acl_action_map_t _action_map =
                     {},
                 },
             },
-            &nas_acl_action_t::get_opaque_data_action_val,
-            &nas_acl_action_t::set_opaque_data_action_val,
         },
+        &nas_acl_action_t::get_opaque_data_action_val,
+        &nas_acl_action_t::set_opaque_data_action_val,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_ACTION_TYPE_FLOOD,
+    {
+        BASE_ACL_ACTION_TYPE_PACKET_ACTION,
+        "ACTION_TYPE_PACKET_ACTION",
         {
-            "ACTION_TYPE_FLOOD",
-            {
-                0, NAS_ACL_DATA_NONE, {},
-            },
+            BASE_ACL_ENTRY_ACTION_PACKET_ACTION_VALUE,
+            NAS_ACL_DATA_U32,
+            sizeof (uint32_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            NULL,
-            NULL,
         },
+        {},
+        &nas_acl_action_t::get_pkt_action_val,
+        &nas_acl_action_t::set_pkt_action_val,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_ACTION_TYPE_MIRROR_INGRESS,
+    {
+        BASE_ACL_ACTION_TYPE_FLOOD,
+        "ACTION_TYPE_FLOOD",
         {
-            "ACTION_TYPE_MIRROR_INGRESS",
-            {
-                BASE_ACL_ENTRY_ACTION_MIRROR_INGRESS_VALUE,
-                NAS_ACL_DATA_EMBEDDED_LIST,
-                {},
-            },
+            0,
+            NAS_ACL_DATA_NONE,
+            {},
+        },
+        {},
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+    },
+
+    {
+        BASE_ACL_ACTION_TYPE_MIRROR_INGRESS,
+        "ACTION_TYPE_MIRROR_INGRESS",
+        {
+            BASE_ACL_ENTRY_ACTION_MIRROR_INGRESS_VALUE,
+            NAS_ACL_DATA_EMBEDDED_LIST,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_ACTION_MIRROR_INGRESS_VALUE_INDEX,
@@ -134,19 +141,23 @@ static const nas_acl_action_map_t _action_map =
                     {},
                 },
             },
-            &nas_acl_action_t::get_opaque_data_action_val,
-            &nas_acl_action_t::set_opaque_data_list_action_val,
         },
+        &nas_acl_action_t::get_opaque_data_action_val,
+        &nas_acl_action_t::set_opaque_data_list_action_val,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_ACTION_TYPE_MIRROR_EGRESS,
+    {
+        BASE_ACL_ACTION_TYPE_MIRROR_EGRESS,
+        "ACTION_TYPE_MIRROR_EGRESS",
         {
-            "ACTION_TYPE_MIRROR_EGRESS",
-            {
-                BASE_ACL_ENTRY_ACTION_MIRROR_EGRESS_VALUE,
-                NAS_ACL_DATA_EMBEDDED_LIST,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_MIRROR_EGRESS_VALUE,
+            NAS_ACL_DATA_EMBEDDED_LIST,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_ACTION_MIRROR_EGRESS_VALUE_INDEX,
@@ -163,35 +174,40 @@ static const nas_acl_action_map_t _action_map =
                     {},
                 },
             },
-            &nas_acl_action_t::get_opaque_data_action_val,
-            &nas_acl_action_t::set_opaque_data_list_action_val,
         },
+        &nas_acl_action_t::get_opaque_data_action_val,
+        &nas_acl_action_t::set_opaque_data_list_action_val,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_COUNTER,
+    {
+        BASE_ACL_ACTION_TYPE_SET_COUNTER,
+        "ACTION_TYPE_SET_COUNTER",
         {
-            "ACTION_TYPE_SET_COUNTER",
-            {
-                BASE_ACL_ENTRY_ACTION_COUNTER_VALUE,
-                NAS_ACL_DATA_OBJ_ID,
-                sizeof (nas_obj_id_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_COUNTER_VALUE,
+            NAS_ACL_DATA_OBJ_ID,
+            sizeof (nas_obj_id_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_action_t::get_obj_id_action_val,
-            &nas_acl_action_t::set_obj_id_action_val,
         },
+        {},
+        &nas_acl_action_t::get_obj_id_action_val,
+        &nas_acl_action_t::set_obj_id_action_val,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_POLICER,
+    {
+        BASE_ACL_ACTION_TYPE_SET_POLICER,
+        "ACTION_TYPE_SET_POLICER",
         {
-            "ACTION_TYPE_SET_POLICER",
-            {
-                BASE_ACL_ENTRY_ACTION_POLICER_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_POLICER_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_ACTION_POLICER_VALUE_INDEX,
@@ -208,255 +224,276 @@ static const nas_acl_action_map_t _action_map =
                     {},
                 },
             },
-            &nas_acl_action_t::get_opaque_data_action_val,
-            &nas_acl_action_t::set_opaque_data_action_val,
         },
+        &nas_acl_action_t::get_opaque_data_action_val,
+        &nas_acl_action_t::set_opaque_data_action_val,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_ACTION_TYPE_DECREMENT_TTL,
+    {
+        BASE_ACL_ACTION_TYPE_DECREMENT_TTL,
+        "ACTION_TYPE_DECREMENT_TTL",
         {
-            "ACTION_TYPE_DECREMENT_TTL",
-            {
-                0, NAS_ACL_DATA_NONE, {},
-            },
+            0,
+            NAS_ACL_DATA_NONE,
             {},
-            NULL,
-            NULL,
         },
+        {},
+        NULL,
+        NULL,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_TC,
+    {
+        BASE_ACL_ACTION_TYPE_SET_TC,
+        "ACTION_TYPE_SET_TC",
         {
-            "ACTION_TYPE_SET_TC",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_TC_VALUE,
-                NAS_ACL_DATA_U8,
-                sizeof (uint8_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_NEW_TC_VALUE,
+            NAS_ACL_DATA_U8,
+            sizeof (uint8_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_action_t::get_u8_action_val,
-            &nas_acl_action_t::set_u8_action_val,
         },
+        {},
+        &nas_acl_action_t::get_u8_action_val,
+        &nas_acl_action_t::set_u8_action_val,
+        &nas_acl_action_decode<uint8_t, NDI_ACL_ACTION_U8>,
+        &nas_acl_action_encode<uint8_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_INNER_VLAN_ID,
+    {
+        BASE_ACL_ACTION_TYPE_SET_INNER_VLAN_ID,
+        "ACTION_TYPE_SET_INNER_VLAN_ID",
         {
-            "ACTION_TYPE_SET_INNER_VLAN_ID",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_INNER_VLAN_ID_VALUE,
-                NAS_ACL_DATA_U16,
-                sizeof (uint16_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {1, NAS_MAX_VLAN_ID},
-            },
-            {},
-            &nas_acl_action_t::get_u16_action_val,
-            &nas_acl_action_t::set_u16_action_val,
+            BASE_ACL_ENTRY_ACTION_NEW_INNER_VLAN_ID_VALUE,
+            NAS_ACL_DATA_U16,
+            sizeof (uint16_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
+            {1, NAS_MAX_VLAN_ID},
         },
+        {},
+        &nas_acl_action_t::get_u16_action_val,
+        &nas_acl_action_t::set_u16_action_val,
+        &nas_acl_action_decode<uint16_t, NDI_ACL_ACTION_U16>,
+        &nas_acl_action_encode<uint16_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_INNER_VLAN_PRI,
+    {
+        BASE_ACL_ACTION_TYPE_SET_INNER_VLAN_PRI,
+        "ACTION_TYPE_SET_INNER_VLAN_PRI",
         {
-            "ACTION_TYPE_SET_INNER_VLAN_PRI",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_INNER_VLAN_PRI_VALUE,
-                NAS_ACL_DATA_U8,
-                sizeof (uint8_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {0, NAS_MAX_DOT1P},
-            },
-            {},
-            &nas_acl_action_t::get_u8_action_val,
-            &nas_acl_action_t::set_u8_action_val,
+            BASE_ACL_ENTRY_ACTION_NEW_INNER_VLAN_PRI_VALUE,
+            NAS_ACL_DATA_U8,
+            sizeof (uint8_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
+            {0, NAS_MAX_DOT1P},
         },
+        {},
+        &nas_acl_action_t::get_u8_action_val,
+        &nas_acl_action_t::set_u8_action_val,
+        &nas_acl_action_decode<uint8_t, NDI_ACL_ACTION_U8>,
+        &nas_acl_action_encode<uint8_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_OUTER_VLAN_ID,
+    {
+        BASE_ACL_ACTION_TYPE_SET_OUTER_VLAN_ID,
+        "ACTION_TYPE_SET_OUTER_VLAN_ID",
         {
-            "ACTION_TYPE_SET_OUTER_VLAN_ID",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_OUTER_VLAN_ID_VALUE,
-                NAS_ACL_DATA_U16,
-                sizeof (uint16_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {1, NAS_MAX_VLAN_ID},
-            },
-            {},
-            &nas_acl_action_t::get_u16_action_val,
-            &nas_acl_action_t::set_u16_action_val,
+            BASE_ACL_ENTRY_ACTION_NEW_OUTER_VLAN_ID_VALUE,
+            NAS_ACL_DATA_U16,
+            sizeof (uint16_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
+            {1, NAS_MAX_VLAN_ID},
         },
+        {},
+        &nas_acl_action_t::get_u16_action_val,
+        &nas_acl_action_t::set_u16_action_val,
+        &nas_acl_action_decode<uint16_t, NDI_ACL_ACTION_U16>,
+        &nas_acl_action_encode<uint16_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_OUTER_VLAN_PRI,
+    {
+        BASE_ACL_ACTION_TYPE_SET_OUTER_VLAN_PRI,
+        "ACTION_TYPE_SET_OUTER_VLAN_PRI",
         {
-            "ACTION_TYPE_SET_OUTER_VLAN_PRI",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_OUTER_VLAN_PRI_VALUE,
-                NAS_ACL_DATA_U8,
-                sizeof (uint8_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {0, NAS_MAX_DOT1P},
-            },
-            {},
-            &nas_acl_action_t::get_u8_action_val,
-            &nas_acl_action_t::set_u8_action_val,
+            BASE_ACL_ENTRY_ACTION_NEW_OUTER_VLAN_PRI_VALUE,
+            NAS_ACL_DATA_U8,
+            sizeof (uint8_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
+            {0, NAS_MAX_DOT1P},
         },
+        {},
+        &nas_acl_action_t::get_u8_action_val,
+        &nas_acl_action_t::set_u8_action_val,
+        &nas_acl_action_decode<uint8_t, NDI_ACL_ACTION_U8>,
+        &nas_acl_action_encode<uint8_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_SRC_MAC,
+    {
+        BASE_ACL_ACTION_TYPE_SET_SRC_MAC,
+        "ACTION_TYPE_SET_SRC_MAC",
         {
-            "ACTION_TYPE_SET_SRC_MAC",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_SRC_MAC_VALUE,
-                NAS_ACL_DATA_BIN,
-                HAL_MAC_ADDR_LEN,
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_NEW_SRC_MAC_VALUE,
+            NAS_ACL_DATA_BIN,
+            HAL_MAC_ADDR_LEN,
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_action_t::get_mac_action_val,
-            &nas_acl_action_t::set_mac_action_val,
         },
+        {},
+        &nas_acl_action_t::get_mac_action_val,
+        &nas_acl_action_t::set_mac_action_val,
+        &nas_acl_action_decode<hal_mac_addr_t, NDI_ACL_ACTION_MAC_ADDR>,
+        &nas_acl_action_encode<hal_mac_addr_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_DST_MAC,
+    {
+        BASE_ACL_ACTION_TYPE_SET_DST_MAC,
+        "ACTION_TYPE_SET_DST_MAC",
         {
-            "ACTION_TYPE_SET_DST_MAC",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_DST_MAC_VALUE,
-                NAS_ACL_DATA_BIN,
-                HAL_MAC_ADDR_LEN,
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_NEW_DST_MAC_VALUE,
+            NAS_ACL_DATA_BIN,
+            HAL_MAC_ADDR_LEN,
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_action_t::get_mac_action_val,
-            &nas_acl_action_t::set_mac_action_val,
         },
+        {},
+        &nas_acl_action_t::get_mac_action_val,
+        &nas_acl_action_t::set_mac_action_val,
+        &nas_acl_action_decode<hal_mac_addr_t, NDI_ACL_ACTION_MAC_ADDR>,
+        &nas_acl_action_encode<hal_mac_addr_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_SRC_IP,
+    {
+        BASE_ACL_ACTION_TYPE_SET_SRC_IP,
+        "ACTION_TYPE_SET_SRC_IP",
         {
-            "ACTION_TYPE_SET_SRC_IP",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_SRC_IP_VALUE,
-                NAS_ACL_DATA_BIN,
-                sizeof (dn_ipv4_addr_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_NEW_SRC_IP_VALUE,
+            NAS_ACL_DATA_BIN,
+            sizeof (dn_ipv4_addr_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_action_t::get_ipv4_action_val,
-            &nas_acl_action_t::set_ipv4_action_val,
         },
+        {},
+        &nas_acl_action_t::get_ipv4_action_val,
+        &nas_acl_action_t::set_ipv4_action_val,
+        &nas_acl_action_decode<dn_ipv4_addr_t, NDI_ACL_ACTION_IPV4_ADDR>,
+        &nas_acl_action_encode<dn_ipv4_addr_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_DST_IP,
+    {
+        BASE_ACL_ACTION_TYPE_SET_DST_IP,
+        "ACTION_TYPE_SET_DST_IP",
         {
-            "ACTION_TYPE_SET_DST_IP",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_DST_IP_VALUE,
-                NAS_ACL_DATA_BIN,
-                sizeof (dn_ipv4_addr_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_NEW_DST_IP_VALUE,
+            NAS_ACL_DATA_BIN,
+            sizeof (dn_ipv4_addr_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_action_t::get_ipv4_action_val,
-            &nas_acl_action_t::set_ipv4_action_val,
         },
+        {},
+        &nas_acl_action_t::get_ipv4_action_val,
+        &nas_acl_action_t::set_ipv4_action_val,
+        &nas_acl_action_decode<dn_ipv4_addr_t, NDI_ACL_ACTION_IPV4_ADDR>,
+        &nas_acl_action_encode<dn_ipv4_addr_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_SRC_IPV6,
+    {
+        BASE_ACL_ACTION_TYPE_SET_SRC_IPV6,
+        "ACTION_TYPE_SET_SRC_IPV6",
         {
-            "ACTION_TYPE_SET_SRC_IPV6",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_SRC_IPV6_VALUE,
-                NAS_ACL_DATA_BIN,
-                sizeof (dn_ipv6_addr_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_NEW_SRC_IPV6_VALUE,
+            NAS_ACL_DATA_BIN,
+            sizeof (dn_ipv6_addr_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_action_t::get_ipv6_action_val,
-            &nas_acl_action_t::set_ipv6_action_val,
         },
+        {},
+        &nas_acl_action_t::get_ipv6_action_val,
+        &nas_acl_action_t::set_ipv6_action_val,
+        &nas_acl_action_decode<dn_ipv6_addr_t, NDI_ACL_ACTION_IPV6_ADDR>,
+        &nas_acl_action_encode<dn_ipv6_addr_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_DST_IPV6,
+    {
+        BASE_ACL_ACTION_TYPE_SET_DST_IPV6,
+        "ACTION_TYPE_SET_DST_IPV6",
         {
-            "ACTION_TYPE_SET_DST_IPV6",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_DST_IPV6_VALUE,
-                NAS_ACL_DATA_BIN,
-                sizeof (dn_ipv6_addr_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_NEW_DST_IPV6_VALUE,
+            NAS_ACL_DATA_BIN,
+            sizeof (dn_ipv6_addr_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_action_t::get_ipv6_action_val,
-            &nas_acl_action_t::set_ipv6_action_val,
         },
+        {},
+        &nas_acl_action_t::get_ipv6_action_val,
+        &nas_acl_action_t::set_ipv6_action_val,
+        &nas_acl_action_decode<dn_ipv6_addr_t, NDI_ACL_ACTION_IPV6_ADDR>,
+        &nas_acl_action_encode<dn_ipv6_addr_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_DSCP,
+    {
+        BASE_ACL_ACTION_TYPE_SET_DSCP,
+        "ACTION_TYPE_SET_DSCP",
         {
-            "ACTION_TYPE_SET_DSCP",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_DSCP_VALUE,
-                NAS_ACL_DATA_U8,
-                sizeof (uint8_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {0, NAS_MAX_DSCP},
-            },
-            {},
-            &nas_acl_action_t::get_u8_action_val,
-            &nas_acl_action_t::set_u8_action_val,
+            BASE_ACL_ENTRY_ACTION_NEW_DSCP_VALUE,
+            NAS_ACL_DATA_U8,
+            sizeof (uint8_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
+            {0, NAS_MAX_DSCP},
         },
+        {},
+        &nas_acl_action_t::get_u8_action_val,
+        &nas_acl_action_t::set_u8_action_val,
+        &nas_acl_action_decode<uint8_t, NDI_ACL_ACTION_U8>,
+        &nas_acl_action_encode<uint8_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_L4_SRC_PORT,
+    {
+        BASE_ACL_ACTION_TYPE_SET_L4_SRC_PORT,
+        "ACTION_TYPE_SET_L4_SRC_PORT",
         {
-            "ACTION_TYPE_SET_L4_SRC_PORT",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_L4_SRC_PORT_VALUE,
-                NAS_ACL_DATA_U16,
-                sizeof (uint16_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_NEW_L4_SRC_PORT_VALUE,
+            NAS_ACL_DATA_U16,
+            sizeof (uint16_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_action_t::get_u16_action_val,
-            &nas_acl_action_t::set_u16_action_val,
         },
+        {},
+        &nas_acl_action_t::get_u16_action_val,
+        &nas_acl_action_t::set_u16_action_val,
+        &nas_acl_action_decode<uint16_t, NDI_ACL_ACTION_U16>,
+        &nas_acl_action_encode<uint16_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_L4_DST_PORT,
+    {
+        BASE_ACL_ACTION_TYPE_SET_L4_DST_PORT,
+        "ACTION_TYPE_SET_L4_DST_PORT",
         {
-            "ACTION_TYPE_SET_L4_DST_PORT",
-            {
-                BASE_ACL_ENTRY_ACTION_NEW_L4_DST_PORT_VALUE,
-                NAS_ACL_DATA_U16,
-                sizeof (uint16_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_NEW_L4_DST_PORT_VALUE,
+            NAS_ACL_DATA_U16,
+            sizeof (uint16_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_action_t::get_u16_action_val,
-            &nas_acl_action_t::set_u16_action_val,
         },
+        {},
+        &nas_acl_action_t::get_u16_action_val,
+        &nas_acl_action_t::set_u16_action_val,
+        &nas_acl_action_decode<uint16_t, NDI_ACL_ACTION_U16>,
+        &nas_acl_action_encode<uint16_t>,
     },
 
-    {BASE_ACL_ACTION_TYPE_SET_CPU_QUEUE,
+    {
+        BASE_ACL_ACTION_TYPE_SET_CPU_QUEUE,
+        "ACTION_TYPE_SET_CPU_QUEUE",
         {
-            "ACTION_TYPE_SET_CPU_QUEUE",
-            {
-                BASE_ACL_ENTRY_ACTION_CPU_QUEUE_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_ACTION_CPU_QUEUE_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_ACTION_CPU_QUEUE_VALUE_INDEX,
@@ -473,62 +510,135 @@ static const nas_acl_action_map_t _action_map =
                     {},
                 },
             },
-            &nas_acl_action_t::get_opaque_data_action_val,
-            &nas_acl_action_t::set_opaque_data_action_val,
         },
+        &nas_acl_action_t::get_opaque_data_action_val,
+        &nas_acl_action_t::set_opaque_data_action_val,
+        NULL,
+        NULL,
     },
-    {BASE_ACL_ACTION_TYPE_EGRESS_MASK,
+
+    {
+        BASE_ACL_ACTION_TYPE_EGRESS_MASK,
+        "ACTION_TYPE_EGRESS_MASK",
         {
-            "ACTION_TYPE_EGRESS_MASK",
-            {
-                BASE_ACL_ENTRY_ACTION_EGRESS_MASK_VALUE,
-                NAS_ACL_DATA_IFLIST,
-                {},
-            },
-            {
-                {},
-            },
-            &nas_acl_action_t::get_action_ifindex_list,
-            &nas_acl_action_t::set_action_ifindex_list,
+            BASE_ACL_ENTRY_ACTION_EGRESS_MASK_VALUE,
+            NAS_ACL_DATA_IFLIST,
+            {},
         },
+        {},
+        &nas_acl_action_t::get_action_ifindex_list,
+        &nas_acl_action_t::set_action_ifindex_list,
+        NULL,
+        NULL,
     },
-    {BASE_ACL_ACTION_TYPE_REDIRECT_PORT_LIST,
+
+    {
+        BASE_ACL_ACTION_TYPE_REDIRECT_PORT_LIST,
+        "ACTION_TYPE_REDIRECT_PORT_LIST",
         {
-            "ACTION_TYPE_REDIRECT_PORT_LIST",
-            {
-                BASE_ACL_ENTRY_ACTION_REDIRECT_PORT_LIST_VALUE,
-                NAS_ACL_DATA_IFLIST,
-                {},
-            },
-            {
-                {},
-            },
-            &nas_acl_action_t::get_action_ifindex_list,
-            &nas_acl_action_t::set_action_ifindex_list,
+            BASE_ACL_ENTRY_ACTION_REDIRECT_PORT_LIST_VALUE,
+            NAS_ACL_DATA_IFLIST,
+            {},
         },
+        {},
+        &nas_acl_action_t::get_action_ifindex_list,
+        &nas_acl_action_t::set_action_ifindex_list,
+        NULL,
+        NULL,
     },
 };
 
+static constexpr size_t _action_map_size = sizeof (_action_map) / sizeof (_action_map[0]);
+
+static constexpr bool _action_map_in_order (size_t idx)
+{
+    return ((idx == _action_map_size) ||
+            (((size_t) _action_map[idx].type == (size_t) _action_map[0].type + idx) &&
+             _action_map_in_order (idx + 1)));
+}
+
+static_assert (_action_map_in_order (0),
+               "_action_map must have one slot per BASE_ACL_ACTION_TYPE_t in enum order");
+
+/*
+ * Never called. Breaks the build when the model adds an Action type
+ * that is not listed here - add the new type to _action_map as well.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wswitch"
+static inline bool _action_map_has_type (BASE_ACL_ACTION_TYPE_t type) noexcept
+{
+    switch (type) {
+        case BASE_ACL_ACTION_TYPE_REDIRECT_PORT:
+        case BASE_ACL_ACTION_TYPE_REDIRECT_IP_NEXTHOP:
+        case BASE_ACL_ACTION_TYPE_PACKET_ACTION:
+        case BASE_ACL_ACTION_TYPE_FLOOD:
+        case BASE_ACL_ACTION_TYPE_MIRROR_INGRESS:
+        case BASE_ACL_ACTION_TYPE_MIRROR_EGRESS:
+        case BASE_ACL_ACTION_TYPE_SET_COUNTER:
+        case BASE_ACL_ACTION_TYPE_SET_POLICER:
+        case BASE_ACL_ACTION_TYPE_DECREMENT_TTL:
+        case BASE_ACL_ACTION_TYPE_SET_TC:
+        case BASE_ACL_ACTION_TYPE_SET_INNER_VLAN_ID:
+        case BASE_ACL_ACTION_TYPE_SET_INNER_VLAN_PRI:
+        case BASE_ACL_ACTION_TYPE_SET_OUTER_VLAN_ID:
+        case BASE_ACL_ACTION_TYPE_SET_OUTER_VLAN_PRI:
+        case BASE_ACL_ACTION_TYPE_SET_SRC_MAC:
+        case BASE_ACL_ACTION_TYPE_SET_DST_MAC:
+        case BASE_ACL_ACTION_TYPE_SET_SRC_IP:
+        case BASE_ACL_ACTION_TYPE_SET_DST_IP:
+        case BASE_ACL_ACTION_TYPE_SET_SRC_IPV6:
+        case BASE_ACL_ACTION_TYPE_SET_DST_IPV6:
+        case BASE_ACL_ACTION_TYPE_SET_DSCP:
+        case BASE_ACL_ACTION_TYPE_SET_L4_SRC_PORT:
+        case BASE_ACL_ACTION_TYPE_SET_L4_DST_PORT:
+        case BASE_ACL_ACTION_TYPE_SET_CPU_QUEUE:
+        case BASE_ACL_ACTION_TYPE_EGRESS_MASK:
+        case BASE_ACL_ACTION_TYPE_REDIRECT_PORT_LIST:
+            return true;
+    }
+    return false;
+}
+#pragma GCC diagnostic pop
+
+const nas_acl_action_info_t* nas_acl_get_action_info (BASE_ACL_ACTION_TYPE_t type) noexcept
+{
+    size_t idx = (size_t) type - (size_t) _action_map[0].type;
+
+    if (idx >= _action_map_size) {
+        return NULL;
+    }
+    return &_action_map[idx];
+}
+
 const char* nas_acl_action_type_name (BASE_ACL_ACTION_TYPE_t type) noexcept
 {
-    auto it = _action_map.find (type);
-    if (it == _action_map.end()) {
+    auto map_info = nas_acl_get_action_info (type);
+    if (map_info == NULL) {
         return "Invalid Action Type";
     }
-    return it->second.name.c_str();
+    return map_info->name;
 }
 
-bool nas_acl_action_is_type_valid (BASE_ACL_ACTION_TYPE_t a_type) noexcept
+// Accepts the model enum name with or without the "ACTION_TYPE_" prefix
+bool nas_acl_action_type_from_name (const char* name, BASE_ACL_ACTION_TYPE_t* type) noexcept
 {
-    if (_action_map.find (a_type) == _action_map.end()) {
-        return false;
+    static constexpr size_t prefix_len = sizeof ("ACTION_TYPE_") - 1;
+
+    if (strncmp (name, "ACTION_TYPE_", prefix_len) == 0) {
+        name += prefix_len;
     }
 
-    return true;
+    for (size_t idx = 0; idx < _action_map_size; idx++) {
+        if (strcmp (_action_map[idx].name + prefix_len, name) == 0) {
+            *type = _action_map[idx].type;
+            return true;
+        }
+    }
+    return false;
 }
 
-nas_acl_action_map_t& nas_acl_get_action_map () noexcept
+bool nas_acl_action_is_type_valid (BASE_ACL_ACTION_TYPE_t a_type) noexcept
 {
-    return (_action_map);
+    return (nas_acl_get_action_info (a_type) != NULL);
 }
-
@@ -31,6 +31,9 @@
 #include "nas_switch.h"
 #include "nas_acl_cps_key.h"
 #include "nas_acl_utl.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_event.h"
+#include "nas_acl_cps_page.h"
 
 static t_std_error
 nas_acl_counter_create (cps_api_object_t obj,
@@ -171,29 +174,33 @@ static t_std_error
 nas_acl_get_counter_info_by_table (cps_api_get_params_t  *param,
                                  size_t                 index,
                                  const nas_acl_table&   table,
-                                 BASE_ACL_OBJECTS_t     obj_type) noexcept
+                                 BASE_ACL_OBJECTS_t     obj_type,
+                                 nas_acl_get_page_t&    page) noexcept
 {
     nas_acl_switch& s = table.get_switch ();
+    const auto& counters = s.counter_list (table.table_id());
 
-    for (const auto& counter_pair: s.counter_list (table.table_id())) {
+    for (auto it = page.first_obj (counters, s.id(), table.table_id());
+         it != counters.end() && page.take (); ++it) {
         t_std_error  rc;
 
         switch (obj_type) {
         case BASE_ACL_COUNTER_OBJ:
             if ((rc = nas_acl_get_counter_info (param, index,
-                    counter_pair.second)) != NAS_ACL_E_NONE) {
+                    it->second)) != NAS_ACL_E_NONE) {
                 return rc;
             }
             break;
         case BASE_ACL_STATS_OBJ:
             if ((rc = nas_acl_stats_info_get (param, index,
-                    counter_pair.second)) != NAS_ACL_E_NONE) {
+                    it->second)) != NAS_ACL_E_NONE) {
                 return rc;
             }
             break;
         default:
             break;
         }
+        page.added (s.id(), table.table_id(), it->first);
     }
     return NAS_ACL_E_NONE;
 }
@@ -202,13 +209,17 @@ static t_std_error
 nas_acl_get_counter_info_by_switch (cps_api_get_params_t  *param,
                                   size_t                 index,
                                   const nas_acl_switch&  s,
-                                  BASE_ACL_OBJECTS_t     obj_type) noexcept
+                                  BASE_ACL_OBJECTS_t     obj_type,
+                                  nas_acl_get_page_t&    page) noexcept
 {
-    for (const auto& tbl_kvp: s.table_list ()) {
+    const auto& tables = s.table_list ();
+
+    for (auto it = page.first_table (tables, s.id());
+         it != tables.end() && !page.more (); ++it) {
         t_std_error  rc;
 
-        if ((rc = nas_acl_get_counter_info_by_table (param, index, tbl_kvp.second,
-                obj_type)) != NAS_ACL_E_NONE) {
+        if ((rc = nas_acl_get_counter_info_by_table (param, index, it->second,
+                obj_type, page)) != NAS_ACL_E_NONE) {
             return rc;
         }
     }
@@ -218,13 +229,17 @@ nas_acl_get_counter_info_by_switch (cps_api_get_params_t  *param,
 static
 t_std_error nas_acl_get_counter_info_all (cps_api_get_params_t *param,
                                                   size_t               index,
-                                                  BASE_ACL_OBJECTS_t   obj_type) noexcept
+                                                  BASE_ACL_OBJECTS_t   obj_type,
+                                                  nas_acl_get_page_t&  page) noexcept
 {
-    for (const auto& switch_pair: nas_acl_get_switch_list ()) {
+    const auto& switches = nas_acl_get_switch_list ();
+
+    for (auto it = page.first_switch (switches);
+         it != switches.end() && !page.more (); ++it) {
         t_std_error  rc;
 
         if ((rc = nas_acl_get_counter_info_by_switch (param,
-                index, switch_pair.second, obj_type)) != NAS_ACL_E_NONE) {
+                index, it->second, obj_type, page)) != NAS_ACL_E_NONE) {
             return rc;
         }
     }
@@ -242,14 +257,26 @@ nas_acl_get_counter (cps_api_get_params_t *param, size_t index,
     nas_obj_id_t           counter_id;
     nas_attr_id_t          table_id_attr_id;
     nas_attr_id_t          counter_id_attr_id;
+    nas_attr_id_t          limit_attr_id;
+    nas_attr_id_t          cursor_attr_id;
 
     if (obj_type == BASE_ACL_COUNTER_OBJ) {
         table_id_attr_id  = BASE_ACL_COUNTER_TABLE_ID;
         counter_id_attr_id  = BASE_ACL_COUNTER_ID;
+        limit_attr_id  = BASE_ACL_COUNTER_GET_LIMIT;
+        cursor_attr_id  = BASE_ACL_COUNTER_GET_CURSOR;
     }
     else {
         table_id_attr_id  = BASE_ACL_STATS_TABLE_ID;
         counter_id_attr_id  = BASE_ACL_STATS_COUNTER_ID;
+        limit_attr_id  = BASE_ACL_STATS_GET_LIMIT;
+        cursor_attr_id  = BASE_ACL_STATS_GET_CURSOR;
+    }
+
+    nas_acl_get_page_t page (filter_obj, limit_attr_id, cursor_attr_id);
+
+    if (!page.valid ()) {
+        return NAS_ACL_E_ATTR_VAL;
     }
 
     bool switch_id_key = nas_acl_cps_key_get_switch_id (filter_obj,
@@ -265,19 +292,19 @@ nas_acl_get_counter (cps_api_get_params_t *param, size_t index,
     try {
         if (!switch_id_key) {
             /* No keys provided */
-            rc = nas_acl_get_counter_info_all (param, index, obj_type);
+            rc = nas_acl_get_counter_info_all (param, index, obj_type, page);
         }
         else if (switch_id_key && !table_id_key) {
             /* Switch Id provided */
             nas_acl_switch& s = nas_acl_get_switch (switch_id);
-            rc = nas_acl_get_counter_info_by_switch (param, index, s, obj_type);
+            rc = nas_acl_get_counter_info_by_switch (param, index, s, obj_type, page);
         }
         else if (switch_id_key && table_id_key && !counter_id_key) {
             /* Switch Id and Table Id provided */
             nas_acl_switch& s = nas_acl_get_switch (switch_id);
             nas_acl_table&  table = s.get_table (table_id);
 
-            rc = nas_acl_get_counter_info_by_table (param, index, table, obj_type);
+            rc = nas_acl_get_counter_info_by_table (param, index, table, obj_type, page);
         }
         else if (switch_id_key && table_id_key && counter_id_key) {
             /* Switch Id, Table Id and Counter Id provided */
@@ -302,16 +329,57 @@ nas_acl_get_counter (cps_api_get_params_t *param, size_t index,
         rc = e.err_code;
     }
 
+    if (rc == NAS_ACL_E_NONE && !page.finish (param->list)) {
+        rc = NAS_ACL_E_MEM;
+    }
+
     return (rc);
 }
 
+// Parse the attributes of a Counter Create object into counter
+void nas_acl_parse_counter_obj (cps_api_object_t obj, nas_acl_counter_t& counter)
+{
+    cps_api_object_it_t    it;
+    cps_api_attr_id_t      attr_id;
+
+    for (cps_api_object_it_begin (obj, &it);
+         cps_api_object_it_valid (&it); cps_api_object_it_next (&it)) {
+
+        attr_id = cps_api_object_attr_id (it.attr);
+
+        switch (attr_id) {
+
+            case BASE_ACL_COUNTER_TYPES:
+            {
+                auto counter_type = cps_api_object_attr_data_u32 (it.attr);
+                NAS_ACL_LOG_DETAIL ("Counter type: %d", counter_type);
+                counter.set_type (counter_type);
+                break;
+            }
+            case BASE_ACL_COUNTER_NPU_ID_LIST:
+            {
+                // Must not check for duplicate attributes, since
+                // 'npu-id-list' is a leaf-list and it will
+                // appear multiple times, once for each element in
+                // the list.
+                auto npu = cps_api_object_attr_data_u32 (it.attr);
+                NAS_ACL_LOG_DETAIL ("NPU Id: %d", npu);
+                counter.add_npu (npu);
+                break;
+            }
+            default:
+                NAS_ACL_LOG_DETAIL ("Unknown attribute ignored %lu(%lx)",
+                                    attr_id, attr_id);
+                break;
+        }
+    }
+}
+
 static
 t_std_error nas_acl_counter_create (cps_api_object_t obj,
                                               cps_api_object_t prev,
                                               bool             is_rollbk_op) noexcept
 {
-    cps_api_object_it_t    it;
-    cps_api_attr_id_t      attr_id;
     nas_switch_id_t        switch_id;
     nas_obj_id_t           table_id;
     nas_obj_id_t           counter_id;
@@ -346,39 +414,10 @@ t_std_error nas_acl_counter_create (cps_api_object_t obj,
                 return NAS_ACL_E_MISSING_KEY;
             }
         }
+        nas_acl_perf_phase_timer_t perf (NAS_ACL_PERF_PHASE_PARSE);
         nas_acl_counter_t tmp_counter (&table);
 
-        for (cps_api_object_it_begin (obj, &it);
-             cps_api_object_it_valid (&it); cps_api_object_it_next (&it)) {
-
-            attr_id = cps_api_object_attr_id (it.attr);
-
-            switch (attr_id) {
-
-                case BASE_ACL_COUNTER_TYPES:
-                {
-                    auto counter_type = cps_api_object_attr_data_u32 (it.attr);
-                    NAS_ACL_LOG_DETAIL ("Counter type: %d", counter_type);
-                    tmp_counter.set_type (counter_type);
-                    break;
-                }
-                case BASE_ACL_COUNTER_NPU_ID_LIST:
-                {
-                    // Must not check for duplicate attributes, since
-                    // 'npu-id-list' is a leaf-list and it will
-                    // appear multiple times, once for each element in
-                    // the list.
-                    auto npu = cps_api_object_attr_data_u32 (it.attr);
-                    NAS_ACL_LOG_DETAIL ("NPU Id: %d", npu);
-                    tmp_counter.add_npu (npu);
-                    break;
-                }
-                default:
-                    NAS_ACL_LOG_DETAIL ("Unknown attribute ignored %lu(%lx)",
-                                        attr_id, attr_id);
-                    break;
-            }
-        }
+        nas_acl_parse_counter_obj (obj, tmp_counter);
 
         // Allocate a new ID for the counter beforehand
         // to avoid rolling back commit if ID allocation fails
@@ -390,14 +429,18 @@ t_std_error nas_acl_counter_create (cps_api_object_t obj,
         }
         tmp_counter.set_counter_id (counter_id);
 
+        perf.next (NAS_ACL_PERF_PHASE_COMMIT);
         tmp_counter.commit_create (is_rollbk_op);
 
         // WARNING !!! CANNOT throw error or exception beyond this point
         // since counter is already committed to SAI
 
+        perf.next (NAS_ACL_PERF_PHASE_SAVE);
         nas_acl_counter_t& new_counter = s.save_counter (std::move(tmp_counter));
         idg.unguard();
+        perf.stop ();
         counter_id = new_counter.counter_id ();
+        nas_acl_event_note (BASE_ACL_COUNTER_OBJ, cps_api_oper_CREATE, table_id, counter_id);
         NAS_ACL_LOG_BRIEF ("Counter Creation successful. Switch Id: %d, "
                            "Table Id: %ld, Counter Id: %ld",
                            switch_id, table_id, counter_id);
@@ -461,12 +504,16 @@ static t_std_error nas_acl_counter_delete (cps_api_object_t obj,
             _fill_counter_attr_info (prev, counter, false);
         }
 
+        nas_acl_perf_phase_timer_t perf (NAS_ACL_PERF_PHASE_COMMIT);
         counter.commit_delete (is_rollbk_op);
 
         // WARNING !!! CANNOT throw error or exception beyond this point
         // since counter is already deleted in SAI
 
+        perf.next (NAS_ACL_PERF_PHASE_SAVE);
         s.remove_counter_from_table (table_id, counter_id);
+        perf.stop ();
+        nas_acl_event_note (BASE_ACL_COUNTER_OBJ, cps_api_oper_DELETE, table_id, counter_id);
 
         NAS_ACL_LOG_BRIEF ("Counter Deletion successful. Switch Id: %d, "
                            "Table Id: %ld, Counter Id: %ld",
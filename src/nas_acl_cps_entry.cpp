@@ -31,6 +31,11 @@
 #include "nas_switch.h"
 #include "nas_acl_cps_key.h"
 #include "nas_acl_utl.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_event.h"
+#include "nas_acl_async.h"
+#include "nas_acl_cps_page.h"
+#include "nas_acl_undo.h"
 #include <utility>
 
 static t_std_error
@@ -53,6 +58,25 @@ static nas_acl_write_operation_map_t nas_acl_entry_op_map [] = {
     {cps_api_oper_DELETE, nas_acl_entry_delete},
 };
 
+static t_std_error
+nas_acl_entry_async_create (cps_api_object_t obj,
+                            cps_api_object_t prev,
+                            bool             is_rollbk_op) noexcept;
+static t_std_error
+nas_acl_entry_async_modify (cps_api_object_t obj,
+                            cps_api_object_t prev,
+                            bool             is_rollbk_op) noexcept;
+static t_std_error
+nas_acl_entry_async_delete (cps_api_object_t obj,
+                            cps_api_object_t prev,
+                            bool             is_rollbk_op) noexcept;
+
+static nas_acl_write_operation_map_t nas_acl_entry_async_op_map [] = {
+    {cps_api_oper_CREATE, nas_acl_entry_async_create},
+    {cps_api_oper_SET, nas_acl_entry_async_modify},
+    {cps_api_oper_DELETE, nas_acl_entry_async_delete},
+};
+
 /* Used by CPS Get handler */
 struct entry_key_t {
     nas_switch_id_t switch_id;
@@ -96,6 +120,22 @@ nas_acl_get_entry_operation_map (cps_api_operation_types_t op) noexcept
     return NULL;
 }
 
+nas_acl_write_operation_map_t *
+nas_acl_get_entry_async_op_map (cps_api_operation_types_t op) noexcept
+{
+    uint32_t                  index;
+    uint32_t                  count;
+
+    count = sizeof (nas_acl_entry_async_op_map) / sizeof (nas_acl_entry_async_op_map [0]);
+
+    for (index = 0; index < count; index++) {
+        if (nas_acl_entry_async_op_map [index].op == op) {
+            return (&nas_acl_entry_async_op_map [index]);
+        }
+    }
+    return NULL;
+}
+
 static inline bool
 nas_acl_fill_entry_npu_list (cps_api_object_t obj, const nas_acl_entry& entry,
                              bool explicit_npu_list=false)
@@ -189,6 +229,26 @@ static bool nas_acl_entry_cps_key_init (cps_api_object_t obj,
     return (_cps_key_fill (obj, entry));
 }
 
+// Status of queued NPU programming - omitted when programmed
+static bool _cps_fill_program_status (cps_api_object_t obj, nas_switch_id_t switch_id,
+                                      nas_obj_id_t table_id, nas_obj_id_t entry_id) noexcept
+{
+    t_std_error err;
+    auto status = nas_acl_async_entry_status (switch_id, table_id, entry_id, &err);
+
+    if (status == NAS_ACL_ASYNC_STATUS_OK) {
+        return true;
+    }
+    if (!cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PROGRAM_STATUS, status)) {
+        return false;
+    }
+    if (status == NAS_ACL_ASYNC_STATUS_FAILED &&
+        !cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PROGRAM_ERROR, err)) {
+        return false;
+    }
+    return true;
+}
+
 static t_std_error nas_acl_get_entry_info (cps_api_get_params_t *param,
                                            size_t                index,
                                            const nas_acl_entry&  entry)
@@ -203,6 +263,11 @@ static t_std_error nas_acl_get_entry_info (cps_api_get_params_t *param,
         return NAS_ACL_E_MEM;
     }
 
+    if (!_cps_fill_program_status (obj, entry.switch_id (), entry.table_id (),
+                                   entry.entry_id ())) {
+        return NAS_ACL_E_MEM;
+    }
+
     if (!nas_acl_entry_cps_key_init (obj, entry)) {
         return NAS_ACL_E_MEM;
     }
@@ -216,31 +281,211 @@ static t_std_error nas_acl_get_entry_info (cps_api_get_params_t *param,
     return NAS_ACL_E_NONE;
 }
 
+// Entry whose Create is queued or failed - only the key and status
+static t_std_error nas_acl_get_entry_status_info (cps_api_get_params_t *param,
+                                                  size_t                index,
+                                                  nas_switch_id_t       switch_id,
+                                                  nas_obj_id_t          table_id,
+                                                  nas_obj_id_t          entry_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+    if (obj == NULL) {
+        return NAS_ACL_E_MEM;
+    }
+    cps_api_object_guard g(obj);
+
+    if (!cps_api_key_from_attr_with_qual (cps_api_object_key (obj),
+                                          BASE_ACL_ENTRY_OBJ,
+                                          cps_api_qualifier_TARGET) ||
+        !nas_acl_cps_key_set_obj_id (obj, BASE_ACL_ENTRY_TABLE_ID, table_id) ||
+        !nas_acl_cps_key_set_obj_id (obj, BASE_ACL_ENTRY_ID, entry_id) ||
+        !_cps_fill_program_status (obj, switch_id, table_id, entry_id)) {
+        return NAS_ACL_E_MEM;
+    }
+
+    if (!cps_api_object_list_append (param->list, obj)) {
+        NAS_ACL_LOG_ERR ("Obj Append failed. Index: %ld", index);
+        return NAS_ACL_E_MEM;
+    }
+
+    g.release();
+    return NAS_ACL_E_NONE;
+}
+
+// A GET filter with Match or Action lists, or an interface, asks for
+// the Entries that have all of them. IP address Filters select the
+// Entries whose address is within the given prefix.
+static bool _cps_is_entry_query (cps_api_object_t filter_obj) noexcept
+{
+    return (cps_api_object_attr_get (filter_obj, BASE_ACL_ENTRY_MATCH) != NULL ||
+            cps_api_object_attr_get (filter_obj, BASE_ACL_ENTRY_ACTION) != NULL ||
+            cps_api_object_attr_get (filter_obj, BASE_ACL_ENTRY_GET_IFINDEX) != NULL);
+}
+
+static bool _entry_has_ifindex (const nas_acl_entry& entry, hal_ifindex_t ifindex) noexcept
+{
+    for (const auto& f_kv: entry.get_filter_list ()) {
+        for (auto port: f_kv.second.get_filter_if_list ()) {
+            if (port == ifindex) return true;
+        }
+    }
+    for (const auto& a_kv: entry.get_action_list ()) {
+        for (auto port: a_kv.second.get_action_if_list ()) {
+            if (port == ifindex) return true;
+        }
+    }
+    return false;
+}
+
+static bool _entry_matches_query (const nas_acl_entry& entry, const nas_acl_entry& query,
+                                  const hal_ifindex_t* ifindex) noexcept
+{
+    for (const auto& q_kv: query.get_filter_list ()) {
+        auto it = entry.get_filter_list ().find (q_kv.first);
+        if (it == entry.get_filter_list ().end ()) {
+            return false;
+        }
+        if (q_kv.second.is_ip_addr ()) {
+            if (!it->second.is_within (q_kv.second)) return false;
+        } else if (it->second != q_kv.second) {
+            return false;
+        }
+    }
+    for (const auto& q_kv: query.get_action_list ()) {
+        auto it = entry.get_action_list ().find (q_kv.first);
+        if (it == entry.get_action_list ().end () || it->second != q_kv.second) {
+            return false;
+        }
+    }
+    return (ifindex == NULL || _entry_has_ifindex (entry, *ifindex));
+}
+
+// Walks the smallest set of candidates the Table's indexes give
+// for the query, instead of all the Entries of the Table
+static t_std_error nas_acl_get_entry_info_by_query (cps_api_get_params_t  *param,
+                                                    size_t                 index,
+                                                    const nas_acl_table&   table,
+                                                    cps_api_object_t       filter_obj,
+                                                    nas_acl_get_page_t&    page)
+{
+    nas_acl_switch& s = table.get_switch ();
+    nas_acl_entry   query (&table);
+
+    try {
+        nas_acl_parse_entry_obj (filter_obj, query);
+    } catch (nas::base_exception& e) {
+        if (e.err_code != NAS_ACL_E_INCONSISTENT) {
+            throw;
+        }
+        // Query on a Filter this Table does not have - nothing to match
+        NAS_ACL_LOG_DETAIL ("Table %ld: %s", table.table_id(), e.err_msg.c_str ());
+        return NAS_ACL_E_NONE;
+    }
+
+    hal_ifindex_t  ifindex = 0;
+    auto ifindex_attr = cps_api_object_attr_get (filter_obj, BASE_ACL_ENTRY_GET_IFINDEX);
+    if (ifindex_attr != NULL) {
+        ifindex = cps_api_object_attr_data_u32 (ifindex_attr);
+    }
+
+    const auto& idx = s.entry_index (table.table_id());
+    const nas_acl_entry_id_set_t* candidates = NULL;
+    nas_acl_entry_id_set_t        ip_candidates;
+
+    auto narrow = [&candidates] (const nas_acl_entry_id_set_t& ids) {
+        if (candidates == NULL || ids.size () < candidates->size ()) {
+            candidates = &ids;
+        }
+    };
+
+    for (const auto& q_kv: query.get_filter_list ()) {
+        if (q_kv.second.is_ip_addr ()) {
+            auto ids = idx.ip_prefix_entries (q_kv.second);
+            if (candidates == NULL || ids.size () < candidates->size ()) {
+                ip_candidates = std::move (ids);
+                candidates = &ip_candidates;
+            }
+        } else {
+            narrow (idx.filter_entries (q_kv.second));
+        }
+    }
+    for (const auto& q_kv: query.get_action_list ()) {
+        narrow (idx.action_entries (q_kv.second));
+    }
+    if (ifindex_attr != NULL) {
+        narrow (idx.ifindex_entries (ifindex));
+    }
+
+    if (candidates == NULL) {
+        return NAS_ACL_E_NONE;
+    }
+
+    NAS_ACL_LOG_DETAIL ("Table %ld: %ld candidate Entries for query",
+                        table.table_id(), candidates->size ());
+
+    for (auto it = page.first_obj (*candidates, s.id(), table.table_id());
+         it != candidates->end(); ++it) {
+
+        auto entry_p = s.find_entry (table.table_id(), *it);
+        if (entry_p == NULL ||
+            !_entry_matches_query (*entry_p, query,
+                                   (ifindex_attr != NULL) ? &ifindex : NULL)) {
+            continue;
+        }
+        if (!page.take ()) {
+            break;
+        }
+
+        t_std_error rc = nas_acl_get_entry_info (param, index, *entry_p);
+        if (rc != NAS_ACL_E_NONE) {
+            return rc;
+        }
+        page.added (s.id(), table.table_id(), *it);
+    }
+    return NAS_ACL_E_NONE;
+}
+
 static t_std_error nas_acl_get_entry_info_by_table (cps_api_get_params_t  *param,
                                                     size_t                 index,
-                                                    const nas_acl_table&   table)
+                                                    const nas_acl_table&   table,
+                                                    cps_api_object_t       query_obj,
+                                                    nas_acl_get_page_t&    page)
 {
     nas_acl_switch& s = table.get_switch ();
     t_std_error  rc;
 
-    for (const auto& entry_pair: s.entry_list (table.table_id())) {
+    if (query_obj != NULL) {
+        return nas_acl_get_entry_info_by_query (param, index, table, query_obj, page);
+    }
+
+    const auto& entries = s.entry_list (table.table_id());
+
+    for (auto it = page.first_obj (entries, s.id(), table.table_id());
+         it != entries.end() && page.take (); ++it) {
 
-        if ((rc = nas_acl_get_entry_info (param, index, entry_pair.second))
+        if ((rc = nas_acl_get_entry_info (param, index, it->second))
             != NAS_ACL_E_NONE) {
             return rc;
         }
+        page.added (s.id(), table.table_id(), it->first);
     }
     return NAS_ACL_E_NONE;
 }
 
 static t_std_error nas_acl_get_entry_info_by_switch (cps_api_get_params_t  *param,
                                                      size_t                 index,
-                                                     const nas_acl_switch&  s)
+                                                     const nas_acl_switch&  s,
+                                                     cps_api_object_t       query_obj,
+                                                     nas_acl_get_page_t&    page)
 {
     t_std_error  rc;
-    for (const auto& tbl_kvp: s.table_list ()) {
+    const auto& tables = s.table_list ();
+
+    for (auto it = page.first_table (tables, s.id());
+         it != tables.end() && !page.more (); ++it) {
 
-        if ((rc = nas_acl_get_entry_info_by_table (param, index, tbl_kvp.second))
+        if ((rc = nas_acl_get_entry_info_by_table (param, index, it->second,
+                                                   query_obj, page))
             != NAS_ACL_E_NONE) {
             return rc;
         }
@@ -249,12 +494,18 @@ static t_std_error nas_acl_get_entry_info_by_switch (cps_api_get_params_t  *para
 }
 
 static t_std_error nas_acl_get_entry_info_all (cps_api_get_params_t *param,
-                                               size_t               index)
+                                               size_t               index,
+                                               cps_api_object_t     query_obj,
+                                               nas_acl_get_page_t&  page)
 {
     t_std_error  rc;
-    for (const auto& switch_pair: nas_acl_get_switch_list ()) {
+    const auto& switches = nas_acl_get_switch_list ();
 
-        if ((rc = nas_acl_get_entry_info_by_switch (param, index, switch_pair.second))
+    for (auto it = page.first_switch (switches);
+         it != switches.end() && !page.more (); ++it) {
+
+        if ((rc = nas_acl_get_entry_info_by_switch (param, index, it->second,
+                                                    query_obj, page))
                 != NAS_ACL_E_NONE) {
             return rc;
         }
@@ -380,31 +631,46 @@ nas_acl_get_entry (cps_api_get_params_t *param, size_t index,
     t_std_error  rc = NAS_ACL_E_NONE;
 
     auto key = _cps_extract_key (filter_obj);
+    nas_acl_get_page_t page (filter_obj, BASE_ACL_ENTRY_GET_LIMIT,
+                             BASE_ACL_ENTRY_GET_CURSOR);
+
+    if (!page.valid ()) {
+        return NAS_ACL_E_ATTR_VAL;
+    }
+
+    auto query_obj = (_cps_is_entry_query (filter_obj)) ? filter_obj : NULL;
 
     try {
         if (!key.has_switch_id) {
             /* No keys provided */
-            rc = nas_acl_get_entry_info_all (param, index);
+            rc = nas_acl_get_entry_info_all (param, index, query_obj, page);
         }
         else if (key.has_switch_id && !key.has_table_id) {
             /* Switch Id provided */
             nas_acl_switch& s = nas_acl_get_switch (key.switch_id);
-            rc = nas_acl_get_entry_info_by_switch (param, index, s);
+            rc = nas_acl_get_entry_info_by_switch (param, index, s, query_obj, page);
         }
         else if (key.has_switch_id && key.has_table_id && !key.has_entry_id) {
             /* Switch Id and Table Id provided */
             nas_acl_switch& s = nas_acl_get_switch (key.switch_id);
             nas_acl_table&  table = s.get_table (key.table_id);
 
-            rc = nas_acl_get_entry_info_by_table (param, index, table);
+            rc = nas_acl_get_entry_info_by_table (param, index, table, query_obj, page);
         }
         else if (key.has_switch_id && key.has_table_id && key.has_entry_id &&
                 !(key.has_match_type || key.has_action_type)) {
             /* Switch Id, Table Id and Entry Id provided */
             nas_acl_switch& s = nas_acl_get_switch (key.switch_id);
-            nas_acl_entry&  entry = s.get_entry (key.table_id, key.entry_id);
 
-            rc = nas_acl_get_entry_info (param, index, entry);
+            if (s.find_entry (key.table_id, key.entry_id) == NULL &&
+                nas_acl_async_entry_status (key.switch_id, key.table_id, key.entry_id)
+                != NAS_ACL_ASYNC_STATUS_OK) {
+                rc = nas_acl_get_entry_status_info (param, index, key.switch_id,
+                                                    key.table_id, key.entry_id);
+            } else {
+                nas_acl_entry&  entry = s.get_entry (key.table_id, key.entry_id);
+                rc = nas_acl_get_entry_info (param, index, entry);
+            }
         }
         else if (key.has_switch_id && key.has_table_id && key.has_entry_id
                  && key.has_match_type) {
@@ -432,6 +698,10 @@ nas_acl_get_entry (cps_api_get_params_t *param, size_t index,
         rc = e.err_code;
     }
 
+    if (rc == NAS_ACL_E_NONE && !page.finish (param->list)) {
+        rc = NAS_ACL_E_MEM;
+    }
+
     return (rc);
 }
 
@@ -470,6 +740,7 @@ static void  _cps_entry_incr_upd (cps_api_object_t       obj,
                                   cps_api_operation_types_t op,
                                   bool                   is_rollbk_op)
 {
+    nas_acl_perf_phase_timer_t perf (NAS_ACL_PERF_PHASE_PARSE);
     nas_obj_id_t      table_id = op_key.t.table_id();
     nas_acl_switch&   s = op_key.s;
     nas_acl_entry&    old_entry = s.get_entry (table_id, op_key.eid);
@@ -517,11 +788,13 @@ static void  _cps_entry_incr_upd (cps_api_object_t       obj,
         }
     }
 
+    perf.next (NAS_ACL_PERF_PHASE_COMMIT);
     new_entry.commit_modify (old_entry, is_rollbk_op);
 
     // WARNING !!! CANNOT throw error or exception beyond this point
     // since entry is already committed to SAI
 
+    perf.next (NAS_ACL_PERF_PHASE_SAVE);
     if (!is_rollbk_op) {
         nas::attr_list_t attr_id_list;
         attr_id_list.reserve (NAS_ACL_MAX_ATTR_DEPTH);
@@ -546,14 +819,15 @@ static void  _cps_entry_incr_upd (cps_api_object_t       obj,
     }
 
     s.save_entry (std::move (new_entry));
+    perf.stop ();
+    nas_acl_event_note (BASE_ACL_ENTRY_OBJ, cps_api_oper_SET, table_id, op_key.eid);
 
     NAS_ACL_LOG_BRIEF ("Entry Modification successful. Switch Id: %d, "
                        "Table Id: %ld, Entry Id: %ld",
                        s.id(), table_id, op_key.eid);
 }
 
-static bool _cps_parse_entry_obj (cps_api_object_t obj, nas_acl_entry& tmp_entry,
-                                  cps_api_operation_types_t op)
+bool nas_acl_parse_entry_obj (cps_api_object_t obj, nas_acl_entry& tmp_entry)
 {
     cps_api_object_it_t    it;
     bool npu_modified = false;
@@ -603,27 +877,31 @@ static bool _cps_parse_entry_obj (cps_api_object_t obj, nas_acl_entry& tmp_entry
     return npu_modified;
 }
 
-static void _cps_pack_attrs (cps_api_object_t pack_obj, cps_api_object_t key_obj,
-                             const nas_acl_entry& entry,
-                             const nas::attr_set_t& attrs, bool npu_modified)
+bool nas_acl_fill_entry_obj (cps_api_object_t obj, const nas_acl_entry& entry)
 {
-    cps_api_object_set_key (pack_obj, cps_api_object_key (key_obj));
-    _cps_key_fill (pack_obj, entry);
+    return (nas_acl_entry_cps_key_init (obj, entry) &&
+            nas_acl_fill_entry_attr_info (obj, entry, false));
+}
+
+bool nas_acl_fill_entry_prev (cps_api_object_t prev, const nas_acl_entry& entry,
+                              const nas::attr_set_t& attrs, bool npu_modified)
+{
+    bool ok = true;
 
     for (auto attr_id: attrs) {
 
         switch (attr_id) {
         case BASE_ACL_ENTRY_PRIORITY:
-            cps_api_object_attr_add_u32 (pack_obj, attr_id,
-                                         entry.priority ());
+            ok = cps_api_object_attr_add_u32 (prev, attr_id,
+                                              entry.priority ()) && ok;
             break;
 
         case BASE_ACL_ENTRY_MATCH:
-            nas_acl_fill_match_attr_list (pack_obj, entry);
+            ok = nas_acl_fill_match_attr_list (prev, entry) && ok;
             break;
 
         case BASE_ACL_ENTRY_ACTION:
-            nas_acl_fill_action_attr_list (pack_obj, entry);
+            ok = nas_acl_fill_action_attr_list (prev, entry) && ok;
             break;
 
         default:
@@ -632,21 +910,16 @@ static void _cps_pack_attrs (cps_api_object_t pack_obj, cps_api_object_t key_obj
     }
 
     if (npu_modified == true) {
-        nas_acl_fill_entry_npu_list (pack_obj, entry);
+        ok = nas_acl_fill_entry_npu_list (prev, entry) && ok;
     }
-}
-
-static void _cps_pack_entry (cps_api_object_t pack_obj, cps_api_object_t key_obj,
-                           const nas_acl_entry& entry)
-{
-    return _cps_pack_attrs (pack_obj, key_obj, entry, entry.set_attr_list (), true);
+    return ok;
 }
 
 static void _cps_pack_key (cps_api_object_t pack_obj, cps_api_object_t key_obj,
                            const nas_acl_entry& entry)
 {
-    nas::attr_set_t dummy;
-    return _cps_pack_attrs (pack_obj, key_obj, entry, dummy, false);
+    cps_api_object_set_key (pack_obj, cps_api_object_key (key_obj));
+    _cps_key_fill (pack_obj, entry);
 }
 
 static t_std_error nas_acl_entry_create (cps_api_object_t obj,
@@ -682,8 +955,9 @@ static t_std_error nas_acl_entry_create (cps_api_object_t obj,
             NAS_ACL_LOG_BRIEF ("Entry ID %lu provided for Entry Create", entry_id);
         }
 
+        nas_acl_perf_phase_timer_t perf (NAS_ACL_PERF_PHASE_PARSE);
         nas_acl_entry tmp_entry (&op_key.t);
-        _cps_parse_entry_obj (obj, tmp_entry, cps_api_oper_CREATE);
+        nas_acl_parse_entry_obj (obj, tmp_entry);
 
         // Allocate a new ID for the entry beforehand
         // to avoid rolling back commit if ID allocation fails
@@ -696,15 +970,19 @@ static t_std_error nas_acl_entry_create (cps_api_object_t obj,
         tmp_entry.set_entry_id (entry_id);
 
         // Apply new entry to NDI and SAI
+        perf.next (NAS_ACL_PERF_PHASE_COMMIT);
         tmp_entry.commit_create (is_rollbk_op);
 
         // WARNING !!! CANNOT throw error or exception beyond this point
         // since entry is already committed to SAI
 
         // Now save the entry in local cache. Also track references to table/counter
+        perf.next (NAS_ACL_PERF_PHASE_SAVE);
         nas_acl_entry& new_entry = sw.save_entry (std::move(tmp_entry));
         idg.unguard ();
+        perf.stop ();
         entry_id = new_entry.entry_id ();
+        nas_acl_event_note (BASE_ACL_ENTRY_OBJ, cps_api_oper_CREATE, table_id, entry_id);
 
         NAS_ACL_LOG_BRIEF ("Entry Creation successful. Switch Id: %d, "
                            "Table Id: %ld, Entry Id: %ld",
@@ -714,7 +992,8 @@ static t_std_error nas_acl_entry_create (cps_api_object_t obj,
             NAS_ACL_LOG_ERR ("Failed to set Entry Id Key as return value");
         }
 
-        if (!is_rollbk_op) {
+        // No prev for the async worker's write
+        if (!is_rollbk_op && prev != NULL) {
             _cps_pack_key (prev, obj, new_entry);
         }
 
@@ -758,23 +1037,38 @@ static t_std_error nas_acl_entry_modify (cps_api_object_t obj,
                             (is_rollbk_op) ? "** ROLLBACK **: " : "",
                             sw.id(), table_id, entry_id);
 
+        nas_acl_perf_phase_timer_t perf (NAS_ACL_PERF_PHASE_PARSE);
         nas_acl_entry& old_entry = sw.get_entry (table_id, entry_id);
         nas_acl_entry  new_entry (old_entry);
-
-        bool npu_modified = _cps_parse_entry_obj (obj, new_entry, cps_api_oper_SET);
+        std::unique_ptr<nas_acl_entry> old_p;
+        // The async worker passes no prev - nothing rolls back its write
+        bool keep_undo = (!is_rollbk_op && prev != NULL);
+
+        bool npu_modified = nas_acl_parse_entry_obj (obj, new_entry);
+        if (keep_undo) {
+            // Receives the replaced Entry for the undo journal
+            old_p.reset (new nas_acl_entry (&op_key.t));
+        }
 
         // Apply changes to NDI and SAI
+        perf.next (NAS_ACL_PERF_PHASE_COMMIT);
         auto mod_attrs = new_entry.commit_modify (old_entry, is_rollbk_op);
 
         // WARNING !!! CANNOT throw error or exception beyond this point
         // since entry is already committed to SAI
 
-        if (!is_rollbk_op) {
-            _cps_pack_attrs (prev, obj, old_entry, mod_attrs, npu_modified);
+        perf.next (NAS_ACL_PERF_PHASE_SAVE);
+        if (keep_undo) {
+            _cps_pack_key (prev, obj, old_entry);
         }
 
         // Now save the entry in local cache. Also track references to table/counter
-        sw.save_entry (std::move (new_entry));
+        sw.save_entry (std::move (new_entry), old_p.get ());
+        if (keep_undo) {
+            nas_acl_undo_save (prev, std::move (old_p), mod_attrs, npu_modified);
+        }
+        perf.stop ();
+        nas_acl_event_note (BASE_ACL_ENTRY_OBJ, cps_api_oper_SET, table_id, entry_id);
 
         NAS_ACL_LOG_BRIEF ("Entry Modification successful. Switch Id: %d, "
                            "Table Id: %ld, Entry Id: %ld",
@@ -817,23 +1111,38 @@ static t_std_error nas_acl_entry_delete (cps_api_object_t obj,
         auto table_id = op_key.t.table_id();
         auto entry_id = op_key.eid;
         nas_acl_entry& entry = sw.get_entry (table_id, entry_id);
+        std::unique_ptr<nas_acl_entry> old_p;
+        bool keep_undo = (!is_rollbk_op && prev != NULL);
 
         NAS_ACL_LOG_BRIEF ("%sSwitch Id: %d, Table Id: %ld, Entry Id: %ld",
                            (is_rollbk_op) ? "** ROLLBACK **: " : "",
                            sw.id(), table_id, entry_id);
 
+        if (keep_undo) {
+            // Receives the removed Entry for the undo journal
+            old_p.reset (new nas_acl_entry (&op_key.t));
+        }
+
         // Apply Delete to NDI and SAI
+        nas_acl_perf_phase_timer_t perf (NAS_ACL_PERF_PHASE_COMMIT);
         entry.commit_delete (is_rollbk_op);
 
         // WARNING !!! CANNOT throw error or exception beyond this point
         // since entry is already deleted in SAI
 
-        if (!is_rollbk_op) {
-            _cps_pack_entry (prev, obj, entry);
+        perf.next (NAS_ACL_PERF_PHASE_SAVE);
+        if (keep_undo) {
+            _cps_pack_key (prev, obj, entry);
         }
 
         // Now save the entry in local cache. Also remove references to table/counter
-        sw.remove_entry_from_table (table_id, entry_id);
+        sw.remove_entry_from_table (table_id, entry_id, old_p.get ());
+        if (keep_undo) {
+            auto attrs = old_p->set_attr_list ();
+            nas_acl_undo_save (prev, std::move (old_p), attrs, true);
+        }
+        perf.stop ();
+        nas_acl_event_note (BASE_ACL_ENTRY_OBJ, cps_api_oper_DELETE, table_id, entry_id);
 
         NAS_ACL_LOG_BRIEF ("Entry Deletion successful. Switch Id: %d, "
                            "Table Id: %ld, Entry Id: %ld",
@@ -852,3 +1161,123 @@ static t_std_error nas_acl_entry_delete (cps_api_object_t obj,
     NAS_ACL_LOG_BRIEF ("Successful ");
     return NAS_ACL_E_NONE;
 }
+
+// Validates the write and saves the previous state - programming the
+// NPUs is queued. See nas_acl_async.h
+static t_std_error nas_acl_entry_async_write (cps_api_object_t          obj,
+                                              cps_api_object_t          prev,
+                                              cps_api_operation_types_t op,
+                                              bool                      is_rollbk_op) noexcept
+{
+    cps_api_object_guard og (cps_api_object_create ());
+
+    if (!og.valid ()) {
+        return NAS_ACL_E_MEM;
+    }
+
+    try {
+        auto op_key = _cps_op_key_extract (obj);
+
+        nas_acl_switch& sw    = op_key.s;
+        auto table_id = op_key.t.table_id();
+        auto entry_id = op_key.eid;
+        std::unique_ptr<nas_acl_id_guard_t> idg;
+
+        NAS_ACL_LOG_BRIEF ("%sOp %d, Switch Id: %d, Table Id: %ld, Entry Id: %ld",
+                           (is_rollbk_op) ? "** ROLLBACK **: " : "", op,
+                           sw.id(), table_id, entry_id);
+
+        if (is_rollbk_op) {
+            // Undo is queued behind the write it undoes
+
+        } else if (op_key.is_incr_upd) {
+            // Match filter or Action update is programmed in place
+            return nas_acl_get_entry_operation_map (op)->fn (obj, prev, false);
+
+        } else if (op == cps_api_oper_CREATE) {
+            if (op_key.has_eid && (sw.find_entry (table_id, entry_id)) != NULL) {
+                NAS_ACL_LOG_ERR ("Entry ID %lu already taken", entry_id);
+                return NAS_ACL_E_KEY_VAL;
+            }
+
+            nas_acl_entry tmp_entry (&op_key.t);
+            nas_acl_parse_entry_obj (obj, tmp_entry);
+
+            idg.reset (new nas_acl_id_guard_t (sw, BASE_ACL_ENTRY_OBJ, table_id));
+            if (!op_key.has_eid) {
+                entry_id = idg->alloc_guarded_id ();
+            } else if (!idg->reserve_guarded_id (entry_id)) {
+                NAS_ACL_LOG_ERR ("Entry ID %lu already taken", entry_id);
+                return NAS_ACL_E_KEY_VAL;
+            }
+            tmp_entry.set_entry_id (entry_id);
+
+            if (!nas_acl_cps_key_set_obj_id (obj, BASE_ACL_ENTRY_ID, entry_id)) {
+                NAS_ACL_LOG_ERR ("Failed to set Entry Id Key as return value");
+                return NAS_ACL_E_MEM;
+            }
+            _cps_pack_key (prev, obj, tmp_entry);
+
+        } else {
+            if (!op_key.has_eid) {
+                NAS_ACL_LOG_ERR ("Entry ID is a mandatory key for Modify/Delete operation");
+                return NAS_ACL_E_MISSING_KEY;
+            }
+
+            nas_acl_entry& old_entry = sw.get_entry (table_id, entry_id);
+            std::unique_ptr<nas_acl_entry> old_p {new nas_acl_entry (old_entry)};
+
+            _cps_pack_key (prev, obj, old_entry);
+            if (op == cps_api_oper_SET) {
+                nas_acl_entry new_entry (old_entry);
+                bool npu_modified = nas_acl_parse_entry_obj (obj, new_entry);
+
+                nas_acl_undo_save (prev, std::move (old_p), new_entry.dirty_attr_list (),
+                                   npu_modified);
+            } else {
+                auto attrs = old_entry.set_attr_list ();
+                nas_acl_undo_save (prev, std::move (old_p), attrs, true);
+            }
+        }
+
+        if (!cps_api_object_clone (og.get (), obj) ||
+            !nas_acl_async_queue (og.get (), op, is_rollbk_op, sw.id (), table_id,
+                                  entry_id, std::move (idg))) {
+            return NAS_ACL_E_MEM;
+        }
+        og.release ();
+
+    } catch (nas::base_exception& e) {
+
+        NAS_ACL_LOG_ERR ("Err_code: 0x%x, fn: %s (), %s", e.err_code,
+                         e.err_fn.c_str (), e.err_msg.c_str ());
+        return e.err_code;
+
+    } catch (std::out_of_range& e) {
+        NAS_ACL_LOG_ERR ("###########  Out of Range exception %s", e.what ());
+        return NAS_ACL_E_FAIL;
+    }
+
+    return NAS_ACL_E_NONE;
+}
+
+static t_std_error nas_acl_entry_async_create (cps_api_object_t obj,
+                                               cps_api_object_t prev,
+                                               bool             is_rollbk_op) noexcept
+{
+    return nas_acl_entry_async_write (obj, prev, cps_api_oper_CREATE, is_rollbk_op);
+}
+
+static t_std_error nas_acl_entry_async_modify (cps_api_object_t obj,
+                                               cps_api_object_t prev,
+                                               bool             is_rollbk_op) noexcept
+{
+    return nas_acl_entry_async_write (obj, prev, cps_api_oper_SET, is_rollbk_op);
+}
+
+static t_std_error nas_acl_entry_async_delete (cps_api_object_t obj,
+                                               cps_api_object_t prev,
+                                               bool             is_rollbk_op) noexcept
+{
+    return nas_acl_entry_async_write (obj, prev, cps_api_oper_DELETE, is_rollbk_op);
+}
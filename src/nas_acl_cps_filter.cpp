@@ -38,30 +38,40 @@ void nas_acl_set_match_attr (const cps_api_object_t     obj,
                              nas_acl_entry&             entry,
                              BASE_ACL_MATCH_TYPE_t      match_type_val,
                              nas::attr_list_t           parent_attr_id_list,
-                             bool                       reset)
+                             bool                       reset,
+                             const nas_acl_attr_index_t* index)
 {
 
-    auto map_kv = nas_acl_get_filter_map().find (match_type_val);
+    auto map_info_p = nas_acl_get_filter_info (match_type_val);
 
-    if (map_kv == nas_acl_get_filter_map().end ()) {
+    if (map_info_p == NULL) {
         throw nas::base_exception {NAS_ACL_E_ATTR_VAL, __PRETTY_FUNCTION__,
                                    std::string {"Could not find filter ("} +
                                    nas_acl_filter_t::type_name (match_type_val)
                                     + " ) "+ std::to_string(match_type_val) };
     }
 
-    const nas_acl_filter_info_t& map_info = map_kv->second;
+    const nas_acl_filter_info_t& map_info = *map_info_p;
     nas_acl_filter_t filter {match_type_val};
 
     if (map_info.val.data_type != NAS_ACL_DATA_NONE) {
 
         parent_attr_id_list.push_back (map_info.val.attr_id);
 
-        auto common_data_list =
-            nas_acl_copy_data_from_obj (obj, parent_attr_id_list, map_info.val,
-                                        map_info.child_list, map_info.name);
+        if (map_info.decode_fn != NULL) {
+            cps_api_object_attr_t attrs [NAS_ACL_MAX_CHILD_ATTRS];
 
-        (filter.*(map_info.set_fn)) (common_data_list);
+            nas_acl_get_attrs_from_obj (obj, parent_attr_id_list, map_info.val,
+                                        map_info.child_list, map_info.name, index, attrs);
+            map_info.decode_fn (filter, map_info.val, map_info.child_list,
+                                attrs, map_info.name);
+        } else {
+            auto common_data_list =
+                nas_acl_copy_data_from_obj (obj, parent_attr_id_list, map_info.val,
+                                            map_info.child_list, map_info.name, index);
+
+            (filter.*(map_info.set_fn)) (common_data_list);
+        }
     }
     entry.add_filter (filter, reset);
 }
@@ -145,6 +155,7 @@ void nas_acl_set_match_list (const cps_api_object_t     obj,
     cps_api_object_it_t        it_match_list = it;
     cps_api_attr_id_t          list_index = 0;
     nas::attr_list_t           parent_attr_id_list;
+    nas_acl_attr_index_t       attr_index;
 
     // Parent attr list to build attr hierarchy
     //  - MATCH-List-Attr . Match-ListIndex . Match-Value-Attr . Match-Value-Child-Attr
@@ -171,15 +182,17 @@ void nas_acl_set_match_list (const cps_api_object_t     obj,
                                        "Missing list container for MATCH in object"};
         }
 
-        bool is_dupl;
-        auto attr_match_type = nas_acl_get_attr (it_match_attr,
-                                                 BASE_ACL_ENTRY_MATCH_TYPE, &is_dupl);
+        // Index the list element once - the Type and the Value
+        // attributes are then looked up from the index
+        attr_index.build (it_match_attr);
+
+        auto attr_match_type = attr_index.find (BASE_ACL_ENTRY_MATCH_TYPE);
 
         if (attr_match_type == NULL) {
             throw nas::base_exception {NAS_ACL_E_MISSING_ATTR, __PRETTY_FUNCTION__,
                                        "Missing MATCH_TYPE attribute"};
         }
-        if (is_dupl) {
+        if (attr_index.is_dupl (BASE_ACL_ENTRY_MATCH_TYPE)) {
             throw nas::base_exception {NAS_ACL_E_DUPLICATE, __PRETTY_FUNCTION__,
                                        "Duplicate MATCH_TYPE attribute"};
         }
@@ -191,7 +204,7 @@ void nas_acl_set_match_list (const cps_api_object_t     obj,
                             nas_acl_filter_t::type_name (match_type_val));
 
         nas_acl_set_match_attr (obj, entry, match_type_val,
-                                parent_attr_id_list, true);
+                                parent_attr_id_list, true, &attr_index);
     }
 }
 
@@ -202,18 +215,22 @@ bool nas_acl_fill_match_attr (cps_api_object_t obj,
 {
     nas_acl_common_data_list_t common_data_list;
 
-    auto map_kv = nas_acl_get_filter_map().find (match_type_val);
+    auto map_info_p = nas_acl_get_filter_info (match_type_val);
 
-    if (map_kv == nas_acl_get_filter_map().end ()) {
+    if (map_info_p == NULL) {
         return false;
     }
 
-    const nas_acl_filter_info_t& map_info = map_kv->second;
-
-    (filter.*(map_info.get_fn)) (common_data_list);
+    const nas_acl_filter_info_t& map_info = *map_info_p;
 
     parent_attr_id_list.push_back (map_info.val.attr_id);
 
+    if (map_info.encode_fn != NULL) {
+        return map_info.encode_fn (filter, obj, parent_attr_id_list, map_info.child_list);
+    }
+
+    (filter.*(map_info.get_fn)) (common_data_list);
+
     if (!nas_acl_copy_data_to_obj (obj, parent_attr_id_list, map_info.val,
                                    map_info.child_list, common_data_list)) {
         NAS_ACL_LOG_ERR ("nas_acl_copy_data_to_obj() failed for Match type %d (%s)",
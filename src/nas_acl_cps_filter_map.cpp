@@ -21,20 +21,28 @@
  * \brief  This file contains ACL Entry Filter Map table initiazation
  */
 #include "nas_acl_cps.h"
+#include "nas_acl_cps_codec.h"
 #include "nas_vlan_consts.h"
 #include "nas_qos_consts.h"
 #include "nas_acl_common.h"
+#include <string.h>
 
-static const nas_acl_filter_map_t _filter_map =
+/*
+ * Indexed by BASE_ACL_MATCH_TYPE_t starting from the type of the first slot.
+ * Slots must stay in enum order with no gaps - checked at compile time below.
+ */
+static constexpr nas_acl_filter_info_t _filter_map [] =
 {
-    {BASE_ACL_MATCH_TYPE_SRC_IPV6,
+    {
+        BASE_ACL_MATCH_TYPE_SRC_IPV6,
+        "MATCH_TYPE_SRC_IPV6",
         {
-            "MATCH_TYPE_SRC_IPV6",
-            {
-                BASE_ACL_ENTRY_MATCH_SRC_IPV6_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_SRC_IPV6_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_SRC_IPV6_VALUE_ADDR,
@@ -51,19 +59,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_ipv6_filter_val,
-            &nas_acl_filter_t::set_ipv6_filter_val,
         },
+        &nas_acl_filter_t::get_ipv6_filter_val,
+        &nas_acl_filter_t::set_ipv6_filter_val,
+        &nas_acl_filter_decode<dn_ipv6_addr_t, NDI_ACL_FILTER_IPV6_ADDR>,
+        &nas_acl_filter_encode<dn_ipv6_addr_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_DST_IPV6,
+    {
+        BASE_ACL_MATCH_TYPE_DST_IPV6,
+        "MATCH_TYPE_DST_IPV6",
         {
-            "MATCH_TYPE_DST_IPV6",
-            {
-                BASE_ACL_ENTRY_MATCH_DST_IPV6_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_DST_IPV6_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_DST_IPV6_VALUE_ADDR,
@@ -80,19 +92,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_ipv6_filter_val,
-            &nas_acl_filter_t::set_ipv6_filter_val,
         },
+        &nas_acl_filter_t::get_ipv6_filter_val,
+        &nas_acl_filter_t::set_ipv6_filter_val,
+        &nas_acl_filter_decode<dn_ipv6_addr_t, NDI_ACL_FILTER_IPV6_ADDR>,
+        &nas_acl_filter_encode<dn_ipv6_addr_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_SRC_MAC,
+    {
+        BASE_ACL_MATCH_TYPE_SRC_MAC,
+        "MATCH_TYPE_SRC_MAC",
         {
-            "MATCH_TYPE_SRC_MAC",
-            {
-                BASE_ACL_ENTRY_MATCH_SRC_MAC_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_SRC_MAC_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_SRC_MAC_VALUE_ADDR,
@@ -109,19 +125,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_mac_filter_val,
-            &nas_acl_filter_t::set_mac_filter_val,
         },
+        &nas_acl_filter_t::get_mac_filter_val,
+        &nas_acl_filter_t::set_mac_filter_val,
+        &nas_acl_filter_decode<hal_mac_addr_t, NDI_ACL_FILTER_MAC_ADDR>,
+        &nas_acl_filter_encode<hal_mac_addr_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_DST_MAC,
+    {
+        BASE_ACL_MATCH_TYPE_DST_MAC,
+        "MATCH_TYPE_DST_MAC",
         {
-            "MATCH_TYPE_DST_MAC",
-            {
-                BASE_ACL_ENTRY_MATCH_DST_MAC_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_DST_MAC_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_DST_MAC_VALUE_ADDR,
@@ -138,19 +158,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_mac_filter_val,
-            &nas_acl_filter_t::set_mac_filter_val,
         },
+        &nas_acl_filter_t::get_mac_filter_val,
+        &nas_acl_filter_t::set_mac_filter_val,
+        &nas_acl_filter_decode<hal_mac_addr_t, NDI_ACL_FILTER_MAC_ADDR>,
+        &nas_acl_filter_encode<hal_mac_addr_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_SRC_IP,
+    {
+        BASE_ACL_MATCH_TYPE_SRC_IP,
+        "MATCH_TYPE_SRC_IP",
         {
-            "MATCH_TYPE_SRC_IP",
-            {
-                BASE_ACL_ENTRY_MATCH_SRC_IP_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_SRC_IP_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_SRC_IP_VALUE_ADDR,
@@ -167,19 +191,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_ipv4_filter_val,
-            &nas_acl_filter_t::set_ipv4_filter_val,
         },
+        &nas_acl_filter_t::get_ipv4_filter_val,
+        &nas_acl_filter_t::set_ipv4_filter_val,
+        &nas_acl_filter_decode<dn_ipv4_addr_t, NDI_ACL_FILTER_IPV4_ADDR>,
+        &nas_acl_filter_encode<dn_ipv4_addr_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_DST_IP,
+    {
+        BASE_ACL_MATCH_TYPE_DST_IP,
+        "MATCH_TYPE_DST_IP",
         {
-            "MATCH_TYPE_DST_IP",
-            {
-                BASE_ACL_ENTRY_MATCH_DST_IP_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_DST_IP_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_DST_IP_VALUE_ADDR,
@@ -196,79 +224,87 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_ipv4_filter_val,
-            &nas_acl_filter_t::set_ipv4_filter_val,
         },
+        &nas_acl_filter_t::get_ipv4_filter_val,
+        &nas_acl_filter_t::set_ipv4_filter_val,
+        &nas_acl_filter_decode<dn_ipv4_addr_t, NDI_ACL_FILTER_IPV4_ADDR>,
+        &nas_acl_filter_encode<dn_ipv4_addr_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_IN_PORTS,
+    {
+        BASE_ACL_MATCH_TYPE_IN_PORTS,
+        "MATCH_TYPE_IN_PORTS",
         {
-            "MATCH_TYPE_IN_PORTS",
-            {
-                BASE_ACL_ENTRY_MATCH_IN_PORTS_VALUE,
-                NAS_ACL_DATA_IFLIST,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_IN_PORTS_VALUE,
+            NAS_ACL_DATA_IFLIST,
             {},
-            &nas_acl_filter_t::get_filter_ifindex_list,
-            &nas_acl_filter_t::set_filter_ifindex_list,
         },
+        {},
+        &nas_acl_filter_t::get_filter_ifindex_list,
+        &nas_acl_filter_t::set_filter_ifindex_list,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_MATCH_TYPE_OUT_PORTS,
+    {
+        BASE_ACL_MATCH_TYPE_OUT_PORTS,
+        "MATCH_TYPE_OUT_PORTS",
         {
-            "MATCH_TYPE_OUT_PORTS",
-            {
-                BASE_ACL_ENTRY_MATCH_OUT_PORTS_VALUE,
-                NAS_ACL_DATA_IFLIST,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_OUT_PORTS_VALUE,
+            NAS_ACL_DATA_IFLIST,
             {},
-            &nas_acl_filter_t::get_filter_ifindex_list,
-            &nas_acl_filter_t::set_filter_ifindex_list,
         },
+        {},
+        &nas_acl_filter_t::get_filter_ifindex_list,
+        &nas_acl_filter_t::set_filter_ifindex_list,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_MATCH_TYPE_IN_PORT,
+    {
+        BASE_ACL_MATCH_TYPE_IN_PORT,
+        "MATCH_TYPE_IN_PORT",
         {
-            "MATCH_TYPE_IN_PORT",
-            {
-                BASE_ACL_ENTRY_MATCH_IN_PORT_VALUE,
-                NAS_ACL_DATA_IFINDEX,
-                sizeof (uint32_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_IN_PORT_VALUE,
+            NAS_ACL_DATA_IFINDEX,
+            sizeof (uint32_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_filter_t::get_filter_ifindex,
-            &nas_acl_filter_t::set_filter_ifindex,
         },
+        {},
+        &nas_acl_filter_t::get_filter_ifindex,
+        &nas_acl_filter_t::set_filter_ifindex,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_MATCH_TYPE_OUT_PORT,
+    {
+        BASE_ACL_MATCH_TYPE_OUT_PORT,
+        "MATCH_TYPE_OUT_PORT",
         {
-            "MATCH_TYPE_OUT_PORT",
-            {
-                BASE_ACL_ENTRY_MATCH_OUT_PORT_VALUE,
-                NAS_ACL_DATA_IFINDEX,
-                sizeof (uint32_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_OUT_PORT_VALUE,
+            NAS_ACL_DATA_IFINDEX,
+            sizeof (uint32_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_filter_t::get_filter_ifindex,
-            &nas_acl_filter_t::set_filter_ifindex,
         },
+        {},
+        &nas_acl_filter_t::get_filter_ifindex,
+        &nas_acl_filter_t::set_filter_ifindex,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_MATCH_TYPE_OUTER_VLAN_ID,
+    {
+        BASE_ACL_MATCH_TYPE_OUTER_VLAN_ID,
+        "MATCH_TYPE_OUTER_VLAN_ID",
         {
-            "MATCH_TYPE_OUTER_VLAN_ID",
-            {
-                BASE_ACL_ENTRY_MATCH_OUTER_VLAN_ID_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_OUTER_VLAN_ID_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_OUTER_VLAN_ID_VALUE_DATA,
@@ -285,64 +321,73 @@ static const nas_acl_filter_map_t _filter_map =
                     {0, NAS_MAX_VLAN_ID},
                 },
             },
-            &nas_acl_filter_t::get_u16_filter_val,
-            &nas_acl_filter_t::set_u16_filter_val,
         },
+        &nas_acl_filter_t::get_u16_filter_val,
+        &nas_acl_filter_t::set_u16_filter_val,
+        &nas_acl_filter_decode<uint16_t, NDI_ACL_FILTER_U16>,
+        &nas_acl_filter_encode<uint16_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_OUTER_VLAN_PRI,
+    {
+        BASE_ACL_MATCH_TYPE_OUTER_VLAN_PRI,
+        "MATCH_TYPE_OUTER_VLAN_PRI",
         {
-            "MATCH_TYPE_OUTER_VLAN_PRI",
-            {
-                BASE_ACL_ENTRY_MATCH_OUTER_VLAN_PRI_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_OUTER_VLAN_PRI_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_OUTER_VLAN_PRI_VALUE_DATA,
                     NAS_ACL_DATA_U8,
                     sizeof (uint8_t),
                     NAS_ACL_ATTR_MODE_MANDATORY,
-                    {0, NAS_MAX_DOT1P}
+                    {0, NAS_MAX_DOT1P},
                 },
                 {
                     BASE_ACL_ENTRY_MATCH_OUTER_VLAN_PRI_VALUE_MASK,
                     NAS_ACL_DATA_U8,
                     sizeof (uint8_t),
                     NAS_ACL_ATTR_MODE_OPTIONAL,
-                    {0, NAS_MAX_DOT1P}
+                    {0, NAS_MAX_DOT1P},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_OUTER_VLAN_CFI,
+    {
+        BASE_ACL_MATCH_TYPE_OUTER_VLAN_CFI,
+        "MATCH_TYPE_OUTER_VLAN_CFI",
         {
-            "MATCH_TYPE_OUTER_VLAN_CFI",
-            {
-                BASE_ACL_ENTRY_MATCH_OUTER_VLAN_CFI_VALUE,
-                NAS_ACL_DATA_U8,
-                sizeof (uint8_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {0, NAS_ACL_MAX_CFI}
-            },
-            {},
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
+            BASE_ACL_ENTRY_MATCH_OUTER_VLAN_CFI_VALUE,
+            NAS_ACL_DATA_U8,
+            sizeof (uint8_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
+            {0, NAS_ACL_MAX_CFI},
         },
+        {},
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_MATCH_TYPE_INNER_VLAN_ID,
+    {
+        BASE_ACL_MATCH_TYPE_INNER_VLAN_ID,
+        "MATCH_TYPE_INNER_VLAN_ID",
         {
-            "MATCH_TYPE_INNER_VLAN_ID",
-            {
-                BASE_ACL_ENTRY_MATCH_INNER_VLAN_ID_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_INNER_VLAN_ID_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_INNER_VLAN_ID_VALUE_DATA,
@@ -359,19 +404,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {0, NAS_MAX_VLAN_ID},
                 },
             },
-            &nas_acl_filter_t::get_u16_filter_val,
-            &nas_acl_filter_t::set_u16_filter_val,
         },
+        &nas_acl_filter_t::get_u16_filter_val,
+        &nas_acl_filter_t::set_u16_filter_val,
+        &nas_acl_filter_decode<uint16_t, NDI_ACL_FILTER_U16>,
+        &nas_acl_filter_encode<uint16_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_INNER_VLAN_PRI,
+    {
+        BASE_ACL_MATCH_TYPE_INNER_VLAN_PRI,
+        "MATCH_TYPE_INNER_VLAN_PRI",
         {
-            "MATCH_TYPE_INNER_VLAN_PRI",
-            {
-                BASE_ACL_ENTRY_MATCH_INNER_VLAN_PRI_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_INNER_VLAN_PRI_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_INNER_VLAN_PRI_VALUE_DATA,
@@ -388,35 +437,40 @@ static const nas_acl_filter_map_t _filter_map =
                     {0, NAS_MAX_DOT1P},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_INNER_VLAN_CFI,
+    {
+        BASE_ACL_MATCH_TYPE_INNER_VLAN_CFI,
+        "MATCH_TYPE_INNER_VLAN_CFI",
         {
-            "MATCH_TYPE_INNER_VLAN_CFI",
-            {
-                BASE_ACL_ENTRY_MATCH_INNER_VLAN_CFI_VALUE,
-                NAS_ACL_DATA_U8,
-                sizeof (uint8_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {0, NAS_ACL_MAX_CFI},
-            },
-            {},
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
+            BASE_ACL_ENTRY_MATCH_INNER_VLAN_CFI_VALUE,
+            NAS_ACL_DATA_U8,
+            sizeof (uint8_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
+            {0, NAS_ACL_MAX_CFI},
         },
+        {},
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_MATCH_TYPE_L4_SRC_PORT,
+    {
+        BASE_ACL_MATCH_TYPE_L4_SRC_PORT,
+        "MATCH_TYPE_L4_SRC_PORT",
         {
-            "MATCH_TYPE_L4_SRC_PORT",
-            {
-                BASE_ACL_ENTRY_MATCH_L4_SRC_PORT_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_L4_SRC_PORT_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_L4_SRC_PORT_VALUE_DATA,
@@ -433,19 +487,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_u16_filter_val,
-            &nas_acl_filter_t::set_u16_filter_val,
         },
+        &nas_acl_filter_t::get_u16_filter_val,
+        &nas_acl_filter_t::set_u16_filter_val,
+        &nas_acl_filter_decode<uint16_t, NDI_ACL_FILTER_U16>,
+        &nas_acl_filter_encode<uint16_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_L4_DST_PORT,
+    {
+        BASE_ACL_MATCH_TYPE_L4_DST_PORT,
+        "MATCH_TYPE_L4_DST_PORT",
         {
-            "MATCH_TYPE_L4_DST_PORT",
-            {
-                BASE_ACL_ENTRY_MATCH_L4_DST_PORT_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_L4_DST_PORT_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_L4_DST_PORT_VALUE_DATA,
@@ -462,19 +520,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_u16_filter_val,
-            &nas_acl_filter_t::set_u16_filter_val,
         },
+        &nas_acl_filter_t::get_u16_filter_val,
+        &nas_acl_filter_t::set_u16_filter_val,
+        &nas_acl_filter_decode<uint16_t, NDI_ACL_FILTER_U16>,
+        &nas_acl_filter_encode<uint16_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_ETHER_TYPE,
+    {
+        BASE_ACL_MATCH_TYPE_ETHER_TYPE,
+        "MATCH_TYPE_ETHER_TYPE",
         {
-            "MATCH_TYPE_ETHER_TYPE",
-            {
-                BASE_ACL_ENTRY_MATCH_ETHER_TYPE_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_ETHER_TYPE_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_ETHER_TYPE_VALUE_DATA,
@@ -491,19 +553,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_u16_filter_val,
-            &nas_acl_filter_t::set_u16_filter_val,
         },
+        &nas_acl_filter_t::get_u16_filter_val,
+        &nas_acl_filter_t::set_u16_filter_val,
+        &nas_acl_filter_decode<uint16_t, NDI_ACL_FILTER_U16>,
+        &nas_acl_filter_encode<uint16_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_IP_PROTOCOL,
+    {
+        BASE_ACL_MATCH_TYPE_IP_PROTOCOL,
+        "MATCH_TYPE_IP_PROTOCOL",
         {
-            "MATCH_TYPE_IP_PROTOCOL",
-            {
-                BASE_ACL_ENTRY_MATCH_IP_PROTOCOL_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_IP_PROTOCOL_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_IP_PROTOCOL_VALUE_DATA,
@@ -520,19 +586,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_DSCP,
+    {
+        BASE_ACL_MATCH_TYPE_DSCP,
+        "MATCH_TYPE_DSCP",
         {
-            "MATCH_TYPE_DSCP",
-            {
-                BASE_ACL_ENTRY_MATCH_DSCP_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_DSCP_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_DSCP_VALUE_DATA,
@@ -549,19 +619,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {0, NAS_MAX_DSCP},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_TTL,
+    {
+        BASE_ACL_MATCH_TYPE_TTL,
+        "MATCH_TYPE_TTL",
         {
-            "MATCH_TYPE_TTL",
-            {
-                BASE_ACL_ENTRY_MATCH_TTL_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_TTL_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_TTL_VALUE_DATA,
@@ -578,19 +652,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_TOS,
+    {
+        BASE_ACL_MATCH_TYPE_TOS,
+        "MATCH_TYPE_TOS",
         {
-            "MATCH_TYPE_TOS",
-            {
-                BASE_ACL_ENTRY_MATCH_TOS_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_TOS_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_TOS_VALUE_DATA,
@@ -607,19 +685,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_IP_FLAGS,
+    {
+        BASE_ACL_MATCH_TYPE_IP_FLAGS,
+        "MATCH_TYPE_IP_FLAGS",
         {
-            "MATCH_TYPE_IP_FLAGS",
-            {
-                BASE_ACL_ENTRY_MATCH_IP_FLAGS_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_IP_FLAGS_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_IP_FLAGS_VALUE_DATA,
@@ -636,19 +718,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {0, NAS_ACL_MAX_IP_FLAGS},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_TCP_FLAGS,
+    {
+        BASE_ACL_MATCH_TYPE_TCP_FLAGS,
+        "MATCH_TYPE_TCP_FLAGS",
         {
-            "MATCH_TYPE_TCP_FLAGS",
-            {
-                BASE_ACL_ENTRY_MATCH_TCP_FLAGS_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_TCP_FLAGS_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_TCP_FLAGS_VALUE_DATA,
@@ -665,51 +751,57 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_IP_TYPE,
+    {
+        BASE_ACL_MATCH_TYPE_IP_TYPE,
+        "MATCH_TYPE_IP_TYPE",
         {
-            "MATCH_TYPE_IP_TYPE",
-            {
-                BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE,
-                NAS_ACL_DATA_U32,
-                sizeof (uint32_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_IP_TYPE_VALUE,
+            NAS_ACL_DATA_U32,
+            sizeof (uint32_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_filter_t::get_ip_type_filter_val,
-            &nas_acl_filter_t::set_ip_type_filter_val,
         },
+        {},
+        &nas_acl_filter_t::get_ip_type_filter_val,
+        &nas_acl_filter_t::set_ip_type_filter_val,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_MATCH_TYPE_IP_FRAG,
+    {
+        BASE_ACL_MATCH_TYPE_IP_FRAG,
+        "MATCH_TYPE_IP_FRAG",
         {
-            "MATCH_TYPE_IP_FRAG",
-            {
-                BASE_ACL_ENTRY_MATCH_IP_FRAG_VALUE,
-                NAS_ACL_DATA_U32,
-                sizeof (uint32_t),
-                NAS_ACL_ATTR_MODE_MANDATORY,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_IP_FRAG_VALUE,
+            NAS_ACL_DATA_U32,
+            sizeof (uint32_t),
+            NAS_ACL_ATTR_MODE_MANDATORY,
             {},
-            &nas_acl_filter_t::get_ip_frag_filter_val,
-            &nas_acl_filter_t::set_ip_frag_filter_val,
         },
+        {},
+        &nas_acl_filter_t::get_ip_frag_filter_val,
+        &nas_acl_filter_t::set_ip_frag_filter_val,
+        NULL,
+        NULL,
     },
 
-    {BASE_ACL_MATCH_TYPE_IPV6_FLOW_LABEL,
+    {
+        BASE_ACL_MATCH_TYPE_IPV6_FLOW_LABEL,
+        "MATCH_TYPE_IPV6_FLOW_LABEL",
         {
-            "MATCH_TYPE_IPV6_FLOW_LABEL",
-            {
-                BASE_ACL_ENTRY_MATCH_IPV6_FLOW_LABEL_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_IPV6_FLOW_LABEL_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_IPV6_FLOW_LABEL_VALUE_DATA,
@@ -726,19 +818,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {0, NAS_ACL_MAX_IPV6_FLOW_LABEL},
                 },
             },
-            &nas_acl_filter_t::get_u32_filter_val,
-            &nas_acl_filter_t::set_u32_filter_val,
         },
+        &nas_acl_filter_t::get_u32_filter_val,
+        &nas_acl_filter_t::set_u32_filter_val,
+        &nas_acl_filter_decode<uint32_t, NDI_ACL_FILTER_U32>,
+        &nas_acl_filter_encode<uint32_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_TC,
+    {
+        BASE_ACL_MATCH_TYPE_TC,
+        "MATCH_TYPE_TC",
         {
-            "MATCH_TYPE_TC",
-            {
-                BASE_ACL_ENTRY_MATCH_TC_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_TC_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_TC_VALUE_DATA,
@@ -755,19 +851,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_ECN,
+    {
+        BASE_ACL_MATCH_TYPE_ECN,
+        "MATCH_TYPE_ECN",
         {
-            "MATCH_TYPE_ECN",
-            {
-                BASE_ACL_ENTRY_MATCH_ECN_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_ECN_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_ECN_VALUE_DATA,
@@ -784,19 +884,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {0, NAS_ACL_MAX_ECN},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_ICMP_TYPE,
+    {
+        BASE_ACL_MATCH_TYPE_ICMP_TYPE,
+        "MATCH_TYPE_ICMP_TYPE",
         {
-            "MATCH_TYPE_ICMP_TYPE",
-            {
-                BASE_ACL_ENTRY_MATCH_ICMP_TYPE_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_ICMP_TYPE_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_ICMP_TYPE_VALUE_DATA,
@@ -813,19 +917,23 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
     },
 
-    {BASE_ACL_MATCH_TYPE_ICMP_CODE,
+    {
+        BASE_ACL_MATCH_TYPE_ICMP_CODE,
+        "MATCH_TYPE_ICMP_CODE",
         {
-            "MATCH_TYPE_ICMP_CODE",
-            {
-                BASE_ACL_ENTRY_MATCH_ICMP_CODE_VALUE,
-                NAS_ACL_DATA_EMBEDDED,
-                {},
-            },
+            BASE_ACL_ENTRY_MATCH_ICMP_CODE_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
             {
                 {
                     BASE_ACL_ENTRY_MATCH_ICMP_CODE_VALUE_DATA,
@@ -842,32 +950,179 @@ static const nas_acl_filter_map_t _filter_map =
                     {},
                 },
             },
-            &nas_acl_filter_t::get_u8_filter_val,
-            &nas_acl_filter_t::set_u8_filter_val,
         },
+        &nas_acl_filter_t::get_u8_filter_val,
+        &nas_acl_filter_t::set_u8_filter_val,
+        &nas_acl_filter_decode<uint8_t, NDI_ACL_FILTER_U8>,
+        &nas_acl_filter_encode<uint8_t>,
+    },
+
+    {
+        BASE_ACL_MATCH_TYPE_L4_SRC_PORT_RANGE,
+        "MATCH_TYPE_L4_SRC_PORT_RANGE",
+        {
+            BASE_ACL_ENTRY_MATCH_L4_SRC_PORT_RANGE_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
+            {
+                {
+                    BASE_ACL_ENTRY_MATCH_L4_SRC_PORT_RANGE_VALUE_MIN,
+                    NAS_ACL_DATA_U16,
+                    sizeof (uint16_t),
+                    NAS_ACL_ATTR_MODE_MANDATORY,
+                    {},
+                },
+                {
+                    BASE_ACL_ENTRY_MATCH_L4_SRC_PORT_RANGE_VALUE_MAX,
+                    NAS_ACL_DATA_U16,
+                    sizeof (uint16_t),
+                    NAS_ACL_ATTR_MODE_MANDATORY,
+                    {},
+                },
+            },
+        },
+        &nas_acl_filter_t::get_l4_port_range_filter_val,
+        &nas_acl_filter_t::set_l4_port_range_filter_val,
+        NULL,
+        NULL,
     },
 
+    {
+        BASE_ACL_MATCH_TYPE_L4_DST_PORT_RANGE,
+        "MATCH_TYPE_L4_DST_PORT_RANGE",
+        {
+            BASE_ACL_ENTRY_MATCH_L4_DST_PORT_RANGE_VALUE,
+            NAS_ACL_DATA_EMBEDDED,
+            {},
+        },
+        {
+            2,
+            {
+                {
+                    BASE_ACL_ENTRY_MATCH_L4_DST_PORT_RANGE_VALUE_MIN,
+                    NAS_ACL_DATA_U16,
+                    sizeof (uint16_t),
+                    NAS_ACL_ATTR_MODE_MANDATORY,
+                    {},
+                },
+                {
+                    BASE_ACL_ENTRY_MATCH_L4_DST_PORT_RANGE_VALUE_MAX,
+                    NAS_ACL_DATA_U16,
+                    sizeof (uint16_t),
+                    NAS_ACL_ATTR_MODE_MANDATORY,
+                    {},
+                },
+            },
+        },
+        &nas_acl_filter_t::get_l4_port_range_filter_val,
+        &nas_acl_filter_t::set_l4_port_range_filter_val,
+        NULL,
+        NULL,
+    },
 };
 
+static constexpr size_t _filter_map_size = sizeof (_filter_map) / sizeof (_filter_map[0]);
+
+static constexpr bool _filter_map_in_order (size_t idx)
+{
+    return ((idx == _filter_map_size) ||
+            (((size_t) _filter_map[idx].type == (size_t) _filter_map[0].type + idx) &&
+             _filter_map_in_order (idx + 1)));
+}
+
+static_assert (_filter_map_in_order (0),
+               "_filter_map must have one slot per BASE_ACL_MATCH_TYPE_t in enum order");
+
+/*
+ * Never called. Breaks the build when the model adds a Match type
+ * that is not listed here - add the new type to _filter_map as well.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wswitch"
+static inline bool _filter_map_has_type (BASE_ACL_MATCH_TYPE_t type) noexcept
+{
+    switch (type) {
+        case BASE_ACL_MATCH_TYPE_SRC_IPV6:
+        case BASE_ACL_MATCH_TYPE_DST_IPV6:
+        case BASE_ACL_MATCH_TYPE_SRC_MAC:
+        case BASE_ACL_MATCH_TYPE_DST_MAC:
+        case BASE_ACL_MATCH_TYPE_SRC_IP:
+        case BASE_ACL_MATCH_TYPE_DST_IP:
+        case BASE_ACL_MATCH_TYPE_IN_PORTS:
+        case BASE_ACL_MATCH_TYPE_OUT_PORTS:
+        case BASE_ACL_MATCH_TYPE_IN_PORT:
+        case BASE_ACL_MATCH_TYPE_OUT_PORT:
+        case BASE_ACL_MATCH_TYPE_OUTER_VLAN_ID:
+        case BASE_ACL_MATCH_TYPE_OUTER_VLAN_PRI:
+        case BASE_ACL_MATCH_TYPE_OUTER_VLAN_CFI:
+        case BASE_ACL_MATCH_TYPE_INNER_VLAN_ID:
+        case BASE_ACL_MATCH_TYPE_INNER_VLAN_PRI:
+        case BASE_ACL_MATCH_TYPE_INNER_VLAN_CFI:
+        case BASE_ACL_MATCH_TYPE_L4_SRC_PORT:
+        case BASE_ACL_MATCH_TYPE_L4_DST_PORT:
+        case BASE_ACL_MATCH_TYPE_ETHER_TYPE:
+        case BASE_ACL_MATCH_TYPE_IP_PROTOCOL:
+        case BASE_ACL_MATCH_TYPE_DSCP:
+        case BASE_ACL_MATCH_TYPE_TTL:
+        case BASE_ACL_MATCH_TYPE_TOS:
+        case BASE_ACL_MATCH_TYPE_IP_FLAGS:
+        case BASE_ACL_MATCH_TYPE_TCP_FLAGS:
+        case BASE_ACL_MATCH_TYPE_IP_TYPE:
+        case BASE_ACL_MATCH_TYPE_IP_FRAG:
+        case BASE_ACL_MATCH_TYPE_IPV6_FLOW_LABEL:
+        case BASE_ACL_MATCH_TYPE_TC:
+        case BASE_ACL_MATCH_TYPE_ECN:
+        case BASE_ACL_MATCH_TYPE_ICMP_TYPE:
+        case BASE_ACL_MATCH_TYPE_ICMP_CODE:
+        case BASE_ACL_MATCH_TYPE_L4_SRC_PORT_RANGE:
+        case BASE_ACL_MATCH_TYPE_L4_DST_PORT_RANGE:
+            return true;
+    }
+    return false;
+}
+#pragma GCC diagnostic pop
+
+const nas_acl_filter_info_t* nas_acl_get_filter_info (BASE_ACL_MATCH_TYPE_t type) noexcept
+{
+    size_t idx = (size_t) type - (size_t) _filter_map[0].type;
+
+    if (idx >= _filter_map_size) {
+        return NULL;
+    }
+    return &_filter_map[idx];
+}
+
 const char* nas_acl_filter_type_name (BASE_ACL_MATCH_TYPE_t type) noexcept
 {
-    auto it = _filter_map.find (type);
-    if (it == _filter_map.end()) {
+    auto map_info = nas_acl_get_filter_info (type);
+    if (map_info == NULL) {
         return "Invalid Filter Type";
     }
-    return it->second.name.c_str();
+    return map_info->name;
 }
 
-bool nas_acl_filter_is_type_valid (BASE_ACL_MATCH_TYPE_t f_type) noexcept
+// Accepts the model enum name with or without the "MATCH_TYPE_" prefix
+bool nas_acl_filter_type_from_name (const char* name, BASE_ACL_MATCH_TYPE_t* type) noexcept
 {
-    if (_filter_map.find (f_type) == _filter_map.end()) {
-        return false;
+    static constexpr size_t prefix_len = sizeof ("MATCH_TYPE_") - 1;
+
+    if (strncmp (name, "MATCH_TYPE_", prefix_len) == 0) {
+        name += prefix_len;
+    }
+
+    for (size_t idx = 0; idx < _filter_map_size; idx++) {
+        if (strcmp (_filter_map[idx].name + prefix_len, name) == 0) {
+            *type = _filter_map[idx].type;
+            return true;
+        }
     }
-    return true;
+    return false;
 }
 
-nas_acl_filter_map_t& nas_acl_get_filter_map () noexcept
+bool nas_acl_filter_is_type_valid (BASE_ACL_MATCH_TYPE_t f_type) noexcept
 {
-    return (_filter_map);
+    return (nas_acl_get_filter_info (f_type) != NULL);
 }
-
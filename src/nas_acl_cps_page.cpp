@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*!
+ * \file   nas_acl_cps_page.cpp
+ * \brief  Paged GET of ACL Entries, Counters and Stats
+ */
+
+#include "nas_acl_cps_page.h"
+#include "nas_acl_log.h"
+#include <string.h>
+
+nas_acl_get_page_t::nas_acl_get_page_t (cps_api_object_t filter_obj,
+                                        cps_api_attr_id_t limit_attr,
+                                        cps_api_attr_id_t cursor_attr) noexcept
+    : _cursor_attr (cursor_attr)
+{
+    if (filter_obj == NULL) {
+        return;
+    }
+
+    auto limit = cps_api_object_attr_get (filter_obj, limit_attr);
+    if (limit != NULL) {
+        _limit = cps_api_object_attr_data_u32 (limit);
+    }
+
+    auto cursor = cps_api_object_attr_get (filter_obj, cursor_attr);
+    if (cursor == NULL) {
+        return;
+    }
+
+    if (cps_api_object_attr_len (cursor) != sizeof (_cursor)) {
+        NAS_ACL_LOG_ERR ("Bad GET cursor length %ld", cps_api_object_attr_len (cursor));
+        _valid = false;
+        return;
+    }
+
+    memcpy (&_cursor, cps_api_object_attr_data_bin (cursor), sizeof (_cursor));
+    _resume = true;
+
+    NAS_ACL_LOG_DETAIL ("GET resumes after Switch %d Table %ld Object %ld, Limit %ld",
+                        _cursor.switch_id, _cursor.table_id, _cursor.obj_id, _limit);
+}
+
+bool nas_acl_get_page_t::take () noexcept
+{
+    if (_limit != 0 && _count >= _limit) {
+        _more = true;
+        return false;
+    }
+    return true;
+}
+
+void nas_acl_get_page_t::added (nas_switch_id_t switch_id, nas_obj_id_t table_id,
+                                nas_obj_id_t obj_id) noexcept
+{
+    _last = {switch_id, table_id, obj_id};
+    _count++;
+}
+
+bool nas_acl_get_page_t::finish (cps_api_object_list_t list) const noexcept
+{
+    if (!_more) {
+        return true;
+    }
+
+    auto size = cps_api_object_list_size (list);
+    if (size == 0) {
+        return false;
+    }
+
+    auto obj = cps_api_object_list_get (list, size - 1);
+    return cps_api_object_attr_add (obj, _cursor_attr, &_last, sizeof (_last));
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_cps_perf.cpp
+ * \brief  This file contains CPS related ACL latency histogram functionality
+ */
+#include "event_log.h"
+#include "std_error_codes.h"
+#include "cps_api_operation.h"
+#include "cps_api_object_key.h"
+#include "cps_class_map.h"
+#include "nas_acl_log.h"
+#include "nas_acl_cps.h"
+#include "nas_acl_perf.h"
+
+static t_std_error nas_acl_perf_stats_clear (cps_api_object_t obj,
+                                             cps_api_object_t prev,
+                                             bool             rollback) noexcept;
+
+static nas_acl_write_operation_map_t nas_acl_perf_stats_op_map [] = {
+    {cps_api_oper_DELETE, nas_acl_perf_stats_clear},
+};
+
+nas_acl_write_operation_map_t *
+nas_acl_get_perf_stats_op_map (cps_api_operation_types_t op) noexcept
+{
+    return (op == cps_api_oper_DELETE) ? &nas_acl_perf_stats_op_map[0]: NULL;
+}
+
+static bool nas_acl_perf_stats_fill (cps_api_object_t obj,
+                                     const std::string& name,
+                                     const nas_acl_perf_hist_t& hist) noexcept
+{
+    if (!cps_api_key_from_attr_with_qual (cps_api_object_key (obj),
+                                          BASE_ACL_PERF_STATS_OBJ,
+                                          cps_api_qualifier_TARGET)) {
+        NAS_ACL_LOG_ERR ("Failed to create Key from Perf Stats Object");
+        return false;
+    }
+
+    if (!cps_api_object_attr_add (obj, BASE_ACL_PERF_STATS_NAME,
+                                  name.c_str (), name.size () + 1) ||
+        !cps_api_object_attr_add_u64 (obj, BASE_ACL_PERF_STATS_COUNT,
+                                      hist.count) ||
+        !cps_api_object_attr_add_u64 (obj, BASE_ACL_PERF_STATS_TOTAL_TIME,
+                                      hist.total_ns) ||
+        !cps_api_object_attr_add_u64 (obj, BASE_ACL_PERF_STATS_MAX_TIME,
+                                      hist.max_ns)) {
+        return false;
+    }
+
+    // Leaf-list position is the log2 bucket index
+    for (size_t bucket = 0; bucket < NAS_ACL_PERF_HIST_BUCKETS; bucket++) {
+        if (!cps_api_object_attr_add_u64 (obj, BASE_ACL_PERF_STATS_BUCKET,
+                                          hist.bucket[bucket])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+t_std_error nas_acl_get_perf_stats (cps_api_get_params_t *param, size_t index,
+                                    cps_api_object_t filter_obj) noexcept
+{
+    std::string filtr_name;
+
+    auto name_attr = cps_api_object_attr_get (filter_obj, BASE_ACL_PERF_STATS_NAME);
+    if (name_attr != NULL) {
+        filtr_name = static_cast<const char*> (cps_api_object_attr_data_bin (name_attr));
+    }
+
+    t_std_error rc = NAS_ACL_E_NONE;
+
+    try {
+        nas_acl_perf_walk ([&] (const std::string& name,
+                                const nas_acl_perf_hist_t& hist) {
+
+            if (rc != NAS_ACL_E_NONE ||
+                (!filtr_name.empty () && filtr_name != name)) {
+                return;
+            }
+
+            cps_api_object_t obj = cps_api_object_list_create_obj_and_append (param->list);
+
+            if (obj == NULL || !nas_acl_perf_stats_fill (obj, name, hist)) {
+                NAS_ACL_LOG_ERR ("Perf stats %s fill failed. Index: %ld",
+                                 name.c_str (), index);
+                rc = NAS_ACL_E_MEM;
+            }
+        });
+    } catch (std::bad_alloc& e) {
+        return NAS_ACL_E_MEM;
+    }
+
+    return rc;
+}
+
+static t_std_error nas_acl_perf_stats_clear (cps_api_object_t obj,
+                                             cps_api_object_t prev,
+                                             bool             rollback) noexcept
+{
+    NAS_ACL_LOG_BRIEF ("Clearing ACL latency histograms");
+
+    // Dump the histograms to the log before they are lost
+    nas_acl_perf_dump ();
+    nas_acl_perf_reset ();
+
+    // No rollback for Perf Stats - hence no need to fill prev obj
+    return NAS_ACL_E_NONE;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*!
+ * \file   nas_acl_cps_pool.cpp
+ * \brief  This file contains CPS related ACL slab pool statistics functionality
+ */
+#include "event_log.h"
+#include "std_error_codes.h"
+#include "cps_api_operation.h"
+#include "cps_api_object_key.h"
+#include "cps_class_map.h"
+#include "nas_acl_log.h"
+#include "nas_acl_cps.h"
+#include "nas_acl_switch_list.h"
+
+static bool nas_acl_pool_stats_fill (cps_api_object_t obj,
+                                     nas_switch_id_t switch_id,
+                                     nas_obj_id_t table_id,
+                                     const nas_acl_pool_t& pool,
+                                     const nas_acl_pool_stats_t& stats) noexcept
+{
+    if (!cps_api_key_from_attr_with_qual (cps_api_object_key (obj),
+                                          BASE_ACL_POOL_STATS_OBJ,
+                                          cps_api_qualifier_TARGET)) {
+        NAS_ACL_LOG_ERR ("Failed to create Key from Pool Stats Object");
+        return false;
+    }
+
+    return (cps_api_object_attr_add_u32 (obj, BASE_ACL_POOL_STATS_SWITCH_ID,
+                                         switch_id) &&
+            cps_api_object_attr_add_u64 (obj, BASE_ACL_POOL_STATS_TABLE_ID,
+                                         table_id) &&
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_POOL_STATS_BLOCK_SIZE,
+                                         stats.block_size) &&
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_POOL_STATS_SLABS,
+                                         stats.slabs) &&
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_POOL_STATS_BLOCKS_TOTAL,
+                                         stats.blocks_total) &&
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_POOL_STATS_BLOCKS_IN_USE,
+                                         stats.blocks_in_use) &&
+            cps_api_object_attr_add_u64 (obj, BASE_ACL_POOL_STATS_ALLOCS,
+                                         stats.allocs) &&
+            cps_api_object_attr_add_u64 (obj, BASE_ACL_POOL_STATS_REUSED,
+                                         stats.reused) &&
+            cps_api_object_attr_add_u64 (obj, BASE_ACL_POOL_STATS_HEAP_ALLOCS,
+                                         pool.heap_allocs ()));
+}
+
+// One object per size class in use, for every Table or only the
+// Table in the filter object
+t_std_error nas_acl_get_pool_stats (cps_api_get_params_t *param, size_t index,
+                                    cps_api_object_t filter_obj) noexcept
+{
+    auto table_attr = cps_api_object_attr_get (filter_obj, BASE_ACL_POOL_STATS_TABLE_ID);
+    nas_obj_id_t filtr_table_id = (table_attr != NULL) ?
+                                  cps_api_object_attr_data_u64 (table_attr) : 0;
+
+    try {
+        for (const auto& switch_pair: nas_acl_get_switch_list ()) {
+
+            const nas_acl_switch& s = switch_pair.second;
+
+            for (const auto& table_pair: s.table_list ()) {
+
+                nas_obj_id_t table_id = table_pair.first;
+
+                if (table_attr != NULL && filtr_table_id != table_id) {
+                    continue;
+                }
+
+                auto pool_p = s.table_pool (table_id);
+                if (pool_p == nullptr) {
+                    continue;
+                }
+
+                for (const auto& stats: pool_p->stats ()) {
+
+                    cps_api_object_t obj =
+                        cps_api_object_list_create_obj_and_append (param->list);
+
+                    if (obj == NULL ||
+                        !nas_acl_pool_stats_fill (obj, switch_pair.first, table_id,
+                                                  *pool_p, stats)) {
+                        NAS_ACL_LOG_ERR ("Table %ld pool stats fill failed. Index: %ld",
+                                         table_id, index);
+                        return NAS_ACL_E_MEM;
+                    }
+                }
+            }
+        }
+    } catch (std::bad_alloc& e) {
+        return NAS_ACL_E_MEM;
+    }
+
+    return NAS_ACL_E_NONE;
+}
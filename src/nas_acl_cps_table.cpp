@@ -30,6 +30,9 @@
 #include "nas_acl_utl.h"
 #include "nas_acl_cps_key.h"
 #include "nas_acl_switch_list.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_event.h"
+#include <stdint.h>
 
 static t_std_error
 nas_acl_table_create (cps_api_object_t obj,
@@ -120,6 +123,79 @@ nas_acl_fill_table_attr_info (cps_api_object_t obj, const nas_acl_table& table,
         return false;
     }
 
+    // Quotas are only present if they were set
+    if (table.hw_quota ().rows != 0 &&
+        !cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_MAX_ROWS,
+                                      table.hw_quota ().rows)) {
+        return false;
+    }
+
+    if (table.hw_quota ().counters != 0 &&
+        !cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_MAX_COUNTERS,
+                                      table.hw_quota ().counters)) {
+        return false;
+    }
+
+    return true;
+}
+
+// Hardware usage of the Table in each of its NPUs. Free counts are left
+// out when neither the Table quota nor the NPU capacity limits them.
+static bool nas_acl_fill_table_hw_usage (cps_api_object_t obj,
+                                         const nas_acl_table& table) noexcept
+{
+    auto& s = table.get_switch ();
+    cps_api_attr_id_t ids[3] = {BASE_ACL_TABLE_HW_USAGE, 0, 0};
+    size_t idx = 0;
+
+    // Usage-List-Attr . ListIndex . Usage-Child-Attr
+    for (auto npu_id: table.npu_list ()) {
+
+        auto used = s.table_hw_usage (table.table_id (), npu_id);
+        auto room = s.hw_headroom (table, npu_id);
+
+        uint32_t npu = npu_id;
+        uint32_t val;
+
+        ids[1] = idx++;
+
+        ids[2] = BASE_ACL_TABLE_HW_USAGE_NPU_ID;
+        if (!cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                                   &npu, sizeof (npu))) {
+            return false;
+        }
+
+        ids[2] = BASE_ACL_TABLE_HW_USAGE_ROWS_USED;
+        val = used.rows;
+        if (!cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                                   &val, sizeof (val))) {
+            return false;
+        }
+
+        ids[2] = BASE_ACL_TABLE_HW_USAGE_COUNTERS_USED;
+        val = used.counters;
+        if (!cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                                   &val, sizeof (val))) {
+            return false;
+        }
+
+        ids[2] = BASE_ACL_TABLE_HW_USAGE_ROWS_FREE;
+        val = room.rows;
+        if (room.rows != SIZE_MAX &&
+            !cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                                   &val, sizeof (val))) {
+            return false;
+        }
+
+        ids[2] = BASE_ACL_TABLE_HW_USAGE_COUNTERS_FREE;
+        val = room.counters;
+        if (room.counters != SIZE_MAX &&
+            !cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                                   &val, sizeof (val))) {
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -164,6 +240,12 @@ static t_std_error nas_acl_get_table_info (cps_api_get_params_t *param,
          return cps_api_ret_code_ERR;
     }
 
+    if (nas_acl_fill_table_hw_usage (obj, table) == false) {
+         NAS_ACL_LOG_ERR ("nas_acl_fill_table_hw_usage() failed. "
+                          "Index: %ld", index);
+         return cps_api_ret_code_ERR;
+    }
+
     return cps_api_ret_code_OK;
 }
 
@@ -235,21 +317,99 @@ t_std_error nas_acl_get_table (cps_api_get_params_t *param, size_t index,
     return (rc);
 }
 
-static
-t_std_error nas_acl_table_create (cps_api_object_t obj,
-                                  cps_api_object_t prev,
-                                  bool             is_rollbk_op) noexcept
+// Parse the attributes of a Table Create object into table
+void nas_acl_parse_table_obj (cps_api_object_t obj, nas_acl_table& table)
 {
     cps_api_object_it_t    it;
     cps_api_attr_id_t      attr_id;
-    nas_switch_id_t        switch_id;
     uint32_t               npu;
-    nas_obj_id_t           table_id;
     uint_t                 stage;
     uint_t                 priority;
     uint_t                 match_field;
     bool                   is_stage_present = false;
     bool                   is_priority_present = false;
+
+    for (cps_api_object_it_begin (obj, &it);
+         cps_api_object_it_valid (&it); cps_api_object_it_next (&it)) {
+
+        attr_id = cps_api_object_attr_id (it.attr);
+
+        switch (attr_id) {
+            case BASE_ACL_TABLE_STAGE:
+                if (is_stage_present == true) {
+                    throw nas::base_exception {NAS_ACL_E_DUPLICATE,
+                        __FUNCTION__, "Duplicate Stage attribute "};
+                }
+                else {
+                    is_stage_present = true;
+                    stage = cps_api_object_attr_data_u32 (it.attr);
+                    table.set_stage (stage);
+                    NAS_ACL_LOG_DETAIL ("Stage: %d", stage);
+                }
+                break;
+
+            case BASE_ACL_TABLE_PRIORITY:
+                if (is_priority_present == true) {
+                    throw nas::base_exception {NAS_ACL_E_DUPLICATE,
+                        __FUNCTION__, "Duplicate Priority attribute "};
+                }
+                else {
+                    is_priority_present = true;
+                    priority = cps_api_object_attr_data_u32 (it.attr);
+                    NAS_ACL_LOG_DETAIL ("Priority: %d", priority);
+                    table.set_priority (priority);
+                }
+                break;
+
+            case BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS:
+                // Must not check for duplicate attributes, since
+                // 'allowed-match-fields' is a leaf-list and it will
+                // appear multiple times, once for each element in
+                // the list.
+                match_field = cps_api_object_attr_data_u32 (it.attr);
+                NAS_ACL_LOG_DETAIL ("Match field: %d (%s)", match_field,
+                                    nas_acl_filter_type_name (static_cast
+                                                              <BASE_ACL_MATCH_TYPE_t>
+                                                              (match_field)));
+
+                table.set_allowed_filter (match_field);
+                break;
+
+            case BASE_ACL_TABLE_MAX_ROWS:
+                table.set_max_rows (cps_api_object_attr_data_u32 (it.attr));
+                NAS_ACL_LOG_DETAIL ("Max Rows: %ld", table.hw_quota ().rows);
+                break;
+
+            case BASE_ACL_TABLE_MAX_COUNTERS:
+                table.set_max_counters (cps_api_object_attr_data_u32 (it.attr));
+                NAS_ACL_LOG_DETAIL ("Max Counters: %ld", table.hw_quota ().counters);
+                break;
+
+            case BASE_ACL_TABLE_NPU_ID_LIST:
+                // Must not check for duplicate attributes, since
+                // 'npu-id-list' is a leaf-list and it will
+                // appear multiple times, once for each element in
+                // the list.
+                npu = cps_api_object_attr_data_u32 (it.attr);
+                NAS_ACL_LOG_DETAIL ("NPU Id: %d", npu);
+                table.add_npu (npu);
+                break;
+
+            default:
+                NAS_ACL_LOG_DETAIL ("Unknown attribute ignored %lu(%lx)",
+                                    attr_id, attr_id);
+                break;
+        }
+    }
+}
+
+static
+t_std_error nas_acl_table_create (cps_api_object_t obj,
+                                  cps_api_object_t prev,
+                                  bool             is_rollbk_op) noexcept
+{
+    nas_switch_id_t        switch_id;
+    nas_obj_id_t           table_id;
     bool                   id_passed_in = false;
 
     if (!nas_acl_cps_key_get_switch_id (obj, NAS_ACL_SWITCH_ATTR,
@@ -276,70 +436,10 @@ t_std_error nas_acl_table_create (cps_api_object_t obj,
             }
         }
 
+        nas_acl_perf_phase_timer_t perf (NAS_ACL_PERF_PHASE_PARSE);
         nas_acl_table tmp_table (&s);
 
-        for (cps_api_object_it_begin (obj, &it);
-             cps_api_object_it_valid (&it); cps_api_object_it_next (&it)) {
-
-            attr_id = cps_api_object_attr_id (it.attr);
-
-            switch (attr_id) {
-                case BASE_ACL_TABLE_STAGE:
-                    if (is_stage_present == true) {
-                        throw nas::base_exception {NAS_ACL_E_DUPLICATE,
-                            __FUNCTION__, "Duplicate Stage attribute "};
-                    }
-                    else {
-                        is_stage_present = true;
-                        stage = cps_api_object_attr_data_u32 (it.attr);
-                        tmp_table.set_stage (stage);
-                        NAS_ACL_LOG_DETAIL ("Stage: %d", stage);
-                    }
-                    break;
-
-                case BASE_ACL_TABLE_PRIORITY:
-                    if (is_priority_present == true) {
-                        throw nas::base_exception {NAS_ACL_E_DUPLICATE,
-                            __FUNCTION__, "Duplicate Priority attribute "};
-                    }
-                    else {
-                        is_priority_present = true;
-                        priority = cps_api_object_attr_data_u32 (it.attr);
-                        NAS_ACL_LOG_DETAIL ("Priority: %d", priority);
-                        tmp_table.set_priority (priority);
-                    }
-                    break;
-
-                case BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS:
-                    // Must not check for duplicate attributes, since
-                    // 'allowed-match-fields' is a leaf-list and it will
-                    // appear multiple times, once for each element in
-                    // the list.
-                    match_field = cps_api_object_attr_data_u32 (it.attr);
-                    NAS_ACL_LOG_DETAIL ("Match field: %d (%s)", match_field,
-                                        nas_acl_filter_type_name (static_cast
-                                                                  <BASE_ACL_MATCH_TYPE_t>
-                                                                  (match_field)));
-
-                    tmp_table.set_allowed_filter (match_field);
-                    break;
-
-                case BASE_ACL_TABLE_NPU_ID_LIST:
-                    // Must not check for duplicate attributes, since
-                    // 'npu-id-list' is a leaf-list and it will
-                    // appear multiple times, once for each element in
-                    // the list.
-                    npu = cps_api_object_attr_data_u32 (it.attr);
-                    NAS_ACL_LOG_DETAIL ("NPU Id: %d", npu);
-                    tmp_table.add_npu (npu);
-                    break;
-
-                default:
-                    NAS_ACL_LOG_DETAIL ("Unknown attribute ignored %lu(%lx)",
-                                        attr_id, attr_id);
-                    break;
-            }
-        }
+        nas_acl_parse_table_obj (obj, tmp_table);
 
         // Allocate a new ID for the Table beforehand
         // to avoid rolling back commit if ID allocation fails
@@ -351,14 +451,18 @@ t_std_error nas_acl_table_create (cps_api_object_t obj,
         }
         tmp_table.set_table_id (table_id);
 
+        perf.next (NAS_ACL_PERF_PHASE_COMMIT);
         tmp_table.commit_create (is_rollbk_op);
 
         // WARNING !!! CANNOT throw error or exception beyond this point
         // since table is already committed to SAI
 
+        perf.next (NAS_ACL_PERF_PHASE_SAVE);
         nas_acl_table& new_table = s.save_table (std::move (tmp_table));
         idg.unguard();
+        perf.stop ();
         table_id = new_table.table_id ();
+        nas_acl_event_note (BASE_ACL_TABLE_OBJ, cps_api_oper_CREATE, table_id, table_id);
         NAS_ACL_LOG_BRIEF ("Table Creation successful. Switch Id: %d, "
                            "Table Id: %ld", switch_id, table_id);
 
@@ -418,12 +522,16 @@ t_std_error nas_acl_table_delete (cps_api_object_t obj,
             nas_acl_fill_table_attr_info (prev, curr_table);
         }
 
+        nas_acl_perf_phase_timer_t perf (NAS_ACL_PERF_PHASE_COMMIT);
         curr_table.commit_delete (is_rollbk_op);
 
         // WARNING !!! CANNOT throw error or exception beyond this point
         // since table is already deleted from SAI
 
+        perf.next (NAS_ACL_PERF_PHASE_SAVE);
         s.remove_table (table_id);
+        perf.stop ();
+        nas_acl_event_note (BASE_ACL_TABLE_OBJ, cps_api_oper_DELETE, table_id, table_id);
 
     } catch (nas::base_exception& e) {
 
@@ -36,11 +36,11 @@ static bool _add_data_to_obj (cps_api_object_t       obj,
                               NAS_ACL_DATA_TYPE_t    obj_data_type)
 {
     cps_api_object_ATTR_TYPE_t  cps_attr_type;
-    void                       *p_data;
+    const void                 *p_data;
     size_t                      size;
 
     if (obj_data_type == NAS_ACL_DATA_OPAQUE) {
-        return nas::ndi_obj_id_table_cps_serialize (in_common_data.ndi_obj_id_table,
+        return nas::ndi_obj_id_table_cps_serialize (in_common_data.ndi_obj_id_table (),
                                                     obj, attr_list.data(),
                                                     attr_list.size());
     }
@@ -86,8 +86,8 @@ static bool _add_data_to_obj (cps_api_object_t       obj,
             break;
 
         case NAS_ACL_DATA_BIN:
-            p_data        = in_common_data.bytes.data();
-            size          = in_common_data.bytes.size();
+            p_data        = in_common_data.bytes_data ();
+            size          = in_common_data.bytes_size ();
             cps_attr_type = cps_api_object_ATTR_T_BIN;
             break;
 
@@ -231,7 +231,7 @@ _copy_iflist_data_to_obj (cps_api_object_t            obj,
         return false;
     }
 
-    for (auto if_index: common_data_list.at(0).ifindex_list) {
+    for (auto if_index: common_data_list.at(0).ifindex_list ()) {
 
         if (!cps_api_object_e_add (obj,
                                    parent_list.data (),
@@ -249,7 +249,7 @@ _copy_iflist_data_to_obj (cps_api_object_t            obj,
 static nas_acl_common_data_t _cps_wr_attr_data  (cps_api_object_attr_t  attr_val,
                                                  NAS_ACL_DATA_TYPE_t    obj_data_type,
                                                  size_t                 attr_len,
-                                                 const std::string&     sub_obj_name)
+                                                 const char*            sub_obj_name)
 {
     nas_acl_common_data_t  out_common_data {};
 
@@ -282,12 +282,8 @@ static nas_acl_common_data_t _cps_wr_attr_data  (cps_api_object_attr_t  attr_val
             break;
 
         case NAS_ACL_DATA_BIN:
-        {
-            auto data_p = (uint8_t *) cps_api_object_attr_data_bin (attr_val);
-            auto& bytes = out_common_data.bytes;
-            bytes.insert (bytes.begin(), data_p, data_p+attr_len);
+            out_common_data.set_bytes (cps_api_object_attr_data_bin (attr_val), attr_len);
             break;
-        }
 
         case NAS_ACL_DATA_NONE:
             break;
@@ -303,7 +299,7 @@ static nas_acl_common_data_t _cps_wr_attr_data  (cps_api_object_attr_t  attr_val
 
 // Fill Optional mask if not provided by setting all bits to 1
 static nas_acl_common_data_t _fill_optional_attr (const nas_acl_map_data_t&  val_info,
-                                                  const std::string& sub_obj_name)
+                                                  const char*        sub_obj_name)
 {
     nas_acl_common_data_t     out_common_data {};
 
@@ -338,11 +334,8 @@ static nas_acl_common_data_t _fill_optional_attr (const nas_acl_map_data_t&  val
             break;
 
         case NAS_ACL_DATA_BIN:
-        {
-            auto& bytes = out_common_data.bytes;
-            bytes.insert (bytes.begin(), val_info.data_len, 0xff);
+            out_common_data.fill_bytes (0xff, val_info.data_len);
             break;
-        }
         default:
             throw nas::base_exception { NAS_ACL_E_FAIL, __PRETTY_FUNCTION__,
                 std::string {"Failed to extract "} + sub_obj_name
@@ -393,29 +386,14 @@ static bool _validate_range (const nas_acl_map_data_t&  val_info,
     return true;
 }
 
-static nas_acl_common_data_t _get_data_from_obj (cps_api_object_t           obj,
-                                                 nas::attr_list_t&          attr_list,
-                                                 const nas_acl_map_data_t&  data_info,
-                                                 const std::string&         sub_obj_name)
+// Returns false if an optional attribute is missing.
+// attr_list is the hierarchy of attr_val from the top of the object
+// and is used only for error reporting
+static bool _check_attr (cps_api_object_attr_t      attr_val,
+                         const nas::attr_list_t&    attr_list,
+                         const nas_acl_map_data_t&  data_info,
+                         const char*                sub_obj_name)
 {
-    auto obj_data_type   = data_info.data_type;
-
-    if (obj_data_type == NAS_ACL_DATA_OPAQUE) {
-        nas_acl_common_data_t  common_data {};
-
-        if (nas::ndi_obj_id_table_cps_unserialize (common_data.ndi_obj_id_table,
-                                                   obj, attr_list.data(),
-                                                   attr_list.size())) {
-            return common_data;
-        } else {
-            throw nas::base_exception { NAS_ACL_E_MISSING_ATTR, __PRETTY_FUNCTION__,
-                std::string {"Failed to extract "} + sub_obj_name
-                + ": Missing Opaque Attribute " + std::to_string (data_info.attr_id) };
-        }
-    }
-
-    auto attr_val = cps_api_object_e_get (obj, attr_list.data (), attr_list.size ());
-
     if (attr_val == NULL) {
 
         if (data_info.mode == NAS_ACL_ATTR_MODE_MANDATORY) {
@@ -428,7 +406,7 @@ static nas_acl_common_data_t _get_data_from_obj (cps_api_object_t           obj,
                                         + ": No such attribute - " + attr_str};
         }
 
-        return _fill_optional_attr (data_info, sub_obj_name);
+        return false;
     }
 
     auto attr_len = cps_api_object_attr_len (attr_val);
@@ -438,11 +416,28 @@ static nas_acl_common_data_t _get_data_from_obj (cps_api_object_t           obj,
         throw nas::base_exception { NAS_ACL_E_ATTR_LEN, __PRETTY_FUNCTION__,
                 std::string {"Failed to extract "} + sub_obj_name
                 + ": Size mismatch for attribute " + std::to_string (data_info.attr_id)
-                + " data type " + nas_acl_obj_data_type_to_str (obj_data_type) +
+                + " data type " + nas_acl_obj_data_type_to_str (data_info.data_type) +
                 + " - expected: " + std::to_string (expected_size)
                 + " received: " + std::to_string (attr_len) };
     }
 
+    return true;
+}
+
+// attr_list is the hierarchy of attr_val from the top of the object
+// and is used only for error reporting
+static nas_acl_common_data_t _get_data_from_attr (cps_api_object_attr_t      attr_val,
+                                                  const nas::attr_list_t&    attr_list,
+                                                  const nas_acl_map_data_t&  data_info,
+                                                  const char*                sub_obj_name)
+{
+    if (!_check_attr (attr_val, attr_list, data_info, sub_obj_name)) {
+        return _fill_optional_attr (data_info, sub_obj_name);
+    }
+
+    auto obj_data_type = data_info.data_type;
+    auto attr_len      = cps_api_object_attr_len (attr_val);
+
     auto common_data = _cps_wr_attr_data (attr_val, obj_data_type, attr_len, sub_obj_name);
 
     if (!_validate_range (data_info, common_data)) {
@@ -457,17 +452,89 @@ static nas_acl_common_data_t _get_data_from_obj (cps_api_object_t           obj,
     return common_data;
 }
 
-static void _get_child_attrs_from_obj (cps_api_object_t               obj,
+static nas_acl_common_data_t _get_data_from_obj (cps_api_object_t           obj,
+                                                 nas::attr_list_t&          attr_list,
+                                                 const nas_acl_map_data_t&  data_info,
+                                                 const char*                sub_obj_name)
+{
+    if (data_info.data_type == NAS_ACL_DATA_OPAQUE) {
+        nas_acl_common_data_t  common_data {};
+
+        if (nas::ndi_obj_id_table_cps_unserialize (common_data.ndi_obj_id_table (),
+                                                   obj, attr_list.data(),
+                                                   attr_list.size())) {
+            return common_data;
+        } else {
+            throw nas::base_exception { NAS_ACL_E_MISSING_ATTR, __PRETTY_FUNCTION__,
+                std::string {"Failed to extract "} + sub_obj_name
+                + ": Missing Opaque Attribute " + std::to_string (data_info.attr_id) };
+        }
+    }
+
+    auto attr_val = cps_api_object_e_get (obj, attr_list.data (), attr_list.size ());
+
+    return _get_data_from_attr (attr_val, attr_list, data_info, sub_obj_name);
+}
+
+// Where the attributes of a Match/Action value are looked up from.
+// If the value was found through the list element index, the children are
+// found directly inside its container attribute (parent_attr). Otherwise
+// the full attr hierarchy is walked from the top of the object.
+typedef struct _nas_acl_attr_src_t {
+    cps_api_object_t       obj;
+    bool                   indexed;
+    cps_api_object_attr_t  parent_attr;
+} nas_acl_attr_src_t;
+
+static cps_api_object_attr_t _find_inside_attr (cps_api_object_attr_t parent_attr,
+                                                cps_api_attr_id_t     attr_id)
+{
+    if (parent_attr == NULL) {
+        return NULL;
+    }
+
+    cps_api_object_it_t it;
+    cps_api_object_it_from_attr (parent_attr, &it);
+    cps_api_object_it_inside (&it);
+
+    return cps_api_object_it_find (&it, attr_id);
+}
+
+static cps_api_object_attr_t _get_child_attr (const nas_acl_attr_src_t&  src,
+                                              nas::attr_list_t&          attr_list,
+                                              cps_api_attr_id_t          attr_id)
+{
+    if (!src.indexed) {
+        return cps_api_object_e_get (src.obj, attr_list.data (), attr_list.size ());
+    }
+
+    return _find_inside_attr (src.parent_attr, attr_id);
+}
+
+static nas_acl_common_data_t _get_child_data (const nas_acl_attr_src_t&  src,
+                                              nas::attr_list_t&          attr_list,
+                                              const nas_acl_map_data_t&  data_info,
+                                              const char*                sub_obj_name)
+{
+    if (!src.indexed || data_info.data_type == NAS_ACL_DATA_OPAQUE) {
+        return _get_data_from_obj (src.obj, attr_list, data_info, sub_obj_name);
+    }
+
+    return _get_data_from_attr (_get_child_attr (src, attr_list, data_info.attr_id),
+                                attr_list, data_info, sub_obj_name);
+}
+
+static void _get_child_attrs_from_obj (const nas_acl_attr_src_t&      src,
                                        nas::attr_list_t&              parent_list,
                                        const nas_acl_map_data_list_t& child_list,
-                                       const std::string&             subobj_name,
+                                       const char*                    subobj_name,
                                        nas_acl_common_data_list_t&    common_data_list)
 {
     for (auto data_info: child_list) {
         parent_list.push_back (data_info.attr_id);
 
-        auto common_data =_get_data_from_obj (obj, parent_list, data_info,
-                                              subobj_name);
+        auto common_data =_get_child_data (src, parent_list, data_info,
+                                           subobj_name);
         common_data_list.push_back (std::move (common_data));
 
         /* Remove the processed child attr id */
@@ -475,16 +542,20 @@ static void _get_child_attrs_from_obj (cps_api_object_t               obj,
     }
 }
 
-static nas_acl_common_data_list_t _get_child_list_from_obj (cps_api_object_t               obj,
+static nas_acl_common_data_list_t _get_child_list_from_obj (const nas_acl_attr_src_t&      src,
                                                             nas::attr_list_t&              parent_list,
                                                             const nas_acl_map_data_t&      val_info,
                                                             const nas_acl_map_data_list_t& child_list,
-                                                            const std::string&             subobj_name)
+                                                            const char*                    subobj_name)
 {
     nas_acl_common_data_list_t    common_data_list;
-    cps_api_object_it_t           it_value_list;
+    cps_api_object_it_t           it_value_list {};
 
-    cps_api_object_it (obj, parent_list.data (), parent_list.size (), &it_value_list);
+    if (!src.indexed) {
+        cps_api_object_it (src.obj, parent_list.data (), parent_list.size (), &it_value_list);
+    } else if (src.parent_attr != NULL) {
+        cps_api_object_it_from_attr (src.parent_attr, &it_value_list);
+    }
 
     if (!cps_api_object_it_valid (&it_value_list)) {
         if (val_info.mode == NAS_ACL_ATTR_MODE_MANDATORY) {
@@ -500,18 +571,21 @@ static nas_acl_common_data_list_t _get_child_list_from_obj (cps_api_object_t
 
         auto list_index = cps_api_object_attr_id (it_value_list.attr);
         parent_list.push_back (list_index);
-        _get_child_attrs_from_obj (obj, parent_list, child_list, subobj_name, common_data_list);
+
+        nas_acl_attr_src_t elem_src {src.obj, src.indexed, it_value_list.attr};
+        _get_child_attrs_from_obj (elem_src, parent_list, child_list, subobj_name,
+                                   common_data_list);
         parent_list.pop_back ();
     }
     return common_data_list;
 }
 
 static nas_acl_common_data_list_t
-_copy_non_iflist_data_from_obj (cps_api_object_t               obj,
+_copy_non_iflist_data_from_obj (const nas_acl_attr_src_t&      src,
                                 nas::attr_list_t&              parent_list,
                                 const nas_acl_map_data_t&      val_info,
                                 const nas_acl_map_data_list_t& child_list,
-                                const std::string&             subobj_name)
+                                const char*                    subobj_name)
 {
     // Full ACL Entry update -
     // Unpacking Filter/Action value from CPS obj with list of Filters or Actions
@@ -534,30 +608,39 @@ _copy_non_iflist_data_from_obj (cps_api_object_t               obj,
     // within a particular Match or Action Value
 
     if (val_info.data_type == NAS_ACL_DATA_EMBEDDED_LIST) {
-        return _get_child_list_from_obj (obj, parent_list, val_info, child_list, subobj_name);
+        return _get_child_list_from_obj (src, parent_list, val_info, child_list, subobj_name);
     }
 
     nas_acl_common_data_list_t    common_data_list;
 
     if (val_info.data_type == NAS_ACL_DATA_EMBEDDED) {
-        _get_child_attrs_from_obj (obj, parent_list, child_list, subobj_name, common_data_list);
+        common_data_list.reserve (child_list.size ());
+        _get_child_attrs_from_obj (src, parent_list, child_list, subobj_name, common_data_list);
         return common_data_list;
     }
 
-    auto common_data = _get_data_from_obj (obj, parent_list, val_info, subobj_name);
+    auto common_data = (src.indexed && val_info.data_type != NAS_ACL_DATA_OPAQUE) ?
+        _get_data_from_attr (src.parent_attr, parent_list, val_info, subobj_name) :
+        _get_data_from_obj (src.obj, parent_list, val_info, subobj_name);
     common_data_list.push_back (std::move (common_data));
     return common_data_list;
 }
 
 static nas_acl_common_data_list_t _copy_iflist_data_from_obj (cps_api_object_t   obj,
                                                               nas::attr_list_t&  parent_list,
-                                                              const std::string& sub_obj_name)
+                                                              const char*        sub_obj_name,
+                                                              const nas_acl_attr_index_t* index)
 {
     auto ifval_attr_id = parent_list.back();
     parent_list.pop_back ();
 
     cps_api_object_it_t   it_if_list;
-    if (parent_list.empty()) {
+    if (index != NULL) {
+        // Full ACL Entry update with the list element already indexed -
+        // the IF-VAL attributes are at the level of the index
+        it_if_list = index->begin ();
+
+    } else if (parent_list.empty()) {
         // Incremental update -
         // For unpacking IfList from CPS object containing a single Filter,
         //   the parent_list input param will have just 1 element
@@ -620,7 +703,7 @@ static nas_acl_common_data_list_t _copy_iflist_data_from_obj (cps_api_object_t
 
         if (cps_api_object_attr_id (it_if_list.attr) == ifval_attr_id) {
             hal_ifindex_t ifindex = cps_api_object_attr_data_u32 (it_if_list.attr);
-            common_data.ifindex_list.push_back (ifindex);
+            common_data.ifindex_list ().push_back (ifindex);
             NAS_ACL_LOG_DETAIL ("match ifindex: %d (0x%x)", ifindex, ifindex);
         }
     }
@@ -673,19 +756,57 @@ nas_acl_copy_data_from_obj (cps_api_object_t                obj,
                             nas::attr_list_t&               parent_list,
                             const nas_acl_map_data_t&       val_info,
                             const nas_acl_map_data_list_t&  child_list,
-                            const std::string&              sub_obj_name)
+                            const char*                     sub_obj_name,
+                            const nas_acl_attr_index_t*     index)
 {
     switch (val_info.data_type) {
 
         case NAS_ACL_DATA_IFLIST:
-            return _copy_iflist_data_from_obj(obj, parent_list, sub_obj_name);
+            return _copy_iflist_data_from_obj(obj, parent_list, sub_obj_name, index);
         default:
             break;
     }
-    return _copy_non_iflist_data_from_obj (obj, parent_list, val_info,
+
+    nas_acl_attr_src_t src {obj, (index != NULL),
+                            (index != NULL) ? index->find (val_info.attr_id) : NULL};
+
+    return _copy_non_iflist_data_from_obj (src, parent_list, val_info,
                                            child_list, sub_obj_name);
 }
 
+void
+nas_acl_get_attrs_from_obj (cps_api_object_t                obj,
+                            nas::attr_list_t&               parent_list,
+                            const nas_acl_map_data_t&       val_info,
+                            const nas_acl_map_data_list_t&  child_list,
+                            const char*                     name,
+                            const nas_acl_attr_index_t*     index,
+                            cps_api_object_attr_t*          attrs)
+{
+    nas_acl_attr_src_t src {obj, (index != NULL),
+                            (index != NULL) ? index->find (val_info.attr_id) : NULL};
+
+    if (val_info.data_type != NAS_ACL_DATA_EMBEDDED) {
+        attrs[0] = src.indexed ? src.parent_attr :
+            cps_api_object_e_get (obj, parent_list.data (), parent_list.size ());
+
+        _check_attr (attrs[0], parent_list, val_info, name);
+        return;
+    }
+
+    size_t attr_idx = 0;
+
+    for (const auto& data_info: child_list) {
+        parent_list.push_back (data_info.attr_id);
+
+        attrs[attr_idx] = _get_child_attr (src, parent_list, data_info.attr_id);
+        _check_attr (attrs[attr_idx], parent_list, data_info, name);
+
+        parent_list.pop_back ();
+        attr_idx++;
+    }
+}
+
 const char* nas_acl_obj_data_type_to_str (NAS_ACL_DATA_TYPE_t obj_data_type)
 {
     static const std::unordered_map
@@ -28,6 +28,8 @@
 #include "nas_acl_table.h"
 #include "nas_acl_switch.h"
 #include "nas_ndi_acl.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_warm.h"
 #include "nas_acl_log.h"
 #include <inttypes.h>
 
@@ -37,7 +39,12 @@ static void _utl_push_disable_action_to_npu (nas_acl_entry& acl_entry,
                                              bool remove_counter=false);
 
 nas_acl_entry::nas_acl_entry (const nas_acl_table* table_p)
-    :nas::base_obj_t (&(table_p->get_switch())), _table_p (table_p)
+    :nas::base_obj_t (&(table_p->get_switch())), _table_p (table_p),
+     _pool (table_p->get_switch().table_pool (table_p->table_id())),
+     _flist (0, filter_list_t::hasher (), filter_list_t::key_equal (),
+             filter_list_t::allocator_type (_pool.get ())),
+     _alist (0, action_list_t::hasher (), action_list_t::key_equal (),
+             action_list_t::allocator_type (_pool.get ()))
 {
 }
 
@@ -48,14 +55,89 @@ nas_obj_id_t  nas_acl_entry::table_id() const noexcept
 
 // Override base npu_list routine to return a more restrictive
 // NPU list in case the ACL entry is qualified with in ports or out ports
+// or only has port actions
 const nas::npu_set_t&  nas_acl_entry::npu_list () const
 {
+    if (_action_npus.size () != 0) {
+        return _action_npus;
+    }
     if (_filter_npus.size () != 0) {
         return _filter_npus;
     }
     return nas::base_obj_t::npu_list();
 }
 
+static void _npus_intersect (nas::npu_set_t& npus, const nas::npu_set_t& other)
+{
+    nas::npu_set_t  common;
+
+    for (auto npu_id: npus) {
+        if (other.contains (npu_id)) {
+            common.add (npu_id);
+        }
+    }
+    npus = common;
+}
+
+// NPUs that all the port filters have ports in - the Entry
+// matches nothing in the other NPUs
+nas::npu_set_t nas_acl_entry::_flist_npus () const
+{
+    nas::npu_set_t  npus;
+    bool            first = true;
+
+    for (auto& f_kv: _flist) {
+        if (!f_kv.second.is_npu_specific ()) {
+            continue;
+        }
+        if (first) {
+            npus = f_kv.second.get_npu_list ();
+            first = false;
+        } else {
+            _npus_intersect (npus, f_kv.second.get_npu_list ());
+        }
+    }
+    return npus;
+}
+
+// NPUs where the Entry has an action left - empty unless all its
+// actions are port actions
+nas::npu_set_t nas_acl_entry::_alist_npus () const
+{
+    nas::npu_set_t  npus;
+
+    for (auto& a_kv: _alist) {
+        if (!a_kv.second.is_npu_specific ()) {
+            return nas::npu_set_t {};
+        }
+        for (auto npu_id: a_kv.second.get_npu_list ()) {
+            npus.add (npu_id);
+        }
+    }
+    return npus;
+}
+
+// An Entry with only port actions would be programmed without any
+// action in the NPUs that have none of the ports - leave those out.
+// If that leaves no NPU the Entry stays where it is.
+void nas_acl_entry::_prune_action_npus ()
+{
+    _action_npus.clear ();
+
+    auto npus = _alist_npus ();
+    if (npus.empty ()) {
+        return;
+    }
+
+    _npus_intersect (npus, npu_list ());
+
+    if (!npus.empty () && npus.size () != npu_list ().size ()) {
+        _action_npus = npus;
+        NAS_ACL_LOG_DETAIL ("Table %ld Entry %ld: Port actions in %ld of the NPUs",
+                            table_id(), entry_id(), _action_npus.size ());
+    }
+}
+
 void nas_acl_entry::set_priority (ndi_acl_priority_t p)
 {
     _priority = p;
@@ -83,6 +165,43 @@ bool nas_acl_entry::is_npu_set (npu_id_t npu_id) const noexcept
     return _filter_npus.contains (npu_id);
 }
 
+bool nas_acl_entry::has_port_range () const noexcept
+{
+    for (auto& f_kv: _flist) {
+        if (f_kv.second.is_port_range ()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// All the NDI entries programmed for this ACL entry in the NPU
+nas_acl_entry::ndi_entry_id_list_t
+nas_acl_entry::ndi_entry_id_list (npu_id_t npu_id) const
+{
+    ndi_entry_id_list_t id_list {ndi_entry_ids.at (npu_id)};
+
+    auto it_expn = ndi_expn_entry_ids.find (npu_id);
+    if (it_expn != ndi_expn_entry_ids.end()) {
+        id_list.insert (id_list.end(), it_expn->second.begin(),
+                        it_expn->second.end());
+    }
+    return id_list;
+}
+
+void nas_acl_entry::_save_ndi_entry_ids (npu_id_t npu_id,
+                                         const ndi_entry_id_list_t& id_list)
+{
+    ndi_entry_ids[npu_id] = id_list.front();
+
+    if (id_list.size() > 1) {
+        ndi_expn_entry_ids[npu_id] = ndi_entry_id_list_t (id_list.begin() + 1,
+                                                          id_list.end());
+    } else {
+        ndi_expn_entry_ids.erase (npu_id);
+    }
+}
+
 /*
  * reset=True indicates that this Entry is being created or modified in overwrite mode
  * reset=False indicates that a single Filter is being added/modified/deleted
@@ -101,14 +220,53 @@ void nas_acl_entry::add_filter (nas_acl_filter_t& filter, bool reset)
         _filter_npus.clear();
     }
 
+    auto ndi_ftype = nas_acl_filter_t::ndi_filter_type (filter.filter_type());
+    if (ndi_ftype != filter.filter_type()) {
+        // A port range and its L4 port filter program the same NDI field
+        if (_flist.find (ndi_ftype) != _flist.end()) {
+            throw nas::base_exception {NAS_ACL_E_INCONSISTENT, __PRETTY_FUNCTION__,
+                                       std::string {"Cannot have "} + filter.name() +
+                                       " and " + nas_acl_filter_t::type_name (ndi_ftype) +
+                                       " Match filter in the same Entry."};
+        }
+    } else {
+        for (auto& f_kv: _flist) {
+            if (f_kv.first != ndi_ftype &&
+                nas_acl_filter_t::ndi_filter_type (f_kv.first) == ndi_ftype) {
+                throw nas::base_exception {NAS_ACL_E_INCONSISTENT, __PRETTY_FUNCTION__,
+                                           std::string {"Cannot have "} + filter.name() +
+                                           " and " + f_kv.second.name() +
+                                           " Match filter in the same Entry."};
+            }
+        }
+    }
+
     if (filter.is_npu_specific ()) {
-        // Ensure that the entry has no other NPU specific filters.
-        if (!_filter_npus.empty() &&
-             _flist.find(filter.filter_type()) == _flist.end()) {
+        // In port and In port-list filters cannot be in the same Entry
+        auto ftype = filter.filter_type();
+        auto in_peer = (ftype == BASE_ACL_MATCH_TYPE_IN_PORT) ?
+            BASE_ACL_MATCH_TYPE_IN_PORTS : BASE_ACL_MATCH_TYPE_IN_PORT;
+
+        if ((ftype == BASE_ACL_MATCH_TYPE_IN_PORT ||
+             ftype == BASE_ACL_MATCH_TYPE_IN_PORTS) &&
+            _flist.find (in_peer) != _flist.end()) {
             throw nas::base_exception {NAS_ACL_E_INCONSISTENT, __PRETTY_FUNCTION__,
                                        "Cannot have Port and Port-list Match filter in the same Entry."};
         }
-        _filter_npus = filter.get_npu_list ();
+
+        auto filter_npus = filter.get_npu_list ();
+        for (auto& f_kv: _flist) {
+            if (f_kv.first != ftype && f_kv.second.is_npu_specific ()) {
+                _npus_intersect (filter_npus, f_kv.second.get_npu_list ());
+            }
+        }
+
+        if (filter_npus.empty () && !filter.get_npu_list ().empty ()) {
+            throw nas::base_exception {NAS_ACL_E_INCONSISTENT, __PRETTY_FUNCTION__,
+                                       std::string {"Filter "} + filter.name() +
+                                       " has no ports in the NPUs of the other Port filters"};
+        }
+        _filter_npus = filter_npus;
 
         // Assuming the NPUs required by the filter have changed ensure that
         // the entry's ACL table is installed on the new set of NPUs.
@@ -132,9 +290,9 @@ void nas_acl_entry::add_filter (nas_acl_filter_t& filter, bool reset)
 
 void nas_acl_entry::remove_filter (BASE_ACL_MATCH_TYPE_t ftype)
 {
-    if (nas_acl_filter_t::is_npu_specific (ftype))
-        _filter_npus.clear();
     _flist.erase (ftype);
+    if (nas_acl_filter_t::is_npu_specific (ftype))
+        _filter_npus = _flist_npus ();
     mark_attr_dirty (BASE_ACL_ENTRY_MATCH);
 }
 
@@ -208,34 +366,74 @@ void nas_acl_entry::add_action (nas_acl_action_t& action, bool reset)
 
 void nas_acl_entry::commit_create (bool rolling_back)
 {
-    if (_following_table_npus) {
-        // A New Entry starts with _following_table_npus flag set
-        // This flag is reset when the entry's NPUlist attribute is set
-        // If no NPUs are set then copy all NPUs from table
-        // In this case the Filter NPUs would have been already
-        // validated to be a subset of the Table's NPUs
-        copy_table_npus();
+    prepare_commit (nullptr);
+
+    _admit_hw (nullptr);
+
+    nas::base_obj_t::commit_create (rolling_back);
+}
+
+// Checks of a commit that need no NDI call, except the hardware admission
+void nas_acl_entry::prepare_commit (const nas_acl_entry* entry_orig)
+{
+    if (entry_orig == nullptr) {
+        if (_following_table_npus) {
+            // A New Entry starts with _following_table_npus flag set
+            // This flag is reset when the entry's NPUlist attribute is set
+            // If no NPUs are set then copy all NPUs from table
+            // In this case the Filter NPUs would have been already
+            // validated to be a subset of the Table's NPUs
+            copy_table_npus();
+        } else {
+            // Entry's NPUlist attribute was set - ensure that this is a
+            // super set of all the NPUs required by its filters
+            for (auto npu_id: _filter_npus) {
+                if (!npu_list().contains (npu_id)) {
+                    throw nas::base_exception {NAS_ACL_E_INCONSISTENT, __PRETTY_FUNCTION__,
+                            std::string {"NPU list for Entry "} + std::to_string (entry_id())
+                            + " is missing NPU " + std::to_string (npu_id)};
+                }
+            }
+        }
     } else {
-        // Entry's NPUlist attribute was set - ensure that this is a
-        // super set of all the NPUs required by its filters
-        for (auto npu_id: _filter_npus) {
-            if (!npu_list().contains (npu_id)) {
-                throw nas::base_exception {NAS_ACL_E_INCONSISTENT, __PRETTY_FUNCTION__,
-                        std::string {"NPU list for Entry "} + std::to_string (entry_id())
-                        + " is missing NPU " + std::to_string (npu_id)};
+        if (!_following_table_npus &&
+            nas::base_obj_t::npu_list().empty()) {
+            // If all NPUs have been removed then copy all NPUs from table
+            copy_table_npus();
+        }
+        else if (!_following_table_npus) {
+            // Entry has its own set of NPUs - ensure that this is a super set
+            // of all the NPUs needed by its filters
+            for (auto npu_id: _filter_npus) {
+                if (!nas::base_obj_t::npu_list().contains (npu_id)) {
+                    throw nas::base_exception {NAS_ACL_E_INCONSISTENT, __PRETTY_FUNCTION__,
+                            std::string {"NPU list for Entry "} +
+                            std::to_string (entry_id()) +
+                            " is missing NPU " + std::to_string (npu_id)};
+                }
             }
         }
     }
 
-    if (is_counter_enabled ()) { _validate_counter_npus (); }
+    _prune_action_npus ();
 
-    nas::base_obj_t::commit_create (rolling_back);
+    if (is_counter_enabled ()) { _validate_counter_npus (); }
 }
 
 void nas_acl_entry::_validate_counter_npus () const
 {
+    auto counter_p = get_counter();
+    // A Counter checked before it is created takes the NPUs of its Table
+    // unless it has its own
+    const auto& counter_npus = (counter_p->following_table_npus ()) ?
+                               counter_p->get_table().npu_list() :
+                               counter_p->npu_list();
+
     for (auto npu_id: npu_list()) {
-        if (!get_counter()->is_obj_in_npu (npu_id)) {
+        bool in_npu = (counter_p->is_created_in_ndi ()) ?
+                      counter_p->is_obj_in_npu (npu_id) :
+                      counter_npus.contains (npu_id);
+        if (!in_npu) {
             throw nas::base_exception {NAS_ACL_E_INCONSISTENT, __PRETTY_FUNCTION__,
                 std::string {"NPU list for Counter "} +
                     std::to_string (counter_id()) +
@@ -247,27 +445,58 @@ void nas_acl_entry::_validate_counter_npus () const
 nas::attr_set_t nas_acl_entry::commit_modify (base_obj_t& entry_orig,
                                               bool rolling_back)
 {
-    if (!_following_table_npus &&
-        nas::base_obj_t::npu_list().empty()) {
-        // If all NPUs have been removed then copy all NPUs from table
-        copy_table_npus();
-    }
-    else if (!_following_table_npus) {
-        // Entry has its own set of NPUs - ensure that this is a super set
-        // of all the NPUs needed by its filters
-        for (auto npu_id: _filter_npus) {
-            if (!nas::base_obj_t::npu_list().contains (npu_id)) {
-                throw nas::base_exception {NAS_ACL_E_INCONSISTENT, __PRETTY_FUNCTION__,
-                        std::string {"NPU list for Entry "} +
-                        std::to_string (entry_id()) +
-                        " is missing NPU " + std::to_string (npu_id)};
-            }
+    auto& acl_entry_orig = static_cast<nas_acl_entry&> (entry_orig);
+
+    prepare_commit (&acl_entry_orig);
+
+    _admit_hw (&acl_entry_orig);
+
+    auto modified = nas::base_obj_t::commit_modify (entry_orig, rolling_back);
+
+    // The NDI entries in the NPUs that the Entry left were deleted through
+    // the original - drop the IDs copied from it
+    for (auto it = ndi_entry_ids.begin (); it != ndi_entry_ids.end (); ) {
+        if (npu_list ().contains (it->first)) {
+            ++it;
+            continue;
         }
+        ndi_expn_entry_ids.erase (it->first);
+        it = ndi_entry_ids.erase (it);
     }
 
-    if (is_counter_enabled ()) { _validate_counter_npus (); }
+    return modified;
+}
+
+size_t nas_acl_entry::hw_rows () const
+{
+    return (has_port_range ()) ?
+        nas_acl_port_range_expn_count (_port_range_expn ()) : 1;
+}
+
+size_t nas_acl_entry::hw_rows_in_npu (npu_id_t npu_id) const noexcept
+{
+    if (ndi_entry_ids.find (npu_id) == ndi_entry_ids.end ()) {
+        return 0;
+    }
+    auto it_expn = ndi_expn_entry_ids.find (npu_id);
+    return 1 + ((it_expn != ndi_expn_entry_ids.end ()) ? it_expn->second.size () : 0);
+}
+
+// Reject an Entry that does not fit before it is pushed to any NPU
+void nas_acl_entry::_admit_hw (const nas_acl_entry* entry_orig) const
+{
+    size_t rows = hw_rows ();
+
+    for (auto npu_id: npu_list()) {
+
+        size_t rows_orig = (entry_orig != nullptr) ?
+            entry_orig->hw_rows_in_npu (npu_id) : 0;
 
-    return nas::base_obj_t::commit_modify (entry_orig, rolling_back);
+        if (rows > rows_orig) {
+            get_table().get_switch().hw_admit (get_table(), npu_id,
+                                               {rows - rows_orig, 0});
+        }
+    }
 }
 
 const nas_acl_filter_t& nas_acl_entry::get_filter (BASE_ACL_MATCH_TYPE_t
@@ -295,15 +524,24 @@ const nas_acl_action_t& nas_acl_entry::get_action (BASE_ACL_ACTION_TYPE_t
 }
 
 
+// Port range filters pick their value/mask from the prefixes list,
+// in the same order as they appear in the filter list
 bool nas_acl_entry::_copy_all_filters_ndi (ndi_acl_entry_t &ndi_acl_entry,
                                            npu_id_t npu_id,
+                                           const nas_acl_port_prefix_list_t& prefixes,
                                            nas::mem_alloc_helper_t& mem_trakr) const
 {
     int i = 0;
+    size_t range_idx = 0;
     for (const_filter_iter_t itr = _flist.begin();
          itr != _flist.end(); ++itr,++i) {
 
         auto& f = nas_acl_entry::get_filter_from_itr (itr);
+        if (f.is_port_range ()) {
+            f.copy_filter_ndi_prefix (&ndi_acl_entry.filter_list[i],
+                                      prefixes.at (range_idx++));
+            continue;
+        }
         if (!f.copy_filter_ndi (&ndi_acl_entry.filter_list[i],
                                 npu_id, mem_trakr)) {
             // NPU specific filter is not needed for
@@ -313,6 +551,19 @@ bool nas_acl_entry::_copy_all_filters_ndi (ndi_acl_entry_t &ndi_acl_entry,
     return true;
 }
 
+std::vector<nas_acl_port_prefix_list_t> nas_acl_entry::_port_range_expn () const
+{
+    std::vector<nas_acl_port_prefix_list_t> expn_list;
+
+    for (const_filter_iter_t itr = _flist.begin(); itr != _flist.end(); ++itr) {
+        auto& f = nas_acl_entry::get_filter_from_itr (itr);
+        if (f.is_port_range ()) {
+            expn_list.push_back (f.port_range_expand ());
+        }
+    }
+    return expn_list;
+}
+
 static void _copy_ndi_counter_id (const nas_acl_entry& entry,
                                   ndi_acl_entry_action_t& ndi_action,
                                   npu_id_t  npu_id) noexcept
@@ -340,8 +591,13 @@ ndi_acl_action_list_t nas_acl_entry::_copy_all_actions_ndi (npu_id_t npu_id,
     return ndi_alist;
 }
 
-bool nas_acl_entry::push_create_obj_to_npu (npu_id_t npu_id,
-                                            void* ndi_obj)
+// Filters are kept in compact form and expanded into this
+// scratch list only while an entry is being created in the NPU
+static thread_local std::vector<ndi_acl_entry_filter_t> _ndi_filter_scratch;
+
+bool nas_acl_entry::_push_create_expn_to_npu (npu_id_t npu_id,
+                                              const nas_acl_port_prefix_list_t& prefixes,
+                                              ndi_obj_id_t& ndi_entry_id) const
 {
     t_std_error rc = STD_ERR_OK;
     nas::mem_alloc_helper_t mem_trakr;
@@ -353,10 +609,11 @@ bool nas_acl_entry::push_create_obj_to_npu (npu_id_t npu_id,
     ndi_acl_entry.priority = priority();
 
     /////// Populate the filters
+    _ndi_filter_scratch.resize (_flist.size());
     ndi_acl_entry.filter_count = _flist.size();
-    ndi_acl_entry.filter_list = mem_trakr.alloc<ndi_acl_entry_filter_t> (_flist.size());
+    ndi_acl_entry.filter_list = _ndi_filter_scratch.data();
 
-    if (!_copy_all_filters_ndi (ndi_acl_entry, npu_id, mem_trakr)) {
+    if (!_copy_all_filters_ndi (ndi_acl_entry, npu_id, prefixes, mem_trakr)) {
         return false;
     }
 
@@ -366,20 +623,76 @@ bool nas_acl_entry::push_create_obj_to_npu (npu_id_t npu_id,
     ndi_acl_entry.action_count = ndi_alist.size();
     ndi_acl_entry.action_list = ndi_alist.data();
 
-    ndi_obj_id_t ndi_entry_id;
-
-    if ((rc = ndi_acl_entry_create (npu_id, &ndi_acl_entry,
-            &ndi_entry_id)) != STD_ERR_OK) {
+    if ((rc = nas_acl_perf_ndi_call (ndi_acl_entry_create, npu_id, &ndi_acl_entry,
+                                     &ndi_entry_id)) != STD_ERR_OK) {
         throw nas::base_exception {rc, __PRETTY_FUNCTION__,
             std::string {"NDI ACL Entry Create failed for NPU "} +
             std::to_string (npu_id)};
     }
 
-    ndi_entry_ids[npu_id] = ndi_entry_id;
+    return true;
+}
+
+static void _utl_delete_ndi_entries (npu_id_t npu_id,
+                                     const nas_acl_entry::ndi_entry_id_list_t& id_list) noexcept
+{
+    for (auto ndi_entry_id: id_list) {
+        t_std_error rc = nas_acl_perf_ndi_call (ndi_acl_entry_delete, npu_id,
+                                                ndi_entry_id);
+        if (rc != STD_ERR_OK) {
+            NAS_ACL_LOG_ERR ("NPU %d: NDI ACL Entry 0x%" PRIx64 " Delete failed, "
+                             "ErrCode: %d", npu_id, ndi_entry_id, rc);
+        }
+    }
+}
+
+bool nas_acl_entry::push_create_obj_to_npu (npu_id_t npu_id,
+                                            void* ndi_obj)
+{
+    // Replayed after a warm restart - take over the NDI entries
+    // already in the NPU, including the port range expansion
+    ndi_entry_id_list_t adopted;
+    if (nas_acl_warm_adopt (NAS_ACL_WARM_OBJ_ENTRY, switch_id(), table_id(),
+                            entry_id(), npu_id,
+                            nas_acl_warm_entry_hash (*this, npu_id), adopted)) {
+        _save_ndi_entry_ids (npu_id, adopted);
+        return true;
+    }
+
+    auto expn_list = _port_range_expn ();
+    auto expn_count = nas_acl_port_range_expn_count (expn_list);
+
+    ndi_entry_id_list_t created;
+    nas_acl_port_prefix_list_t prefixes;
+
+    created.reserve (expn_count);
+
+    for (size_t expn_idx = 0; expn_idx < expn_count; expn_idx++) {
+
+        nas_acl_port_range_expn_at (expn_list, expn_idx, prefixes);
+
+        ndi_obj_id_t ndi_entry_id;
+
+        try {
+            if (!_push_create_expn_to_npu (npu_id, prefixes, ndi_entry_id)) {
+                // NPU specific filters do not depend on the expansion
+                // so this can only happen for the first NDI entry
+                return false;
+            }
+        } catch (nas::base_exception& e) {
+            // All or nothing - remove the NDI entries already created
+            // in this NPU for the port range expansion
+            _utl_delete_ndi_entries (npu_id, created);
+            throw;
+        }
+        created.push_back (ndi_entry_id);
+    }
+
+    _save_ndi_entry_ids (npu_id, created);
 
     NAS_ACL_LOG_DETAIL ("Switch %d Table %ld: Created ACL Entry in NPU %d "
-            "NDI-ID 0x%" PRIx64,
-            switch_id(), table_id(), npu_id, ndi_entry_id);
+            "NDI-ID 0x%" PRIx64 " (%ld NDI entries)",
+            switch_id(), table_id(), npu_id, created.front(), created.size());
 
     return true;
 }
@@ -396,11 +709,36 @@ bool nas_acl_entry::push_delete_obj_to_npu (npu_id_t npu_id)
         return false;
     }
 
-    if ((rc = ndi_acl_entry_delete (npu_id, it_ndi_eid->second))
-         != STD_ERR_OK) {
+    auto id_list = ndi_entry_id_list (npu_id);
+
+    // Delete the port range expansion entries first and the
+    // entry tracked in ndi_entry_ids last
+    for (size_t idx = id_list.size(); idx-- > 0; ) {
+
+        if ((rc = nas_acl_perf_ndi_call (ndi_acl_entry_delete, npu_id,
+                                         id_list[idx])) == STD_ERR_OK) {
+            continue;
+        }
+
+        // All or nothing - recreate the NDI entries that were already
+        // deleted so that the entry is intact in this NPU
+        auto expn_list = _port_range_expn ();
+        nas_acl_port_prefix_list_t prefixes;
+
+        for (size_t restore = idx + 1; restore < id_list.size(); restore++) {
+            nas_acl_port_range_expn_at (expn_list, restore, prefixes);
+            try {
+                _push_create_expn_to_npu (npu_id, prefixes, id_list[restore]);
+            } catch (nas::base_exception& e) {
+                NAS_ACL_LOG_ERR ("NPU %d: Restore of ACL Entry %ld failed: %s",
+                                 npu_id, entry_id(), e.err_msg.c_str());
+            }
+        }
+        _save_ndi_entry_ids (npu_id, id_list);
+
         throw nas::base_exception {rc, __PRETTY_FUNCTION__,
                                    std::string {"NDI ACL Entry "} +
-                                   std::to_string (ndi_entry_ids.at (npu_id)) +
+                                   std::to_string (id_list[idx]) +
                                    " Delete failed for NPU " + std::to_string (npu_id)};
     }
 
@@ -410,6 +748,7 @@ bool nas_acl_entry::push_delete_obj_to_npu (npu_id_t npu_id)
                         ndi_entry_ids.at (npu_id));
 
     ndi_entry_ids.erase (npu_id);
+    ndi_expn_entry_ids.erase (npu_id);
 
     return true;
 }
@@ -438,13 +777,15 @@ bool nas_acl_entry::push_leaf_attr_to_npu (nas_attr_id_t attr_id,
     switch (attr_id)
     {
         case BASE_ACL_ENTRY_PRIORITY:
-            if ((rc = ndi_acl_entry_set_priority (npu_id, ndi_entry_ids.at(npu_id),
-                                                  priority()))
-                != STD_ERR_OK)
-            {
-                throw nas::base_exception {rc, __PRETTY_FUNCTION__,
-                                   std::string {"NDI Entry Priority Set Failed for NPU "} +
-                                   std::to_string (npu_id)};
+            for (auto ndi_entry_id: ndi_entry_id_list (npu_id)) {
+                if ((rc = nas_acl_perf_ndi_call (ndi_acl_entry_set_priority, npu_id,
+                                                 ndi_entry_id, priority()))
+                    != STD_ERR_OK)
+                {
+                    throw nas::base_exception {rc, __PRETTY_FUNCTION__,
+                                       std::string {"NDI Entry Priority Set Failed for NPU "} +
+                                       std::to_string (npu_id)};
+                }
             }
 
             NAS_ACL_LOG_DETAIL ("Switch %d Table %ld Entry %ld: Modified Priority in NPU %d",
@@ -499,12 +840,14 @@ static void _utl_push_disable_filter_to_npu (nas_acl_entry& acl_entry,
 {
     t_std_error rc;
 
-    if ((rc = ndi_acl_entry_disable_filter (npu_id, acl_entry.ndi_entry_ids.at (npu_id),
-                                            f_type)) != STD_ERR_OK) {
-        throw nas::base_exception {rc, __PRETTY_FUNCTION__,
-                                   std::string {"NDI Filter Disable failed for "} +
-                                   nas_acl_filter_t::type_name (f_type) +
-                                   " for NPU " + std::to_string (npu_id)};
+    for (auto ndi_entry_id: acl_entry.ndi_entry_id_list (npu_id)) {
+        if ((rc = nas_acl_perf_ndi_call (ndi_acl_entry_disable_filter, npu_id,
+                                         ndi_entry_id, f_type)) != STD_ERR_OK) {
+            throw nas::base_exception {rc, __PRETTY_FUNCTION__,
+                                       std::string {"NDI Filter Disable failed for "} +
+                                       nas_acl_filter_t::type_name (f_type) +
+                                       " for NPU " + std::to_string (npu_id)};
+        }
     }
 
     NAS_ACL_LOG_DETAIL ("ACL Entry NDI: Disabled Filter %s in NPU %d",
@@ -526,11 +869,13 @@ static void _utl_push_filter_to_npu (nas_acl_entry& acl_entry,
 
     t_std_error rc;
 
-    if ((rc = ndi_acl_entry_set_filter (npu_id, acl_entry.ndi_entry_ids.at (npu_id),
-                                        &ndi_filter)) != STD_ERR_OK) {
-        throw nas::base_exception {rc, __PRETTY_FUNCTION__,
-                                   std::string {"NDI Filter set failed for "} +
-                                   f_add.name() + " for NPU " + std::to_string (npu_id)};
+    for (auto ndi_entry_id: acl_entry.ndi_entry_id_list (npu_id)) {
+        if ((rc = nas_acl_perf_ndi_call (ndi_acl_entry_set_filter, npu_id, ndi_entry_id,
+                                         &ndi_filter)) != STD_ERR_OK) {
+            throw nas::base_exception {rc, __PRETTY_FUNCTION__,
+                                       std::string {"NDI Filter set failed for "} +
+                                       f_add.name() + " for NPU " + std::to_string (npu_id)};
+        }
     }
 
     NAS_ACL_LOG_DETAIL ("ACL Entry NDI: Set Filter %s in NPU %d",
@@ -649,13 +994,14 @@ static void _utl_push_disable_action_to_npu (nas_acl_entry& acl_entry,
                                              bool remove_counter)
 {
     t_std_error rc;
-    if ((rc = ndi_acl_entry_disable_action (npu_id,
-                                            acl_entry.ndi_entry_ids.at (npu_id),
-                                            a_type)) != STD_ERR_OK) {
-        throw nas::base_exception {rc, __PRETTY_FUNCTION__,
-            std::string {"NDI Action Disable failed for "} +
-            nas_acl_action_t::type_name (a_type) +
-            " for NPU " + std::to_string (npu_id)};
+    for (auto ndi_entry_id: acl_entry.ndi_entry_id_list (npu_id)) {
+        if ((rc = nas_acl_perf_ndi_call (ndi_acl_entry_disable_action, npu_id,
+                                         ndi_entry_id, a_type)) != STD_ERR_OK) {
+            throw nas::base_exception {rc, __PRETTY_FUNCTION__,
+                std::string {"NDI Action Disable failed for "} +
+                nas_acl_action_t::type_name (a_type) +
+                " for NPU " + std::to_string (npu_id)};
+        }
     }
 
     NAS_ACL_LOG_DETAIL ("ACL Entry NDI: Disabled Action %s in NPU %d",
@@ -681,14 +1027,15 @@ static void _utl_push_action_to_npu (nas_acl_entry& acl_entry,
         _copy_ndi_counter_id (acl_entry, ndi_alist.back(), npu_id);
     }
 
-    for (auto& ndi_action: ndi_alist) {
-        if ((rc = ndi_acl_entry_set_action (npu_id,
-                acl_entry.ndi_entry_ids.at (npu_id),
-                &ndi_action)) != STD_ERR_OK) {
+    for (auto ndi_entry_id: acl_entry.ndi_entry_id_list (npu_id)) {
+        for (auto& ndi_action: ndi_alist) {
+            if ((rc = nas_acl_perf_ndi_call (ndi_acl_entry_set_action, npu_id,
+                                             ndi_entry_id, &ndi_action)) != STD_ERR_OK) {
 
-            throw nas::base_exception {rc, __PRETTY_FUNCTION__,
-                std::string {"NDI Action Set failed for "} +
-                a_add.name() + " for NPU " + std::to_string (npu_id)};
+                throw nas::base_exception {rc, __PRETTY_FUNCTION__,
+                    std::string {"NDI Action Set failed for "} +
+                    a_add.name() + " for NPU " + std::to_string (npu_id)};
+            }
         }
     }
 
@@ -780,6 +1127,13 @@ void nas_acl_entry::push_non_leaf_attr_ndi (nas_attr_id_t   non_leaf_attr_id,
     switch (static_cast<BASE_ACL_ENTRY_t>(non_leaf_attr_id))
     {
         case BASE_ACL_ENTRY_MATCH:
+            {
+                nas_acl_entry& entry_old = dynamic_cast <nas_acl_entry&> (obj_old);
+                if (_is_port_range_modified (entry_old)) {
+                    _reprogram_port_range_ndi (entry_old, npu_list, r_trakr, rolling_back);
+                    break;
+                }
+            }
             _utl_modify_flist_npulist_ndi (*this, obj_old, npu_list, r_trakr, rolling_back);
             break;
         case BASE_ACL_ENTRY_ACTION:
@@ -791,6 +1145,85 @@ void nas_acl_entry::push_non_leaf_attr_ndi (nas_attr_id_t   non_leaf_attr_id,
     }
 }
 
+bool nas_acl_entry::_is_port_range_modified (const nas_acl_entry& entry_old) const noexcept
+{
+    for (auto ftype: {BASE_ACL_MATCH_TYPE_L4_SRC_PORT_RANGE,
+                      BASE_ACL_MATCH_TYPE_L4_DST_PORT_RANGE}) {
+
+        auto itr_new = _flist.find (ftype);
+        auto itr_old = entry_old._flist.find (ftype);
+
+        bool in_new = (itr_new != _flist.end());
+        bool in_old = (itr_old != entry_old._flist.end());
+
+        if (in_new != in_old) {
+            return true;
+        }
+        if (in_new && (get_filter_from_itr (itr_new) != get_filter_from_itr (itr_old))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A change in port range changes the number of NDI entries needed.
+// Program the complete set of NDI entries for the new filter list
+// before removing the old set, so that traffic always hits one of them.
+void nas_acl_entry::_reprogram_port_range_ndi (nas_acl_entry& entry_old,
+                                               nas::npu_set_t  npu_list,
+                                               nas::rollback_trakr_t& r_trakr,
+                                               bool rolling_back)
+{
+    for (auto npu_id: npu_list) {
+
+        ndi_entry_id_list_t old_id_list;
+        if (entry_old.ndi_entry_ids.find (npu_id) != entry_old.ndi_entry_ids.end()) {
+            old_id_list = entry_old.ndi_entry_id_list (npu_id);
+        }
+
+        ndi_entry_ids.erase (npu_id);
+        ndi_expn_entry_ids.erase (npu_id);
+
+        try {
+            push_create_obj_to_npu (npu_id, NULL);
+
+        } catch (nas::base_exception& e) {
+            if (rolling_back) {
+                NAS_ACL_LOG_ERR ("Rollback failed: NPU %d: %s ErrCode: %d \n",
+                                 npu_id, e.err_msg.c_str(), e.err_code);
+                continue;
+            }
+            throw;
+        }
+
+        _utl_delete_ndi_entries (npu_id, old_id_list);
+
+        if (!rolling_back && ndi_entry_ids.find (npu_id) != ndi_entry_ids.end()) {
+            // Upon successful NDI reprogram, start tracking this for rollback
+            entry_old._rollbk_expn_entry_ids[npu_id] = ndi_entry_id_list (npu_id);
+
+            nas::rollbk_elem_t r_elem {nas::ROLLBK_CREATE_ATTR, npu_id,
+                {BASE_ACL_ENTRY_MATCH, BASE_ACL_MATCH_TYPE_L4_SRC_PORT_RANGE}};
+            r_trakr.push_back (r_elem);
+        }
+    }
+}
+
+// Called on the original entry to undo _reprogram_port_range_ndi
+void nas_acl_entry::_rollback_port_range_ndi (npu_id_t npu_id)
+{
+    auto it_rollbk = _rollbk_expn_entry_ids.find (npu_id);
+    if (it_rollbk == _rollbk_expn_entry_ids.end()) {
+        return;
+    }
+
+    ndi_entry_id_list_t new_id_list = it_rollbk->second;
+    _rollbk_expn_entry_ids.erase (it_rollbk);
+
+    push_create_obj_to_npu (npu_id, NULL);
+    _utl_delete_ndi_entries (npu_id, new_id_list);
+}
+
 void nas_acl_entry::rollback_create_attr_in_npu (const nas::attr_list_t&
                                                  attr_hierarchy,
                                                  npu_id_t npu_id)
@@ -808,6 +1241,11 @@ void nas_acl_entry::rollback_create_attr_in_npu (const nas::attr_list_t&
                 auto f_type = static_cast <BASE_ACL_MATCH_TYPE_t>
                     (attr_hierarchy[1]);
 
+                if (nas_acl_filter_t::is_port_range (f_type)) {
+                    _rollback_port_range_ndi (npu_id);
+                    break;
+                }
+
                 _utl_push_disable_filter_to_npu (*this, f_type, npu_id);
 
             } catch (nas::base_exception& e) {
@@ -898,6 +1336,10 @@ void nas_acl_entry::dbg_dump () const
     for (auto ndi_entry_map: ndi_entry_ids) {
         NAS_ACL_LOG_DUMP ("(NPU %d, %ld) ", ndi_entry_map.first, ndi_entry_map.second );
     }
+    for (auto& expn_map: ndi_expn_entry_ids) {
+        NAS_ACL_LOG_DUMP ("(NPU %d, %ld port range entries) ",
+                          expn_map.first, expn_map.second.size());
+    }
     NAS_ACL_LOG_DUMP ("");
     NAS_ACL_LOG_DUMP ("Num Filters: %ld", get_filter_list().size());
     for (auto& f_kv: get_filter_list()) {
@@ -0,0 +1,492 @@
+
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+/*!
+ * \file   nas_acl_event.cpp
+ * \brief  NAS ACL coalesced change notification events
+ */
+#include "event_log.h"
+#include "std_error_codes.h"
+#include "nas_acl_log.h"
+#include "nas_acl_event.h"
+#include "cps_api_events.h"
+#include "cps_class_map.h"
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <stdlib.h>
+
+typedef std::chrono::steady_clock _event_clock_t;
+
+// Object Type, Table Id, Object Id
+typedef std::tuple<uint32_t, nas_obj_id_t, nas_obj_id_t> _event_key_t;
+
+// Operation and error of a failed write
+typedef std::pair<cps_api_operation_types_t, t_std_error> _event_failure_t;
+
+class _event_batch_t
+{
+    public:
+        bool empty () const noexcept
+        {
+            return (_changes.empty () && _failures.empty () && !_overflow);
+        }
+        bool overflow () const noexcept {return _overflow;}
+        const std::map<_event_key_t, cps_api_operation_types_t>& changes () const noexcept
+        {
+            return _changes;
+        }
+        const std::map<_event_key_t, _event_failure_t>& failures () const noexcept
+        {
+            return _failures;
+        }
+
+        void add (const _event_key_t& key, cps_api_operation_types_t op) noexcept;
+        void add_failure (const _event_key_t& key, cps_api_operation_types_t op,
+                          t_std_error rc) noexcept;
+        void merge (const _event_batch_t& batch) noexcept;
+        void clear () noexcept
+        {
+            _changes.clear ();
+            _failures.clear ();
+            _overflow = false;
+        }
+        void swap (_event_batch_t& batch) noexcept
+        {
+            _changes.swap (batch._changes);
+            _failures.swap (batch._failures);
+            std::swap (_overflow, batch._overflow);
+        }
+
+    private:
+        void set_overflow () noexcept {clear (); _overflow = true;}
+
+        std::map<_event_key_t, cps_api_operation_types_t> _changes;
+        std::map<_event_key_t, _event_failure_t>          _failures;
+        bool _overflow = false;
+};
+
+typedef enum {
+    _EVENT_TXN_NONE,        /* Change outside a CPS transaction */
+    _EVENT_TXN_WRITE,       /* Held back until the transaction ends */
+    _EVENT_TXN_ROLLBACK,    /* Undo of a committed transaction */
+    _EVENT_TXN_DROP,        /* Undo of a failed transaction */
+} _event_txn_mode_t;
+
+// Never destroyed - the detached publisher thread waits on them until exit
+static std::mutex&                     _event_mutex = *(new std::mutex);
+static std::condition_variable&        _event_cv = *(new std::condition_variable);
+static nas_acl_event_publish_fn_ptr_t  _event_publish_fn = NULL;
+static cps_api_event_service_handle_t  _event_handle;
+static uint32_t                        _event_window_ms = NAS_ACL_EVENT_WINDOW_MS_DEF;
+static uint64_t                        _event_seq = 0;
+
+static _event_batch_t                  _event_batch;
+static _event_clock_t::time_point      _event_batch_start;
+
+static _event_batch_t                  _event_txn_batch;
+static const void*                     _event_open_txn = NULL;
+static const void*                     _event_aborted_txn = NULL;
+// Per thread - changes made by other threads are not part of the transaction
+static thread_local _event_txn_mode_t  _event_txn_mode = _EVENT_TXN_NONE;
+
+void _event_batch_t::add (const _event_key_t& key, cps_api_operation_types_t op) noexcept
+{
+    if (_overflow) {
+        return;
+    }
+
+    try {
+        auto it = _changes.find (key);
+
+        if (it == _changes.end ()) {
+            if (_changes.size () + _failures.size () >= NAS_ACL_EVENT_MAX_CHANGES) {
+                set_overflow ();
+                return;
+            }
+            _changes.insert (std::make_pair (key, op));
+            return;
+        }
+
+        auto old_op = it->second;
+
+        if (old_op == cps_api_oper_CREATE) {
+            if (op == cps_api_oper_DELETE) {
+                // Object did not exist before the batch
+                _changes.erase (it);
+            }
+            return;
+        }
+
+        if (old_op == cps_api_oper_DELETE && op == cps_api_oper_CREATE) {
+            it->second = cps_api_oper_SET;
+            return;
+        }
+        it->second = op;
+
+    } catch (std::exception& e) {
+        NAS_ACL_LOG_ERR ("Failed to record ACL change: %s", e.what ());
+        set_overflow ();
+    }
+}
+
+// Latest failure of an object is kept
+void _event_batch_t::add_failure (const _event_key_t& key, cps_api_operation_types_t op,
+                                  t_std_error rc) noexcept
+{
+    if (_overflow) {
+        return;
+    }
+
+    try {
+        if (_failures.find (key) == _failures.end () &&
+            _changes.size () + _failures.size () >= NAS_ACL_EVENT_MAX_CHANGES) {
+            set_overflow ();
+            return;
+        }
+        _failures [key] = _event_failure_t {op, rc};
+
+    } catch (std::exception& e) {
+        NAS_ACL_LOG_ERR ("Failed to record ACL failure: %s", e.what ());
+        set_overflow ();
+    }
+}
+
+void _event_batch_t::merge (const _event_batch_t& batch) noexcept
+{
+    if (batch._overflow) {
+        set_overflow ();
+        return;
+    }
+
+    for (const auto& change: batch._changes) {
+        add (change.first, change.second);
+    }
+    for (const auto& failure: batch._failures) {
+        add_failure (failure.first, failure.second.first, failure.second.second);
+    }
+}
+
+static void _event_batch_merge (const _event_batch_t& batch) noexcept
+{
+    if (batch.empty ()) {
+        return;
+    }
+
+    bool was_empty = _event_batch.empty ();
+    _event_batch.merge (batch);
+
+    if (was_empty) {
+        _event_batch_start = _event_clock_t::now ();
+        _event_cv.notify_one ();
+    }
+}
+
+static void _event_fill (cps_api_object_t obj, uint64_t seq,
+                         const _event_batch_t& batch) noexcept
+{
+    cps_api_key_from_attr_with_qual (cps_api_object_key (obj), BASE_ACL_EVENT_OBJ,
+                                     cps_api_qualifier_OBSERVED);
+
+    cps_api_object_attr_add_u64 (obj, BASE_ACL_EVENT_SEQUENCE, seq);
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_EVENT_OVERFLOW, batch.overflow ());
+
+    // Change-List-Attr . ListIndex . Change-Child-Attr
+    cps_api_attr_id_t ids[3] = {BASE_ACL_EVENT_CHANGE, 0, 0};
+    cps_api_attr_id_t idx = 0;
+
+    for (const auto& change: batch.changes ()) {
+
+        uint32_t obj_type = std::get<0> (change.first);
+        uint32_t op       = change.second;
+
+        ids[1] = idx++;
+
+        ids[2] = BASE_ACL_EVENT_CHANGE_OBJ_TYPE;
+        cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                              &obj_type, sizeof (obj_type));
+
+        ids[2] = BASE_ACL_EVENT_CHANGE_OPERATION;
+        cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                              &op, sizeof (op));
+
+        ids[2] = BASE_ACL_EVENT_CHANGE_TABLE_ID;
+        cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U64,
+                              &std::get<1> (change.first), sizeof (nas_obj_id_t));
+
+        ids[2] = BASE_ACL_EVENT_CHANGE_ID;
+        cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U64,
+                              &std::get<2> (change.first), sizeof (nas_obj_id_t));
+    }
+
+    // Failure-List-Attr . ListIndex . Failure-Child-Attr
+    ids[0] = BASE_ACL_EVENT_FAILURE;
+    idx = 0;
+
+    for (const auto& failure: batch.failures ()) {
+
+        uint32_t obj_type = std::get<0> (failure.first);
+        uint32_t op       = failure.second.first;
+        uint32_t err      = failure.second.second;
+
+        ids[1] = idx++;
+
+        ids[2] = BASE_ACL_EVENT_FAILURE_OBJ_TYPE;
+        cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                              &obj_type, sizeof (obj_type));
+
+        ids[2] = BASE_ACL_EVENT_FAILURE_OPERATION;
+        cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                              &op, sizeof (op));
+
+        ids[2] = BASE_ACL_EVENT_FAILURE_TABLE_ID;
+        cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U64,
+                              &std::get<1> (failure.first), sizeof (nas_obj_id_t));
+
+        ids[2] = BASE_ACL_EVENT_FAILURE_ID;
+        cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U64,
+                              &std::get<2> (failure.first), sizeof (nas_obj_id_t));
+
+        ids[2] = BASE_ACL_EVENT_FAILURE_ERROR;
+        cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                              &err, sizeof (err));
+    }
+}
+
+// Called with the event mutex held - released while publishing
+static void _event_publish (std::unique_lock<std::mutex>& lock) noexcept
+{
+    if (_event_batch.empty ()) {
+        return;
+    }
+
+    _event_batch_t batch;
+    batch.swap (_event_batch);
+
+    auto fn  = _event_publish_fn;
+    auto seq = ++_event_seq;
+
+    lock.unlock ();
+
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj == NULL) {
+        NAS_ACL_LOG_ERR ("Failed to allocate ACL event %ld", seq);
+    } else {
+        _event_fill (obj, seq, batch);
+
+        if (fn != NULL && !fn (obj)) {
+            NAS_ACL_LOG_ERR ("Failed to publish ACL event %ld", seq);
+        }
+        cps_api_object_delete (obj);
+    }
+
+    NAS_ACL_LOG_DETAIL ("ACL event %ld: %ld changes, %ld failures%s", seq,
+                        batch.changes ().size (), batch.failures ().size (),
+                        (batch.overflow ()) ? ", overflow" : "");
+
+    lock.lock ();
+}
+
+static void _event_publisher_main () noexcept
+{
+    std::unique_lock<std::mutex> lock (_event_mutex);
+
+    while (true) {
+        _event_cv.wait (lock, [] {return !_event_batch.empty ();});
+
+        auto due = _event_batch_start + std::chrono::milliseconds (_event_window_ms);
+
+        if (_event_clock_t::now () < due) {
+            // Re-checked after the wait - the batch may have been
+            // flushed or the window changed
+            _event_cv.wait_until (lock, due);
+            continue;
+        }
+
+        _event_publish (lock);
+    }
+}
+
+static bool _event_cps_publish (cps_api_object_t obj)
+{
+    return (cps_api_event_publish (_event_handle, obj) == cps_api_ret_code_OK);
+}
+
+bool nas_acl_event_init () noexcept
+{
+    const char* window_str = getenv (NAS_ACL_EVENT_WINDOW_MS_ENV);
+
+    if (window_str != NULL) {
+        nas_acl_event_window_set (strtoul (window_str, NULL, 0));
+    }
+
+    if (cps_api_event_service_init () != cps_api_ret_code_OK ||
+        cps_api_event_client_connect (&_event_handle) != cps_api_ret_code_OK) {
+        NAS_ACL_LOG_ERR ("Failed to connect to CPS event service - "
+                         "ACL change events disabled");
+        return false;
+    }
+
+    try {
+        std::thread publisher (_event_publisher_main);
+        publisher.detach ();
+
+    } catch (std::exception& e) {
+        NAS_ACL_LOG_ERR ("Failed to start ACL event publisher: %s - "
+                         "ACL change events disabled", e.what ());
+        return false;
+    }
+
+    nas_acl_event_publish_fn_set (_event_cps_publish);
+
+    NAS_ACL_LOG_BRIEF ("ACL change events enabled, batching window %d ms",
+                       nas_acl_event_window_get ());
+    return true;
+}
+
+void nas_acl_event_publish_fn_set (nas_acl_event_publish_fn_ptr_t fn) noexcept
+{
+    std::lock_guard<std::mutex> lock (_event_mutex);
+
+    _event_publish_fn = fn;
+
+    if (fn == NULL) {
+        _event_batch.clear ();
+        _event_txn_batch.clear ();
+    }
+}
+
+void nas_acl_event_window_set (uint32_t window_ms) noexcept
+{
+    std::lock_guard<std::mutex> lock (_event_mutex);
+
+    _event_window_ms = window_ms;
+    _event_cv.notify_one ();
+}
+
+uint32_t nas_acl_event_window_get () noexcept
+{
+    std::lock_guard<std::mutex> lock (_event_mutex);
+
+    return _event_window_ms;
+}
+
+void nas_acl_event_note (BASE_ACL_OBJECTS_t        obj_type,
+                         cps_api_operation_types_t op,
+                         nas_obj_id_t              table_id,
+                         nas_obj_id_t              obj_id) noexcept
+{
+    std::lock_guard<std::mutex> lock (_event_mutex);
+
+    if (_event_publish_fn == NULL) {
+        return;
+    }
+
+    _event_key_t key {obj_type, table_id, obj_id};
+
+    switch (_event_txn_mode) {
+        case _EVENT_TXN_WRITE:
+            _event_txn_batch.add (key, op);
+            break;
+
+        case _EVENT_TXN_DROP:
+            break;
+
+        default:
+        {
+            _event_batch_t batch;
+            batch.add (key, op);
+            _event_batch_merge (batch);
+            break;
+        }
+    }
+}
+
+void nas_acl_event_note_failure (BASE_ACL_OBJECTS_t        obj_type,
+                                 cps_api_operation_types_t op,
+                                 nas_obj_id_t              table_id,
+                                 nas_obj_id_t              obj_id,
+                                 t_std_error               rc) noexcept
+{
+    std::lock_guard<std::mutex> lock (_event_mutex);
+
+    if (_event_publish_fn == NULL) {
+        return;
+    }
+
+    _event_batch_t batch;
+    batch.add_failure (_event_key_t {obj_type, table_id, obj_id}, op, rc);
+    _event_batch_merge (batch);
+}
+
+void nas_acl_event_txn_begin (const void* txn, bool rollback) noexcept
+{
+    std::lock_guard<std::mutex> lock (_event_mutex);
+
+    if (!rollback) {
+        if (_event_open_txn != NULL && _event_open_txn != txn) {
+            // Last ACL object of the earlier transaction was never seen
+            _event_batch_merge (_event_txn_batch);
+            _event_txn_batch.clear ();
+        }
+        _event_open_txn    = txn;
+        _event_aborted_txn = NULL;
+        _event_txn_mode    = _EVENT_TXN_WRITE;
+        return;
+    }
+
+    if (txn == _event_open_txn) {
+        // Failed in another subsystem before the last ACL object
+        _event_txn_batch.clear ();
+        _event_open_txn    = NULL;
+        _event_aborted_txn = txn;
+    }
+
+    // Changes of a failed transaction were never published, so neither
+    // is their undo. Undo of a published transaction is a change.
+    _event_txn_mode = (txn == _event_aborted_txn) ?
+                      _EVENT_TXN_DROP : _EVENT_TXN_ROLLBACK;
+}
+
+void nas_acl_event_txn_end (const void* txn, bool success, bool last) noexcept
+{
+    std::lock_guard<std::mutex> lock (_event_mutex);
+
+    if (_event_txn_mode == _EVENT_TXN_WRITE) {
+        if (!success) {
+            _event_txn_batch.clear ();
+            _event_open_txn    = NULL;
+            _event_aborted_txn = txn;
+        } else if (last) {
+            _event_batch_merge (_event_txn_batch);
+            _event_txn_batch.clear ();
+            _event_open_txn = NULL;
+        }
+    }
+
+    _event_txn_mode = _EVENT_TXN_NONE;
+}
+
+void nas_acl_event_flush () noexcept
+{
+    std::unique_lock<std::mutex> lock (_event_mutex);
+
+    _event_publish (lock);
+}
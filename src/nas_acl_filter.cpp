@@ -32,21 +32,159 @@
 #include <unordered_map>
 #include <arpa/inet.h>
 
+static const nas::ifindex_list_t _empty_ifindex_list {};
+
 nas_acl_filter_t::nas_acl_filter_t (BASE_ACL_MATCH_TYPE_t t)
+    : _filter_type {t}
 {
     if (!is_type_valid (t)) {
         throw nas::base_exception {NAS_ACL_E_ATTR_VAL, __PRETTY_FUNCTION__,
             std::string {"Invalid filter type "} + std::to_string (t)};
     }
 
-    memset (&_f_info, 0, sizeof (_f_info));
-    _f_info.filter_type = t;
+    memset (_val, 0, sizeof (_val));
+}
+
+nas_acl_filter_t::nas_acl_filter_t (const nas_acl_filter_t& rhs)
+    : _filter_type {rhs._filter_type}
+{
+    _copy_val (rhs);
+}
+
+nas_acl_filter_t::nas_acl_filter_t (nas_acl_filter_t&& rhs) noexcept
+    : _filter_type {rhs._filter_type}, _values_type {rhs._values_type}, _len {rhs._len}
+{
+    memcpy (_val, rhs._val, sizeof (_val));
+    rhs._values_type = 0;
+}
+
+nas_acl_filter_t& nas_acl_filter_t::operator= (const nas_acl_filter_t& rhs)
+{
+    if (this != &rhs) {
+        _release_ports ();
+        _filter_type = rhs._filter_type;
+        _copy_val (rhs);
+    }
+    return *this;
+}
+
+nas_acl_filter_t& nas_acl_filter_t::operator= (nas_acl_filter_t&& rhs) noexcept
+{
+    if (this != &rhs) {
+        _release_ports ();
+        _filter_type = rhs._filter_type;
+        _values_type = rhs._values_type;
+        _len = rhs._len;
+        memcpy (_val, rhs._val, sizeof (_val));
+        rhs._values_type = 0;
+    }
+    return *this;
+}
+
+// Expects any port list of this to be released
+void nas_acl_filter_t::_copy_val (const nas_acl_filter_t& rhs)
+{
+    memcpy (_val, rhs._val, sizeof (_val));
+    _len = rhs._len;
+    _values_type = 0;
+
+    if (rhs._has_ports () && rhs._port.ifindex_list != NULL) {
+        _port.ifindex_list = new nas::ifindex_list_t (*rhs._port.ifindex_list);
+    }
+    _values_type = rhs._values_type;
+}
+
+// Switches the filter to a Port or Port list filter
+nas::ifindex_list_t& nas_acl_filter_t::_ports (ndi_acl_filter_values_type_t values_type)
+{
+    if (!_has_ports () || _port.ifindex_list == NULL) {
+        auto list_p = new nas::ifindex_list_t {};
+
+        if (_filter_type == BASE_ACL_MATCH_TYPE_IN_PORTS ||
+            _filter_type == BASE_ACL_MATCH_TYPE_OUT_PORTS) {
+            // Reserve initial space for some ports
+            // The list can grow beyond this if required
+            list_p->reserve (nas_acl_filter_t::port_count_estm);
+        }
+
+        _release_ports ();
+        memset (_val, 0, sizeof (_val));
+        _len = 0;
+        _port.ifindex_list = list_p;
+    }
+    _values_type = values_type;
+    return *_port.ifindex_list;
+}
+
+void nas_acl_filter_t::_release_ports () noexcept
+{
+    if (_has_ports ()) {
+        delete _port.ifindex_list;
+        _values_type = 0;
+    }
+}
+
+void nas_acl_filter_t::_reset_val (ndi_acl_filter_values_type_t values_type) noexcept
+{
+    _release_ports ();
+    memset (_val, 0, sizeof (_val));
+
+    _values_type = values_type;
+    _len = 0;
+}
+
+// Mask is NULL for filters that match on the value alone
+void nas_acl_filter_t::_set_val (ndi_acl_filter_values_type_t values_type,
+                                 const void* data, const void* mask, size_t len) noexcept
+{
+    _reset_val (values_type);
+
+    _len = len;
+    memcpy (_val, data, len);
+
+    if (mask != NULL) {
+        memcpy (_val + len, mask, len);
+        for (size_t idx = 0; idx < len; idx++) {
+            _val [idx] &= _val [len + idx];
+        }
+    }
+}
+
+const nas::ifindex_list_t& nas_acl_filter_t::get_filter_if_list () const noexcept
+{
+    return (_has_ports () && _port.ifindex_list != NULL) ?
+        *_port.ifindex_list : _empty_ifindex_list;
+}
+
+// Expand to the NDI filter - port lists are left to the caller
+void nas_acl_filter_t::_fill_ndi (ndi_acl_entry_filter_t* ndi_filter_p) const noexcept
+{
+    memset (ndi_filter_p, 0, sizeof (*ndi_filter_p));
+
+    ndi_filter_p->filter_type = _filter_type;
+    ndi_filter_p->values_type = (ndi_acl_filter_values_type_t) _values_type;
 
-    if (t == BASE_ACL_MATCH_TYPE_IN_PORTS ||
-        t == BASE_ACL_MATCH_TYPE_OUT_PORTS) {
-        // Reserve initial space for some ports
-        // The list can grow beyond this if required
-        _ifindex_list.reserve(nas_acl_filter_t::port_count_estm);
+    switch (_values_type) {
+        case NDI_ACL_FILTER_IP_TYPE:
+            ndi_filter_p->data.ip_type = (BASE_ACL_MATCH_IP_TYPE_t) _enum_val;
+            break;
+
+        case NDI_ACL_FILTER_IP_FRAG:
+            ndi_filter_p->data.ip_frag = (BASE_ACL_MATCH_IP_FRAG_t) _enum_val;
+            break;
+
+        case NDI_ACL_FILTER_PORT:
+            ndi_filter_p->data.values.ndi_port = _port.ndi_port;
+            break;
+
+        case NDI_ACL_FILTER_PORTLIST:
+            break;
+
+        default:
+            // All NDI filter values start at the top of the values union
+            memcpy (&ndi_filter_p->data.values, _val, _len);
+            memcpy (&ndi_filter_p->mask.values, _val + _len, _len);
+            break;
     }
 }
 
@@ -92,18 +230,19 @@ void nas_acl_filter_t::get_u32_filter_val (nas_acl_common_data_list_t& val_list)
     nas_acl_common_data_t match_data = {};
     nas_acl_common_data_t match_mask = {};
 
-    match_data.u32 = _f_info.data.values.u32;
+    get_filter_val (match_data.u32, match_mask.u32);
     val_list.push_back (match_data);
-    match_mask.u32 = _f_info.mask.values.u32;
     val_list.push_back (match_mask);
 }
 
 void nas_acl_filter_t::set_u32_filter_val (const nas_acl_common_data_list_t& val_list)
 {
-    _f_info.values_type     = NDI_ACL_FILTER_U32;
-    _f_info.data.values.u32 = val_list.at(0).u32;
+    auto data = val_list.at(0).u32;
+
     if (val_list.size () > 1) {
-        _f_info.mask.values.u32 = val_list.at(1).u32;
+        set_filter_val (NDI_ACL_FILTER_U32, data, val_list.at(1).u32);
+    } else {
+        _set_val (NDI_ACL_FILTER_U32, &data, NULL, sizeof (data));
     }
 }
 
@@ -112,18 +251,19 @@ void nas_acl_filter_t::get_u16_filter_val (nas_acl_common_data_list_t& val_list)
     nas_acl_common_data_t match_data = {};
     nas_acl_common_data_t match_mask = {};
 
-    match_data.u16 = _f_info.data.values.u16;
+    get_filter_val (match_data.u16, match_mask.u16);
     val_list.push_back (match_data);
-    match_mask.u16 = _f_info.mask.values.u16;
     val_list.push_back (match_mask);
 }
 
 void nas_acl_filter_t::set_u16_filter_val (const nas_acl_common_data_list_t& val_list)
 {
-    _f_info.values_type     = NDI_ACL_FILTER_U16;
-    _f_info.data.values.u16 = val_list.at(0).u16;
+    auto data = val_list.at(0).u16;
+
     if (val_list.size () > 1) {
-        _f_info.mask.values.u16 = val_list.at(1).u16;
+        set_filter_val (NDI_ACL_FILTER_U16, data, val_list.at(1).u16);
+    } else {
+        _set_val (NDI_ACL_FILTER_U16, &data, NULL, sizeof (data));
     }
 }
 
@@ -132,18 +272,19 @@ void nas_acl_filter_t::get_u8_filter_val (nas_acl_common_data_list_t& val_list)
     nas_acl_common_data_t match_data = {};
     nas_acl_common_data_t match_mask = {};
 
-    match_data.u8 = _f_info.data.values.u8;
+    get_filter_val (match_data.u8, match_mask.u8);
     val_list.push_back (match_data);
-    match_mask.u8 = _f_info.mask.values.u8;
     val_list.push_back (match_mask);
 }
 
 void nas_acl_filter_t::set_u8_filter_val (const nas_acl_common_data_list_t& val_list)
 {
-    _f_info.values_type    = NDI_ACL_FILTER_U8;
-    _f_info.data.values.u8 = val_list.at(0).u8;
+    auto data = val_list.at(0).u8;
+
     if (val_list.size () > 1) {
-        _f_info.mask.values.u8      = val_list.at(1).u8;
+        set_filter_val (NDI_ACL_FILTER_U8, data, val_list.at(1).u8);
+    } else {
+        _set_val (NDI_ACL_FILTER_U8, &data, NULL, sizeof (data));
     }
 }
 
@@ -153,15 +294,8 @@ void nas_acl_filter_t::get_ipv4_filter_val (nas_acl_common_data_list_t& val_list
     nas_acl_common_data_t match_mask;
 
     // IPv4 value can be considered as an array of bytes - copy this into the bytes array
-    auto& val = _f_info.data.values.ipv4;
-    auto val_u8 = (uint8_t*) &val;
-    auto& bytes = match_addr.bytes;
-    bytes.insert (bytes.begin(), val_u8, val_u8+sizeof (val));
-
-    auto& mask = _f_info.mask.values.ipv4;
-    auto mask_u8 = (uint8_t*) &mask;
-    auto& bytes_mask = match_mask.bytes;
-    bytes_mask.insert (bytes_mask.begin(), mask_u8, mask_u8+ sizeof (mask));
+    match_addr.set_bytes (_val, sizeof (dn_ipv4_addr_t));
+    match_mask.set_bytes (_val + sizeof (dn_ipv4_addr_t), sizeof (dn_ipv4_addr_t));
 
     val_list.push_back (match_addr);
     val_list.push_back (match_mask);
@@ -173,15 +307,8 @@ void nas_acl_filter_t::get_ipv6_filter_val (nas_acl_common_data_list_t& val_list
     nas_acl_common_data_t match_mask;
 
     // IPv6 value can be considered as an array of bytes - copy this into the bytes array
-    auto& val = _f_info.data.values.ipv6;
-    auto val_u8 = (uint8_t*) &val;
-    auto& bytes = match_addr.bytes;
-    bytes.insert(bytes.begin(), val_u8, val_u8+sizeof (val));
-
-    auto& mask = _f_info.mask.values.ipv6;
-    auto mask_u8 = (uint8_t*) &mask;
-    auto& bytes_mask = match_mask.bytes;
-    bytes_mask.insert (bytes_mask.begin(), mask_u8, mask_u8+ sizeof (mask));
+    match_addr.set_bytes (_val, sizeof (dn_ipv6_addr_t));
+    match_mask.set_bytes (_val + sizeof (dn_ipv6_addr_t), sizeof (dn_ipv6_addr_t));
 
     val_list.push_back (match_addr);
     val_list.push_back (match_mask);
@@ -189,22 +316,16 @@ void nas_acl_filter_t::get_ipv6_filter_val (nas_acl_common_data_list_t& val_list
 
 void nas_acl_filter_t::set_ipv4_filter_val (const nas_acl_common_data_list_t& val_list)
 {
-    _f_info.values_type = NDI_ACL_FILTER_IPV4_ADDR;
     // IPv4 value can be considered as an array of bytes - copy from the bytes array
-    memcpy ((uint8_t*)&_f_info.data.values.ipv4, val_list.at(0).bytes.data(),
-            sizeof (_f_info.data.values.ipv4));
-    memcpy ((uint8_t*)&_f_info.mask.values.ipv4, val_list.at(1).bytes.data(),
-            sizeof (_f_info.mask.values.ipv4));
+    _set_val (NDI_ACL_FILTER_IPV4_ADDR, val_list.at(0).bytes_data (),
+              val_list.at(1).bytes_data (), sizeof (dn_ipv4_addr_t));
 }
 
 void nas_acl_filter_t::set_ipv6_filter_val (const nas_acl_common_data_list_t& val_list)
 {
-    _f_info.values_type = NDI_ACL_FILTER_IPV6_ADDR;
     // IPv6 value can be considered as an array of bytes - copy from the bytes array
-    memcpy ((uint8_t*)&_f_info.data.values.ipv6, val_list.at(0).bytes.data(),
-            sizeof (_f_info.data.values.ipv6));
-    memcpy ((uint8_t*)&_f_info.mask.values.ipv6, val_list.at(1).bytes.data(),
-            sizeof (_f_info.mask.values.ipv6));
+    _set_val (NDI_ACL_FILTER_IPV6_ADDR, val_list.at(0).bytes_data (),
+              val_list.at(1).bytes_data (), sizeof (dn_ipv6_addr_t));
 }
 
 void nas_acl_filter_t::get_mac_filter_val (nas_acl_common_data_list_t& val_list) const
@@ -212,13 +333,8 @@ void nas_acl_filter_t::get_mac_filter_val (nas_acl_common_data_list_t& val_list)
     nas_acl_common_data_t match_addr;
     nas_acl_common_data_t match_mask;
 
-    const uint8_t* mac_p = _f_info.data.values.mac;
-    const uint8_t* mac_mask_p = _f_info.mask.values.mac;
-    auto& bytes = match_addr.bytes;
-    auto& bytes_mask = match_mask.bytes;
-
-    bytes.insert (bytes.begin(), mac_p, mac_p+ HAL_MAC_ADDR_LEN);
-    bytes_mask.insert (bytes_mask.begin(), mac_mask_p, mac_mask_p+ HAL_MAC_ADDR_LEN);
+    match_addr.set_bytes (_val, HAL_MAC_ADDR_LEN);
+    match_mask.set_bytes (_val + HAL_MAC_ADDR_LEN, HAL_MAC_ADDR_LEN);
 
     val_list.push_back (match_addr);
     val_list.push_back (match_mask);
@@ -226,16 +342,57 @@ void nas_acl_filter_t::get_mac_filter_val (nas_acl_common_data_list_t& val_list)
 
 void nas_acl_filter_t::set_mac_filter_val (const nas_acl_common_data_list_t& val_list)
 {
-    _f_info.values_type = NDI_ACL_FILTER_MAC_ADDR;
-    memcpy (_f_info.data.values.mac, val_list.at(0).bytes.data(), HAL_MAC_ADDR_LEN);
-    memcpy (_f_info.mask.values.mac, val_list.at(1).bytes.data(), HAL_MAC_ADDR_LEN);
+    _set_val (NDI_ACL_FILTER_MAC_ADDR, val_list.at(0).bytes_data (),
+              val_list.at(1).bytes_data (), HAL_MAC_ADDR_LEN);
+}
+
+void nas_acl_filter_t::get_l4_port_range_filter_val (nas_acl_common_data_list_t& val_list) const
+{
+    nas_acl_common_data_t range_min = {};
+    nas_acl_common_data_t range_max = {};
+
+    range_min.u16 = _range.min;
+    val_list.push_back (range_min);
+    range_max.u16 = _range.max;
+    val_list.push_back (range_max);
+}
+
+void nas_acl_filter_t::set_l4_port_range_filter_val (const nas_acl_common_data_list_t& val_list)
+{
+    auto min = val_list.at(0).u16;
+    auto max = val_list.at(1).u16;
+
+    if (min > max) {
+        throw nas::base_exception {NAS_ACL_E_ATTR_VAL, __PRETTY_FUNCTION__,
+            std::string {"Invalid L4 port range "} + std::to_string (min)
+            + " - " + std::to_string (max)};
+    }
+    _reset_val (NDI_ACL_FILTER_U16);
+    _range.min = min;
+    _range.max = max;
+}
+
+nas_acl_port_prefix_list_t nas_acl_filter_t::port_range_expand () const
+{
+    return nas_acl_port_range_expand (_range.min, _range.max);
+}
+
+// Fill the NDI filter for one value/mask prefix of a port range
+void nas_acl_filter_t::copy_filter_ndi_prefix (ndi_acl_entry_filter_t* ndi_filter_p,
+                                               const nas_acl_port_prefix_t& prefix) const noexcept
+{
+    _fill_ndi (ndi_filter_p);
+    ndi_filter_p->filter_type = ndi_filter_type (filter_type ());
+    ndi_filter_p->values_type = NDI_ACL_FILTER_U16;
+    ndi_filter_p->data.values.u16 = prefix.data;
+    ndi_filter_p->mask.values.u16 = prefix.mask;
 }
 
 void nas_acl_filter_t::get_ip_type_filter_val (nas_acl_common_data_list_t& val_list) const
 {
     nas_acl_common_data_t ip_type;
 
-    ip_type.u32 = _f_info.data.ip_type;
+    ip_type.u32 = _enum_val;
 
     val_list.push_back (ip_type);
 }
@@ -248,15 +405,15 @@ void nas_acl_filter_t::set_ip_type_filter_val (const nas_acl_common_data_list_t&
         throw nas::base_exception {NAS_ACL_E_ATTR_VAL, __PRETTY_FUNCTION__,
             std::string {"Invalid IP type value "} + std::to_string (val)};
     }
-    _f_info.values_type  = NDI_ACL_FILTER_IP_TYPE;
-    _f_info.data.ip_type = (BASE_ACL_MATCH_IP_TYPE_t) val;
+    _reset_val (NDI_ACL_FILTER_IP_TYPE);
+    _enum_val = val;
 }
 
 void nas_acl_filter_t::get_ip_frag_filter_val (nas_acl_common_data_list_t& val_list) const
 {
     nas_acl_common_data_t ip_frag;
 
-    ip_frag.u32 = _f_info.data.ip_frag;
+    ip_frag.u32 = _enum_val;
 
     val_list.push_back (ip_frag);
 }
@@ -269,18 +426,19 @@ void nas_acl_filter_t::set_ip_frag_filter_val (const nas_acl_common_data_list_t&
         throw nas::base_exception {NAS_ACL_E_ATTR_VAL, __PRETTY_FUNCTION__,
             std::string {"Invalid IP frag value "} + std::to_string (val)};
     }
-    _f_info.values_type  = NDI_ACL_FILTER_IP_FRAG;
-    _f_info.data.ip_frag = (BASE_ACL_MATCH_IP_FRAG_t) val;
+    _reset_val (NDI_ACL_FILTER_IP_FRAG);
+    _enum_val = val;
 }
 
 void nas_acl_filter_t::get_filter_ifindex_list (nas_acl_common_data_list_t& val_list) const
 {
     nas_acl_common_data_t if_list_data;
+    const auto& if_list = get_filter_if_list ();
 
-    if (_ifindex_list.size () != 0) {
+    if (if_list.size () != 0) {
 
-        for (auto ifindex: _ifindex_list) {
-            if_list_data.ifindex_list.push_back (ifindex);
+        for (auto ifindex: if_list) {
+            if_list_data.ifindex_list ().push_back (ifindex);
         }
 
         val_list.push_back (if_list_data);
@@ -289,11 +447,11 @@ void nas_acl_filter_t::get_filter_ifindex_list (nas_acl_common_data_list_t& val_
 
 void nas_acl_filter_t::set_filter_ifindex_list (const nas_acl_common_data_list_t& val_list)
 {
-    _f_info.values_type  = NDI_ACL_FILTER_PORTLIST;
+    auto& if_list = _ports (NDI_ACL_FILTER_PORTLIST);
 
-    for (auto match_data: val_list) {
-        for (auto port: match_data.ifindex_list) {
-            _ifindex_list.push_back (port);
+    for (const auto& match_data: val_list) {
+        for (auto port: match_data.ifindex_list ()) {
+            if_list.push_back (port);
         }
     }
 }
@@ -302,8 +460,10 @@ void nas_acl_filter_t::get_filter_ifindex (nas_acl_common_data_list_t& val_list)
 {
     nas_acl_common_data_t data;
 
-    if (_ifindex_list.size () != 0) {
-       data.ifindex = _ifindex_list.at(0);
+    const auto& if_list = get_filter_if_list ();
+
+    if (if_list.size () != 0) {
+       data.ifindex = if_list.at(0);
        val_list.push_back (data);
     }
 }
@@ -318,38 +478,34 @@ void nas_acl_filter_t::set_filter_ifindex (const nas_acl_common_data_list_t& val
     }
 
     auto ifindex = val_list.at(0).ifindex;
-    _ifindex_list.push_back (ifindex);
 
     interface_ctrl_t  intf_ctrl {};
     nas_acl_utl_ifidx_to_ndi_port (ifindex, &intf_ctrl);
 
-    _f_info.values_type  = NDI_ACL_FILTER_PORT;
-    _f_info.data.values.ndi_port.npu_id = intf_ctrl.npu_id;
-    _f_info.data.values.ndi_port.npu_port = intf_ctrl.port_id;
+    _ports (NDI_ACL_FILTER_PORT).push_back (ifindex);
+    _port.ndi_port.npu_id = intf_ctrl.npu_id;
+    _port.ndi_port.npu_port = intf_ctrl.port_id;
 }
 
 bool nas_acl_filter_t::copy_filter_ndi (ndi_acl_entry_filter_t* ndi_filter_p,
                                         npu_id_t npu_id,
                                         nas::mem_alloc_helper_t& mem_trakr) const
 {
-    if (ndi_filter_p->values_type == NDI_ACL_FILTER_PORT &&
-        _f_info.data.values.ndi_port.npu_id != npu_id)
+    if (_values_type == NDI_ACL_FILTER_PORT &&
+        _port.ndi_port.npu_id != npu_id)
     {
         NAS_ACL_LOG_DETAIL ("Skipping NPU %d - Filter has no ports", npu_id);
         return false;
     }
 
-    *ndi_filter_p = _f_info;
+    _fill_ndi (ndi_filter_p);
 
     if (ndi_filter_p->values_type == NDI_ACL_FILTER_PORTLIST) {
 
-        // Assert to ensure that we are not overwriting existing portlist
-        STD_ASSERT (ndi_filter_p->data.values.ndi_portlist.port_list == NULL);
-
         // Build the list of NPU specific ports
         std::vector<ndi_port_t> ndi_plist;
 
-        for (auto ifindex: _ifindex_list) {
+        for (auto ifindex: get_filter_if_list ()) {
             // Convert to NPU and port
             interface_ctrl_t  intf_ctrl {};
             nas_acl_utl_ifidx_to_ndi_port (ifindex, &intf_ctrl);
@@ -377,7 +533,7 @@ nas::npu_set_t nas_acl_filter_t::get_npu_list () const
     nas::npu_set_t  filter_npu_list;
 
     if (is_npu_specific()) {
-        for (auto ifindex: _ifindex_list) {
+        for (auto ifindex: get_filter_if_list ()) {
             // Convert to NPU and port
             interface_ctrl_t  intf_ctrl {};
             nas_acl_utl_ifidx_to_ndi_port (ifindex, &intf_ctrl);
@@ -394,39 +550,101 @@ bool nas_acl_filter_t::operator!= (const nas_acl_filter_t& rhs) const noexcept
         return true;
     }
 
-    if (_f_info.values_type == NDI_ACL_FILTER_PORTLIST ||
-        _f_info.values_type == NDI_ACL_FILTER_PORT)
-    {
-        if (_ifindex_list != rhs._ifindex_list) {
-            return true;
-        }
+    if (_values_type != rhs._values_type) {
+        return true;
     }
-    else {
-        if (memcmp (&_f_info, &rhs._f_info, sizeof(_f_info))) {
-            return true;
-        }
+
+    if (_has_ports ()) {
+        return (get_filter_if_list () != rhs.get_filter_if_list ());
+    }
+
+    switch (_values_type) {
+        case NDI_ACL_FILTER_IP_TYPE:
+        case NDI_ACL_FILTER_IP_FRAG:
+            return (_enum_val != rhs._enum_val);
+        default:
+            break;
     }
 
-    return false;
+    if (is_port_range ()) {
+        return (_range.min != rhs._range.min || _range.max != rhs._range.max);
+    }
+
+    // Value is canonical - only the value and mask bytes need comparing
+    return (_len != rhs._len || memcmp (_val, rhs._val, 2 * _len) != 0);
+}
+
+uint64_t nas_acl_filter_t::cfg_hash () const noexcept
+{
+    uint64_t hash = nas_acl_hash_val (NAS_ACL_HASH_INIT, _filter_type);
+    hash = nas_acl_hash_val (hash, _values_type);
+
+    if (_has_ports ()) {
+        const auto& if_list = get_filter_if_list ();
+        return nas_acl_hash_bytes (hash, if_list.data (),
+                                   if_list.size () * sizeof (if_list[0]));
+    }
+
+    switch (_values_type) {
+        case NDI_ACL_FILTER_IP_TYPE:
+        case NDI_ACL_FILTER_IP_FRAG:
+            return nas_acl_hash_val (hash, _enum_val);
+        default:
+            break;
+    }
+
+    if (is_port_range ()) {
+        return nas_acl_hash_val (nas_acl_hash_val (hash, _range.min), _range.max);
+    }
+
+    return nas_acl_hash_bytes (hash, _val, 2 * _len);
+}
+
+bool nas_acl_filter_t::is_ip_addr () const noexcept
+{
+    return (_values_type == NDI_ACL_FILTER_IPV4_ADDR ||
+            _values_type == NDI_ACL_FILTER_IPV6_ADDR);
+}
+
+bool nas_acl_filter_t::is_within (const nas_acl_filter_t& prefix) const noexcept
+{
+    if (_filter_type != prefix._filter_type || !is_ip_addr () ||
+        _values_type != prefix._values_type) {
+        return false;
+    }
+
+    // At least the prefix mask bits, with the same values
+    for (size_t idx = 0; idx < _len; idx++) {
+        auto prefix_mask = prefix.ip_mask ()[idx];
+        if ((ip_mask ()[idx] & prefix_mask) != prefix_mask ||
+            (ip_addr ()[idx] & prefix_mask) != prefix.ip_addr ()[idx]) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void nas_acl_filter_t::dbg_dump () const
 {
+    ndi_acl_entry_filter_t f_info;
+
+    _fill_ndi (&f_info);
+
     NAS_ACL_LOG_DUMP ("Filter: %s", name ());
 
-    switch (_f_info.values_type)
+    switch (f_info.values_type)
     {
         case NDI_ACL_FILTER_IP_TYPE:
-            NAS_ACL_LOG_DUMP ("  ip_type = %d", _f_info.data.ip_type);
+            NAS_ACL_LOG_DUMP ("  ip_type = %d", f_info.data.ip_type);
             break;
 
         case NDI_ACL_FILTER_IP_FRAG:
-            NAS_ACL_LOG_DUMP ("  ip_frag = %d", _f_info.data.ip_frag);
+            NAS_ACL_LOG_DUMP ("  ip_frag = %d", f_info.data.ip_frag);
             break;
 
         case NDI_ACL_FILTER_PORTLIST:
             NAS_ACL_LOG_DUMP ("  Ports = ");
-            for (auto ifindex: _ifindex_list) {
+            for (auto ifindex: get_filter_if_list ()) {
                 NAS_ACL_LOG_DUMP ("%d, ", ifindex);
             }
             NAS_ACL_LOG_DUMP ("");
@@ -434,28 +652,28 @@ void nas_acl_filter_t::dbg_dump () const
 
         case NDI_ACL_FILTER_MAC_ADDR:
             NAS_ACL_LOG_DUMP ("  mac-addr = %0x:%0x:%0x:%0x:%0x:%0x ",
-                              _f_info.data.values.mac[0],
-                              _f_info.data.values.mac[1],
-                              _f_info.data.values.mac[2],
-                              _f_info.data.values.mac[3],
-                              _f_info.data.values.mac[4],
-                              _f_info.data.values.mac[5]);
+                              f_info.data.values.mac[0],
+                              f_info.data.values.mac[1],
+                              f_info.data.values.mac[2],
+                              f_info.data.values.mac[3],
+                              f_info.data.values.mac[4],
+                              f_info.data.values.mac[5]);
             NAS_ACL_LOG_DUMP ("  mac-addr-mask = %0x:%0x:%0x:%0x:%0x:%0x ",
-                              _f_info.mask.values.mac[0],
-                              _f_info.mask.values.mac[1],
-                              _f_info.mask.values.mac[2],
-                              _f_info.mask.values.mac[3],
-                              _f_info.mask.values.mac[4],
-                              _f_info.mask.values.mac[5]);
+                              f_info.mask.values.mac[0],
+                              f_info.mask.values.mac[1],
+                              f_info.mask.values.mac[2],
+                              f_info.mask.values.mac[3],
+                              f_info.mask.values.mac[4],
+                              f_info.mask.values.mac[5]);
             break;
 
         case NDI_ACL_FILTER_IPV4_ADDR:
             {
                 char buff[INET_ADDRSTRLEN];
                 NAS_ACL_LOG_DUMP ("   ipv4 addr = %s, ipv4 addr mask = %s",
-                                  inet_ntop (AF_INET, &_f_info.data.values.ipv4,
+                                  inet_ntop (AF_INET, &f_info.data.values.ipv4,
                                              buff, sizeof(buff)),
-                                  inet_ntop (AF_INET, &_f_info.mask.values.ipv4,
+                                  inet_ntop (AF_INET, &f_info.mask.values.ipv4,
                                              buff, sizeof(buff)));
             }
             break;
@@ -464,26 +682,30 @@ void nas_acl_filter_t::dbg_dump () const
             {
                 char buff[INET6_ADDRSTRLEN];
                 NAS_ACL_LOG_DUMP ("   ipv6 addr = %s, ipv6 addr mask = %s",
-                                  inet_ntop (AF_INET6, &_f_info.data.values.ipv6,
+                                  inet_ntop (AF_INET6, &f_info.data.values.ipv6,
                                              buff, sizeof(buff)),
-                                  inet_ntop (AF_INET6, &_f_info.mask.values.ipv6,
+                                  inet_ntop (AF_INET6, &f_info.mask.values.ipv6,
                                              buff, sizeof(buff)));
             }
             break;
 
         case NDI_ACL_FILTER_U32:
-            NAS_ACL_LOG_DUMP ("  U32 Value = %u", _f_info.data.values.u32);
-            NAS_ACL_LOG_DUMP ("  U32 Mask = %u", _f_info.mask.values.u32);
+            NAS_ACL_LOG_DUMP ("  U32 Value = %u", f_info.data.values.u32);
+            NAS_ACL_LOG_DUMP ("  U32 Mask = %u", f_info.mask.values.u32);
             break;
 
         case NDI_ACL_FILTER_U16:
-            NAS_ACL_LOG_DUMP ("  U16 Value = %d", _f_info.data.values.u16);
-            NAS_ACL_LOG_DUMP ("  U16 Mask = %d", _f_info.mask.values.u16);
+            if (is_port_range ()) {
+                NAS_ACL_LOG_DUMP ("  Range = %d - %d", _range.min, _range.max);
+                break;
+            }
+            NAS_ACL_LOG_DUMP ("  U16 Value = %d", f_info.data.values.u16);
+            NAS_ACL_LOG_DUMP ("  U16 Mask = %d", f_info.mask.values.u16);
             break;
 
         case NDI_ACL_FILTER_U8:
-            NAS_ACL_LOG_DUMP ("  U8 Value = %d", _f_info.data.values.u8);
-            NAS_ACL_LOG_DUMP ("  U8 Mask = %d", _f_info.mask.values.u8);
+            NAS_ACL_LOG_DUMP ("  U8 Value = %d", f_info.data.values.u8);
+            NAS_ACL_LOG_DUMP ("  U8 Mask = %d", f_info.mask.values.u8);
             break;
 
         default:
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*!
+ * \file   nas_acl_index.cpp
+ * \brief  Secondary indexes of the ACL Entries in a Table
+ */
+
+#include "nas_acl_index.h"
+#include "nas_acl_entry.h"
+
+const nas_acl_entry_id_set_t nas_acl_entry_index_t::_no_entries;
+
+template <typename K, typename M>
+static const nas_acl_entry_id_set_t& _find_entries (const M& index, const K& key,
+                                                    const nas_acl_entry_id_set_t& none)
+                                                    noexcept
+{
+    auto it = index.find (key);
+    return (it == index.end ()) ? none : it->second;
+}
+
+template <typename K, typename M>
+static void _erase_entry (M& index, const K& key, nas_obj_id_t entry_id) noexcept
+{
+    auto it = index.find (key);
+    if (it == index.end ()) {
+        return;
+    }
+    it->second.erase (entry_id);
+    if (it->second.empty ()) {
+        index.erase (it);
+    }
+}
+
+void nas_acl_entry_index_t::add (const nas_acl_entry& entry)
+{
+    auto entry_id = entry.entry_id ();
+
+    for (const auto& f_kv: entry.get_filter_list ()) {
+
+        auto& filter = f_kv.second;
+        _filters[filter.cfg_hash ()].insert (entry_id);
+
+        if (filter.is_ip_addr ()) {
+            std::vector<uint8_t> addr (filter.ip_addr (),
+                                       filter.ip_addr () + filter.ip_addr_len ());
+            _ip_addrs[filter.filter_type ()].emplace (std::move (addr), entry_id);
+        }
+        for (auto ifindex: filter.get_filter_if_list ()) {
+            _ifindexes[ifindex].insert (entry_id);
+        }
+    }
+
+    for (const auto& a_kv: entry.get_action_list ()) {
+
+        auto& action = a_kv.second;
+        _actions[action.cfg_hash ()].insert (entry_id);
+
+        for (auto ifindex: action.get_action_if_list ()) {
+            _ifindexes[ifindex].insert (entry_id);
+        }
+    }
+}
+
+void nas_acl_entry_index_t::remove (const nas_acl_entry& entry) noexcept
+{
+    auto entry_id = entry.entry_id ();
+
+    for (const auto& f_kv: entry.get_filter_list ()) {
+
+        auto& filter = f_kv.second;
+        _erase_entry (_filters, filter.cfg_hash (), entry_id);
+
+        auto it_type = _ip_addrs.find (filter.filter_type ());
+        if (filter.is_ip_addr () && it_type != _ip_addrs.end ()) {
+            std::vector<uint8_t> addr (filter.ip_addr (),
+                                       filter.ip_addr () + filter.ip_addr_len ());
+            auto range = it_type->second.equal_range (addr);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == entry_id) {
+                    it_type->second.erase (it);
+                    break;
+                }
+            }
+        }
+        for (auto ifindex: filter.get_filter_if_list ()) {
+            _erase_entry (_ifindexes, ifindex, entry_id);
+        }
+    }
+
+    for (const auto& a_kv: entry.get_action_list ()) {
+
+        auto& action = a_kv.second;
+        _erase_entry (_actions, action.cfg_hash (), entry_id);
+
+        for (auto ifindex: action.get_action_if_list ()) {
+            _erase_entry (_ifindexes, ifindex, entry_id);
+        }
+    }
+}
+
+const nas_acl_entry_id_set_t&
+nas_acl_entry_index_t::filter_entries (const nas_acl_filter_t& filter) const noexcept
+{
+    return _find_entries (_filters, filter.cfg_hash (), _no_entries);
+}
+
+const nas_acl_entry_id_set_t&
+nas_acl_entry_index_t::action_entries (const nas_acl_action_t& action) const noexcept
+{
+    return _find_entries (_actions, action.cfg_hash (), _no_entries);
+}
+
+const nas_acl_entry_id_set_t&
+nas_acl_entry_index_t::ifindex_entries (hal_ifindex_t ifindex) const noexcept
+{
+    return _find_entries (_ifindexes, ifindex, _no_entries);
+}
+
+nas_acl_entry_id_set_t
+nas_acl_entry_index_t::ip_prefix_entries (const nas_acl_filter_t& prefix) const
+{
+    nas_acl_entry_id_set_t entries;
+
+    auto it_type = _ip_addrs.find (prefix.filter_type ());
+    if (it_type == _ip_addrs.end () || !prefix.is_ip_addr ()) {
+        return entries;
+    }
+
+    // Addresses within the prefix are from the prefix itself up to
+    // the prefix with all the bits outside the mask set
+    std::vector<uint8_t> low (prefix.ip_addr (), prefix.ip_addr () + prefix.ip_addr_len ());
+    std::vector<uint8_t> high (low);
+    for (size_t idx = 0; idx < high.size (); idx++) {
+        high[idx] |= ~prefix.ip_mask ()[idx];
+    }
+
+    auto& ip_index = it_type->second;
+    for (auto it = ip_index.lower_bound (low);
+         it != ip_index.end () && it->first <= high; ++it) {
+        entries.insert (it->second);
+    }
+    return entries;
+}
+
+// Every interface the Entry refers to - repeats are harmless to the
+// set operations of the callers
+template <typename F>
+static void _for_each_ifindex (const nas_acl_entry& entry, F fn)
+{
+    for (const auto& f_kv: entry.get_filter_list ()) {
+        for (auto ifindex: f_kv.second.get_filter_if_list ()) {
+            fn (ifindex);
+        }
+    }
+    for (const auto& a_kv: entry.get_action_list ()) {
+        for (auto ifindex: a_kv.second.get_action_if_list ()) {
+            fn (ifindex);
+        }
+    }
+}
+
+void nas_acl_if_index_t::add (const nas_acl_entry& entry)
+{
+    nas_acl_entry_ref_t ref {entry.table_id (), entry.entry_id ()};
+
+    _for_each_ifindex (entry, [&] (hal_ifindex_t ifindex) {
+        _refs[ifindex].insert (ref);
+    });
+}
+
+void nas_acl_if_index_t::remove (const nas_acl_entry& entry) noexcept
+{
+    nas_acl_entry_ref_t ref {entry.table_id (), entry.entry_id ()};
+
+    _for_each_ifindex (entry, [&] (hal_ifindex_t ifindex) {
+        auto it = _refs.find (ifindex);
+        if (it == _refs.end ()) {
+            return;
+        }
+        it->second.erase (ref);
+        if (it->second.empty ()) {
+            _refs.erase (it);
+        }
+    });
+}
+
+nas_acl_entry_ref_list_t nas_acl_if_index_t::entries (hal_ifindex_t ifindex) const
+{
+    auto it = _refs.find (ifindex);
+    if (it == _refs.end ()) {
+        return {};
+    }
+    return nas_acl_entry_ref_list_t (it->second.begin (), it->second.end ());
+}
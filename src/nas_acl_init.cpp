@@ -26,10 +26,11 @@
 #include "std_error_codes.h"
 #include "nas_acl_cps.h"
 #include "nas_acl_init.h"
-#include "std_mutex_lock.h"
-
-/*** NAS ACL Main Control block ***/
-std_mutex_lock_create_static_init_fast (nas_acl_mutex);
+#include "nas_acl_warm.h"
+#include "nas_acl_event.h"
+#include "nas_acl_async.h"
+#include "nas_acl_intf.h"
+#include "nas_acl_prepare.h"
 
 static t_std_error _cps_init ()
 {
@@ -72,31 +73,50 @@ static t_std_error _cps_init ()
     return STD_ERR_OK;
 }
 
-int nas_acl_lock () noexcept
-{
-    return (std_mutex_lock (&nas_acl_mutex));
-}
-
-int nas_acl_unlock () noexcept
-{
-    return (std_mutex_unlock (&nas_acl_mutex));
-}
-
-extern "C" {
-
-t_std_error nas_acl_init(void)
+static t_std_error _nas_acl_init (bool warm)
 {
     t_std_error rc = STD_ERR_OK;
 
-    NAS_ACL_LOG_BRIEF ("Initializing NAS-ACL");
+    NAS_ACL_LOG_BRIEF ("Initializing NAS-ACL%s", (warm) ? " after warm restart" : "");
 
     do {
+        nas_acl_warm_init (warm);
+
         if ((rc = _cps_init ()) != STD_ERR_OK) {
             break;
         }
 
+        // Runs without change events if the event service is not available
+        nas_acl_event_init ();
+        nas_acl_async_init ();
+        // Runs without LAG tracking if interface events are not available
+        nas_acl_intf_init ();
+        nas_acl_txn_lock_init ();
+        nas_acl_prepare_init ();
+
     } while (0);
 
     return rc;
 }
+
+extern "C" {
+
+t_std_error nas_acl_init(void)
+{
+    return _nas_acl_init (false);
+}
+
+t_std_error nas_acl_init_warm(void)
+{
+    return _nas_acl_init (true);
+}
+
+t_std_error nas_acl_warm_reconcile_done(void)
+{
+    nas_acl_lock ();
+    nas_acl_warm_reconcile ();
+    nas_acl_unlock ();
+
+    return STD_ERR_OK;
+}
 }
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_intf.cpp
+ * \brief  NAS ACL reprogram of the Entries that refer to an interface
+ */
+
+#include "cps_api_events.h"
+#include "cps_api_object_key.h"
+#include "dell-interface.h"
+#include "std_error_codes.h"
+#include "nas_acl_log.h"
+#include "nas_acl_intf.h"
+#include "nas_acl_cps.h"
+#include "nas_acl_switch_list.h"
+#include "nas_base_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+
+// Never destroyed - the detached refresh thread waits on them until exit
+static std::mutex&               _intf_mutex = *(new std::mutex);
+static std::condition_variable&  _intf_cv = *(new std::condition_variable);
+static std::set<hal_ifindex_t>   _intf_pending;
+static uint32_t                  _intf_refresh_ms = NAS_ACL_INTF_REFRESH_MS_DEF;
+
+template <typename L>
+static bool _has_ifindex (const L& if_list, hal_ifindex_t ifindex) noexcept
+{
+    return (std::find (if_list.begin (), if_list.end (), ifindex) != if_list.end ());
+}
+
+// Filter or Action resolved again from its ifindexes through the CPS
+// map getter and setter
+template <typename T, typename I>
+static T _resolve (const T& obj, const I* map_info_p)
+{
+    if (map_info_p == NULL || map_info_p->get_fn == NULL || map_info_p->set_fn == NULL) {
+        throw nas::base_exception {NAS_ACL_E_FAIL, __PRETTY_FUNCTION__,
+                                   std::string {"Cannot resolve "} + obj.name ()};
+    }
+
+    nas_acl_common_data_list_t data_list;
+    (obj.*(map_info_p->get_fn)) (data_list);
+
+    T resolved {map_info_p->type};
+    (resolved.*(map_info_p->set_fn)) (data_list);
+    return resolved;
+}
+
+// Returns false if the Filters and Actions on the interface resolve to
+// what the Entry already has
+static bool _resolve_entry (nas_acl_entry& entry, const nas_acl_entry& old_entry,
+                            hal_ifindex_t ifindex)
+{
+    std::vector<nas_acl_filter_t> flist;
+    bool                          flist_changed = false;
+
+    for (const auto& f_kv: old_entry.get_filter_list ()) {
+        auto& filter = f_kv.second;
+        if (!_has_ifindex (filter.get_filter_if_list (), ifindex)) {
+            flist.push_back (filter);
+            continue;
+        }
+        flist.push_back (_resolve (filter, nas_acl_get_filter_info (filter.filter_type ())));
+        flist_changed = flist_changed || (flist.back () != filter);
+    }
+
+    std::vector<nas_acl_action_t> alist;
+    bool                          alist_changed = false;
+
+    for (const auto& a_kv: old_entry.get_action_list ()) {
+        auto& action = a_kv.second;
+        if (!_has_ifindex (action.get_action_if_list (), ifindex)) {
+            alist.push_back (action);
+            continue;
+        }
+        alist.push_back (_resolve (action, nas_acl_get_action_info (action.action_type ())));
+        alist_changed = alist_changed || (alist.back () != action);
+    }
+
+    // Only the lists that changed are marked for the NDI push
+    if (flist_changed) {
+        entry.reset_filter ();
+        for (auto& filter: flist) {
+            entry.add_filter (filter, false);
+        }
+    }
+    if (alist_changed) {
+        entry.reset_action ();
+        for (auto& action: alist) {
+            entry.add_action (action, false);
+        }
+    }
+
+    return (flist_changed || alist_changed);
+}
+
+t_std_error nas_acl_intf_reprogram_entries (nas_acl_switch&                 sw,
+                                            hal_ifindex_t                   ifindex,
+                                            const nas_acl_entry_ref_list_t& entries,
+                                            nas_acl_intf_stats_t*           stats) noexcept
+{
+    nas_acl_intf_stats_t  count {};
+
+    for (const auto& ref: entries) {
+
+        try {
+            nas_acl_entry& old_entry = sw.get_entry (ref.first, ref.second);
+            nas_acl_entry  new_entry (old_entry);
+
+            if (!_resolve_entry (new_entry, old_entry, ifindex)) {
+                count.unchanged++;
+                continue;
+            }
+
+            new_entry.commit_modify (old_entry, false);
+
+            // WARNING !!! CANNOT throw error or exception beyond this point
+            // since entry is already committed to SAI
+            sw.save_entry (std::move (new_entry));
+            count.reprogrammed++;
+
+        } catch (nas::base_exception& e) {
+            NAS_ACL_LOG_ERR ("Reprogram of Table Id %ld Entry Id %ld failed: %s",
+                             ref.first, ref.second, e.err_msg.c_str ());
+            count.failed++;
+        } catch (std::exception& e) {
+            NAS_ACL_LOG_ERR ("Reprogram of Table Id %ld Entry Id %ld failed: %s",
+                             ref.first, ref.second, e.what ());
+            count.failed++;
+        }
+    }
+
+    NAS_ACL_LOG_BRIEF ("IfIndex %d: %ld Entries reprogrammed, %ld unchanged, %ld failed",
+                       ifindex, count.reprogrammed, count.unchanged, count.failed);
+
+    if (stats != NULL) {
+        *stats = count;
+    }
+    return (count.failed == 0) ? NAS_ACL_E_NONE : NAS_ACL_E_FAIL;
+}
+
+t_std_error nas_acl_intf_reprogram (nas_switch_id_t       switch_id,
+                                    hal_ifindex_t         ifindex,
+                                    nas_acl_intf_stats_t* stats) noexcept
+{
+    // The Entries can be in any Table of the switch
+    nas_acl_lock_scope_t scope (NAS_ACL_LOCK_TABLES, switch_id);
+    t_std_error          rc;
+
+    scope.lock ();
+
+    try {
+        nas_acl_switch& sw = nas_acl_get_switch (switch_id);
+        auto entries = sw.if_entries (ifindex);
+
+        NAS_ACL_LOG_BRIEF ("Switch Id: %d IfIndex %d in %ld Entries",
+                           switch_id, ifindex, entries.size ());
+
+        rc = nas_acl_intf_reprogram_entries (sw, ifindex, entries, stats);
+
+    } catch (nas::base_exception& e) {
+        NAS_ACL_LOG_ERR ("Interface %d reprogram failed: %s", ifindex,
+                         e.err_msg.c_str ());
+        rc = e.err_code;
+    }
+
+    scope.unlock ();
+    return rc;
+}
+
+void nas_acl_intf_note_change (hal_ifindex_t ifindex) noexcept
+{
+    try {
+        std::lock_guard<std::mutex> lock (_intf_mutex);
+
+        if (_intf_pending.insert (ifindex).second) {
+            _intf_cv.notify_one ();
+        }
+    } catch (std::exception& e) {
+        NAS_ACL_LOG_ERR ("Interface %d change dropped: %s", ifindex, e.what ());
+    }
+}
+
+size_t nas_acl_intf_refresh_pending () noexcept
+{
+    std::vector<hal_ifindex_t> batch;
+
+    {
+        std::lock_guard<std::mutex> lock (_intf_mutex);
+
+        while (!_intf_pending.empty () && batch.size () < NAS_ACL_INTF_REFRESH_MAX) {
+            batch.push_back (*_intf_pending.begin ());
+            _intf_pending.erase (_intf_pending.begin ());
+        }
+    }
+
+    for (auto ifindex: batch) {
+        try {
+            // Interface index has a lock of its own - most interface
+            // events do not concern ACL and need no Table lock
+            if (nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ()).if_entries (ifindex).empty ()) {
+                continue;
+            }
+        } catch (nas::base_exception& e) {
+            NAS_ACL_LOG_ERR ("Interface %d refresh failed: %s", ifindex,
+                             e.err_msg.c_str ());
+            continue;
+        }
+
+        nas_acl_intf_reprogram (NAS_ACL_DEFAULT_SWITCH_ID (), ifindex, NULL);
+    }
+
+    return batch.size ();
+}
+
+static void _intf_refresh_main () noexcept
+{
+    std::unique_lock<std::mutex> lock (_intf_mutex);
+
+    while (true) {
+        _intf_cv.wait (lock, [] {return !_intf_pending.empty ();});
+
+        auto interval = std::chrono::milliseconds (_intf_refresh_ms);
+
+        lock.unlock ();
+        nas_acl_intf_refresh_pending ();
+
+        // Changes noted meanwhile wait for the next interval
+        std::this_thread::sleep_for (interval);
+        lock.lock ();
+    }
+}
+
+static bool _intf_event_cb (cps_api_object_t obj, void* context)
+{
+    auto ifindex_attr = cps_api_object_attr_get (obj,
+                            DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_IF_INDEX);
+
+    if (ifindex_attr != NULL) {
+        nas_acl_intf_note_change (cps_api_object_attr_data_u32 (ifindex_attr));
+    }
+    return true;
+}
+
+bool nas_acl_intf_init () noexcept
+{
+    const char* interval_str = getenv (NAS_ACL_INTF_REFRESH_MS_ENV);
+
+    if (interval_str != NULL) {
+        nas_acl_intf_refresh_interval_set (strtoul (interval_str, NULL, 0));
+    }
+
+    try {
+        std::thread refresher (_intf_refresh_main);
+        refresher.detach ();
+
+    } catch (std::exception& e) {
+        NAS_ACL_LOG_ERR ("Failed to start ACL interface refresh: %s - "
+                         "LAG changes need the Entries to be written again", e.what ());
+        return false;
+    }
+
+    // LAG membership changes are published on the interface object
+    cps_api_key_t        key;
+    cps_api_event_reg_t  reg {};
+
+    cps_api_key_from_attr_with_qual (&key, DELL_BASE_IF_CMN_IF_INTERFACES_INTERFACE_OBJ,
+                                     cps_api_qualifier_OBSERVED);
+    reg.number_of_objects = 1;
+    reg.objects           = &key;
+
+    if (cps_api_event_thread_init () != cps_api_ret_code_OK ||
+        cps_api_event_thread_reg (&reg, _intf_event_cb, NULL) != cps_api_ret_code_OK) {
+        NAS_ACL_LOG_ERR ("Failed to subscribe to interface events - "
+                         "LAG changes need the Entries to be written again");
+        return false;
+    }
+
+    NAS_ACL_LOG_BRIEF ("ACL interface refresh enabled, interval %d ms",
+                       nas_acl_intf_refresh_interval_get ());
+    return true;
+}
+
+void nas_acl_intf_refresh_interval_set (uint32_t interval_ms) noexcept
+{
+    std::lock_guard<std::mutex> lock (_intf_mutex);
+    _intf_refresh_ms = interval_ms;
+}
+
+uint32_t nas_acl_intf_refresh_interval_get () noexcept
+{
+    std::lock_guard<std::mutex> lock (_intf_mutex);
+    return _intf_refresh_ms;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*!
+ * \file   nas_acl_lock.cpp
+ * \brief  NAS ACL lock hierarchy
+ */
+
+#include "nas_acl_lock.h"
+#include "nas_acl_switch_list.h"
+#include "nas_acl_log.h"
+
+/*** NAS ACL Main Control block ***/
+static nas_acl_rwlock_t _nas_acl_lock;
+
+static std::mutex       _nas_acl_ndi_mutex;
+
+nas_acl_rwlock_t::nas_acl_rwlock_t () noexcept
+{
+    pthread_rwlockattr_t attr;
+
+    pthread_rwlockattr_init (&attr);
+    pthread_rwlockattr_setkind_np (&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    pthread_rwlock_init (&_lock, &attr);
+    pthread_rwlockattr_destroy (&attr);
+}
+
+nas_acl_rwlock_t::~nas_acl_rwlock_t ()
+{
+    pthread_rwlock_destroy (&_lock);
+}
+
+int nas_acl_lock () noexcept
+{
+    return (_nas_acl_lock.lock ());
+}
+
+int nas_acl_lock_shared () noexcept
+{
+    return (_nas_acl_lock.lock_shared ());
+}
+
+int nas_acl_unlock () noexcept
+{
+    return (_nas_acl_lock.unlock ());
+}
+
+std::mutex& nas_acl_ndi_mutex () noexcept
+{
+    return _nas_acl_ndi_mutex;
+}
+
+void nas_acl_lock_scope_t::lock () noexcept
+{
+    if (_level == NAS_ACL_LOCK_ALL) {
+        nas_acl_lock ();
+        return;
+    }
+
+    nas_acl_lock_shared ();
+
+    nas_acl_switch* sw_p;
+    try {
+        sw_p = &nas_acl_get_switch (_switch_id);
+    } catch (nas::base_exception& e) {
+        // Request fails on the invalid switch without touching any state
+        NAS_ACL_LOG_BRIEF ("Switch %d not locked: %s", _switch_id, e.err_msg.c_str ());
+        return;
+    }
+
+    _switch_p = sw_p;
+
+    if (_level == NAS_ACL_LOCK_SWITCH) {
+        sw_p->lock ().lock ();
+        return;
+    }
+
+    sw_p->lock ().lock_shared ();
+
+    // Tables cannot come or go while the switch lock is held.
+    // A missing Table fails the request without touching any state.
+    if (_level == NAS_ACL_LOCK_TABLE) {
+        _table_lock_p = sw_p->table_lock (_table_id);
+        if (_table_lock_p != nullptr) {
+            _table_lock_p->lock ();
+        }
+        return;
+    }
+
+    // Table list is ordered by Table ID
+    for (const auto& table_pair: sw_p->table_list ()) {
+        auto table_lock_p = sw_p->table_lock (table_pair.first);
+        if (table_lock_p != nullptr) {
+            table_lock_p->lock ();
+        }
+    }
+}
+
+void nas_acl_lock_scope_t::unlock () noexcept
+{
+    if (_switch_p != nullptr) {
+        if (_table_lock_p != nullptr) {
+            _table_lock_p->unlock ();
+            _table_lock_p = nullptr;
+
+        } else if (_level == NAS_ACL_LOCK_TABLES) {
+            // Same Tables as when locked - the switch lock is still held
+            const auto& tables = _switch_p->table_list ();
+            for (auto it = tables.rbegin (); it != tables.rend (); ++it) {
+                auto table_lock_p = _switch_p->table_lock (it->first);
+                if (table_lock_p != nullptr) {
+                    table_lock_p->unlock ();
+                }
+            }
+        }
+
+        _switch_p->lock ().unlock ();
+        _switch_p = nullptr;
+    }
+
+    nas_acl_unlock ();
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_perf.cpp
+ * \brief  NAS ACL CPS and NDI latency histograms
+ */
+
+#include "nas_acl_perf.h"
+#include "nas_acl_log.h"
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <map>
+#include <mutex>
+
+// Leaf lock - requests on different Tables record in parallel
+static std::mutex _perf_mutex;
+
+static nas_acl_perf_hist_t
+_cps_hist [NAS_ACL_PERF_OBJ_MAX][NAS_ACL_PERF_OP_MAX][NAS_ACL_PERF_PHASE_MAX];
+
+static std::map<npu_id_t, nas_acl_perf_hist_t> _ndi_hist;
+
+// Request of this thread holding its NAS ACL locks
+static thread_local const nas_acl_perf_req_t* _active_req = NULL;
+static thread_local nas_acl_perf_obj_t        _active_obj;
+static thread_local nas_acl_perf_op_t         _active_op;
+
+static const char* _obj_name [NAS_ACL_PERF_OBJ_MAX] = {
+    "table", "entry", "counter", "stats",
+};
+
+static const char* _op_name [NAS_ACL_PERF_OP_MAX] = {
+    "create", "set", "delete", "get",
+};
+
+static const char* _phase_name [NAS_ACL_PERF_PHASE_MAX] = {
+    "total", "lock-wait", "parse", "commit", "save",
+};
+
+uint64_t nas_acl_perf_now_ns () noexcept
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+size_t nas_acl_perf_bucket (uint64_t ns) noexcept
+{
+    if (ns == 0) {
+        return 0;
+    }
+
+    size_t bucket = 64 - __builtin_clzll (ns);
+    return (bucket < NAS_ACL_PERF_HIST_BUCKETS) ?
+        bucket : (NAS_ACL_PERF_HIST_BUCKETS - 1);
+}
+
+void nas_acl_perf_hist_record (nas_acl_perf_hist_t& hist, uint64_t ns) noexcept
+{
+    hist.count++;
+    hist.total_ns += ns;
+    if (ns > hist.max_ns) {
+        hist.max_ns = ns;
+    }
+    hist.bucket[nas_acl_perf_bucket (ns)]++;
+}
+
+void nas_acl_perf_record (nas_acl_perf_obj_t obj, nas_acl_perf_op_t op,
+                          nas_acl_perf_phase_t phase, uint64_t ns) noexcept
+{
+    std::lock_guard<std::mutex> lock (_perf_mutex);
+    nas_acl_perf_hist_record (_cps_hist[obj][op][phase], ns);
+}
+
+void nas_acl_perf_ndi_record (npu_id_t npu_id, uint64_t ns) noexcept
+{
+    try {
+        std::lock_guard<std::mutex> lock (_perf_mutex);
+        nas_acl_perf_hist_record (_ndi_hist[npu_id], ns);
+    } catch (...) {
+        // Instrumentation must never fail the NDI call
+    }
+}
+
+void nas_acl_perf_walk (const nas_acl_perf_walk_fn_t& fn)
+{
+    std::lock_guard<std::mutex> lock (_perf_mutex);
+
+    for (size_t obj = 0; obj < NAS_ACL_PERF_OBJ_MAX; obj++) {
+        for (size_t op = 0; op < NAS_ACL_PERF_OP_MAX; op++) {
+            for (size_t phase = 0; phase < NAS_ACL_PERF_PHASE_MAX; phase++) {
+
+                const auto& hist = _cps_hist[obj][op][phase];
+                if (hist.count == 0) {
+                    continue;
+                }
+                fn (std::string {_obj_name[obj]} + "/" + _op_name[op]
+                    + "/" + _phase_name[phase], hist);
+            }
+        }
+    }
+
+    for (const auto& npu_hist: _ndi_hist) {
+        fn (std::string {"ndi/npu-"} + std::to_string (npu_hist.first),
+            npu_hist.second);
+    }
+}
+
+void nas_acl_perf_reset () noexcept
+{
+    std::lock_guard<std::mutex> lock (_perf_mutex);
+    memset (_cps_hist, 0, sizeof (_cps_hist));
+    _ndi_hist.clear ();
+}
+
+void nas_acl_perf_dump () noexcept
+{
+    NAS_ACL_LOG_DUMP ("NAS ACL latency histograms (ns)");
+    NAS_ACL_LOG_DUMP ("-------------------------------");
+
+    try {
+        nas_acl_perf_walk ([] (const std::string& name,
+                               const nas_acl_perf_hist_t& hist) {
+
+            NAS_ACL_LOG_DUMP ("%-24s count %" PRIu64 " avg %" PRIu64 " max %" PRIu64,
+                              name.c_str (), hist.count,
+                              hist.total_ns / hist.count, hist.max_ns);
+
+            for (size_t bucket = 0; bucket < NAS_ACL_PERF_HIST_BUCKETS; bucket++) {
+                if (hist.bucket[bucket] != 0) {
+                    NAS_ACL_LOG_DUMP ("    < 2^%-2zu: %" PRIu64,
+                                      bucket, hist.bucket[bucket]);
+                }
+            }
+        });
+    } catch (...) {
+    }
+}
+
+nas_acl_perf_req_t::nas_acl_perf_req_t (nas_acl_perf_obj_t obj,
+                                        nas_acl_perf_op_t op) noexcept
+    : _obj (obj), _op (op), _start_ns (nas_acl_perf_now_ns ())
+{
+}
+
+void nas_acl_perf_req_t::lock_acquired () noexcept
+{
+    if (_obj >= NAS_ACL_PERF_OBJ_MAX || _op >= NAS_ACL_PERF_OP_MAX) {
+        return;
+    }
+    nas_acl_perf_record (_obj, _op, NAS_ACL_PERF_PHASE_LOCK_WAIT,
+                         nas_acl_perf_now_ns () - _start_ns);
+    _active_req = this;
+    _active_obj = _obj;
+    _active_op  = _op;
+    _active = true;
+}
+
+void nas_acl_perf_req_t::end () noexcept
+{
+    if (!_active) {
+        return;
+    }
+    nas_acl_perf_record (_obj, _op, NAS_ACL_PERF_PHASE_TOTAL,
+                         nas_acl_perf_now_ns () - _start_ns);
+    _active_req = NULL;
+    _active = false;
+}
+
+nas_acl_perf_phase_timer_t::nas_acl_perf_phase_timer_t (nas_acl_perf_phase_t phase) noexcept
+    : _phase (phase), _start_ns (nas_acl_perf_now_ns ())
+{
+}
+
+void nas_acl_perf_phase_timer_t::next (nas_acl_perf_phase_t phase) noexcept
+{
+    uint64_t now_ns = nas_acl_perf_now_ns ();
+
+    if (_running && _active_req != NULL) {
+        nas_acl_perf_record (_active_obj, _active_op, _phase, now_ns - _start_ns);
+    }
+    _phase = phase;
+    _start_ns = now_ns;
+    _running = true;
+}
+
+void nas_acl_perf_phase_timer_t::stop () noexcept
+{
+    if (_running && _active_req != NULL) {
+        nas_acl_perf_record (_active_obj, _active_op, _phase,
+                             nas_acl_perf_now_ns () - _start_ns);
+    }
+    _running = false;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_pool.cpp
+ * \brief  NAS ACL per-table slab pools
+ */
+
+#include "nas_acl_pool.h"
+#include <algorithm>
+
+static inline size_t _class_index (size_t size) noexcept
+{
+    return (size == 0) ? 0 : (size - 1) / NAS_ACL_POOL_CLASS_SIZE;
+}
+
+void nas_acl_pool_t::_add_slab (_size_class_t& sc, size_t block_size)
+{
+    // Each slab is twice the size of the previous one, up to the max.
+    // Doubling stops at the max - shifting by the slab count overflows once
+    // a class has many slabs.
+    size_t num_blocks = NAS_ACL_POOL_MIN_SLAB;
+    for (size_t idx = 0; idx < sc.slabs.size () && num_blocks < NAS_ACL_POOL_MAX_SLAB; idx++) {
+        num_blocks <<= 1;
+    }
+    num_blocks = std::min<size_t> (num_blocks, NAS_ACL_POOL_MAX_SLAB);
+
+    std::unique_ptr<uint8_t[]> slab {new uint8_t [num_blocks * block_size]};
+
+    sc.fresh_p = slab.get ();
+    sc.fresh_left = num_blocks;
+    sc.slabs.push_back (std::move (slab));
+    sc.blocks_total += num_blocks;
+}
+
+void* nas_acl_pool_t::alloc (size_t size)
+{
+    if (size > NAS_ACL_POOL_MAX_BLOCK) {
+        _heap_allocs++;
+        return ::operator new (size);
+    }
+
+    auto  cls_idx = _class_index (size);
+    auto& sc = _classes [cls_idx];
+    void* block_p;
+
+    // Blocks freed by erased nodes are handed out first
+    if (sc.free_list != nullptr) {
+        block_p = sc.free_list;
+        sc.free_list = sc.free_list->next;
+        sc.reused++;
+    } else {
+        size_t block_size = (cls_idx + 1) * NAS_ACL_POOL_CLASS_SIZE;
+
+        if (sc.fresh_left == 0) {
+            _add_slab (sc, block_size);
+        }
+        block_p = sc.fresh_p;
+        sc.fresh_p += block_size;
+        sc.fresh_left--;
+    }
+
+    sc.allocs++;
+    sc.blocks_in_use++;
+
+    return block_p;
+}
+
+void nas_acl_pool_t::free (void* p, size_t size) noexcept
+{
+    if (p == nullptr) {
+        return;
+    }
+
+    if (size > NAS_ACL_POOL_MAX_BLOCK) {
+        ::operator delete (p);
+        return;
+    }
+
+    auto& sc = _classes [_class_index (size)];
+    auto block_p = static_cast<_block_t*> (p);
+
+    block_p->next = sc.free_list;
+    sc.free_list = block_p;
+    sc.blocks_in_use--;
+}
+
+std::vector<nas_acl_pool_stats_t> nas_acl_pool_t::stats () const
+{
+    std::vector<nas_acl_pool_stats_t> stats_list;
+
+    for (size_t idx = 0; idx < _num_classes; idx++) {
+        const auto& sc = _classes [idx];
+
+        if (sc.slabs.empty ()) {
+            continue;
+        }
+        stats_list.push_back ({(idx + 1) * NAS_ACL_POOL_CLASS_SIZE, sc.slabs.size (),
+                               sc.blocks_total, sc.blocks_in_use,
+                               sc.allocs, sc.reused});
+    }
+    return stats_list;
+}
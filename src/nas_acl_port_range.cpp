@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_port_range.cpp
+ * \brief  NAS ACL L4 port range to value/mask prefix expansion
+ */
+
+#include "nas_acl_port_range.h"
+
+nas_acl_port_prefix_list_t nas_acl_port_range_expand (uint16_t min,
+                                                      uint16_t max)
+{
+    nas_acl_port_prefix_list_t prefix_list;
+
+    if (min > max) {
+        return prefix_list;
+    }
+
+    prefix_list.reserve (NAS_ACL_PORT_RANGE_MAX_PREFIXES);
+
+    // Greedy walk from the low end - at every step take the largest block
+    // that is aligned on the current start and does not overshoot the end.
+    // Each block is the largest possible, so the resulting cover is minimal.
+    uint32_t lo = min;
+    uint32_t hi = max;
+
+    while (lo <= hi) {
+        uint32_t block = (lo == 0) ? (UINT16_MAX + 1) : (lo & (~lo + 1));
+
+        while (lo + block - 1 > hi) {
+            block >>= 1;
+        }
+
+        prefix_list.push_back (nas_acl_port_prefix_t {
+                                   static_cast<uint16_t> (lo),
+                                   static_cast<uint16_t> (~(block - 1))});
+        lo += block;
+    }
+
+    return prefix_list;
+}
+
+size_t nas_acl_port_range_expn_count (const std::vector<nas_acl_port_prefix_list_t>&
+                                      expn_list) noexcept
+{
+    size_t count = 1;
+
+    for (const auto& prefix_list: expn_list) {
+        count *= prefix_list.size ();
+    }
+    return count;
+}
+
+void nas_acl_port_range_expn_at (const std::vector<nas_acl_port_prefix_list_t>&
+                                 expn_list, size_t expn_idx,
+                                 nas_acl_port_prefix_list_t& out) noexcept
+{
+    out.clear ();
+
+    // Mixed radix decode of the cross product position
+    for (const auto& prefix_list: expn_list) {
+        out.push_back (prefix_list[expn_idx % prefix_list.size ()]);
+        expn_idx /= prefix_list.size ();
+    }
+}
@@ -0,0 +1,593 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*!
+ * \file   nas_acl_prepare.cpp
+ * \brief  NAS ACL validation of a CPS change list before any NDI call
+ */
+#include "dell-base-acl.h"
+#include "event_log.h"
+#include "std_error_codes.h"
+#include "nas_acl_log.h"
+#include "nas_acl_prepare.h"
+#include "nas_acl_cps.h"
+#include "nas_acl_cps_key.h"
+#include "nas_acl_switch_list.h"
+#include "nas_base_utils.h"
+#include "cps_api_object_key.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+
+static t_std_error
+nas_acl_validate_set (cps_api_object_t obj,
+                      cps_api_object_t /* prev */,
+                      bool             is_rollbk_op) noexcept;
+
+static nas_acl_write_operation_map_t nas_acl_validate_op_map [] = {
+    {cps_api_oper_SET, nas_acl_validate_set},
+};
+
+static std::atomic<bool> _prepare_enabled {false};
+
+// Object is left to its own write
+struct _prep_defer_t {};
+
+// Entry as left by the objects already walked
+struct _prep_entry_t {
+    bool                   exists;
+    // Rows it takes - unknown for a deferred write
+    bool                   rows_known;
+    size_t                 rows;
+    std::vector<npu_id_t>  npus;
+};
+
+struct _prep_table_t {
+    bool                                        created = false;
+    bool                                        deleted = false;
+    // Scratch copy of a Table created with its ID
+    std::unique_ptr<nas_acl_table>              table;
+    // Counters and Entries created (true) or deleted (false)
+    std::unordered_map<nas_obj_id_t, bool>      counters;
+    std::unordered_map<nas_obj_id_t, _prep_entry_t> entries;
+    bool                                        new_counters = false;
+    std::map<npu_id_t, int64_t>                 rows;
+};
+
+typedef std::pair<nas_switch_id_t, nas_obj_id_t> _prep_table_key_t;
+typedef std::pair<nas_switch_id_t, npu_id_t>     _prep_npu_key_t;
+
+class _prep_txn_t
+{
+    public:
+        void table_write (cps_api_object_t obj, cps_api_operation_types_t op);
+        void counter_write (cps_api_object_t obj, cps_api_operation_types_t op);
+        void entry_write (cps_api_object_t obj, cps_api_operation_types_t op);
+
+    private:
+        std::map<_prep_table_key_t, _prep_table_t>  _tables;
+        // Switches with Tables created without ID
+        std::set<nas_switch_id_t>                   _new_tables;
+        std::map<_prep_npu_key_t, int64_t>          _npu_rows;
+        // Scratch copies of the Counters created with their ID, per switch.
+        // Declared after the Tables they point to.
+        std::map<nas_switch_id_t, nas_acl_switch::staged_counter_list_t>  _counters;
+
+        const nas_acl_table& _table (nas_acl_switch& sw, nas_obj_id_t table_id);
+        void _drop_counters (nas_switch_id_t switch_id, nas_obj_id_t table_id);
+        void _check_counter (nas_acl_switch& sw, _prep_table_t& tbl,
+                             const nas_acl_entry& entry);
+        void _add_rows (nas_acl_switch& sw, const nas_acl_table& table,
+                        _prep_table_t& tbl, npu_id_t npu_id, int64_t rows);
+        void _release (nas_acl_switch& sw, const nas_acl_table& table,
+                       _prep_table_t& tbl, nas_obj_id_t entry_id);
+};
+
+// Counters of the transaction are found by the switch lookups while in scope
+class _prep_stage_t
+{
+    public:
+        _prep_stage_t (nas_acl_switch& sw,
+                       nas_acl_switch::staged_counter_list_t& counters) noexcept
+            : _sw (sw) { _sw.stage_counters (&counters); }
+        ~_prep_stage_t () { _sw.stage_counters (nullptr); }
+
+    private:
+        nas_acl_switch& _sw;
+};
+
+static inline size_t _prep_room (size_t limit, size_t used) noexcept
+{
+    return (limit == 0) ? SIZE_MAX : (used < limit) ? limit - used : 0;
+}
+
+static nas_switch_id_t _prep_switch_id (cps_api_object_t obj)
+{
+    nas_switch_id_t switch_id;
+
+    if (!nas_acl_cps_key_get_switch_id (obj, NAS_ACL_SWITCH_ATTR, &switch_id)) {
+        throw nas::base_exception {NAS_ACL_E_MISSING_KEY, __PRETTY_FUNCTION__,
+                                   "Missing Switch ID key"};
+    }
+    return switch_id;
+}
+
+static nas_obj_id_t _prep_table_id (cps_api_object_t obj, cps_api_attr_id_t table_attr)
+{
+    nas_obj_id_t table_id;
+
+    if (!nas_acl_cps_key_get_obj_id (obj, table_attr, &table_id)) {
+        throw nas::base_exception {NAS_ACL_E_MISSING_KEY, __PRETTY_FUNCTION__,
+                                   "Missing Table ID key"};
+    }
+    return table_id;
+}
+
+// Table created by the transaction, or in the cache and not deleted by it
+const nas_acl_table& _prep_txn_t::_table (nas_acl_switch& sw, nas_obj_id_t table_id)
+{
+    auto& tbl = _tables[{sw.id (), table_id}];
+
+    if (tbl.created) {
+        return *tbl.table;
+    }
+    if (tbl.deleted || sw.find_table (table_id) == NULL) {
+        if (!tbl.deleted && _new_tables.count (sw.id ()) != 0) {
+            throw _prep_defer_t {};
+        }
+        throw nas::base_exception {NAS_ACL_E_KEY_VAL, __PRETTY_FUNCTION__,
+                                   std::string {"No such Table "} +
+                                   std::to_string (table_id)};
+    }
+    return sw.get_table (table_id);
+}
+
+void _prep_txn_t::table_write (cps_api_object_t obj, cps_api_operation_types_t op)
+{
+    auto         switch_id = _prep_switch_id (obj);
+    nas_obj_id_t table_id;
+
+    if (!nas_acl_cps_key_get_obj_id (obj, BASE_ACL_TABLE_ID, &table_id)) {
+        if (op == cps_api_oper_CREATE) {
+            _new_tables.insert (switch_id);
+        }
+        throw _prep_defer_t {};
+    }
+
+    auto& sw = nas_acl_get_switch (switch_id);
+    auto& tbl = _tables[{switch_id, table_id}];
+
+    if (op == cps_api_oper_CREATE) {
+        if (tbl.created || (!tbl.deleted && sw.find_table (table_id) != NULL)) {
+            throw nas::base_exception {NAS_ACL_E_KEY_VAL, __PRETTY_FUNCTION__,
+                                       std::string {"Table ID already taken "} +
+                                       std::to_string (table_id)};
+        }
+        _drop_counters (switch_id, table_id);
+        tbl = _prep_table_t {};
+        tbl.created = true;
+        tbl.table.reset (new nas_acl_table (&sw));
+        nas_acl_parse_table_obj (obj, *tbl.table);
+        tbl.table->set_table_id (table_id);
+        return;
+    }
+
+    if (op == cps_api_oper_DELETE) {
+        _drop_counters (switch_id, table_id);
+        tbl = _prep_table_t {};
+        tbl.deleted = true;
+    }
+    throw _prep_defer_t {};
+}
+
+// Forget the Counters of a Table created or deleted again
+void _prep_txn_t::_drop_counters (nas_switch_id_t switch_id, nas_obj_id_t table_id)
+{
+    auto& counters = _counters[switch_id];
+    auto  it = counters.lower_bound ({table_id, 0});
+
+    while (it != counters.end () && it->first.first == table_id) {
+        it = counters.erase (it);
+    }
+}
+
+void _prep_txn_t::counter_write (cps_api_object_t obj, cps_api_operation_types_t op)
+{
+    auto         switch_id = _prep_switch_id (obj);
+    auto         table_id = _prep_table_id (obj, BASE_ACL_COUNTER_TABLE_ID);
+    auto&        tbl = _tables[{switch_id, table_id}];
+    auto&        counters = _counters[switch_id];
+    nas_obj_id_t counter_id;
+
+    if (!nas_acl_cps_key_get_obj_id (obj, BASE_ACL_COUNTER_ID, &counter_id)) {
+        if (op == cps_api_oper_CREATE) {
+            tbl.new_counters = true;
+        }
+        throw _prep_defer_t {};
+    }
+
+    if (op == cps_api_oper_DELETE) {
+        tbl.counters[counter_id] = false;
+        counters.erase ({table_id, counter_id});
+    }
+    if (op != cps_api_oper_CREATE) {
+        throw _prep_defer_t {};
+    }
+
+    auto& sw = nas_acl_get_switch (switch_id);
+    const nas_acl_table* table_p;
+
+    try {
+        table_p = &_table (sw, table_id);
+    } catch (_prep_defer_t&) {
+        // Table created without ID - Entries that use the Counter are deferred
+        tbl.counters[counter_id] = true;
+        throw;
+    }
+
+    auto it = tbl.counters.find (counter_id);
+    bool taken = (it != tbl.counters.end ()) ? it->second :
+                 (!tbl.created && sw.find_counter (table_id, counter_id) != NULL);
+
+    if (taken) {
+        throw nas::base_exception {NAS_ACL_E_MISSING_KEY, __PRETTY_FUNCTION__,
+                                   std::string {"Counter ID already taken "} +
+                                   std::to_string (counter_id)};
+    }
+
+    nas_acl_counter_t counter (table_p);
+    nas_acl_parse_counter_obj (obj, counter);
+    counter.set_counter_id (counter_id);
+
+    counters.emplace (std::make_pair (table_id, counter_id), std::move (counter));
+    tbl.counters[counter_id] = true;
+}
+
+// Counter of the Entry is not deleted by the transaction. Entries that use
+// a Counter the transaction creates without ID, or in a Table created
+// without ID, are deferred.
+void _prep_txn_t::_check_counter (nas_acl_switch& sw, _prep_table_t& tbl,
+                                  const nas_acl_entry& entry)
+{
+    if (!entry.is_counter_enabled ()) {
+        return;
+    }
+
+    auto counter_id = entry.counter_id ();
+    auto it = tbl.counters.find (counter_id);
+
+    if (it != tbl.counters.end ()) {
+        if (it->second) {
+            if (_counters[sw.id ()].count ({entry.table_id (), counter_id}) == 0) {
+                throw _prep_defer_t {};
+            }
+            return;
+        }
+        throw nas::base_exception {NAS_ACL_E_ATTR_VAL, __PRETTY_FUNCTION__,
+                                   std::string {"No such Counter "} +
+                                   std::to_string (counter_id)};
+    }
+    if (tbl.new_counters && sw.find_counter (entry.table_id (), counter_id) == NULL) {
+        throw _prep_defer_t {};
+    }
+}
+
+// Rows added (or freed if negative) in an NPU by the transaction must fit
+// in the room left in the Table quota and in the NPU
+void _prep_txn_t::_add_rows (nas_acl_switch& sw, const nas_acl_table& table,
+                             _prep_table_t& tbl, npu_id_t npu_id, int64_t rows)
+{
+    auto& tbl_rows = tbl.rows[npu_id];
+    auto& npu_rows = _npu_rows[{sw.id (), npu_id}];
+
+    tbl_rows += rows;
+    npu_rows += rows;
+
+    if (rows <= 0) {
+        return;
+    }
+
+    auto tbl_room = _prep_room (table.hw_quota ().rows,
+                                sw.table_hw_usage (table.table_id (), npu_id).rows);
+    auto npu_room = _prep_room (sw.hw_capacity (npu_id).rows,
+                                sw.npu_hw_usage (npu_id).rows);
+
+    if ((tbl_rows > 0 && static_cast<size_t> (tbl_rows) > tbl_room) ||
+        (npu_rows > 0 && static_cast<size_t> (npu_rows) > npu_room)) {
+        throw nas::base_exception {NAS_ACL_E_FULL, __PRETTY_FUNCTION__,
+                std::string {"No room in NPU "} + std::to_string (npu_id)
+                + " for Table " + std::to_string (table.table_id ()) + ": needs "
+                + std::to_string (tbl_rows) + " more rows in the Table and "
+                + std::to_string (npu_rows) + " in the NPU"};
+    }
+}
+
+// Free the rows of an Entry about to be replaced or deleted
+void _prep_txn_t::_release (nas_acl_switch& sw, const nas_acl_table& table,
+                            _prep_table_t& tbl, nas_obj_id_t entry_id)
+{
+    auto it = tbl.entries.find (entry_id);
+
+    if (it != tbl.entries.end () && it->second.rows_known) {
+        for (auto npu_id: it->second.npus) {
+            _add_rows (sw, table, tbl, npu_id, -static_cast<int64_t> (it->second.rows));
+        }
+        return;
+    }
+
+    // Rows of a deferred write are taken as those of the cached Entry
+    auto entry_p = (tbl.created) ? NULL : sw.find_entry (table.table_id (), entry_id);
+    if (entry_p == NULL) {
+        return;
+    }
+
+    const auto& entry = *entry_p;
+    for (const auto& ndi_kv: entry.ndi_entry_ids) {
+        _add_rows (sw, table, tbl, ndi_kv.first,
+                   -static_cast<int64_t> (entry.hw_rows_in_npu (ndi_kv.first)));
+    }
+}
+
+void _prep_txn_t::entry_write (cps_api_object_t obj, cps_api_operation_types_t op)
+{
+    auto  switch_id = _prep_switch_id (obj);
+    auto  table_id = _prep_table_id (obj, BASE_ACL_ENTRY_TABLE_ID);
+    auto& sw = nas_acl_get_switch (switch_id);
+    auto& table = _table (sw, table_id);
+    auto& tbl = _tables[{switch_id, table_id}];
+
+    _prep_stage_t stage (sw, _counters[switch_id]);
+
+    nas_obj_id_t entry_id;
+    bool         has_eid = nas_acl_cps_key_get_obj_id (obj, BASE_ACL_ENTRY_ID, &entry_id);
+    uint32_t     upd_type;
+
+    if (nas_acl_cps_key_get_u32 (obj, BASE_ACL_ENTRY_MATCH_TYPE, &upd_type) ||
+        nas_acl_cps_key_get_u32 (obj, BASE_ACL_ENTRY_ACTION_TYPE, &upd_type)) {
+        // Incremental Match filter or Action update
+        throw _prep_defer_t {};
+    }
+
+    if (!has_eid && op != cps_api_oper_CREATE) {
+        throw nas::base_exception {NAS_ACL_E_MISSING_KEY, __PRETTY_FUNCTION__,
+                                   "Entry ID is a mandatory key for Modify/Delete"};
+    }
+
+    // Entry as left by the objects before - NULL if only in the cache
+    auto it = (has_eid) ? tbl.entries.find (entry_id) : tbl.entries.end ();
+    _prep_entry_t* prep_p = (it != tbl.entries.end ()) ? &it->second : NULL;
+    bool exists = (prep_p != NULL) ? prep_p->exists :
+                  (has_eid && !tbl.created && sw.find_entry (table_id, entry_id) != NULL);
+
+    if (op == cps_api_oper_CREATE) {
+        if (has_eid && exists) {
+            throw nas::base_exception {NAS_ACL_E_KEY_VAL, __PRETTY_FUNCTION__,
+                                       std::string {"Entry ID already taken "} +
+                                       std::to_string (entry_id)};
+        }
+    } else if (!exists) {
+        throw nas::base_exception {NAS_ACL_E_KEY_VAL, __PRETTY_FUNCTION__,
+                                   std::string {"No such Entry "} +
+                                   std::to_string (entry_id)};
+    }
+
+    if (op == cps_api_oper_DELETE) {
+        _release (sw, table, tbl, entry_id);
+        tbl.entries[entry_id] = _prep_entry_t {false, true, 0, {}};
+        return;
+    }
+
+    try {
+        if (prep_p != NULL && op == cps_api_oper_SET) {
+            // Content left by an earlier write of the transaction is not kept
+            throw _prep_defer_t {};
+        }
+
+        const nas_acl_entry* old_p = (op == cps_api_oper_SET) ?
+                                     &sw.get_entry (table_id, entry_id) : NULL;
+        nas_acl_entry entry = (old_p != NULL) ? nas_acl_entry (*old_p) :
+                                                nas_acl_entry (&table);
+
+        try {
+            nas_acl_parse_entry_obj (obj, entry);
+        } catch (nas::base_exception&) {
+            // Counter created earlier in the transaction is not in the cache yet
+            _check_counter (sw, tbl, entry);
+            throw;
+        }
+        _check_counter (sw, tbl, entry);
+
+        entry.prepare_commit (old_p);
+
+        if (old_p != NULL) {
+            _release (sw, table, tbl, entry_id);
+        }
+
+        _prep_entry_t prep {true, true, entry.hw_rows (), {}};
+        for (auto npu_id: entry.npu_list ()) {
+            prep.npus.push_back (npu_id);
+            _add_rows (sw, table, tbl, npu_id, prep.rows);
+        }
+
+        if (has_eid) {
+            tbl.entries[entry_id] = std::move (prep);
+        }
+
+    } catch (_prep_defer_t&) {
+        if (has_eid) {
+            // Exists after the deferred write, with rows not known
+            tbl.entries[entry_id] = _prep_entry_t {true, false, 0, {}};
+        }
+        throw;
+    }
+}
+
+bool nas_acl_prepare_list (cps_api_object_list_t     list,
+                           size_t                    start_index,
+                           nas_acl_prepare_result_t* result) noexcept
+{
+    _prep_txn_t txn;
+    size_t      count = cps_api_object_list_size (list);
+
+    *result = nas_acl_prepare_result_t {NAS_ACL_E_NONE, 0, 0, 0};
+
+    for (size_t index = start_index; index < count; index++) {
+
+        cps_api_object_t obj = cps_api_object_list_get (list, index);
+
+        if (obj == NULL ||
+            cps_api_key_get_cat (cps_api_object_key (obj)) != cps_api_obj_CAT_BASE_ACL) {
+            continue;
+        }
+
+        auto op = cps_api_object_type_operation (cps_api_object_key (obj));
+
+        try {
+            switch (cps_api_key_get_subcat (cps_api_object_key (obj))) {
+                case BASE_ACL_TABLE_OBJ:
+                    txn.table_write (obj, op);
+                    break;
+
+                case BASE_ACL_COUNTER_OBJ:
+                    txn.counter_write (obj, op);
+                    break;
+
+                case BASE_ACL_ENTRY_OBJ:
+                    txn.entry_write (obj, op);
+                    break;
+
+                default:
+                    // Stats, Apply and other objects are left to their write
+                    throw _prep_defer_t {};
+            }
+            result->checked++;
+
+        } catch (_prep_defer_t&) {
+            result->deferred++;
+
+        } catch (nas::base_exception& e) {
+            NAS_ACL_LOG_BRIEF ("Object %ld would fail - Err_code: 0x%x, fn: %s (), %s",
+                               index, e.err_code, e.err_fn.c_str (), e.err_msg.c_str ());
+            result->rc = e.err_code;
+            result->fail_index = index;
+            return false;
+
+        } catch (std::exception& e) {
+            NAS_ACL_LOG_BRIEF ("Object %ld would fail - %s", index, e.what ());
+            result->rc = NAS_ACL_E_FAIL;
+            result->fail_index = index;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void nas_acl_prepare_init () noexcept
+{
+    const char* prepare_str = getenv (NAS_ACL_PREPARE_ENV);
+
+    if (prepare_str != NULL && strcmp (prepare_str, "1") == 0) {
+        nas_acl_prepare_enable (true);
+    }
+}
+
+// Read once per transaction, before its first ACL object is written
+void nas_acl_prepare_enable (bool enable) noexcept
+{
+    _prepare_enabled = enable;
+
+    NAS_ACL_LOG_BRIEF ("Transaction prepare %s", (enable) ? "enabled" : "disabled");
+}
+
+bool nas_acl_prepare_is_enabled () noexcept
+{
+    return _prepare_enabled;
+}
+
+nas_acl_write_operation_map_t *
+nas_acl_get_validate_op_map (cps_api_operation_types_t op) noexcept
+{
+    uint32_t                  index;
+    uint32_t                  count;
+
+    count = sizeof (nas_acl_validate_op_map) / sizeof (nas_acl_validate_op_map [0]);
+
+    for (index = 0; index < count; index++) {
+        if (nas_acl_validate_op_map [index].op == op) {
+            return (&nas_acl_validate_op_map [index]);
+        }
+    }
+    return NULL;
+}
+
+// Dry run of the serialized ACL objects - the result is returned in the
+// object and the request itself succeeds
+static t_std_error nas_acl_validate_set (cps_api_object_t obj,
+                                         cps_api_object_t /* prev */,
+                                         bool             is_rollbk_op) noexcept
+{
+    if (is_rollbk_op) {
+        return NAS_ACL_E_NONE;
+    }
+
+    cps_api_object_list_guard lg (cps_api_object_list_create ());
+    if (lg.get () == NULL) {
+        return NAS_ACL_E_MEM;
+    }
+
+    cps_api_object_it_t it;
+    for (cps_api_object_it_begin (obj, &it);
+         cps_api_object_it_valid (&it); cps_api_object_it_next (&it)) {
+
+        if (cps_api_object_attr_id (it.attr) != BASE_ACL_VALIDATE_OBJECT) {
+            continue;
+        }
+
+        cps_api_object_t acl_obj = cps_api_object_list_create_obj_and_append (lg.get ());
+        if (acl_obj == NULL) {
+            return NAS_ACL_E_MEM;
+        }
+        if (!cps_api_array_to_object (cps_api_object_attr_data_bin (it.attr),
+                                      cps_api_object_attr_len (it.attr), acl_obj)) {
+            NAS_ACL_LOG_ERR ("Bad object %ld in Validate",
+                             cps_api_object_list_size (lg.get ()) - 1);
+            return NAS_ACL_E_ATTR_VAL;
+        }
+    }
+
+    nas_acl_prepare_result_t result;
+    bool ok = nas_acl_prepare_list (lg.get (), 0, &result);
+
+    if (!cps_api_object_attr_add_u32 (obj, BASE_ACL_VALIDATE_STATUS, result.rc) ||
+        (!ok && !cps_api_object_attr_add_u32 (obj, BASE_ACL_VALIDATE_FAILED_INDEX,
+                                              result.fail_index)) ||
+        !cps_api_object_attr_add_u32 (obj, BASE_ACL_VALIDATE_CHECKED, result.checked) ||
+        !cps_api_object_attr_add_u32 (obj, BASE_ACL_VALIDATE_DEFERRED, result.deferred)) {
+        return NAS_ACL_E_MEM;
+    }
+
+    NAS_ACL_LOG_BRIEF ("Validate of %ld objects: rc 0x%x, %ld checked, %ld deferred",
+                       cps_api_object_list_size (lg.get ()), result.rc,
+                       result.checked, result.deferred);
+    return NAS_ACL_E_NONE;
+}
@@ -23,8 +23,27 @@
 
 #include "nas_base_utils.h"
 #include "nas_acl_switch.h"
+#include "nas_acl_warm.h"
 #include "event_log.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
 #include <string>
+#include <tuple>
+
+static size_t _hw_env_capacity (const char* env_name) noexcept
+{
+    const char* cap_str = getenv (env_name);
+
+    return (cap_str != NULL) ? strtoul (cap_str, NULL, 0) : 0;
+}
+
+nas_acl_switch::nas_acl_switch (nas_obj_id_t id)
+    : nas::base_switch_t (id)
+{
+    _hw_default_capacity.rows = _hw_env_capacity (NAS_ACL_HW_MAX_ROWS_ENV);
+    _hw_default_capacity.counters = _hw_env_capacity (NAS_ACL_HW_MAX_COUNTERS_ENV);
+}
 
 nas_acl_table& nas_acl_switch::get_table (nas_obj_id_t tbl_id)
 {
@@ -57,6 +76,186 @@ nas_acl_switch::entry_list (nas_obj_id_t table_id) const
     }
 }
 
+const nas_acl_entry_index_t&
+nas_acl_switch::entry_index (nas_obj_id_t table_id) const
+{
+    try {
+        return _table_containers.at(table_id)._entry_index;
+    } catch (std::out_of_range& ) {
+        throw nas::base_exception {NAS_ACL_E_KEY_VAL, __PRETTY_FUNCTION__,
+                              std::string {"Invalid Table ID "} +
+                                  std::to_string(table_id)};
+    }
+}
+
+std::shared_ptr<nas_acl_pool_t>
+nas_acl_switch::table_pool (nas_obj_id_t table_id) const noexcept
+{
+    auto it_tbl = _table_containers.find (table_id);
+    if (it_tbl == _table_containers.end ()) return nullptr;
+
+    return it_tbl->second._pool;
+}
+
+std::mutex* nas_acl_switch::table_lock (nas_obj_id_t table_id) noexcept
+{
+    auto it_tbl = _table_containers.find (table_id);
+    if (it_tbl == _table_containers.end ()) return nullptr;
+
+    return &it_tbl->second._lock;
+}
+
+void nas_acl_switch::set_hw_capacity (npu_id_t npu_id,
+                                      const nas_acl_hw_usage_t& cap) noexcept
+{
+    std::lock_guard<std::mutex> lock (_hw_mutex);
+    _npu_hw_capacity[npu_id] = cap;
+}
+
+nas_acl_hw_usage_t nas_acl_switch::hw_capacity (npu_id_t npu_id) const noexcept
+{
+    std::lock_guard<std::mutex> lock (_hw_mutex);
+
+    auto it = _npu_hw_capacity.find (npu_id);
+    return (it != _npu_hw_capacity.end ()) ? it->second : _hw_default_capacity;
+}
+
+nas_acl_hw_usage_t nas_acl_switch::npu_hw_usage (npu_id_t npu_id) const noexcept
+{
+    std::lock_guard<std::mutex> lock (_hw_mutex);
+
+    auto it = _npu_hw_usage.find (npu_id);
+    return (it != _npu_hw_usage.end ()) ? it->second : nas_acl_hw_usage_t {0, 0};
+}
+
+nas_acl_hw_usage_t nas_acl_switch::table_hw_usage (nas_obj_id_t table_id,
+                                                   npu_id_t npu_id) const noexcept
+{
+    auto it_tbl = _table_containers.find (table_id);
+    if (it_tbl == _table_containers.end ()) return {0, 0};
+
+    auto& usage_list = it_tbl->second._hw_usage;
+    auto it = usage_list.find (npu_id);
+    return (it != usage_list.end ()) ? it->second : nas_acl_hw_usage_t {0, 0};
+}
+
+static inline size_t _hw_room (size_t limit, size_t used) noexcept
+{
+    return (limit == 0) ? SIZE_MAX : (used < limit) ? limit - used : 0;
+}
+
+nas_acl_hw_usage_t nas_acl_switch::hw_headroom (const nas_acl_table& table,
+                                                npu_id_t npu_id) const noexcept
+{
+    auto quota = table.hw_quota ();
+    auto tbl_used = table_hw_usage (table.table_id (), npu_id);
+    auto cap = hw_capacity (npu_id);
+    auto npu_used = npu_hw_usage (npu_id);
+
+    return {std::min (_hw_room (quota.rows, tbl_used.rows),
+                      _hw_room (cap.rows, npu_used.rows)),
+            std::min (_hw_room (quota.counters, tbl_used.counters),
+                      _hw_room (cap.counters, npu_used.counters))};
+}
+
+// Checked before any NDI call, so that a full NPU does not cause the
+// rollback of NPUs already programmed. Writers to other Tables may take
+// the last NPU room meanwhile - NDI still has the final say.
+void nas_acl_switch::hw_admit (const nas_acl_table& table, npu_id_t npu_id,
+                               const nas_acl_hw_usage_t& more) const
+{
+    auto room = hw_headroom (table, npu_id);
+
+    if (more.rows > room.rows || more.counters > room.counters) {
+        throw nas::base_exception {NAS_ACL_E_FULL, __PRETTY_FUNCTION__,
+                std::string {"No room in NPU "} + std::to_string (npu_id)
+                + " for Table " + std::to_string (table.table_id ()) + ": needs "
+                + std::to_string (more.rows) + " rows, "
+                + std::to_string (more.counters) + " counters, has "
+                + std::to_string (room.rows) + " rows, "
+                + std::to_string (room.counters) + " counters"};
+    }
+}
+
+void nas_acl_switch::_hw_account (acl_table_container_t& container, npu_id_t npu_id,
+                                  const nas_acl_hw_usage_t& usage, bool add) noexcept
+{
+    auto update = [&usage, add] (nas_acl_hw_usage_t& total) {
+        if (add) {
+            total.rows += usage.rows;
+            total.counters += usage.counters;
+        } else {
+            total.rows -= std::min (total.rows, usage.rows);
+            total.counters -= std::min (total.counters, usage.counters);
+        }
+    };
+
+    update (container._hw_usage[npu_id]);
+
+    std::lock_guard<std::mutex> lock (_hw_mutex);
+    update (_npu_hw_usage[npu_id]);
+}
+
+// Replaces what an object was charged with its new usage
+void nas_acl_switch::_hw_charge (acl_table_container_t& container,
+                                 hw_usage_list_t& charged,
+                                 hw_usage_list_t&& usage) noexcept
+{
+    for (const auto& kv: charged) {
+        _hw_account (container, kv.first, kv.second, false);
+    }
+    for (const auto& kv: usage) {
+        _hw_account (container, kv.first, kv.second, true);
+    }
+    charged = std::move (usage);
+}
+
+// An Entry takes a row in an NPU for each NDI entry
+void nas_acl_switch::_hw_account_entry (acl_table_container_t& container,
+                                        const nas_acl_entry& entry, bool add) noexcept
+{
+    hw_usage_list_t usage;
+
+    if (add) {
+        for (const auto& ndi_kv: entry.ndi_entry_ids) {
+
+            auto npu_id = ndi_kv.first;
+            auto it_expn = entry.ndi_expn_entry_ids.find (npu_id);
+            size_t rows = 1 + ((it_expn != entry.ndi_expn_entry_ids.end ()) ?
+                               it_expn->second.size () : 0);
+
+            usage[npu_id] = {rows, 0};
+        }
+    }
+
+    _hw_charge (container, container._entry_hw_usage[entry.entry_id ()],
+                std::move (usage));
+    if (!add) {
+        container._entry_hw_usage.erase (entry.entry_id ());
+    }
+}
+
+void nas_acl_switch::_hw_account_counter (acl_table_container_t& container,
+                                          const nas_acl_counter_t& counter,
+                                          bool add) noexcept
+{
+    hw_usage_list_t usage;
+
+    if (add) {
+        for (auto npu_id: counter.npu_list ()) {
+            if (counter.is_obj_in_npu (npu_id)) {
+                usage[npu_id] = {0, 1};
+            }
+        }
+    }
+
+    _hw_charge (container, container._counter_hw_usage[counter.counter_id ()],
+                std::move (usage));
+    if (!add) {
+        container._counter_hw_usage.erase (counter.counter_id ());
+    }
+}
+
 const nas_acl_switch::counter_list_t&
 nas_acl_switch::counter_list (nas_obj_id_t table_id) const
 {
@@ -96,9 +295,20 @@ nas_acl_entry* nas_acl_switch::find_entry (nas_obj_id_t tbl_id,
     return &it_entry->second;
 }
 
+nas_acl_entry_ref_list_t nas_acl_switch::if_entries (hal_ifindex_t ifindex) const
+{
+    std::lock_guard<std::mutex> lock (_if_mutex);
+    return _if_index.entries (ifindex);
+}
+
 nas_acl_counter_t& nas_acl_switch::get_counter (nas_obj_id_t tbl_id,
                                                 nas_obj_id_t counter_id)
 {
+    if (_staged_counters != nullptr) {
+        auto it_staged = _staged_counters->find ({tbl_id, counter_id});
+        if (it_staged != _staged_counters->end ()) return it_staged->second;
+    }
+
     auto it_tbl = _table_containers.find (tbl_id);
     if (it_tbl == _table_containers.end ()) {
         throw nas::base_exception {NAS_ACL_E_KEY_VAL, __PRETTY_FUNCTION__,
@@ -119,6 +329,11 @@ nas_acl_counter_t& nas_acl_switch::get_counter (nas_obj_id_t tbl_id,
 nas_acl_counter_t* nas_acl_switch::find_counter (nas_obj_id_t tbl_id,
                                                 nas_obj_id_t counter_id) noexcept
 {
+    if (_staged_counters != nullptr) {
+        auto it_staged = _staged_counters->find ({tbl_id, counter_id});
+        if (it_staged != _staged_counters->end ()) return &it_staged->second;
+    }
+
     auto it_tbl = _table_containers.find (tbl_id);
     if (it_tbl == _table_containers.end ()) return nullptr;
 
@@ -142,22 +357,35 @@ nas_acl_table& nas_acl_switch::save_table (nas_acl_table&& t) noexcept
     if (it == _tables.end()) {
         ///// Adding a New table to list /////
         // Allocate a new container for the entries in the table
-        _table_containers.insert (std::make_pair (t.table_id(),
-                                                  acl_table_container_t {}));
+        _table_containers.emplace (std::piecewise_construct,
+                                   std::forward_as_tuple (t.table_id()),
+                                   std::forward_as_tuple ());
 
         // Insert new Table into cache,
         // by moving contents from the argument passed in.
         // Return newly inserted Table
         auto p = _tables.insert (std::make_pair (t.table_id(), std::move (t)));
+        nas_acl_warm_save (p.first->second);
         return (p.first->second);
     }
 
     // Update existing table if present
-    return (it->second = std::move(t));
+    it->second = std::move(t);
+    nas_acl_warm_save (it->second);
+    return (it->second);
 }
 
 void nas_acl_switch::remove_table (nas_obj_id_t table_id) noexcept
 {
+    auto it_tbl = _table_containers.find (table_id);
+    if (it_tbl != _table_containers.end ()) {
+        for (const auto& counter_pair: it_tbl->second._acl_counters) {
+            nas_acl_warm_remove (NAS_ACL_WARM_OBJ_COUNTER, id(), table_id,
+                                 counter_pair.first);
+        }
+    }
+    nas_acl_warm_remove (NAS_ACL_WARM_OBJ_TABLE, id(), table_id, table_id);
+
     // Remove all entries in this table
     _table_containers.erase(table_id);
     // Remove the table itself
@@ -166,7 +394,8 @@ void nas_acl_switch::remove_table (nas_obj_id_t table_id) noexcept
 }
 
 void nas_acl_switch::remove_entry_from_table (nas_obj_id_t table_id,
-                                              nas_obj_id_t entry_id) noexcept
+                                              nas_obj_id_t entry_id,
+                                              nas_acl_entry* e_removed) noexcept
 {
     // This is an internal function - Table ID cannot be invalid
     auto& container = _table_containers.at(table_id);
@@ -175,8 +404,18 @@ void nas_acl_switch::remove_entry_from_table (nas_obj_id_t table_id,
     if (new_counter_p != nullptr) {
         new_counter_p->del_ref (e_del.entry_id());
     }
+    _hw_account_entry (container, e_del, false);
+    container._entry_index.remove (e_del);
+    {
+        std::lock_guard<std::mutex> lock (_if_mutex);
+        _if_index.remove (e_del);
+    }
+    if (e_removed != nullptr) {
+        *e_removed = std::move (e_del);
+    }
     container._acl_entries.erase (entry_id);
     container._entry_id_gen.release_id (entry_id);
+    nas_acl_warm_remove (NAS_ACL_WARM_OBJ_ENTRY, id(), table_id, entry_id);
 }
 
 nas_obj_id_t nas_acl_switch::alloc_entry_id_in_table (nas_obj_id_t table_id)
@@ -210,7 +449,8 @@ void nas_acl_switch::release_entry_id_in_table (nas_obj_id_t table_id,
     _table_containers.at (table_id)._entry_id_gen.release_id (entry_id);
 }
 
-nas_acl_entry& nas_acl_switch::save_entry (nas_acl_entry&& e_temp) noexcept
+nas_acl_entry& nas_acl_switch::save_entry (nas_acl_entry&& e_temp,
+                                           nas_acl_entry* e_replaced) noexcept
 {
     /* Save is declared noexcept since it cannot fail.
      * This update is already committed to NDI and we are beyond
@@ -219,7 +459,8 @@ nas_acl_entry& nas_acl_switch::save_entry (nas_acl_entry&& e_temp) noexcept
      * considered above - such fatal exceptions will terminate NAS.
      */
     nas_obj_id_t  table_id = e_temp.table_id();
-    auto& entry_list = _table_containers.at (table_id)._acl_entries;
+    auto& container = _table_containers.at (table_id);
+    auto& entry_list = container._acl_entries;
 
     auto it = entry_list.find (e_temp.entry_id());
     if (it == entry_list.end()) {
@@ -233,6 +474,13 @@ nas_acl_entry& nas_acl_switch::save_entry (nas_acl_entry&& e_temp) noexcept
         if (new_counter_p != nullptr) {
             new_counter_p->add_ref (new_entry.entry_id());
         }
+        _hw_account_entry (container, new_entry, true);
+        container._entry_index.add (new_entry);
+        {
+            std::lock_guard<std::mutex> lock (_if_mutex);
+            _if_index.add (new_entry);
+        }
+        nas_acl_warm_save (new_entry);
         return (new_entry);
     }
 
@@ -247,7 +495,21 @@ nas_acl_entry& nas_acl_switch::save_entry (nas_acl_entry&& e_temp) noexcept
             new_counter_p->add_ref (e_temp.entry_id());
         }
     }
-    return (e_orig = std::move(e_temp));
+    _hw_account_entry (container, e_orig, false);
+    _hw_account_entry (container, e_temp, true);
+    container._entry_index.remove (e_orig);
+    {
+        std::lock_guard<std::mutex> lock (_if_mutex);
+        _if_index.remove (e_orig);
+        if (e_replaced != nullptr) {
+            *e_replaced = std::move (e_orig);
+        }
+        e_orig = std::move(e_temp);
+        _if_index.add (e_orig);
+    }
+    container._entry_index.add (e_orig);
+    nas_acl_warm_save (e_orig);
+    return (e_orig);
 }
 
 void nas_acl_switch::remove_counter_from_table (nas_obj_id_t table_id,
@@ -255,8 +517,13 @@ void nas_acl_switch::remove_counter_from_table (nas_obj_id_t table_id,
 {
     // This is an internal function - Table ID cannot be invalid
     auto& container = _table_containers.at(table_id);
+    auto it_cntr = container._acl_counters.find (counter_id);
+    if (it_cntr != container._acl_counters.end ()) {
+        _hw_account_counter (container, it_cntr->second, false);
+    }
     container._acl_counters.erase (counter_id);
     container._counter_id_gen.release_id (counter_id);
+    nas_acl_warm_remove (NAS_ACL_WARM_OBJ_COUNTER, id(), table_id, counter_id);
 }
 
 nas_obj_id_t nas_acl_switch::alloc_counter_id_in_table (nas_obj_id_t table_id)
@@ -291,7 +558,8 @@ nas_acl_counter_t&  nas_acl_switch::save_counter (nas_acl_counter_t&& tmp_cntr)
      * considered above - such fatal exceptions will terminate NAS.
      */
     nas_obj_id_t  table_id = tmp_cntr.table_id();
-    auto& counter_list = _table_containers.at (table_id)._acl_counters;
+    auto& container = _table_containers.at (table_id);
+    auto& counter_list = container._acl_counters;
 
     auto it = counter_list.find (tmp_cntr.counter_id());
     if (it == counter_list.end()) {
@@ -302,8 +570,14 @@ nas_acl_counter_t&  nas_acl_switch::save_counter (nas_acl_counter_t&& tmp_cntr)
         auto p = counter_list.insert (std::make_pair (tmp_cntr.counter_id(),
                                                       std::move(tmp_cntr)));
 
+        _hw_account_counter (container, p.first->second, true);
+        nas_acl_warm_save (p.first->second);
         return (p.first->second);
     }
 
-    return (it->second = std::move(tmp_cntr));
+    _hw_account_counter (container, it->second, false);
+    _hw_account_counter (container, tmp_cntr, true);
+    it->second = std::move(tmp_cntr);
+    nas_acl_warm_save (it->second);
+    return (it->second);
 }
@@ -29,17 +29,13 @@
 #include "nas_acl_switch_list.h"
 #include "nas_acl_switch.h"
 #include "nas_switch.h"
+#include <mutex>
+#include <tuple>
 
 static switch_list_t  _switches;
 
-static nas_acl_switch& _save_switch (nas_acl_switch&& s)
-{
-    /* Inserting new Switch into cache,
-     * by moving contents from the argument passed in.
-     * Return reference to the newly inserted Switch */
-    auto p = _switches.insert (std::make_pair (s.id(), std::move(s)));
-    return (p.first->second);
-}
+// Switches are added on first use under a shared NAS ACL lock
+static std::mutex     _switch_list_mutex;
 
 const switch_list_t& nas_acl_get_switch_list () noexcept
 {
@@ -48,6 +44,8 @@ const switch_list_t& nas_acl_get_switch_list () noexcept
 
 nas_acl_switch& nas_acl_get_switch (nas_switch_id_t switch_id)
 {
+    std::lock_guard<std::mutex> lock (_switch_list_mutex);
+
     /* Try getting switch from local cache.
      * If not present then query it from NAS common library and
      * cache it
@@ -59,9 +57,6 @@ nas_acl_switch& nas_acl_get_switch (nas_switch_id_t switch_id)
 
     } else {
         // Not in cache .. create a new switch
-        // Initialize it with switch ID
-        nas_acl_switch sw_tmp{switch_id};
-
         const nas_switch_detail_t* sw =  nas_switch (switch_id);
 
         if (sw == NULL) {
@@ -70,9 +65,16 @@ nas_acl_switch& nas_acl_get_switch (nas_switch_id_t switch_id)
                                        + std::to_string (switch_id)};
         }
 
+        /* Switch holds its locks - so it is built in place
+         * and initialized with switch ID */
+        auto p = _switches.emplace (std::piecewise_construct,
+                                    std::forward_as_tuple (switch_id),
+                                    std::forward_as_tuple (switch_id));
+        auto& new_sw = p.first->second;
+
         for (size_t count = 0; count < sw->number_of_npus; count++)
-            sw_tmp.add_npu (sw->npus[count]);
+            new_sw.add_npu (sw->npus[count]);
 
-        return _save_switch (std::move (sw_tmp));
+        return new_sw;
     }
 }
@@ -25,6 +25,8 @@
 #include "nas_acl_switch.h"
 #include "nas_acl_filter.h"
 #include "nas_ndi_acl.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_warm.h"
 #include "nas_acl_log.h"
 #include <inttypes.h>
 
@@ -163,6 +165,28 @@ void nas_acl_table::set_allowed_filter (uint_t filter_id)
     _allowed_filters.insert(f);
 }
 
+void nas_acl_table::set_max_rows (uint_t rows)
+{
+    if (is_created_in_ndi()) {
+        // Create-Only attribute
+        throw nas::base_exception {NAS_ACL_E_CREATE_ONLY, __PRETTY_FUNCTION__,
+                                "Cannot modify Max Rows for Table"};
+    }
+
+    _hw_quota.rows = rows;
+}
+
+void nas_acl_table::set_max_counters (uint_t counters)
+{
+    if (is_created_in_ndi()) {
+        // Create-Only attribute
+        throw nas::base_exception {NAS_ACL_E_CREATE_ONLY, __PRETTY_FUNCTION__,
+                                "Cannot modify Max Counters for Table"};
+    }
+
+    _hw_quota.counters = counters;
+}
+
 void nas_acl_table::allowed_filters_c_cpy (size_t filter_count,
                                            BASE_ACL_MATCH_TYPE_t* filter_list) const noexcept
 {
@@ -180,14 +204,24 @@ void* nas_acl_table::alloc_fill_ndi_obj (nas::mem_alloc_helper_t& mem_trakr)
 {
     ndi_acl_table_t* ndi_tbl_p = mem_trakr.alloc<ndi_acl_table_t> (1);
 
-    ndi_tbl_p->filter_count = allowed_filters_count ();
+    // Port range filters are programmed as value/mask prefixes of
+    // the L4 port filter - so NDI needs only the L4 port field
+    filter_set_t ndi_filters;
+    for (auto filter: _allowed_filters) {
+        ndi_filters.insert (nas_acl_filter_t::ndi_filter_type (filter));
+    }
+
+    ndi_tbl_p->filter_count = ndi_filters.size ();
 
     ndi_tbl_p->filter_list = mem_trakr.alloc<BASE_ACL_MATCH_TYPE_t> (ndi_tbl_p->filter_count);
 
     ndi_tbl_p->stage = stage();
     ndi_tbl_p->priority = priority();
 
-    allowed_filters_c_cpy (ndi_tbl_p->filter_count, ndi_tbl_p->filter_list);
+    size_t count = 0;
+    for (auto filter: ndi_filters) {
+        ndi_tbl_p->filter_list[count++] = filter;
+    }
 
     return ndi_tbl_p;
 }
@@ -200,7 +234,17 @@ bool nas_acl_table::push_create_obj_to_npu (npu_id_t npu_id,
 
     auto ndi_tbl_p = static_cast<ndi_acl_table_t*> (ndi_obj);
 
-    if ((rc = ndi_acl_table_create (npu_id, ndi_tbl_p, &ndi_tbl_id))
+    // Replayed after a warm restart - take over the Table already in the NPU
+    std::vector<ndi_obj_id_t> adopted;
+    if (nas_acl_warm_adopt (NAS_ACL_WARM_OBJ_TABLE, get_switch().id(), table_id(),
+                            table_id(), npu_id, nas_acl_warm_table_hash (*this),
+                            adopted)) {
+        _ndi_obj_ids[npu_id] = adopted.front ();
+        return true;
+    }
+
+    if ((rc = nas_acl_perf_ndi_call (ndi_acl_table_create, npu_id,
+                                     ndi_tbl_p, &ndi_tbl_id))
             != STD_ERR_OK)
     {
         throw nas::base_exception {rc, __PRETTY_FUNCTION__,
@@ -231,7 +275,8 @@ bool nas_acl_table::push_delete_obj_to_npu (npu_id_t npu_id)
 {
     t_std_error rc;
 
-    if ((rc = ndi_acl_table_delete (npu_id, _ndi_obj_ids.at (npu_id)))
+    if ((rc = nas_acl_perf_ndi_call (ndi_acl_table_delete, npu_id,
+                                     _ndi_obj_ids.at (npu_id)))
         != STD_ERR_OK)
     {
         throw nas::base_exception {rc, __PRETTY_FUNCTION__,
@@ -274,8 +319,8 @@ bool nas_acl_table::push_leaf_attr_to_npu (nas_attr_id_t attr_id,
     switch (attr_id)
     {
         case BASE_ACL_TABLE_PRIORITY:
-            if ((rc = ndi_acl_table_set_priority (npu_id, _ndi_obj_ids.at(npu_id),
-                                                    priority()))
+            if ((rc = nas_acl_perf_ndi_call (ndi_acl_table_set_priority, npu_id,
+                                             _ndi_obj_ids.at(npu_id), priority()))
                 != STD_ERR_OK)
             {
                 throw nas::base_exception {rc, __PRETTY_FUNCTION__,
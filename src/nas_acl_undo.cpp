@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_undo.cpp
+ * \brief  NAS ACL undo journal of the Entries changed by a CPS transaction
+ */
+
+#include "nas_acl_log.h"
+#include "nas_acl_undo.h"
+#include "nas_acl_cps.h"
+#include "nas_acl_lock.h"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+typedef struct _undo_rec_t {
+    std::unique_ptr<nas_acl_entry>  entry_p;
+    nas::attr_set_t                 attrs;
+    bool                            npu_modified;
+    bool                            filled;
+    // The Entry's Table may be deleted before the record
+    nas_switch_id_t                 switch_id;
+    nas_obj_id_t                    table_id;
+} _undo_rec_t;
+
+// Written by the CPS thread and by the async worker
+static std::mutex                                        _undo_mutex;
+static std::unordered_map<cps_api_object_t, _undo_rec_t> _undo_journal;
+
+void nas_acl_undo_save (cps_api_object_t                prev,
+                        std::unique_ptr<nas_acl_entry>  old_entry_p,
+                        const nas::attr_set_t&          attrs,
+                        bool                            npu_modified) noexcept
+{
+    if (old_entry_p == nullptr) {
+        return;
+    }
+
+    try {
+        auto switch_id = old_entry_p->switch_id ();
+        auto table_id  = old_entry_p->table_id ();
+
+        std::lock_guard<std::mutex> lock (_undo_mutex);
+
+        // Prev objects live until their transaction ends, and so does the
+        // journal - the key is new
+        _undo_journal.emplace (prev, _undo_rec_t {std::move (old_entry_p), attrs,
+                                                  npu_modified, false,
+                                                  switch_id, table_id});
+        return;
+
+    } catch (std::exception& e) {
+        NAS_ACL_LOG_BRIEF ("Undo record not kept: %s", e.what ());
+    }
+
+    if (!nas_acl_fill_entry_prev (prev, *old_entry_p, attrs, npu_modified)) {
+        NAS_ACL_LOG_ERR ("Failed to save Entry Id %ld for rollback",
+                         old_entry_p->entry_id ());
+    }
+}
+
+void nas_acl_undo_fill (cps_api_object_t prev) noexcept
+{
+    std::lock_guard<std::mutex> lock (_undo_mutex);
+
+    auto it = _undo_journal.find (prev);
+    if (it == _undo_journal.end () || it->second.filled) {
+        return;
+    }
+
+    // Record is kept - the Entry is freed with its Table lock held
+    auto& rec = it->second;
+    rec.filled = true;
+
+    if (!nas_acl_fill_entry_prev (prev, *rec.entry_p, rec.attrs, rec.npu_modified)) {
+        NAS_ACL_LOG_ERR ("Failed to restore Entry Id %ld for rollback",
+                         rec.entry_p->entry_id ());
+    }
+}
+
+void nas_acl_undo_reset (bool lock_tables, bool fill_prev) noexcept
+{
+    std::vector<_undo_rec_t> recs;
+
+    {
+        std::lock_guard<std::mutex> lock (_undo_mutex);
+
+        try {
+            recs.reserve (_undo_journal.size ());
+        } catch (std::exception& e) {
+            NAS_ACL_LOG_ERR ("Undo journal not reset: %s", e.what ());
+            return;
+        }
+        for (auto& rec_pair: _undo_journal) {
+            auto& rec = rec_pair.second;
+
+            if (fill_prev && !rec.filled &&
+                !nas_acl_fill_entry_prev (rec_pair.first, *rec.entry_p, rec.attrs,
+                                          rec.npu_modified)) {
+                NAS_ACL_LOG_ERR ("Failed to save Entry Id %ld for rollback",
+                                 rec.entry_p->entry_id ());
+            }
+            recs.push_back (std::move (rec));
+        }
+        _undo_journal.clear ();
+    }
+
+    for (auto& rec: recs) {
+        nas_acl_lock_scope_t scope (NAS_ACL_LOCK_TABLE, rec.switch_id, rec.table_id);
+
+        if (lock_tables) scope.lock ();
+        rec.entry_p.reset ();
+        if (lock_tables) scope.unlock ();
+    }
+}
+
+size_t nas_acl_undo_size () noexcept
+{
+    std::lock_guard<std::mutex> lock (_undo_mutex);
+    return _undo_journal.size ();
+}
@@ -0,0 +1,583 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_warm.cpp
+ * \brief  NAS ACL warm restart checkpoint and reconcile
+ */
+
+#include "dell-base-acl.h"
+#include "nas_acl_warm.h"
+#include "nas_acl_switch.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_log.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+// Object type, Switch, Table, Object ID
+typedef std::tuple<uint8_t, nas_switch_id_t, nas_obj_id_t, nas_obj_id_t> _warm_obj_key_t;
+// Object key and NPU
+typedef std::tuple<_warm_obj_key_t, npu_id_t> _warm_npu_key_t;
+
+typedef std::vector<uint32_t> _warm_rec_list_t;
+
+// NDI objects of the previous run not yet adopted or removed
+typedef struct _warm_old_obj_t {
+    uint64_t                   cfg_hash = 0;
+    std::vector<ndi_obj_id_t>  ndi_ids;
+    _warm_rec_list_t           recs;
+} _warm_old_obj_t;
+
+static int                 _warm_fd = -1;
+static uint8_t*            _warm_map_p = nullptr;
+static size_t              _warm_map_len = 0;
+static _warm_rec_list_t    _warm_free_recs;
+
+static std::map<_warm_obj_key_t, _warm_rec_list_t>  _warm_obj_recs;
+static std::map<_warm_npu_key_t, _warm_old_obj_t>   _warm_old_objs;
+static bool                                         _warm_reconciling = false;
+
+// Leaf lock - Entries of different Tables are saved in parallel
+static std::mutex                                   _warm_mutex;
+
+static inline nas_acl_warm_hdr_t* _warm_hdr () noexcept
+{
+    return reinterpret_cast<nas_acl_warm_hdr_t*> (_warm_map_p);
+}
+
+static inline nas_acl_warm_rec_t* _warm_rec (uint32_t rec_idx) noexcept
+{
+    return reinterpret_cast<nas_acl_warm_rec_t*> (_warm_map_p +
+                                                  sizeof (nas_acl_warm_hdr_t)) + rec_idx;
+}
+
+static inline size_t _warm_file_len (size_t rec_count) noexcept
+{
+    return sizeof (nas_acl_warm_hdr_t) + rec_count * sizeof (nas_acl_warm_rec_t);
+}
+
+// On failure the checkpoint is left unmapped - and no longer updated
+static bool _warm_map (size_t len) noexcept
+{
+    if (ftruncate (_warm_fd, len) != 0) {
+        NAS_ACL_LOG_ERR ("Warm checkpoint resize to %ld failed: %s", len, strerror (errno));
+        return false;
+    }
+
+    if (_warm_map_p != nullptr) {
+        munmap (_warm_map_p, _warm_map_len);
+        _warm_map_p = nullptr;
+    }
+
+    void* p = mmap (NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, _warm_fd, 0);
+    if (p == MAP_FAILED) {
+        NAS_ACL_LOG_ERR ("Warm checkpoint map failed: %s", strerror (errno));
+        return false;
+    }
+
+    _warm_map_p = static_cast<uint8_t*> (p);
+    _warm_map_len = len;
+
+    return true;
+}
+
+// Double the number of records - new records are zero, ie. free
+static bool _warm_grow () noexcept
+{
+    uint32_t old_count = _warm_hdr ()->rec_count;
+    uint32_t new_count = old_count * 2;
+
+    // Free list never reallocates - records are freed in noexcept paths
+    try {
+        _warm_free_recs.reserve (new_count);
+    } catch (std::bad_alloc& e) {
+        return false;
+    }
+
+    if (!_warm_map (_warm_file_len (new_count))) {
+        return false;
+    }
+
+    _warm_hdr ()->rec_count = new_count;
+
+    for (uint32_t rec_idx = new_count; rec_idx-- > old_count; ) {
+        _warm_free_recs.push_back (rec_idx);
+    }
+    return true;
+}
+
+static void _warm_free_rec_list (const _warm_rec_list_t& recs) noexcept
+{
+    if (_warm_map_p == nullptr) {
+        return;
+    }
+    for (auto rec_idx: recs) {
+        _warm_rec (rec_idx)->obj_type = NAS_ACL_WARM_OBJ_FREE;
+        _warm_free_recs.push_back (rec_idx);
+    }
+}
+
+static bool _warm_add_rec (_warm_rec_list_t& recs, const nas_acl_warm_rec_t& rec)
+{
+    if (_warm_free_recs.empty () && !_warm_grow ()) {
+        return false;
+    }
+
+    uint32_t rec_idx = _warm_free_recs.back ();
+    auto rec_p = _warm_rec (rec_idx);
+
+    // Type is written last so that a half written record is never valid
+    memcpy (rec_p, &rec, sizeof (rec));
+    rec_p->obj_type = NAS_ACL_WARM_OBJ_FREE;
+    std::atomic_signal_fence (std::memory_order_release);
+    rec_p->obj_type = rec.obj_type;
+
+    _warm_free_recs.pop_back ();
+    recs.push_back (rec_idx);
+
+    return true;
+}
+
+static void _warm_load () noexcept
+{
+    auto hdr_p = _warm_hdr ();
+
+    _warm_free_recs.reserve (hdr_p->rec_count);
+
+    for (uint32_t rec_idx = hdr_p->rec_count; rec_idx-- > 0; ) {
+
+        auto rec_p = _warm_rec (rec_idx);
+
+        if (rec_p->obj_type == NAS_ACL_WARM_OBJ_FREE ||
+            rec_p->obj_type > NAS_ACL_WARM_OBJ_ENTRY) {
+            rec_p->obj_type = NAS_ACL_WARM_OBJ_FREE;
+            _warm_free_recs.push_back (rec_idx);
+            continue;
+        }
+
+        _warm_obj_key_t obj_key {rec_p->obj_type, rec_p->switch_id,
+                                 rec_p->table_id, rec_p->obj_id};
+        auto& old_obj = _warm_old_objs[_warm_npu_key_t {obj_key, rec_p->npu_id}];
+
+        if (old_obj.ndi_ids.size () <= rec_p->ndi_idx) {
+            old_obj.ndi_ids.resize (rec_p->ndi_idx + 1);
+        }
+        old_obj.ndi_ids[rec_p->ndi_idx] = rec_p->ndi_id;
+        old_obj.cfg_hash = rec_p->cfg_hash;
+        old_obj.recs.push_back (rec_idx);
+    }
+}
+
+static void _warm_close () noexcept
+{
+    if (_warm_map_p != nullptr) {
+        munmap (_warm_map_p, _warm_map_len);
+    }
+    if (_warm_fd >= 0) {
+        close (_warm_fd);
+    }
+
+    _warm_fd = -1;
+    _warm_map_p = nullptr;
+    _warm_map_len = 0;
+    _warm_free_recs.clear ();
+    _warm_obj_recs.clear ();
+    _warm_old_objs.clear ();
+    _warm_reconciling = false;
+}
+
+bool nas_acl_warm_open (const char* path, bool warm) noexcept
+{
+    std::lock_guard<std::mutex> lock (_warm_mutex);
+
+    _warm_close ();
+
+    _warm_fd = open (path, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+    if (_warm_fd < 0) {
+        NAS_ACL_LOG_ERR ("Warm checkpoint %s open failed: %s", path, strerror (errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat (_warm_fd, &st) != 0) {
+        st.st_size = 0;
+    }
+
+    size_t file_len = st.st_size;
+
+    if (warm && file_len >= sizeof (nas_acl_warm_hdr_t) && _warm_map (file_len)) {
+
+        auto hdr_p = _warm_hdr ();
+
+        if (hdr_p->magic == NAS_ACL_WARM_MAGIC &&
+            hdr_p->version == NAS_ACL_WARM_VERSION &&
+            hdr_p->rec_size == sizeof (nas_acl_warm_rec_t) &&
+            file_len >= _warm_file_len (hdr_p->rec_count)) {
+
+            try {
+                _warm_load ();
+            } catch (std::bad_alloc& e) {
+                NAS_ACL_LOG_ERR ("Warm checkpoint load out of memory");
+                _warm_old_objs.clear ();
+                _warm_free_recs.clear ();
+                warm = false;
+            }
+
+            if (warm) {
+                _warm_reconciling = !_warm_old_objs.empty ();
+                NAS_ACL_LOG_BRIEF ("Warm restart: %ld NDI objects in checkpoint",
+                                   _warm_old_objs.size ());
+                return true;
+            }
+        } else {
+            NAS_ACL_LOG_ERR ("Warm checkpoint %s invalid - starting cold", path);
+        }
+    }
+
+    // Cold start - the NPU has no ACL objects, start with an empty file
+    if (ftruncate (_warm_fd, 0) != 0 ||
+        !_warm_map (_warm_file_len (NAS_ACL_WARM_MIN_RECORDS))) {
+        _warm_close ();
+        return false;
+    }
+
+    auto hdr_p = _warm_hdr ();
+    hdr_p->magic = NAS_ACL_WARM_MAGIC;
+    hdr_p->version = NAS_ACL_WARM_VERSION;
+    hdr_p->rec_size = sizeof (nas_acl_warm_rec_t);
+    hdr_p->rec_count = NAS_ACL_WARM_MIN_RECORDS;
+
+    try {
+        _warm_free_recs.reserve (NAS_ACL_WARM_MIN_RECORDS);
+    } catch (std::bad_alloc& e) {
+        _warm_close ();
+        return false;
+    }
+
+    for (uint32_t rec_idx = NAS_ACL_WARM_MIN_RECORDS; rec_idx-- > 0; ) {
+        _warm_free_recs.push_back (rec_idx);
+    }
+
+    return true;
+}
+
+void nas_acl_warm_init (bool warm) noexcept
+{
+    const char* warm_str = getenv (NAS_ACL_WARM_ENV);
+
+    if (!warm && (warm_str == NULL || strcmp (warm_str, "1") != 0)) {
+        NAS_ACL_LOG_BRIEF ("Warm restart not enabled - no checkpoint kept");
+        return;
+    }
+
+    // Runs without a checkpoint if the file cannot be used -
+    // the next restart is then cold
+    nas_acl_warm_open (NAS_ACL_WARM_FILE, warm);
+}
+
+void nas_acl_warm_close () noexcept
+{
+    std::lock_guard<std::mutex> lock (_warm_mutex);
+
+    _warm_close ();
+}
+
+bool nas_acl_warm_is_reconciling () noexcept
+{
+    std::lock_guard<std::mutex> lock (_warm_mutex);
+
+    return _warm_reconciling;
+}
+
+static t_std_error _warm_ndi_delete (uint8_t obj_type, npu_id_t npu_id,
+                                     ndi_obj_id_t ndi_id) noexcept
+{
+    switch (obj_type) {
+        case NAS_ACL_WARM_OBJ_TABLE:
+            return nas_acl_perf_ndi_call (ndi_acl_table_delete, npu_id, ndi_id);
+        case NAS_ACL_WARM_OBJ_COUNTER:
+            return nas_acl_perf_ndi_call (ndi_acl_counter_delete, npu_id, ndi_id);
+        default:
+            return nas_acl_perf_ndi_call (ndi_acl_entry_delete, npu_id, ndi_id);
+    }
+}
+
+static void _warm_remove_old_obj (const _warm_npu_key_t& npu_key,
+                                  const _warm_old_obj_t& old_obj) noexcept
+{
+    auto obj_type = std::get<0> (std::get<0> (npu_key));
+    auto npu_id = std::get<1> (npu_key);
+
+    // Port range expansion entries first, as on a regular delete
+    for (size_t idx = old_obj.ndi_ids.size (); idx-- > 0; ) {
+
+        auto ndi_id = old_obj.ndi_ids[idx];
+        t_std_error rc = _warm_ndi_delete (obj_type, npu_id, ndi_id);
+
+        if (rc != STD_ERR_OK) {
+            NAS_ACL_LOG_ERR ("Warm restart: NPU %d NDI object 0x%" PRIx64
+                             " delete failed, rc %d", npu_id, ndi_id, rc);
+        }
+    }
+    _warm_free_rec_list (old_obj.recs);
+}
+
+void nas_acl_warm_reconcile () noexcept
+{
+    std::lock_guard<std::mutex> lock (_warm_mutex);
+
+    if (!_warm_reconciling) {
+        return;
+    }
+
+    NAS_ACL_LOG_BRIEF ("Warm restart: removing %ld NDI objects not replayed",
+                       _warm_old_objs.size ());
+
+    // Entries refer to Counters and Tables - remove them in that order
+    for (uint8_t obj_type: {NAS_ACL_WARM_OBJ_ENTRY, NAS_ACL_WARM_OBJ_COUNTER,
+                            NAS_ACL_WARM_OBJ_TABLE}) {
+        for (const auto& old_kv: _warm_old_objs) {
+            if (std::get<0> (std::get<0> (old_kv.first)) == obj_type) {
+                _warm_remove_old_obj (old_kv.first, old_kv.second);
+            }
+        }
+    }
+
+    _warm_old_objs.clear ();
+    _warm_reconciling = false;
+}
+
+uint64_t nas_acl_warm_table_hash (const nas_acl_table& table) noexcept
+{
+    uint64_t hash = nas_acl_hash_val (NAS_ACL_HASH_INIT, table.stage ());
+    hash = nas_acl_hash_val (hash, table.priority ());
+
+    // Set is ordered
+    for (auto f_type: table.allowed_filters ()) {
+        hash = nas_acl_hash_val (hash, f_type);
+    }
+    return hash;
+}
+
+uint64_t nas_acl_warm_counter_hash (const nas_acl_counter_t& counter,
+                                    npu_id_t npu_id) noexcept
+{
+    uint64_t hash = nas_acl_hash_val (NAS_ACL_HASH_INIT, counter.is_pkt_count_enabled ());
+    hash = nas_acl_hash_val (hash, counter.is_byte_count_enabled ());
+
+    try {
+        hash = nas_acl_hash_val (hash, counter.get_table ().get_ndi_obj_id (npu_id));
+    } catch (...) {
+    }
+    return hash;
+}
+
+uint64_t nas_acl_warm_entry_hash (const nas_acl_entry& entry,
+                                  npu_id_t npu_id) noexcept
+{
+    uint64_t hash = nas_acl_hash_val (NAS_ACL_HASH_INIT, entry.priority ());
+    uint64_t flist_hash = 0;
+    uint64_t alist_hash = 0;
+
+    // Unordered lists - combine the digest of each element
+    for (const auto& f_kv: entry.get_filter_list ()) {
+        flist_hash += f_kv.second.cfg_hash ();
+    }
+    for (const auto& a_kv: entry.get_action_list ()) {
+        alist_hash += a_kv.second.cfg_hash ();
+    }
+    hash = nas_acl_hash_val (nas_acl_hash_val (hash, flist_hash), alist_hash);
+
+    // NDI objects the Entry refers to in this NPU
+    try {
+        hash = nas_acl_hash_val (hash, entry.get_table ().get_ndi_obj_id (npu_id));
+
+        auto counter_p = entry.get_counter ();
+        if (counter_p != nullptr && counter_p->is_obj_in_npu (npu_id)) {
+            hash = nas_acl_hash_val (hash, counter_p->ndi_obj_id (npu_id));
+        }
+    } catch (...) {
+    }
+    return hash;
+}
+
+bool nas_acl_warm_adopt (nas_acl_warm_obj_t obj_type, nas_switch_id_t switch_id,
+                         nas_obj_id_t table_id, nas_obj_id_t obj_id,
+                         npu_id_t npu_id, uint64_t cfg_hash,
+                         std::vector<ndi_obj_id_t>& ndi_ids) noexcept
+{
+    std::lock_guard<std::mutex> lock (_warm_mutex);
+
+    if (!_warm_reconciling) {
+        return false;
+    }
+
+    _warm_npu_key_t npu_key {_warm_obj_key_t {obj_type, switch_id, table_id, obj_id},
+                             npu_id};
+
+    auto it = _warm_old_objs.find (npu_key);
+    if (it == _warm_old_objs.end ()) {
+        return false;
+    }
+
+    auto& old_obj = it->second;
+
+    if (old_obj.cfg_hash != cfg_hash) {
+        NAS_ACL_LOG_BRIEF ("Warm restart: Switch %d Table %ld object %ld type %d "
+                           "changed in NPU %d - reprogramming",
+                           switch_id, table_id, obj_id, obj_type, npu_id);
+        // Entries can go right away - Tables and Counters may still be
+        // in use by Entries of the previous run not yet replayed
+        if (obj_type == NAS_ACL_WARM_OBJ_ENTRY) {
+            _warm_remove_old_obj (npu_key, old_obj);
+            _warm_old_objs.erase (it);
+        }
+        return false;
+    }
+
+    try {
+        ndi_ids = old_obj.ndi_ids;
+    } catch (std::bad_alloc& e) {
+        return false;
+    }
+
+    NAS_ACL_LOG_DETAIL ("Warm restart: Switch %d Table %ld object %ld type %d "
+                        "adopted in NPU %d NDI-ID 0x%" PRIx64,
+                        switch_id, table_id, obj_id, obj_type, npu_id,
+                        ndi_ids.front ());
+
+    // The records are rewritten when the object is saved
+    _warm_free_rec_list (old_obj.recs);
+    _warm_old_objs.erase (it);
+
+    return true;
+}
+
+// Replace the records of an object with a record per NDI object
+template <typename F>
+static void _warm_save_obj (const _warm_obj_key_t& obj_key, F fill_recs) noexcept
+{
+    std::lock_guard<std::mutex> lock (_warm_mutex);
+
+    if (_warm_map_p == nullptr) {
+        return;
+    }
+
+    try {
+        auto& recs = _warm_obj_recs[obj_key];
+
+        _warm_free_rec_list (recs);
+        recs.clear ();
+
+        nas_acl_warm_rec_t rec = {};
+        rec.obj_type  = std::get<0> (obj_key);
+        rec.switch_id = std::get<1> (obj_key);
+        rec.table_id  = std::get<2> (obj_key);
+        rec.obj_id    = std::get<3> (obj_key);
+
+        fill_recs (rec, recs);
+    } catch (std::bad_alloc& e) {
+        NAS_ACL_LOG_ERR ("Warm checkpoint of Table %ld object %ld failed",
+                         std::get<2> (obj_key), std::get<3> (obj_key));
+    }
+}
+
+void nas_acl_warm_save (const nas_acl_table& table) noexcept
+{
+    _warm_save_obj (_warm_obj_key_t {NAS_ACL_WARM_OBJ_TABLE, table.switch_id (),
+                                     table.table_id (), table.table_id ()},
+                    [&] (nas_acl_warm_rec_t& rec, _warm_rec_list_t& recs) {
+        rec.cfg_hash = nas_acl_warm_table_hash (table);
+
+        for (auto npu_id: table.npu_list ()) {
+            try {
+                rec.ndi_id = table.get_ndi_obj_id (npu_id);
+            } catch (nas::base_exception& e) {
+                continue;
+            }
+            rec.npu_id = npu_id;
+            if (!_warm_add_rec (recs, rec)) return;
+        }
+    });
+}
+
+void nas_acl_warm_save (const nas_acl_counter_t& counter) noexcept
+{
+    _warm_save_obj (_warm_obj_key_t {NAS_ACL_WARM_OBJ_COUNTER, counter.switch_id (),
+                                     counter.table_id (), counter.counter_id ()},
+                    [&] (nas_acl_warm_rec_t& rec, _warm_rec_list_t& recs) {
+        for (auto npu_id: counter.npu_list ()) {
+            if (!counter.is_obj_in_npu (npu_id)) {
+                continue;
+            }
+            rec.npu_id = npu_id;
+            rec.ndi_id = counter.ndi_obj_id (npu_id);
+            rec.cfg_hash = nas_acl_warm_counter_hash (counter, npu_id);
+            if (!_warm_add_rec (recs, rec)) return;
+        }
+    });
+}
+
+void nas_acl_warm_save (const nas_acl_entry& entry) noexcept
+{
+    _warm_save_obj (_warm_obj_key_t {NAS_ACL_WARM_OBJ_ENTRY, entry.switch_id (),
+                                     entry.table_id (), entry.entry_id ()},
+                    [&] (nas_acl_warm_rec_t& rec, _warm_rec_list_t& recs) {
+        for (const auto& ndi_kv: entry.ndi_entry_ids) {
+
+            auto npu_id = ndi_kv.first;
+            auto id_list = entry.ndi_entry_id_list (npu_id);
+
+            rec.npu_id = npu_id;
+            rec.cfg_hash = nas_acl_warm_entry_hash (entry, npu_id);
+
+            for (size_t idx = 0; idx < id_list.size (); idx++) {
+                rec.ndi_idx = idx;
+                rec.ndi_id = id_list[idx];
+                if (!_warm_add_rec (recs, rec)) return;
+            }
+        }
+    });
+}
+
+void nas_acl_warm_remove (nas_acl_warm_obj_t obj_type, nas_switch_id_t switch_id,
+                          nas_obj_id_t table_id, nas_obj_id_t obj_id) noexcept
+{
+    std::lock_guard<std::mutex> lock (_warm_mutex);
+
+    if (_warm_map_p == nullptr) {
+        return;
+    }
+
+    auto it = _warm_obj_recs.find (_warm_obj_key_t {obj_type, switch_id,
+                                                    table_id, obj_id});
+    if (it == _warm_obj_recs.end ()) {
+        return;
+    }
+
+    _warm_free_rec_list (it->second);
+    _warm_obj_recs.erase (it);
+}
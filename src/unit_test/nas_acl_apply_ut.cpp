@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_switch_list.h"
+#include <map>
+#include <vector>
+
+#define UT_APPLY_NPU        0
+#define UT_APPLY_BAD_ENTRY  4000
+
+typedef struct _ut_apply_entry_t {
+    nas_obj_id_t  entry_id;     /* 0 - pair by content or priority */
+    uint32_t      priority;
+    uint32_t      dst_port;
+    uint32_t      tc;
+} ut_apply_entry_t;
+
+typedef struct _ut_apply_counts_t {
+    uint32_t  created;
+    uint32_t  modified;
+    uint32_t  deleted;
+    uint32_t  unchanged;
+} ut_apply_counts_t;
+
+static cps_api_object_t ut_apply_obj_create (cps_api_attr_id_t obj_attr,
+                                             cps_api_attr_id_t table_attr,
+                                             nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static bool ut_apply_add_entry (cps_api_object_t apply_obj, nas_obj_id_t table_id,
+                                const ut_apply_entry_t& entry)
+{
+    cps_api_object_guard og (ut_apply_obj_create (BASE_ACL_ENTRY_OBJ,
+                                                  BASE_ACL_ENTRY_TABLE_ID, table_id));
+    if (!og.valid ()) {
+        return false;
+    }
+
+    if (entry.entry_id != 0) {
+        cps_api_set_key_data (og.get (), BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                              &entry.entry_id, sizeof (uint64_t));
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry.entry_id;
+    ut_entry.priority  = entry.priority;
+    ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_L4_DST_PORT,
+                                  {entry.dst_port, 0xffff}});
+    ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {entry.tc}});
+
+    cps_api_object_attr_add_u32 (og.get (), BASE_ACL_ENTRY_PRIORITY, entry.priority);
+
+    if (!ut_fill_entry_match (og.get (), ut_entry) ||
+        !ut_fill_entry_action (og.get (), ut_entry)) {
+        return false;
+    }
+
+    return cps_api_object_attr_add (apply_obj, BASE_ACL_APPLY_ENTRY,
+                                    cps_api_object_array (og.get ()),
+                                    cps_api_object_to_array_len (og.get ()));
+}
+
+// Apply the desired Entries to the Table. With fail_after, an Entry
+// update that fails follows in the same transaction.
+static cps_api_return_code_t ut_apply (nas_obj_id_t table_id,
+                                       const std::vector<ut_apply_entry_t>& entries,
+                                       ut_apply_counts_t* counts,
+                                       bool fail_after = false)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return cps_api_ret_code_ERR;
+    }
+
+    cps_api_return_code_t rc = cps_api_ret_code_ERR;
+
+    do {
+        auto obj = ut_apply_obj_create (BASE_ACL_APPLY_OBJ, BASE_ACL_APPLY_TABLE_ID,
+                                        table_id);
+        if (obj == NULL) {
+            break;
+        }
+
+        bool ok = true;
+        for (const auto& entry: entries) {
+            ok = ok && ut_apply_add_entry (obj, table_id, entry);
+        }
+        if (!ok || cps_api_set (&params, obj) != cps_api_ret_code_OK) {
+            break;
+        }
+
+        if (fail_after) {
+            nas_obj_id_t entry_id = UT_APPLY_BAD_ENTRY;
+
+            obj = ut_apply_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                       table_id);
+            if (obj == NULL) {
+                break;
+            }
+            cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                                  &entry_id, sizeof (uint64_t));
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, 1);
+
+            if (cps_api_set (&params, obj) != cps_api_ret_code_OK) {
+                break;
+            }
+        }
+
+        rc = nas_acl_ut_cps_api_commit (&params, true);
+
+        if (rc == cps_api_ret_code_OK && counts != NULL) {
+            obj = cps_api_object_list_get (params.change_list, 0);
+
+            auto attr_u32 = [obj] (cps_api_attr_id_t attr_id) -> uint32_t {
+                auto attr = cps_api_object_attr_get (obj, attr_id);
+                return (attr != NULL) ? cps_api_object_attr_data_u32 (attr) : UINT32_MAX;
+            };
+            counts->created   = attr_u32 (BASE_ACL_APPLY_CREATED);
+            counts->modified  = attr_u32 (BASE_ACL_APPLY_MODIFIED);
+            counts->deleted   = attr_u32 (BASE_ACL_APPLY_DELETED);
+            counts->unchanged = attr_u32 (BASE_ACL_APPLY_UNCHANGED);
+        }
+    } while (0);
+
+    cps_api_transaction_close (&params);
+
+    return rc;
+}
+
+static bool ut_apply_check (const char* step, const ut_apply_counts_t& counts,
+                            uint32_t created, uint32_t modified,
+                            uint32_t deleted, uint32_t unchanged)
+{
+    if (counts.created != created || counts.modified != modified ||
+        counts.deleted != deleted || counts.unchanged != unchanged) {
+        ut_printf ("%s(): %s - Created %u Modified %u Deleted %u Unchanged %u\r\n",
+                   __FUNCTION__, step, counts.created, counts.modified,
+                   counts.deleted, counts.unchanged);
+        return false;
+    }
+    return true;
+}
+
+// Entry ID to priority of each Entry in the Table
+static std::map<nas_obj_id_t, uint32_t> ut_apply_entries (nas_obj_id_t table_id)
+{
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+    std::map<nas_obj_id_t, uint32_t> entries;
+
+    for (const auto& entry_kv: s.entry_list (table_id)) {
+        entries [entry_kv.first] = entry_kv.second.priority ();
+    }
+    return entries;
+}
+
+static nas_obj_id_t ut_apply_entry_id (nas_obj_id_t table_id, uint32_t priority)
+{
+    for (const auto& entry_kv: ut_apply_entries (table_id)) {
+        if (entry_kv.second == priority) {
+            return entry_kv.first;
+        }
+    }
+    return 0;
+}
+
+static bool ut_apply_table_op (nas_obj_id_t* table_id, bool create)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_apply_obj_create (BASE_ACL_TABLE_OBJ, (create) ? 0 : BASE_ACL_TABLE_ID,
+                                    *table_id);
+    bool ok = (obj != NULL);
+
+    if (ok && create) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 90);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_APPLY_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_L4_DST_PORT);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    } else if (ok) {
+        ok = (cps_api_delete (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok && create) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+bool nas_acl_ut_apply_test ()
+{
+    nas_obj_id_t       table_id = 0;
+    ut_apply_counts_t  counts {};
+    bool               ok = false;
+
+    if (!ut_apply_table_op (&table_id, true)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    do {
+        std::vector<ut_apply_entry_t> desired {
+            {0, 10, 80, 1}, {0, 20, 443, 2}, {0, 30, 22, 3},
+        };
+
+        if (ut_apply (table_id, desired, &counts) != cps_api_ret_code_OK ||
+            !ut_apply_check ("Initial", counts, 3, 0, 0, 0)) {
+            break;
+        }
+
+        // Same policy pushed again in another order - no NDI call
+        auto entries = ut_apply_entries (table_id);
+        auto ndi_writes = ut_ndi_entry_write_count ();
+
+        std::vector<ut_apply_entry_t> reordered {desired.rbegin (), desired.rend ()};
+
+        if (ut_apply (table_id, reordered, &counts) != cps_api_ret_code_OK ||
+            !ut_apply_check ("Unchanged", counts, 0, 0, 0, 3)) {
+            break;
+        }
+        if (ut_ndi_entry_write_count () != ndi_writes ||
+            ut_apply_entries (table_id) != entries) {
+            ut_printf ("%s(): Unchanged Entries reprogrammed\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Filter change paired by priority, priority change paired by ID,
+        // one Entry dropped and one added
+        nas_obj_id_t https_id = ut_apply_entry_id (table_id, 20);
+
+        desired = {
+            {0, 10, 8080, 1}, {https_id, 25, 443, 2}, {0, 40, 53, 4},
+        };
+        if (ut_apply (table_id, desired, &counts) != cps_api_ret_code_OK ||
+            !ut_apply_check ("Changed", counts, 1, 2, 1, 0)) {
+            break;
+        }
+        if (ut_apply_entry_id (table_id, 25) != https_id ||
+            ut_apply_entry_id (table_id, 30) != 0 ||
+            ut_apply_entry_id (table_id, 40) == 0) {
+            ut_printf ("%s(): Table not reconciled\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Priority only change is a single NDI call
+        desired [1].priority = 26;
+        ndi_writes = ut_ndi_entry_write_count ();
+
+        if (ut_apply (table_id, desired, &counts) != cps_api_ret_code_OK ||
+            !ut_apply_check ("Priority", counts, 0, 1, 0, 2)) {
+            break;
+        }
+        if (ut_ndi_entry_write_count () != ndi_writes + 1) {
+            ut_printf ("%s(): %lu NDI calls for a priority change\r\n", __FUNCTION__,
+                       ut_ndi_entry_write_count () - ndi_writes);
+            break;
+        }
+
+        // Failure later in the transaction restores the Table
+        entries = ut_apply_entries (table_id);
+
+        if (ut_apply (table_id, {}, NULL, true) == cps_api_ret_code_OK) {
+            ut_printf ("%s(): Failing transaction succeeded\r\n", __FUNCTION__);
+            break;
+        }
+        if (ut_apply_entries (table_id) != entries) {
+            ut_printf ("%s(): Table not restored by rollback\r\n", __FUNCTION__);
+            break;
+        }
+
+        if (ut_apply (table_id, {}, &counts) != cps_api_ret_code_OK ||
+            !ut_apply_check ("Empty", counts, 0, 0, 3, 0)) {
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    if (!ok) {
+        ut_apply (table_id, {}, NULL);
+    }
+    if (!ut_apply_table_op (&table_id, false)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    return ok;
+}
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_async.h"
+#include "nas_acl_switch_list.h"
+#include <vector>
+
+#define UT_ASYNC_NPU        0
+#define UT_ASYNC_FAIL_ID    200
+#define UT_ASYNC_UNDO_ID    300
+#define UT_ASYNC_BAD_ENTRY  4000
+
+static cps_api_object_t ut_async_obj_create (cps_api_attr_id_t obj_attr,
+                                             cps_api_attr_id_t table_attr,
+                                             nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static bool ut_async_table_op (nas_obj_id_t* table_id, bool create)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_async_obj_create (BASE_ACL_TABLE_OBJ, (create) ? 0 : BASE_ACL_TABLE_ID,
+                                    *table_id);
+    bool ok = (obj != NULL);
+
+    if (ok && create) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 92);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_ASYNC_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_L4_DST_PORT);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    } else if (ok) {
+        ok = (cps_api_delete (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok && create) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+// Adds an Entry write to the transaction. Entry ID 0 is allocated on Create.
+static bool ut_async_entry_op (cps_api_transaction_params_t* params,
+                               cps_api_operation_types_t op, nas_obj_id_t table_id,
+                               nas_obj_id_t entry_id, uint32_t priority)
+{
+    auto obj = ut_async_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+
+    if (obj == NULL) {
+        return false;
+    }
+
+    if (entry_id != 0) {
+        cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                              &entry_id, sizeof (uint64_t));
+    }
+
+    if (op == cps_api_oper_DELETE) {
+        return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+    }
+
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, priority);
+
+    if (op == cps_api_oper_SET) {
+        return (cps_api_set (params, obj) == cps_api_ret_code_OK);
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+    ut_entry.priority  = priority;
+    ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_L4_DST_PORT, {priority, 0xffff}});
+    ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+
+    if (!ut_fill_entry_match (obj, ut_entry) ||
+        !ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return false;
+    }
+
+    return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+}
+
+static const nas_acl_entry* ut_async_find_entry (nas_obj_id_t table_id,
+                                                 nas_obj_id_t entry_id)
+{
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    return s.find_entry (table_id, entry_id);
+}
+
+// Program status reported by an Entry GET
+static uint32_t ut_async_get_status (nas_obj_id_t table_id, nas_obj_id_t entry_id)
+{
+    cps_api_get_params_t params;
+    uint32_t status = UINT32_MAX;
+
+    if (cps_api_get_request_init (&params) != cps_api_ret_code_OK) {
+        return status;
+    }
+
+    auto obj = ut_async_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+
+    if (obj != NULL && cps_api_object_list_append (params.filters, obj)) {
+        cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                              &entry_id, sizeof (uint64_t));
+
+        if (nas_acl_ut_cps_api_get (&params, 0) == cps_api_ret_code_OK &&
+            cps_api_object_list_size (params.list) == 1) {
+            auto attr = cps_api_object_attr_get (cps_api_object_list_get (params.list, 0),
+                                                 BASE_ACL_ENTRY_PROGRAM_STATUS);
+            status = (attr != NULL) ? cps_api_object_attr_data_u32 (attr) :
+                                      (uint32_t) NAS_ACL_ASYNC_STATUS_OK;
+        }
+    } else if (obj != NULL) {
+        cps_api_object_delete (obj);
+    }
+
+    cps_api_get_request_close (&params);
+    return status;
+}
+
+bool nas_acl_ut_async_test ()
+{
+    nas_obj_id_t                  table_id = 0;
+    std::vector<nas_obj_id_t>     entry_ids;
+    cps_api_transaction_params_t  params;
+    bool                          ok = false;
+
+    if (!ut_async_table_op (&table_id, true)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    if (!nas_acl_async_enable (true)) {
+        ut_async_table_op (&table_id, false);
+        return false;
+    }
+
+    do {
+        // Creates return with allocated IDs before they are programmed
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+        bool txn_ok = true;
+        for (uint32_t prio = 10; prio <= 30; prio += 10) {
+            txn_ok = txn_ok && ut_async_entry_op (&params, cps_api_oper_CREATE,
+                                                  table_id, 0, prio);
+        }
+        txn_ok = txn_ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+        for (size_t idx = 0; txn_ok && idx < 3; idx++) {
+            auto obj = cps_api_object_list_get (params.change_list, idx);
+            entry_ids.push_back (cps_api_object_attr_data_u64 (
+                                     cps_api_get_key_data (obj, BASE_ACL_ENTRY_ID)));
+        }
+        cps_api_transaction_close (&params);
+
+        if (!txn_ok) {
+            ut_printf ("%s(): Bulk create failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        nas_acl_async_drain ();
+
+        bool all_found = true;
+        for (auto entry_id: entry_ids) {
+            all_found = all_found && (ut_async_find_entry (table_id, entry_id) != NULL) &&
+                        (ut_async_get_status (table_id, entry_id) == NAS_ACL_ASYNC_STATUS_OK);
+        }
+        if (!all_found) {
+            ut_printf ("%s(): Queued Entries not programmed\r\n", __FUNCTION__);
+            break;
+        }
+
+        // NPU failure is reported through the status - the ID is released
+        ut_simulate_ndi_entry_create_error () = UT_ASYNC_NPU;
+
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+        txn_ok = ut_async_entry_op (&params, cps_api_oper_CREATE, table_id,
+                                    UT_ASYNC_FAIL_ID, 40) &&
+                 (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+        cps_api_transaction_close (&params);
+
+        nas_acl_async_drain ();
+        ut_simulate_ndi_entry_create_error () = UT_RESET_NPU;
+
+        if (!txn_ok || ut_async_find_entry (table_id, UT_ASYNC_FAIL_ID) != NULL ||
+            ut_async_get_status (table_id, UT_ASYNC_FAIL_ID) != NAS_ACL_ASYNC_STATUS_FAILED) {
+            ut_printf ("%s(): Failed Create not reported\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Writes to one Entry are programmed in order
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+        txn_ok = ut_async_entry_op (&params, cps_api_oper_CREATE, table_id,
+                                    UT_ASYNC_FAIL_ID, 40) &&
+                 ut_async_entry_op (&params, cps_api_oper_SET, table_id,
+                                    UT_ASYNC_FAIL_ID, 45) &&
+                 ut_async_entry_op (&params, cps_api_oper_SET, table_id,
+                                    entry_ids [0], 15) &&
+                 (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+        cps_api_transaction_close (&params);
+
+        nas_acl_async_drain ();
+
+        auto retry_p = ut_async_find_entry (table_id, UT_ASYNC_FAIL_ID);
+        auto mod_p   = ut_async_find_entry (table_id, entry_ids [0]);
+
+        if (!txn_ok || retry_p == NULL || retry_p->priority () != 45 ||
+            mod_p == NULL || mod_p->priority () != 15 ||
+            ut_async_get_status (table_id, UT_ASYNC_FAIL_ID) != NAS_ACL_ASYNC_STATUS_OK) {
+            ut_printf ("%s(): Ordered writes not programmed\r\n", __FUNCTION__);
+            break;
+        }
+        entry_ids.push_back (UT_ASYNC_FAIL_ID);
+
+        // Queued Create is undone when the transaction fails validation
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+        txn_ok = ut_async_entry_op (&params, cps_api_oper_CREATE, table_id,
+                                    UT_ASYNC_UNDO_ID, 50) &&
+                 ut_async_entry_op (&params, cps_api_oper_SET, table_id,
+                                    UT_ASYNC_BAD_ENTRY, 55) &&
+                 (nas_acl_ut_cps_api_commit (&params, true) != cps_api_ret_code_OK);
+        cps_api_transaction_close (&params);
+
+        nas_acl_async_drain ();
+
+        if (!txn_ok || ut_async_find_entry (table_id, UT_ASYNC_UNDO_ID) != NULL) {
+            ut_printf ("%s(): Queued Create not rolled back\r\n", __FUNCTION__);
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    ut_simulate_ndi_entry_create_error () = UT_RESET_NPU;
+
+    // Table Delete waits for the queued Entry Deletes
+    if (cps_api_transaction_init (&params) == cps_api_ret_code_OK) {
+        bool txn_ok = true;
+
+        for (auto entry_id: entry_ids) {
+            txn_ok = txn_ok && ut_async_entry_op (&params, cps_api_oper_DELETE, table_id,
+                                                  entry_id, 0);
+        }
+        txn_ok = txn_ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+        cps_api_transaction_close (&params);
+
+        if (!txn_ok) {
+            ut_printf ("%s(): Entry delete failed\r\n", __FUNCTION__);
+            ok = false;
+        }
+    }
+
+    if (!ut_async_table_op (&table_id, false)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    nas_acl_async_enable (false);
+    return ok;
+}
@@ -0,0 +1,917 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_bench.cpp
+ * \brief  NAS ACL microbenchmarks on top of the NDI stub
+ *
+ * Built with the UT helpers and stubs by "make check" and run on Google
+ * Benchmark. Each benchmark runs a group of phases once and reports the
+ * time of each phase per operation in its <phase>_ns counters.
+ *
+ * Usage: nas_acl_bench [-n 1000,10000,100000] [-m 2:1,8:4] [-b batch] [-f 32]
+ *                      [-x cfg-dir] [--benchmark_...]
+ *   -n  Entry/counter scale list
+ *   -m  Filter:Action count mix per entry
+ *   -b  Number of CPS objects per transaction
+ *   -f  Number of Match list elements in the entry parse benchmark
+ *   -x  Also load the default ACL configuration (CoPP) from cfg-dir
+ */
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_cfg_load.h"
+#include "nas_acl_switch_list.h"
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+typedef struct _bench_mix_t {
+    size_t num_filters;
+    size_t num_actions;
+} bench_mix_t;
+
+typedef struct _bench_cfg_t {
+    std::vector<size_t>      scales;
+    std::vector<bench_mix_t> mixes;
+    size_t                   batch;
+    size_t                   parse_filters;
+    const char*              cfg_path;
+} bench_cfg_t;
+
+// Filters and Actions whose values can be filled with a plain byte pattern
+static const std::vector<BASE_ACL_MATCH_TYPE_t> _bench_filter_pool =
+{
+    BASE_ACL_MATCH_TYPE_SRC_IP,        BASE_ACL_MATCH_TYPE_DST_IP,
+    BASE_ACL_MATCH_TYPE_L4_SRC_PORT,   BASE_ACL_MATCH_TYPE_L4_DST_PORT,
+    BASE_ACL_MATCH_TYPE_IP_PROTOCOL,   BASE_ACL_MATCH_TYPE_DSCP,
+    BASE_ACL_MATCH_TYPE_ETHER_TYPE,    BASE_ACL_MATCH_TYPE_SRC_MAC,
+    BASE_ACL_MATCH_TYPE_DST_MAC,       BASE_ACL_MATCH_TYPE_SRC_IPV6,
+    BASE_ACL_MATCH_TYPE_DST_IPV6,      BASE_ACL_MATCH_TYPE_TTL,
+    BASE_ACL_MATCH_TYPE_TOS,           BASE_ACL_MATCH_TYPE_TCP_FLAGS,
+    BASE_ACL_MATCH_TYPE_ECN,           BASE_ACL_MATCH_TYPE_ICMP_TYPE,
+    BASE_ACL_MATCH_TYPE_ICMP_CODE,     BASE_ACL_MATCH_TYPE_IPV6_FLOW_LABEL,
+    BASE_ACL_MATCH_TYPE_OUTER_VLAN_PRI, BASE_ACL_MATCH_TYPE_INNER_VLAN_PRI,
+    BASE_ACL_MATCH_TYPE_TC,            BASE_ACL_MATCH_TYPE_IP_FLAGS,
+};
+
+static const std::vector<BASE_ACL_ACTION_TYPE_t> _bench_action_pool =
+{
+    BASE_ACL_ACTION_TYPE_SET_TC,             BASE_ACL_ACTION_TYPE_SET_DSCP,
+    BASE_ACL_ACTION_TYPE_SET_OUTER_VLAN_PRI, BASE_ACL_ACTION_TYPE_SET_INNER_VLAN_PRI,
+    BASE_ACL_ACTION_TYPE_SET_L4_SRC_PORT,    BASE_ACL_ACTION_TYPE_SET_L4_DST_PORT,
+    BASE_ACL_ACTION_TYPE_SET_SRC_MAC,        BASE_ACL_ACTION_TYPE_SET_DST_MAC,
+    BASE_ACL_ACTION_TYPE_SET_SRC_IP,         BASE_ACL_ACTION_TYPE_SET_DST_IP,
+    BASE_ACL_ACTION_TYPE_DECREMENT_TTL,
+};
+
+// Filter values and masks fit the 6-bit DSCP, or the range a narrower
+// field declares in its map
+#define BENCH_FILTER_MASK  0x3f
+
+static uint32_t bench_filter_mask (BASE_ACL_MATCH_TYPE_t ftype)
+{
+    const auto& map_info = *nas_acl_get_filter_info (ftype);
+    uint32_t    mask = BENCH_FILTER_MASK;
+
+    if (map_info.val.range.max != 0) {
+        mask = std::min (mask, (uint32_t) map_info.val.range.max);
+    }
+    for (const auto& child: map_info.child_list) {
+        if (child.range.max != 0) {
+            mask = std::min (mask, (uint32_t) child.range.max);
+        }
+    }
+    return mask;
+}
+
+static uint32_t bench_filter_val (BASE_ACL_MATCH_TYPE_t ftype, size_t idx)
+{
+    return (idx % bench_filter_mask (ftype)) + 1;
+}
+
+// A Table has Entry and Counter IDs up to NAS_ACL_ENTRY_ID_MAX - so the
+// larger scales are spread over several Tables, filled one after the other
+static const size_t _bench_per_table = nas_acl_switch::NAS_ACL_ENTRY_ID_MAX;
+
+static nas_obj_id_t bench_table_of (const std::vector<nas_obj_id_t>& tables, size_t idx)
+{
+    return tables.at (idx / _bench_per_table);
+}
+
+static size_t bench_rss_bytes ()
+{
+    size_t size_pages = 0, rss_pages = 0;
+    FILE*  fp = fopen ("/proc/self/statm", "r");
+
+    if (fp == NULL) {
+        return 0;
+    }
+    if (fscanf (fp, "%zu %zu", &size_pages, &rss_pages) != 2) {
+        rss_pages = 0;
+    }
+    fclose (fp);
+
+    return rss_pages * sysconf (_SC_PAGESIZE);
+}
+
+static void bench_report (benchmark::State& state, const std::string& name,
+                          size_t ops, uint64_t elapsed_ns)
+{
+    state.counters[name + "_ns"] = (ops) ? (double) elapsed_ns / ops : 0;
+}
+
+// Runs fill_fn for each of the ops objects and commits them in batches.
+// Only the commit is timed - building CPS objects is not nas-acl work.
+template <typename F>
+static bool bench_commit (size_t ops, size_t batch, uint64_t* elapsed_ns,
+                          F fill_fn,
+                          std::vector<nas_obj_id_t>* ret_ids = NULL,
+                          cps_api_attr_id_t ret_id_attr = 0)
+{
+    *elapsed_ns = 0;
+
+    for (size_t start = 0; start < ops; start += batch) {
+
+        cps_api_transaction_params_t params;
+
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            return false;
+        }
+
+        size_t end = std::min (ops, start + batch);
+        for (size_t idx = start; idx < end; idx++) {
+            if (!fill_fn (&params, idx)) {
+                cps_api_transaction_close (&params);
+                return false;
+            }
+        }
+
+        uint64_t start_ns = nas_acl_perf_now_ns ();
+        auto rc = nas_acl_ut_cps_api_commit (&params, false);
+        *elapsed_ns += nas_acl_perf_now_ns () - start_ns;
+
+        if (rc == cps_api_ret_code_OK && ret_ids != NULL) {
+            for (size_t ix = 0; ix < end - start; ix++) {
+                auto obj = cps_api_object_list_get (params.change_list, ix);
+                auto attr = cps_api_get_key_data (obj, ret_id_attr);
+                ret_ids->push_back (cps_api_object_attr_data_u64 (attr));
+            }
+        }
+
+        cps_api_transaction_close (&params);
+
+        if (rc != cps_api_ret_code_OK) {
+            printf ("Commit failed at object %zu\r\n", start);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static cps_api_object_t bench_obj_create (cps_api_attr_id_t obj_attr,
+                                          cps_api_attr_id_t table_attr,
+                                          nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static void bench_fill_ut_entry (ut_entry_t& entry, nas_obj_id_t table_id,
+                                 const bench_mix_t& mix, size_t idx)
+{
+    entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    entry.table_id  = table_id;
+    entry.priority  = idx % 0xffff;
+    entry.filter_list.clear ();
+    entry.action_list.clear ();
+
+    for (size_t f = 0; f < mix.num_filters && f < _bench_filter_pool.size (); f++) {
+        auto ftype = _bench_filter_pool[f];
+        entry.filter_list.insert ({ftype, {bench_filter_val (ftype, idx),
+                                           bench_filter_mask (ftype)}});
+    }
+    for (size_t a = 0; a < mix.num_actions && a < _bench_action_pool.size (); a++) {
+        entry.action_list.insert ({_bench_action_pool[a], {(uint32_t) (idx % 0x7) + 1}});
+    }
+}
+
+static bool bench_table_create (size_t num_tables, std::vector<nas_obj_id_t>* table_ids)
+{
+    uint64_t elapsed_ns;
+
+    auto fill_fn = [] (cps_api_transaction_params_t* params, size_t idx) {
+        auto obj = bench_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+        if (obj == NULL) return false;
+
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, idx + 1);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, 0);
+        for (auto f: _bench_filter_pool) {
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS, f);
+        }
+        return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+    };
+
+    return bench_commit (num_tables, num_tables, &elapsed_ns, fill_fn,
+                         table_ids, BASE_ACL_TABLE_ID);
+}
+
+static bool bench_delete (cps_api_attr_id_t obj_attr, cps_api_attr_id_t table_attr,
+                          cps_api_attr_id_t id_attr,
+                          const std::vector<nas_obj_id_t>& tables,
+                          const std::vector<nas_obj_id_t>& ids, size_t batch,
+                          uint64_t* elapsed_ns)
+{
+    return bench_commit (ids.size (), batch, elapsed_ns,
+        [&] (cps_api_transaction_params_t* params, size_t idx) {
+            auto obj = bench_obj_create (obj_attr, table_attr, bench_table_of (tables, idx));
+            if (obj == NULL) return false;
+
+            cps_api_set_key_data (obj, id_attr, cps_api_object_ATTR_T_U64,
+                                  &ids[idx], sizeof (uint64_t));
+            return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+        });
+}
+
+static bool bench_table_ops (benchmark::State& state, size_t num_tables, size_t batch)
+{
+    std::vector<nas_obj_id_t> ids;
+    uint64_t                  elapsed_ns;
+
+    auto fill_fn = [] (cps_api_transaction_params_t* params, size_t idx) {
+        auto obj = bench_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+        if (obj == NULL) return false;
+
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_EGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, idx + 1);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_SRC_IP);
+        return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+    };
+
+    if (!bench_commit (num_tables, batch, &elapsed_ns, fill_fn, &ids, BASE_ACL_TABLE_ID)) {
+        return false;
+    }
+    bench_report (state, "table_create", num_tables, elapsed_ns);
+
+    if (!bench_delete (BASE_ACL_TABLE_OBJ, 0, BASE_ACL_TABLE_ID, {0},
+                       ids, batch, &elapsed_ns)) {
+        return false;
+    }
+    bench_report (state, "table_delete", num_tables, elapsed_ns);
+
+    return true;
+}
+
+static bool bench_entry_ops (benchmark::State& state,
+                             const std::vector<nas_obj_id_t>& tables,
+                             size_t num_entries, const bench_mix_t& mix, size_t batch)
+{
+    std::vector<nas_obj_id_t> ids;
+    uint64_t                  elapsed_ns;
+    ut_entry_t                ut_entry {};
+
+    ids.reserve (num_entries);
+    size_t rss_before = bench_rss_bytes ();
+
+    bool ok = bench_commit (num_entries, batch, &elapsed_ns,
+        [&] (cps_api_transaction_params_t* params, size_t idx) {
+            auto table_id = bench_table_of (tables, idx);
+            auto obj = bench_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                         table_id);
+            if (obj == NULL) return false;
+
+            bench_fill_ut_entry (ut_entry, table_id, mix, idx);
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, ut_entry.priority);
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_NPU_ID_LIST, 0);
+
+            if (!ut_fill_entry_match (obj, ut_entry) ||
+                !ut_fill_entry_action (obj, ut_entry)) {
+                cps_api_object_delete (obj);
+                return false;
+            }
+            return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+        }, &ids, BASE_ACL_ENTRY_ID);
+
+    if (!ok) return false;
+
+    bench_report (state, "entry_create", num_entries, elapsed_ns);
+    size_t rss_after = bench_rss_bytes ();
+    state.counters["entry_bytes"] =
+        (rss_after > rss_before) ? (double) (rss_after - rss_before) / num_entries : 0;
+
+    // Full object modify - new priority
+    ok = bench_commit (num_entries, batch, &elapsed_ns,
+        [&] (cps_api_transaction_params_t* params, size_t idx) {
+            auto obj = bench_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                         bench_table_of (tables, idx));
+            if (obj == NULL) return false;
+
+            cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                                  &ids[idx], sizeof (uint64_t));
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, idx + 1);
+            return (cps_api_set (params, obj) == cps_api_ret_code_OK);
+        });
+
+    if (!ok) return false;
+    bench_report (state, "entry_modify", num_entries, elapsed_ns);
+
+    // Incremental update of a single filter
+    if (mix.num_filters > 0) {
+        const auto& map_info = *nas_acl_get_filter_info (_bench_filter_pool[0]);
+
+        ok = bench_commit (num_entries, batch, &elapsed_ns,
+            [&] (cps_api_transaction_params_t* params, size_t idx) {
+                auto obj = bench_obj_create (BASE_ACL_ENTRY_MATCH, BASE_ACL_ENTRY_TABLE_ID,
+                                             bench_table_of (tables, idx));
+                if (obj == NULL) return false;
+
+                uint32_t ftype = _bench_filter_pool[0];
+                cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                                      &ids[idx], sizeof (uint64_t));
+                cps_api_set_key_data (obj, BASE_ACL_ENTRY_MATCH_TYPE,
+                                      cps_api_object_ATTR_T_U32, &ftype, sizeof (uint32_t));
+
+                ut_attr_id_list_t parent_list {map_info.val.attr_id};
+                if (!ut_copy_data_to_obj (parent_list, map_info.child_list, obj,
+                                          map_info.val.data_type, map_info.val.data_len,
+                                          {bench_filter_val (_bench_filter_pool[0], idx),
+                                           bench_filter_mask (_bench_filter_pool[0])})) {
+                    cps_api_object_delete (obj);
+                    return false;
+                }
+                return (cps_api_set (params, obj) == cps_api_ret_code_OK);
+            });
+
+        if (!ok) return false;
+        bench_report (state, "entry_filter_incr_upd", num_entries, elapsed_ns);
+    }
+
+    // Incremental update of a single action
+    if (mix.num_actions > 0) {
+        const auto& map_info = *nas_acl_get_action_info (_bench_action_pool[0]);
+
+        ok = bench_commit (num_entries, batch, &elapsed_ns,
+            [&] (cps_api_transaction_params_t* params, size_t idx) {
+                auto obj = bench_obj_create (BASE_ACL_ENTRY_ACTION, BASE_ACL_ENTRY_TABLE_ID,
+                                             bench_table_of (tables, idx));
+                if (obj == NULL) return false;
+
+                uint32_t atype = _bench_action_pool[0];
+                cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                                      &ids[idx], sizeof (uint64_t));
+                cps_api_set_key_data (obj, BASE_ACL_ENTRY_ACTION_TYPE,
+                                      cps_api_object_ATTR_T_U32, &atype, sizeof (uint32_t));
+
+                ut_attr_id_list_t parent_list {map_info.val.attr_id};
+                if (!ut_copy_data_to_obj (parent_list, map_info.child_list, obj,
+                                          map_info.val.data_type, map_info.val.data_len,
+                                          {(uint32_t) (idx % 7)})) {
+                    cps_api_object_delete (obj);
+                    return false;
+                }
+                return (cps_api_set (params, obj) == cps_api_ret_code_OK);
+            });
+
+        if (!ok) return false;
+        bench_report (state, "entry_action_incr_upd", num_entries, elapsed_ns);
+    }
+
+    // Full GET of all entries - no key, so that it spans the Tables
+    cps_api_get_params_t get_params;
+
+    if (cps_api_get_request_init (&get_params) != cps_api_ret_code_OK) {
+        return false;
+    }
+    cps_api_object_t filter = cps_api_object_list_create_obj_and_append (get_params.filters);
+    if (filter == NULL) {
+        cps_api_get_request_close (&get_params);
+        return false;
+    }
+    cps_api_key_from_attr_with_qual (cps_api_object_key (filter), BASE_ACL_ENTRY_OBJ,
+                                     cps_api_qualifier_TARGET);
+
+    uint64_t start_ns = nas_acl_perf_now_ns ();
+    auto rc = nas_acl_ut_cps_api_get (&get_params, 0);
+    elapsed_ns = nas_acl_perf_now_ns () - start_ns;
+
+    size_t num_got = cps_api_object_list_size (get_params.list);
+    cps_api_get_request_close (&get_params);
+
+    if (rc != cps_api_ret_code_OK || num_got != num_entries) {
+        printf ("Entry GET returned %zu of %zu entries\r\n", num_got, num_entries);
+        return false;
+    }
+    bench_report (state, "entry_get_all", num_entries, elapsed_ns);
+
+    if (!bench_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, BASE_ACL_ENTRY_ID,
+                       tables, ids, batch, &elapsed_ns)) {
+        return false;
+    }
+    bench_report (state, "entry_delete", num_entries, elapsed_ns);
+
+    return true;
+}
+
+static bool bench_counter_ops (benchmark::State& state,
+                               const std::vector<nas_obj_id_t>& tables,
+                               size_t num_counters, size_t batch)
+{
+    std::vector<nas_obj_id_t> ids;
+    uint64_t                  elapsed_ns;
+
+    ids.reserve (num_counters);
+
+    bool ok = bench_commit (num_counters, batch, &elapsed_ns,
+        [&] (cps_api_transaction_params_t* params, size_t idx) {
+            auto obj = bench_obj_create (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID,
+                                         bench_table_of (tables, idx));
+            if (obj == NULL) return false;
+
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_COUNTER_TYPES,
+                                         BASE_ACL_COUNTER_TYPE_PACKET);
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_COUNTER_NPU_ID_LIST, 0);
+            return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+        }, &ids, BASE_ACL_COUNTER_ID);
+
+    if (!ok) return false;
+    bench_report (state, "counter_create", num_counters, elapsed_ns);
+
+    // Counters have no modifiable attributes - Stats SET is the modify path
+    ok = bench_commit (num_counters, batch, &elapsed_ns,
+        [&] (cps_api_transaction_params_t* params, size_t idx) {
+            auto obj = bench_obj_create (BASE_ACL_STATS_OBJ, BASE_ACL_STATS_TABLE_ID,
+                                         bench_table_of (tables, idx));
+            if (obj == NULL) return false;
+
+            cps_api_set_key_data (obj, BASE_ACL_STATS_COUNTER_ID, cps_api_object_ATTR_T_U64,
+                                  &ids[idx], sizeof (uint64_t));
+            cps_api_object_attr_add_u64 (obj, BASE_ACL_STATS_MATCHED_PACKETS, 0);
+            return (cps_api_set (params, obj) == cps_api_ret_code_OK);
+        });
+
+    if (!ok) return false;
+    bench_report (state, "stats_set", num_counters, elapsed_ns);
+
+    // Stats GET - one request per counter as done by the stats poller
+    elapsed_ns = 0;
+    for (size_t idx = 0; idx < ids.size (); idx++) {
+
+        cps_api_get_params_t get_params;
+        if (cps_api_get_request_init (&get_params) != cps_api_ret_code_OK) {
+            return false;
+        }
+        auto filter = bench_obj_create (BASE_ACL_STATS_OBJ, BASE_ACL_STATS_TABLE_ID,
+                                        bench_table_of (tables, idx));
+        if (filter == NULL || !cps_api_object_list_append (get_params.filters, filter)) {
+            cps_api_get_request_close (&get_params);
+            return false;
+        }
+        cps_api_set_key_data (filter, BASE_ACL_STATS_COUNTER_ID, cps_api_object_ATTR_T_U64,
+                              &ids[idx], sizeof (uint64_t));
+
+        uint64_t start_ns = nas_acl_perf_now_ns ();
+        auto rc = nas_acl_ut_cps_api_get (&get_params, 0);
+        elapsed_ns += nas_acl_perf_now_ns () - start_ns;
+
+        cps_api_get_request_close (&get_params);
+        if (rc != cps_api_ret_code_OK) {
+            return false;
+        }
+    }
+    bench_report (state, "stats_get", num_counters, elapsed_ns);
+
+    if (!bench_delete (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID, BASE_ACL_COUNTER_ID,
+                       tables, ids, batch, &elapsed_ns)) {
+        return false;
+    }
+    bench_report (state, "counter_delete", num_counters, elapsed_ns);
+
+    return true;
+}
+
+// Builds one Entry object with num_filters Match list elements and all the
+// pool Actions, cycling through the filter pool when it runs out.
+static cps_api_object_t bench_parse_obj_create (nas_obj_id_t table_id, size_t num_filters)
+{
+    auto obj = bench_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    ut_attr_id_list_t parent_list;
+
+    for (size_t idx = 0; idx < num_filters; idx++) {
+        uint32_t   ftype = _bench_filter_pool[idx % _bench_filter_pool.size ()];
+        const auto& map_info = *nas_acl_get_filter_info ((BASE_ACL_MATCH_TYPE_t) ftype);
+
+        parent_list = {BASE_ACL_ENTRY_MATCH, idx, BASE_ACL_ENTRY_MATCH_TYPE};
+        if (!cps_api_object_e_add (obj, parent_list.data (), parent_list.size (),
+                                   cps_api_object_ATTR_T_U32, &ftype, sizeof (uint32_t))) {
+            cps_api_object_delete (obj);
+            return NULL;
+        }
+
+        parent_list.back () = map_info.val.attr_id;
+        if (!ut_copy_data_to_obj (parent_list, map_info.child_list, obj,
+                                  map_info.val.data_type, map_info.val.data_len,
+                                  {bench_filter_val ((BASE_ACL_MATCH_TYPE_t) ftype, idx),
+                                   bench_filter_mask ((BASE_ACL_MATCH_TYPE_t) ftype)})) {
+            cps_api_object_delete (obj);
+            return NULL;
+        }
+    }
+
+    ut_entry_t ut_entry {};
+    for (auto atype: _bench_action_pool) {
+        ut_entry.action_list.insert ({atype, {1}});
+    }
+    if (!ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return NULL;
+    }
+    return obj;
+}
+
+// CPS to NAS Entry parsing alone - no commit to NDI
+static bool bench_parse_ops (benchmark::State& state, nas_obj_id_t table_id,
+                             size_t count, size_t num_filters)
+{
+    const nas_acl_table* table_p =
+        nas_acl_get_switch (NAS_ACL_UT_DEF_SWITCH_ID).find_table (table_id);
+
+    auto obj = bench_parse_obj_create (table_id, num_filters);
+    if (table_p == NULL || obj == NULL) {
+        return false;
+    }
+    cps_api_object_guard g (obj);
+
+    cps_api_object_it_t it_match, it_action;
+    cps_api_object_it_begin (obj, &it_match);
+    cps_api_object_it_begin (obj, &it_action);
+    cps_api_object_it_from_attr (cps_api_object_it_find (&it_match, BASE_ACL_ENTRY_MATCH),
+                                 &it_match);
+    cps_api_object_it_from_attr (cps_api_object_it_find (&it_action, BASE_ACL_ENTRY_ACTION),
+                                 &it_action);
+
+    uint64_t match_ns = 0, action_ns = 0;
+
+    try {
+        for (size_t idx = 0; idx < count; idx++) {
+            nas_acl_entry entry {table_p};
+
+            uint64_t start_ns = nas_acl_perf_now_ns ();
+            nas_acl_set_match_list (obj, it_match, entry);
+            uint64_t mid_ns = nas_acl_perf_now_ns ();
+            nas_acl_set_action_list (obj, it_action, entry);
+            action_ns += nas_acl_perf_now_ns () - mid_ns;
+            match_ns += mid_ns - start_ns;
+        }
+    } catch (nas::base_exception& e) {
+        printf ("Entry parse failed: %s\r\n", e.err_msg.c_str ());
+        return false;
+    }
+
+    std::string name = "match_list_parse_" + std::to_string (num_filters) + "f";
+    bench_report (state, name, count, match_ns);
+    name = "action_list_parse_" + std::to_string (_bench_action_pool.size ()) + "a";
+    bench_report (state, name, count, action_ns);
+
+    return true;
+}
+
+// Match value decode and encode through the common data list against the
+// direct codec path, for the pool filters that have a direct codec.
+static bool bench_codec_ops (benchmark::State& state, nas_obj_id_t table_id, size_t count)
+{
+    auto obj = bench_parse_obj_create (table_id, _bench_filter_pool.size ());
+    if (obj == NULL) {
+        return false;
+    }
+    cps_api_object_guard g (obj);
+
+    uint64_t generic_dec_ns = 0, direct_dec_ns = 0;
+    uint64_t generic_enc_ns = 0, direct_enc_ns = 0;
+    size_t   ops = 0;
+
+    try {
+        for (size_t idx = 0; idx < _bench_filter_pool.size (); idx++) {
+            const auto& map_info = *nas_acl_get_filter_info (_bench_filter_pool[idx]);
+
+            if (map_info.decode_fn == NULL) {
+                continue;
+            }
+
+            nas::attr_list_t parent_list {BASE_ACL_ENTRY_MATCH, idx, map_info.val.attr_id};
+            nas_acl_filter_t filter {map_info.type};
+            cps_api_object_attr_t attrs [NAS_ACL_MAX_CHILD_ATTRS];
+
+            uint64_t start_ns = nas_acl_perf_now_ns ();
+            for (size_t cnt = 0; cnt < count; cnt++) {
+                auto common_data_list =
+                    nas_acl_copy_data_from_obj (obj, parent_list, map_info.val,
+                                                map_info.child_list, map_info.name);
+                (filter.*(map_info.set_fn)) (common_data_list);
+            }
+            uint64_t mid_ns = nas_acl_perf_now_ns ();
+            for (size_t cnt = 0; cnt < count; cnt++) {
+                nas_acl_get_attrs_from_obj (obj, parent_list, map_info.val,
+                                            map_info.child_list, map_info.name,
+                                            NULL, attrs);
+                map_info.decode_fn (filter, map_info.val, map_info.child_list,
+                                    attrs, map_info.name);
+            }
+            generic_dec_ns += mid_ns - start_ns;
+            direct_dec_ns += nas_acl_perf_now_ns () - mid_ns;
+
+            // Encode into a scratch object that is thrown away every round
+            for (size_t cnt = 0; cnt < count; cnt++) {
+                cps_api_object_guard enc_g (cps_api_object_create ());
+                nas_acl_common_data_list_t common_data_list;
+
+                start_ns = nas_acl_perf_now_ns ();
+                (filter.*(map_info.get_fn)) (common_data_list);
+                nas_acl_copy_data_to_obj (enc_g.get (), parent_list, map_info.val,
+                                          map_info.child_list, common_data_list);
+                generic_enc_ns += nas_acl_perf_now_ns () - start_ns;
+            }
+            for (size_t cnt = 0; cnt < count; cnt++) {
+                cps_api_object_guard enc_g (cps_api_object_create ());
+
+                start_ns = nas_acl_perf_now_ns ();
+                map_info.encode_fn (filter, enc_g.get (), parent_list, map_info.child_list);
+                direct_enc_ns += nas_acl_perf_now_ns () - start_ns;
+            }
+            ops += count;
+        }
+    } catch (nas::base_exception& e) {
+        printf ("Match value codec failed: %s\r\n", e.err_msg.c_str ());
+        return false;
+    }
+
+    bench_report (state, "match_decode_generic", ops, generic_dec_ns);
+    bench_report (state, "match_decode_direct", ops, direct_dec_ns);
+    bench_report (state, "match_encode_generic", ops, generic_enc_ns);
+    bench_report (state, "match_encode_direct", ops, direct_enc_ns);
+
+    return true;
+}
+
+static bool bench_cfg_cpu_q (uint_t queue_num, nas_obj_id_t* queue_id,
+                             nas::ndi_obj_id_table_t& ndi_ids)
+{
+    *queue_id = queue_num + 1;
+    ndi_ids[0] = queue_num;
+    return true;
+}
+
+static bool bench_cfg_cleanup (nas_obj_id_t table_id)
+{
+    nas_acl_switch&           s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+    std::vector<nas_obj_id_t> entry_ids;
+    std::vector<nas_obj_id_t> counter_ids;
+    uint64_t                  elapsed_ns;
+
+    for (const auto& entry_kv: s.entry_list (table_id)) {
+        entry_ids.push_back (entry_kv.first);
+    }
+    for (const auto& counter_kv: s.counter_list (table_id)) {
+        counter_ids.push_back (counter_kv.first);
+    }
+
+    return (bench_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, BASE_ACL_ENTRY_ID,
+                          {table_id}, entry_ids, entry_ids.size () + 1, &elapsed_ns) &&
+            bench_delete (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID,
+                          BASE_ACL_COUNTER_ID, {table_id}, counter_ids,
+                          counter_ids.size () + 1, &elapsed_ns) &&
+            bench_delete (BASE_ACL_TABLE_OBJ, 0, BASE_ACL_TABLE_ID, {0},
+                          {table_id}, 1, &elapsed_ns));
+}
+
+// Default ACL configuration committed one object per transaction - as
+// base_create_acl_entries.py does - and as the single transaction built
+// by the native loader. Without CPS IPC in the stub environment the
+// difference is only the per transaction cost inside nas-acl.
+static bool bench_cfg_load_ops (benchmark::State& state, const char* cfg_path)
+{
+    static const size_t rounds = 10;
+    nas_acl_switch&     s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    for (size_t batch: {(size_t) 1, SIZE_MAX}) {
+
+        uint64_t build_ns = 0, commit_ns = 0;
+        size_t   ops = 0;
+
+        for (size_t round = 0; round < rounds; round++) {
+
+            cps_api_transaction_params_t cfg_params;
+            nas_acl_cfg_load_stats_t     stats;
+            nas_obj_id_t                 table_id = 1;
+
+            for (const auto& table_kv: s.table_list ()) {
+                table_id = std::max (table_id, table_kv.first + 1);
+            }
+
+            if (cps_api_transaction_init (&cfg_params) != cps_api_ret_code_OK) {
+                return false;
+            }
+
+            uint64_t start_ns = nas_acl_perf_now_ns ();
+            if (nas_acl_cfg_build (cfg_path, table_id, bench_cfg_cpu_q,
+                                   &cfg_params, &stats) != NAS_ACL_E_NONE) {
+                printf ("Config build failed\r\n");
+                cps_api_transaction_close (&cfg_params);
+                return false;
+            }
+            build_ns += nas_acl_perf_now_ns () - start_ns;
+
+            size_t   count = cps_api_object_list_size (cfg_params.change_list);
+            uint64_t elapsed_ns;
+
+            bool ok = bench_commit (count, batch, &elapsed_ns,
+                [&cfg_params] (cps_api_transaction_params_t* params, size_t idx) {
+                    auto obj = cps_api_object_create ();
+                    if (obj == NULL) return false;
+
+                    cps_api_object_clone (obj, cps_api_object_list_get (
+                                                   cfg_params.change_list, idx));
+                    return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+                });
+            cps_api_transaction_close (&cfg_params);
+
+            if (!ok || !bench_cfg_cleanup (table_id)) {
+                return false;
+            }
+            commit_ns += elapsed_ns;
+            ops += count;
+        }
+
+        bench_report (state, "cfg_build", ops, build_ns);
+        bench_report (state, (batch == 1) ? "cfg_commit_per_object" :
+                                            "cfg_commit_single_txn", ops, commit_ns);
+    }
+
+    return true;
+}
+
+static bool bench_parse_args (int argc, char** argv, bench_cfg_t& cfg)
+{
+    int opt;
+
+    while ((opt = getopt (argc, argv, "n:m:b:f:x:")) != -1) {
+        char* tok;
+        char* save = NULL;
+
+        switch (opt) {
+            case 'n':
+                cfg.scales.clear ();
+                for (tok = strtok_r (optarg, ",", &save); tok != NULL;
+                     tok = strtok_r (NULL, ",", &save)) {
+                    cfg.scales.push_back (strtoul (tok, NULL, 0));
+                }
+                break;
+
+            case 'm':
+                cfg.mixes.clear ();
+                for (tok = strtok_r (optarg, ",", &save); tok != NULL;
+                     tok = strtok_r (NULL, ",", &save)) {
+                    bench_mix_t mix {0, 0};
+                    if (sscanf (tok, "%zu:%zu", &mix.num_filters, &mix.num_actions) < 1) {
+                        return false;
+                    }
+                    cfg.mixes.push_back (mix);
+                }
+                break;
+
+            case 'b':
+                cfg.batch = strtoul (optarg, NULL, 0);
+                break;
+
+            case 'f':
+                cfg.parse_filters = strtoul (optarg, NULL, 0);
+                break;
+
+            case 'x':
+                cfg.cfg_path = optarg;
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    return (!cfg.scales.empty () && !cfg.mixes.empty () && cfg.batch > 0);
+}
+
+// Each registered benchmark runs its phases once - they time themselves
+template <typename F>
+static void bench_register (const std::string& name, F fn)
+{
+    benchmark::RegisterBenchmark (name.c_str (), [fn] (benchmark::State& state) {
+        while (state.KeepRunning ()) {
+            if (!fn (state)) {
+                state.SkipWithError ("Benchmark failed");
+                break;
+            }
+        }
+    })->Iterations (1)->Unit (benchmark::kMillisecond);
+}
+
+int main (int argc, char** argv)
+{
+    bench_cfg_t cfg {{1000, 10000, 100000}, {{2, 1}, {8, 4}}, 1000, 32, NULL};
+
+    benchmark::Initialize (&argc, argv);
+
+    if (!bench_parse_args (argc, argv, cfg)) {
+        printf ("Usage: %s [-n scale,...] [-m filters:actions,...] [-b batch]"
+                " [-f parse-filters] [-x cfg-dir] [--benchmark_...]\r\n", argv[0]);
+        return 1;
+    }
+
+    ut_print_set_status (false);
+    nas_acl_ut_env_init ();
+
+    if (cfg.cfg_path != NULL) {
+        const char* cfg_path = cfg.cfg_path;
+        bench_register ("cfg_load", [cfg_path] (benchmark::State& state) {
+            return bench_cfg_load_ops (state, cfg_path);
+        });
+    }
+
+    size_t max_scale = 0;
+    for (auto scale: cfg.scales) {
+        max_scale = std::max (max_scale, scale);
+    }
+
+    std::vector<nas_obj_id_t> tables;
+    if (!bench_table_create ((max_scale + _bench_per_table - 1) / _bench_per_table,
+                             &tables)) {
+        printf ("Benchmark table create failed\r\n");
+        return 1;
+    }
+    nas_obj_id_t table_id = tables.at (0);
+    // Table create/delete takes the Table IDs the Entry Tables leave
+    size_t max_tables = nas_acl_switch::NAS_ACL_TABLE_ID_MAX - tables.size () - 1;
+
+    for (auto scale: cfg.scales) {
+
+        std::string sfx = "/n:" + std::to_string (scale);
+        size_t      batch = cfg.batch;
+        size_t      parse_filters = cfg.parse_filters;
+
+        bench_register ("table_ops" + sfx, [=] (benchmark::State& state) {
+            return bench_table_ops (state, std::min (scale, max_tables), batch);
+        });
+        bench_register ("counter_ops" + sfx, [=] (benchmark::State& state) {
+            return bench_counter_ops (state, tables, scale, batch);
+        });
+        bench_register ("parse_ops" + sfx, [=] (benchmark::State& state) {
+            return bench_parse_ops (state, table_id, scale, parse_filters);
+        });
+        bench_register ("codec_ops" + sfx, [=] (benchmark::State& state) {
+            return bench_codec_ops (state, table_id, scale);
+        });
+
+        for (const auto& mix: cfg.mixes) {
+            bench_register ("entry_ops" + sfx + "/mix:" +
+                            std::to_string (mix.num_filters) + ":" +
+                            std::to_string (mix.num_actions),
+                            [=] (benchmark::State& state) {
+                return bench_entry_ops (state, tables, scale, mix, batch);
+            });
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks ();
+    benchmark::Shutdown ();
+
+    return 0;
+}
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_switch_list.h"
+#include "nas_acl_cfg_load.h"
+#include <sys/stat.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string>
+
+#define UT_CFG_DIR          "/tmp/nas_acl_ut_cfg"
+#define UT_CFG_QUEUE_BASE   100
+
+static const char* _ut_cfg_master =
+    "<?xml version=\"1.0\" ?>\n"
+    "<!-- UT master list -->\n"
+    "<root>\n"
+    "    <INGRESS>\n"
+    "        <table tag=\"ut-flow\" priority=\"7\">\n"
+    "            <entry tag=\"bgp\"  cpu-q=\"9\" action=\"TRAP_TO_CPU\"/>\n"
+    "            <entry tag=\"host\" cpu-q=\"5\" />\n"
+    "            <entry tag=\"stp\"  priority=\"100\" />\n"
+    "        </table>\n"
+    "    </INGRESS>\n"
+    "    <EGRESS>\n"
+    "    </EGRESS>\n"
+    "</root>\n";
+
+static const char* _ut_cfg_detail =
+    "<?xml version=\"1.0\" ?>\n"
+    "<root>\n"
+    "    <table tag=\"ut-flow\">\n"
+    "        <allow-match>SRC_IP</allow-match>\n"
+    "        <allow-match>L4_DST_PORT</allow-match>\n"
+    "        <allow-match>IP_TYPE</allow-match>\n"
+    "        <allow-match>DST_MAC</allow-match>\n"
+    "    </table>\n"
+    "    <entry tag=\"bgp\">\n"
+    "        <match type=\"L4_DST_PORT\">\n"
+    "            <value><data>179</data><mask>0xffff</mask></value>\n"
+    "        </match>\n"
+    "        <match type=\"IP_TYPE\"><value>IP</value></match>\n"
+    "    </entry>\n"
+    "    <entry tag=\"host\">\n"
+    "        <match type=\"SRC_IP\">\n"
+    "            <value><addr>10.0.0.1</addr><mask>255.255.255.0</mask></value>\n"
+    "        </match>\n"
+    "    </entry>\n"
+    "    <entry tag=\"stp\">\n"
+    "        <match type=\"DST_MAC\">\n"
+    "            <value><addr>01:80:c2:00:00:00</addr></value>\n"
+    "        </match>\n"
+    "        <action type=\"PACKET_ACTION\"><value>DROP</value></action>\n"
+    "    </entry>\n"
+    "</root>\n";
+
+static bool ut_cfg_cpu_q (uint_t queue_num, nas_obj_id_t* queue_id,
+                          nas::ndi_obj_id_table_t& ndi_ids)
+{
+    *queue_id = UT_CFG_QUEUE_BASE + queue_num;
+    ndi_ids[0] = queue_num;
+    return true;
+}
+
+static bool ut_cfg_file_write (const char* name, const char* content)
+{
+    std::string path = std::string (UT_CFG_DIR "/") + name;
+    FILE*       fp = fopen (path.c_str (), "w");
+
+    if (fp == NULL) {
+        return false;
+    }
+    bool ok = (fputs (content, fp) >= 0);
+    fclose (fp);
+
+    return ok;
+}
+
+static bool ut_cfg_verify (nas_obj_id_t table_id)
+{
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+    nas_acl_table*  table = s.find_table (table_id);
+
+    if (table == NULL || table->stage () != BASE_ACL_STAGE_INGRESS ||
+        table->priority () != 7 || s.counter_list (table_id).size () != 2 ||
+        s.entry_list (table_id).size () != 3) {
+        ut_printf ("%s(): Table %lu not created as configured\r\n",
+                   __FUNCTION__, table_id);
+        return false;
+    }
+
+    // Entries without a priority count down from the default
+    for (const auto& entry_kv: s.entry_list (table_id)) {
+
+        const nas_acl_entry& entry = entry_kv.second;
+        const auto&          alist = entry.get_action_list ();
+
+        switch (entry.priority ()) {
+            case NAS_ACL_CFG_ENTRY_PRIO:
+                if (entry.get_filter_list ().size () != 2 || alist.size () != 3 ||
+                    alist.count (BASE_ACL_ACTION_TYPE_SET_CPU_QUEUE) == 0 ||
+                    alist.count (BASE_ACL_ACTION_TYPE_PACKET_ACTION) == 0 ||
+                    entry.counter_id () == 0) {
+                    ut_printf ("%s(): Bad CPU Entry\r\n", __FUNCTION__);
+                    return false;
+                }
+                break;
+
+            case NAS_ACL_CFG_ENTRY_PRIO - 1:
+                if (entry.get_filter_list ().size () != 1 || alist.size () != 2 ||
+                    entry.counter_id () == 0) {
+                    ut_printf ("%s(): Bad CPU Entry without packet action\r\n",
+                               __FUNCTION__);
+                    return false;
+                }
+                break;
+
+            case 100:
+                if (entry.get_filter_list ().size () != 1 || alist.size () != 1 ||
+                    alist.count (BASE_ACL_ACTION_TYPE_PACKET_ACTION) == 0) {
+                    ut_printf ("%s(): Bad Entry with detail list action\r\n",
+                               __FUNCTION__);
+                    return false;
+                }
+                break;
+
+            default:
+                ut_printf ("%s(): Unexpected Entry priority %d\r\n",
+                           __FUNCTION__, entry.priority ());
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static bool ut_cfg_cleanup (nas_obj_id_t table_id)
+{
+    nas_acl_switch&              s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+    cps_api_transaction_params_t params;
+    std::vector<nas_obj_id_t>    entry_ids;
+    std::vector<nas_obj_id_t>    counter_ids;
+
+    if (s.find_table (table_id) == NULL) {
+        return true;
+    }
+    for (const auto& entry_kv: s.entry_list (table_id)) {
+        entry_ids.push_back (entry_kv.first);
+    }
+    for (const auto& counter_kv: s.counter_list (table_id)) {
+        counter_ids.push_back (counter_kv.first);
+    }
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj_delete = [&params, table_id] (cps_api_attr_id_t obj_attr,
+                                           cps_api_attr_id_t table_attr,
+                                           cps_api_attr_id_t id_attr,
+                                           nas_obj_id_t id) {
+        cps_api_object_t obj = cps_api_object_create ();
+        if (obj == NULL) return false;
+
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != id_attr) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+        cps_api_set_key_data (obj, id_attr, cps_api_object_ATTR_T_U64,
+                              &id, sizeof (uint64_t));
+        return (cps_api_delete (&params, obj) == cps_api_ret_code_OK);
+    };
+
+    bool ok = true;
+    for (auto id: entry_ids) {
+        ok = ok && obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                               BASE_ACL_ENTRY_ID, id);
+    }
+    for (auto id: counter_ids) {
+        ok = ok && obj_delete (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID,
+                               BASE_ACL_COUNTER_ID, id);
+    }
+    ok = ok && obj_delete (BASE_ACL_TABLE_OBJ, BASE_ACL_TABLE_ID,
+                           BASE_ACL_TABLE_ID, table_id);
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+bool nas_acl_ut_cfg_load_test ()
+{
+    cps_api_transaction_params_t params;
+    nas_acl_cfg_load_stats_t     stats {};
+    nas_obj_id_t                 table_id = 0;
+    bool                         ok = false;
+
+    mkdir (UT_CFG_DIR, 0755);
+
+    do {
+        if (!ut_cfg_file_write (NAS_ACL_CFG_MASTER_FILE, _ut_cfg_master) ||
+            !ut_cfg_file_write (NAS_ACL_CFG_DETAIL_FILE, _ut_cfg_detail)) {
+            ut_printf ("%s(): Config file write failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+        table_id = 1;
+        for (const auto& table_kv: s.table_list ()) {
+            table_id = std::max (table_id, table_kv.first + 1);
+        }
+
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+
+        // Counters ahead of their Entries - all in one transaction
+        if (nas_acl_cfg_build (UT_CFG_DIR, table_id, ut_cfg_cpu_q,
+                               &params, &stats) != NAS_ACL_E_NONE) {
+            ut_printf ("%s(): Build failed\r\n", __FUNCTION__);
+            cps_api_transaction_close (&params);
+            break;
+        }
+        if (stats.tables != 1 || stats.counters != 2 || stats.entries != 3 ||
+            cps_api_object_list_size (params.change_list) != 6) {
+            ut_printf ("%s(): Built %zu Tables %zu Counters %zu Entries\r\n",
+                       __FUNCTION__, stats.tables, stats.counters, stats.entries);
+            cps_api_transaction_close (&params);
+            break;
+        }
+
+        auto rc = nas_acl_ut_cps_api_commit (&params, true);
+        cps_api_transaction_close (&params);
+
+        if (rc != cps_api_ret_code_OK || !ut_cfg_verify (table_id)) {
+            break;
+        }
+
+        // Unknown Match type fails the whole build
+        std::string bad_detail {_ut_cfg_detail};
+        bad_detail.replace (bad_detail.find ("\"IP_TYPE\""), 9, "\"NO_TYPE\"");
+
+        if (!ut_cfg_file_write (NAS_ACL_CFG_DETAIL_FILE, bad_detail.c_str ()) ||
+            cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+        t_std_error err = nas_acl_cfg_build (UT_CFG_DIR, table_id + 1, ut_cfg_cpu_q,
+                                             &params, &stats);
+        cps_api_transaction_close (&params);
+
+        if (err == NAS_ACL_E_NONE) {
+            ut_printf ("%s(): Unknown Match type accepted\r\n", __FUNCTION__);
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    if (table_id != 0 && !ut_cfg_cleanup (table_id)) {
+        ut_printf ("%s(): Cleanup failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    unlink (UT_CFG_DIR "/" NAS_ACL_CFG_MASTER_FILE);
+    unlink (UT_CFG_DIR "/" NAS_ACL_CFG_DETAIL_FILE);
+    rmdir (UT_CFG_DIR);
+
+    return ok;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+#include "nas_acl_cps_ut.h"
+
+#include <string.h>
+
+static bool ut_check_bytes (const nas_acl_common_data_t& data,
+                            const uint8_t* bytes, size_t len, const char* what)
+{
+    if (data.bytes_size () != len || memcmp (data.bytes_data (), bytes, len) != 0) {
+        ut_printf ("%s(): %s - bytes mismatch, size %ld expected %ld\r\n",
+                   __FUNCTION__, what, data.bytes_size (), len);
+        return false;
+    }
+    return true;
+}
+
+// Inline and heap byte strings, lists and NDI object ID tables must survive
+// copy, move and being switched from one kind of value to another
+bool nas_acl_ut_common_data_test ()
+{
+    uint8_t ipv6 [16];
+    uint8_t opaque [64];
+
+    for (size_t idx = 0; idx < sizeof (opaque); idx++) {
+        opaque[idx] = idx;
+    }
+    memset (ipv6, 0xfe, sizeof (ipv6));
+
+    nas_acl_common_data_list_t data_list (4);
+
+    data_list[0].u32 = 0xdeadbeef;
+    data_list[1].set_bytes (ipv6, sizeof (ipv6));
+    data_list[2].set_bytes (opaque, sizeof (opaque));
+    data_list[3].ifindex_list () = {10, 20, 30};
+
+    // Force a reallocation - elements get moved
+    data_list.resize (64);
+
+    auto copy_list = data_list;
+    data_list.clear ();
+
+    const auto& const_list = copy_list;
+    if (copy_list[0].u32 != 0xdeadbeef || copy_list[0].bytes_size () != 0 ||
+        !ut_check_bytes (copy_list[1], ipv6, sizeof (ipv6), "inline") ||
+        !ut_check_bytes (copy_list[2], opaque, sizeof (opaque), "heap") ||
+        const_list[3].ifindex_list () != nas::ifindex_list_t ({10, 20, 30}) ||
+        !const_list[2].ifindex_list ().empty ()) {
+        ut_printf ("%s(): copied list mismatch\r\n", __FUNCTION__);
+        return false;
+    }
+
+    nas_acl_common_data_t data;
+    data.fill_bytes (0xff, 6);
+    data.ndi_obj_id_table () [0] = 100;
+    if (data.bytes_size () != 0 || data.ndi_obj_id_table ().size () != 1) {
+        ut_printf ("%s(): switch to NDI object ID table failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    data = std::move (copy_list[2]);
+    const auto& const_data = data;
+    if (!ut_check_bytes (data, opaque, sizeof (opaque), "moved") ||
+        copy_list[2].bytes_size () != 0 || !const_data.ndi_obj_id_table ().empty ()) {
+        ut_printf ("%s(): move of heap bytes failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    data.set_bytes (ipv6, sizeof (ipv6));
+    return ut_check_bytes (data, ipv6, sizeof (ipv6), "heap to inline");
+}
@@ -558,6 +558,18 @@ static bool ut_validate_sub_data (cps_api_object_t      obj,
     return true;
 }
 
+// Value and Mask filters are stored with the value bits outside the mask
+// cleared. The UT byte string values are all bytes of the same u8, so
+// masking the u32 gives the expected value for every width.
+static ut_val_list_t ut_filter_expected_val_list (const nas_acl_filter_info_t& map_info,
+                                                  const ut_val_list_t& val_list)
+{
+    if (map_info.decode_fn == NULL || val_list.size () < 2) {
+        return val_list;
+    }
+    return ut_val_list_t {val_list.at (0) & val_list.at (1), val_list.at (1)};
+}
+
 bool ut_validate_non_iflist_data (ut_attr_id_list_t&             parent_list,
                                   const nas_acl_map_data_list_t& child_list,
                                   cps_api_object_t               obj,
@@ -1035,15 +1047,15 @@ bool ut_validate_entry_filter_list (const cps_api_object_t     obj,
 
         parent_attr_id_list.push_back (match_val_attr_id);
 
-        const auto& map_kv = nas_acl_get_filter_map().find (match_type_val);
+        auto map_info_p = nas_acl_get_filter_info (match_type_val);
 
-        if (map_kv == nas_acl_get_filter_map().end ()) {
+        if (map_info_p == NULL) {
             ut_printf ("%s(): Unknown Filter (%d).\r\n",
                        __FUNCTION__, match_type_val);
             return false;
         }
 
-        const nas_acl_filter_info_t& map_info = map_kv->second;
+        const nas_acl_filter_info_t& map_info = *map_info_p;
         filter_found = false;
 
         for (auto& filter: entry.filter_list) {
@@ -1056,7 +1068,8 @@ bool ut_validate_entry_filter_list (const cps_api_object_t     obj,
                                        obj,
                                        map_info.val.data_type,
                                        map_info.val.data_len,
-                                       filter.val_list)) {
+                                       ut_filter_expected_val_list (map_info,
+                                                                    filter.val_list))) {
                     return false;
                 }
 
@@ -1121,14 +1134,14 @@ bool ut_validate_entry_action_list (const cps_api_object_t     obj,
         action_type_val = (BASE_ACL_ACTION_TYPE_t)
             cps_api_object_attr_data_u32 (it_lvl_2.attr);
 
-        const auto& map_kv = nas_acl_get_action_map().find (action_type_val);
+        auto map_info_p = nas_acl_get_action_info (action_type_val);
 
-        if (map_kv == nas_acl_get_action_map().end ()) {
+        if (map_info_p == NULL) {
             ut_printf ("%s failed at %d for %d\r\n", __FUNCTION__, __LINE__, action_type_val);
             return false;
         }
 
-        const nas_acl_action_info_t& map_info = map_kv->second;
+        const nas_acl_action_info_t& map_info = *map_info_p;
 
         cps_api_object_it_next (&it_lvl_2);
 
@@ -1193,14 +1206,14 @@ bool ut_fill_entry_match (cps_api_object_t obj, const ut_entry_t& entry)
 
     for (const auto& filter: entry.filter_list) {
 
-        const auto& map_kv = nas_acl_get_filter_map().find (filter.type);
+        auto map_info_p = nas_acl_get_filter_info (filter.type);
 
-        if (map_kv == nas_acl_get_filter_map().end ()) {
+        if (map_info_p == NULL) {
             ut_printf ("FAILED: Could not Find filter type %d\r\n", filter.type);
             return false;
         }
 
-        const nas_acl_filter_info_t& map_info = map_kv->second;
+        const nas_acl_filter_info_t& map_info = *map_info_p;
 
         parent_list.clear ();
 
@@ -1243,14 +1256,14 @@ bool ut_fill_entry_action (cps_api_object_t obj, const ut_entry_t& entry)
 
     for (const auto& action: entry.action_list) {
 
-        const auto& map_kv = nas_acl_get_action_map ().find (action.type);
+        auto map_info_p = nas_acl_get_action_info (action.type);
 
-        if (map_kv == nas_acl_get_action_map().end ()) {
+        if (map_info_p == NULL) {
             ut_printf ("FAILED: Could not Find action type %d\r\n", action.type);
             return false;
         }
 
-        const nas_acl_action_info_t& map_info = map_kv->second;
+        const nas_acl_action_info_t& map_info = *map_info_p;
 
         parent_list.clear ();
 
@@ -1616,15 +1629,12 @@ validate_entry_cps_resp(uint_t op, ut_entry_t& entry, cps_api_object_t prev_obj)
         return false;
     }
 
-    if (op == NAS_ACL_UT_CREATE) {
-        return true;
-    }
-
-    if (op != NAS_ACL_UT_CREATE) {
-        if (validate_entry_obj (prev_obj, entry) != true) {
-            ut_printf ("%s(): validate_entry_obj failed.\r\n", __FUNCTION__);
-            return false;
-        }
+    // The transaction has ended and dropped its undo journal - prev
+    // carries only the key of a modified or deleted Entry
+    if (op != NAS_ACL_UT_CREATE &&
+        cps_api_object_attr_get (prev_obj, BASE_ACL_ENTRY_PRIORITY) != NULL) {
+        ut_printf ("%s(): Entry left in prev.\r\n", __FUNCTION__);
+        return false;
     }
 
     return true;
@@ -2452,14 +2462,14 @@ static void _cps_fill_action_upd_key (cps_api_object_t obj, const ut_entry_t& en
 static bool _cps_fill_filter_upd (cps_api_object_t obj, const ut_entry_t& entry,
         const ut_filter_info_t& filter)
 {
-    const auto& map_kv = nas_acl_get_filter_map().find (filter.type);
+    auto map_info_p = nas_acl_get_filter_info (filter.type);
 
-    if (map_kv == nas_acl_get_filter_map().end ()) {
+    if (map_info_p == NULL) {
         ut_printf ("FAILED: Could not Find filter type %d\r\n", filter.type);
         return false;
     }
 
-    const nas_acl_filter_info_t& map_info = map_kv->second;
+    const nas_acl_filter_info_t& map_info = *map_info_p;
     ut_attr_id_list_t             parent_list;
 
     parent_list.push_back (map_info.val.attr_id);
@@ -2478,14 +2488,14 @@ static bool _cps_fill_filter_upd (cps_api_object_t obj, const ut_entry_t& entry,
 static bool _cps_fill_action_upd (cps_api_object_t obj, const ut_entry_t& entry,
         const ut_action_info_t& action)
 {
-    const auto& map_kv = nas_acl_get_action_map().find (action.type);
+    auto map_info_p = nas_acl_get_action_info (action.type);
 
-    if (map_kv == nas_acl_get_action_map().end ()) {
+    if (map_info_p == NULL) {
         ut_printf ("FAILED: Could not Find filter type %d\r\n", action.type);
         return false;
     }
 
-    const nas_acl_action_info_t& map_info = map_kv->second;
+    const nas_acl_action_info_t& map_info = *map_info_p;
     ut_attr_id_list_t             parent_list;
 
     parent_list.push_back (map_info.val.attr_id);
@@ -2589,3 +2599,48 @@ bool nas_acl_ut_entry_incr_modify_test (nas_acl_ut_table_t& table)
     ut_printf ("********** ACL Entry Incremental Modify TEST PASSED ************\r\n\n");
     return true;
 }
+
+bool nas_acl_ut_attr_index_test ()
+{
+    cps_api_object_t obj = cps_api_object_create ();
+    if (obj == NULL) {
+        return false;
+    }
+    cps_api_object_guard g (obj);
+
+    // Match list element 0 with a duplicate MATCH_TYPE
+    uint32_t          ftype = BASE_ACL_MATCH_TYPE_IP_PROTOCOL;
+    uint8_t           proto = 6;
+    ut_attr_id_list_t parent_list {BASE_ACL_ENTRY_MATCH, 0, BASE_ACL_ENTRY_MATCH_TYPE};
+
+    for (int count = 0; count < 2; count++) {
+        cps_api_object_e_add (obj, parent_list.data (), parent_list.size (),
+                              cps_api_object_ATTR_T_U32, &ftype, sizeof (uint32_t));
+    }
+    parent_list.back () = BASE_ACL_ENTRY_MATCH_IP_PROTOCOL_VALUE;
+    parent_list.push_back (BASE_ACL_ENTRY_MATCH_IP_PROTOCOL_VALUE_DATA);
+    cps_api_object_e_add (obj, parent_list.data (), parent_list.size (),
+                          cps_api_object_ATTR_T_BIN, &proto, sizeof (proto));
+
+    parent_list.resize (2);
+
+    cps_api_object_it_t it;
+    if (!cps_api_object_it (obj, parent_list.data (), parent_list.size (), &it)) {
+        return false;
+    }
+    cps_api_object_it_inside (&it);
+
+    nas_acl_attr_index_t attr_index;
+    attr_index.build (it);
+
+    if (attr_index.find (BASE_ACL_ENTRY_MATCH_TYPE) == NULL ||
+        !attr_index.is_dupl (BASE_ACL_ENTRY_MATCH_TYPE) ||
+        attr_index.find (BASE_ACL_ENTRY_MATCH_IP_PROTOCOL_VALUE) == NULL ||
+        attr_index.is_dupl (BASE_ACL_ENTRY_MATCH_IP_PROTOCOL_VALUE) ||
+        attr_index.find (BASE_ACL_ENTRY_MATCH_DSCP_VALUE) != NULL) {
+        ut_printf ("%s(): Bad attribute index\r\n", __FUNCTION__);
+        return false;
+    }
+
+    return true;
+}
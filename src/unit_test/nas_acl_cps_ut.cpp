@@ -197,6 +197,128 @@ TEST (nas_acl_entry, incr_modify_test)
     ASSERT_TRUE (rc);
 }
 
+TEST (nas_acl_entry, attr_index_test)
+{
+    ASSERT_TRUE (nas_acl_ut_attr_index_test ());
+}
+
+TEST (nas_acl_port_range, expand_test)
+{
+    ASSERT_TRUE (nas_acl_ut_port_range_expand_test ());
+}
+
+TEST (nas_acl_port_range, expn_test)
+{
+    ASSERT_TRUE (nas_acl_ut_port_range_expn_test ());
+}
+
+TEST (nas_acl_perf, hist_test)
+{
+    ASSERT_TRUE (nas_acl_ut_perf_hist_test ());
+}
+
+TEST (nas_acl_perf, stats_get_test)
+{
+    ASSERT_TRUE (nas_acl_ut_perf_stats_get_test ());
+}
+
+TEST (nas_acl_common_data, copy_move_test)
+{
+    ASSERT_TRUE (nas_acl_ut_common_data_test ());
+}
+
+TEST (nas_acl_pool, slab_reuse_test)
+{
+    ASSERT_TRUE (nas_acl_ut_pool_test ());
+}
+
+TEST (nas_acl_warm, checkpoint_adopt_test)
+{
+    ASSERT_TRUE (nas_acl_ut_warm_test ());
+}
+
+TEST (nas_acl_cfg_load, xml_bulk_load_test)
+{
+    ASSERT_TRUE (nas_acl_ut_cfg_load_test ());
+}
+
+TEST (nas_acl_apply, table_reconcile_test)
+{
+    ASSERT_TRUE (nas_acl_ut_apply_test ());
+}
+
+TEST (nas_acl_event, coalesced_event_test)
+{
+    ASSERT_TRUE (nas_acl_ut_event_test ());
+}
+
+TEST (nas_acl_async, queued_entry_write_test)
+{
+    ASSERT_TRUE (nas_acl_ut_async_test ());
+}
+
+TEST (nas_acl_txn_lock, txn_scoped_lock_test)
+{
+    ASSERT_TRUE (nas_acl_ut_txn_lock_test ());
+}
+
+TEST (nas_acl_lock, table_lock_test)
+{
+    ASSERT_TRUE (nas_acl_ut_table_lock_test ());
+}
+
+TEST (nas_acl_hw_res, quota_and_capacity_test)
+{
+    ASSERT_TRUE (nas_acl_ut_hw_res_test ());
+}
+
+TEST (nas_acl_get_page, cursor_walk_test)
+{
+    ASSERT_TRUE (nas_acl_ut_get_page_test ());
+}
+
+TEST (nas_acl_entry_query, indexed_query_test)
+{
+    ASSERT_TRUE (nas_acl_ut_entry_query_test ());
+}
+
+TEST (nas_acl_intf, reprogram_test)
+{
+    ASSERT_TRUE (nas_acl_ut_intf_reprogram_test ());
+}
+
+TEST (nas_acl_intf, refresh_test)
+{
+    ASSERT_TRUE (nas_acl_ut_intf_refresh_test ());
+}
+
+TEST (nas_acl_undo, journal_test)
+{
+    ASSERT_TRUE (nas_acl_ut_undo_journal_test ());
+}
+
+TEST (nas_acl_prepare, txn_prepare_test)
+{
+    ASSERT_TRUE (nas_acl_ut_txn_prepare_test ());
+}
+
+TEST (nas_acl_entry_npu, port_narrowing_test)
+{
+    ASSERT_TRUE (nas_acl_ut_entry_npu_test ());
+}
+
+// Seed and length can be overridden to reproduce or extend a soak run
+TEST (nas_acl_soak, random_txn_test)
+{
+    const char* seed_str  = getenv ("NAS_ACL_UT_SOAK_SEED");
+    const char* steps_str = getenv ("NAS_ACL_UT_SOAK_STEPS");
+
+    uint32_t seed  = (seed_str) ? strtoul (seed_str, NULL, 0) : 0x5eed;
+    size_t   steps = (steps_str) ? strtoul (steps_str, NULL, 0) : 2000;
+
+    ASSERT_TRUE (nas_acl_ut_soak_test (seed, steps)) << "Soak seed " << seed;
+}
+
 int main(int argc, char **argv)
 {
     nas_acl_ut_env_init ();
@@ -37,6 +37,9 @@
         (NAS_ACL_UT_END_FILTER - NAS_ACL_UT_START_FILTER + 1)
 #define NAS_ACL_UT_MAX_NPUS      1
 #define NAS_ACL_UT_NUM_PORTS_PER_NPU 8
+// Ports are registered in more NPUs than the switch has so that Tables
+// can be put in several NPUs and NPU specific Entries narrowed
+#define NAS_ACL_UT_NUM_PORT_NPUS 2
 
 #define NAS_ACL_UT_START_ACTION BASE_ACL_ACTION_TYPE_REDIRECT_PORT
 #define NAS_ACL_UT_END_ACTION   BASE_ACL_ACTION_TYPE_SET_CPU_QUEUE
@@ -133,7 +136,15 @@ bool nas_acl_ut_entry_incr_modify_test (nas_acl_ut_table_t& table);
 bool nas_acl_ut_entry_get_by_table_test (nas_acl_ut_table_t& table);
 bool nas_acl_ut_entry_get_by_switch_test (nas_switch_id_t switch_id);
 bool nas_acl_ut_entry_get_all_test ();
+bool nas_acl_ut_attr_index_test ();
+bool ut_fill_entry_match (cps_api_object_t obj, const ut_entry_t& entry);
 bool ut_fill_entry_action (cps_api_object_t obj, const ut_entry_t& entry);
+bool ut_copy_data_to_obj (ut_attr_id_list_t&             parent_list,
+                          const nas_acl_map_data_list_t& child_list,
+                          cps_api_object_t               obj,
+                          NAS_ACL_DATA_TYPE_t            obj_data_type,
+                          size_t                         obj_data_size,
+                          const ut_val_list_t&           val_list);
 
 void nas_acl_ut_init_tables ();
 bool nas_acl_ut_table_create ();
@@ -150,6 +161,28 @@ bool nas_acl_ut_counter_delete (nas_acl_ut_table_t& table);
 bool nas_acl_ut_stats_get_test (nas_acl_ut_table_t& table);
 bool nas_acl_ut_stats_set_test (nas_acl_ut_table_t& table);
 bool nas_acl_ut_entry_count_enable (nas_acl_ut_table_t& table, bool pkt, bool byte);
+bool nas_acl_ut_port_range_expand_test ();
+bool nas_acl_ut_port_range_expn_test ();
+bool nas_acl_ut_perf_hist_test ();
+bool nas_acl_ut_perf_stats_get_test ();
+bool nas_acl_ut_soak_test (uint32_t seed, size_t steps);
+bool nas_acl_ut_common_data_test ();
+bool nas_acl_ut_pool_test ();
+bool nas_acl_ut_warm_test ();
+bool nas_acl_ut_cfg_load_test ();
+bool nas_acl_ut_apply_test ();
+bool nas_acl_ut_event_test ();
+bool nas_acl_ut_async_test ();
+bool nas_acl_ut_txn_lock_test ();
+bool nas_acl_ut_table_lock_test ();
+bool nas_acl_ut_hw_res_test ();
+bool nas_acl_ut_get_page_test ();
+bool nas_acl_ut_entry_query_test ();
+bool nas_acl_ut_intf_reprogram_test ();
+bool nas_acl_ut_intf_refresh_test ();
+bool nas_acl_ut_undo_journal_test ();
+bool nas_acl_ut_txn_prepare_test ();
+bool nas_acl_ut_entry_npu_test ();
 
 bool ut_print_is_enabled ();
 void ut_print_set_status (bool);
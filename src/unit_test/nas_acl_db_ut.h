@@ -20,6 +20,8 @@
 #define _NAS_ACL_DB_UT_H_
 
 #include "nas_ndi_obj_id_table.h"
+#include <set>
+#include <utility>
 
 #define UT_RESET_NPU  100
 #define UT_RESET_FTYPE 100
@@ -31,4 +33,11 @@ int& ut_simulate_ndi_entry_filter_error_npu();
 int& ut_simulate_ndi_entry_filter_error_ftype();
 int& ut_simulate_ndi_entry_action_error_npu();
 int& ut_simulate_ndi_entry_action_error_atype ();
+
+// NDI entries currently installed in the stub - (NPU, NDI Entry ID)
+typedef std::set<std::pair<npu_id_t, ndi_obj_id_t>> ut_ndi_entry_id_set_t;
+const ut_ndi_entry_id_set_t& ut_ndi_entry_live_ids ();
+
+// NDI calls that create, modify or delete an entry
+size_t ut_ndi_entry_write_count ();
 #endif
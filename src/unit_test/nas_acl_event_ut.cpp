@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_event.h"
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#define UT_EVENT_NPU        0
+#define UT_EVENT_ENTRY_ID   100
+#define UT_EVENT_BAD_ENTRY  4000
+
+// Object Type, Operation, Table Id, Object Id
+typedef std::tuple<uint32_t, uint32_t, nas_obj_id_t, nas_obj_id_t> ut_event_change_t;
+
+typedef struct _ut_event_t {
+    uint64_t                        seq;
+    bool                            overflow;
+    std::vector<ut_event_change_t>  changes;
+} ut_event_t;
+
+static std::vector<ut_event_t> _ut_events;
+
+static bool ut_event_capture (cps_api_object_t obj)
+{
+    ut_event_t event {};
+
+    auto attr = cps_api_object_attr_get (obj, BASE_ACL_EVENT_SEQUENCE);
+    event.seq = (attr != NULL) ? cps_api_object_attr_data_u64 (attr) : 0;
+
+    attr = cps_api_object_attr_get (obj, BASE_ACL_EVENT_OVERFLOW);
+    event.overflow = (attr != NULL) && (cps_api_object_attr_data_u32 (attr) != 0);
+
+    // Change-List-Attr . ListIndex . Change-Child-Attr
+    cps_api_attr_id_t ids[3] = {BASE_ACL_EVENT_CHANGE, 0, 0};
+
+    for (ids[1] = 0; ; ids[1]++) {
+
+        ids[2] = BASE_ACL_EVENT_CHANGE_OBJ_TYPE;
+        auto type_attr = cps_api_object_e_get (obj, ids, 3);
+        ids[2] = BASE_ACL_EVENT_CHANGE_OPERATION;
+        auto op_attr = cps_api_object_e_get (obj, ids, 3);
+        ids[2] = BASE_ACL_EVENT_CHANGE_TABLE_ID;
+        auto table_attr = cps_api_object_e_get (obj, ids, 3);
+        ids[2] = BASE_ACL_EVENT_CHANGE_ID;
+        auto id_attr = cps_api_object_e_get (obj, ids, 3);
+
+        if (type_attr == NULL || op_attr == NULL ||
+            table_attr == NULL || id_attr == NULL) {
+            break;
+        }
+        event.changes.push_back (ut_event_change_t {
+            cps_api_object_attr_data_u32 (type_attr),
+            cps_api_object_attr_data_u32 (op_attr),
+            cps_api_object_attr_data_u64 (table_attr),
+            cps_api_object_attr_data_u64 (id_attr)});
+    }
+
+    _ut_events.push_back (event);
+    return true;
+}
+
+static cps_api_object_t ut_event_obj_create (cps_api_attr_id_t obj_attr,
+                                             cps_api_attr_id_t table_attr,
+                                             nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static bool ut_event_table_create (nas_obj_id_t* table_id)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_event_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+    bool ok = (obj != NULL);
+
+    if (ok) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 91);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_EVENT_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_L4_DST_PORT);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+// Adds an Entry Create to the transaction. Entry ID 0 is allocated.
+static bool ut_event_entry_create (cps_api_transaction_params_t* params,
+                                   nas_obj_id_t table_id, nas_obj_id_t entry_id,
+                                   uint32_t priority)
+{
+    auto obj = ut_event_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+
+    if (obj == NULL) {
+        return false;
+    }
+
+    if (entry_id != 0) {
+        cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                              &entry_id, sizeof (uint64_t));
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+    ut_entry.priority  = priority;
+    ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_L4_DST_PORT, {priority, 0xffff}});
+    ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, priority);
+
+    if (!ut_fill_entry_match (obj, ut_entry) ||
+        !ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return false;
+    }
+
+    return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+}
+
+static bool ut_event_obj_delete (cps_api_transaction_params_t* params,
+                                 cps_api_attr_id_t obj_attr, cps_api_attr_id_t table_attr,
+                                 cps_api_attr_id_t id_attr, nas_obj_id_t table_id,
+                                 nas_obj_id_t obj_id)
+{
+    auto obj = ut_event_obj_create (obj_attr, table_attr, table_id);
+
+    if (obj == NULL) {
+        return false;
+    }
+
+    cps_api_set_key_data (obj, id_attr, cps_api_object_ATTR_T_U64,
+                          &obj_id, sizeof (uint64_t));
+
+    return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+}
+
+// Flushes the batch and checks that exactly one event with the
+// expected changes, in any order, was published
+static bool ut_event_check (const char* step, size_t events_before,
+                            std::vector<ut_event_change_t> expected)
+{
+    nas_acl_event_flush ();
+
+    if (expected.empty ()) {
+        if (_ut_events.size () != events_before) {
+            ut_printf ("%s(): %s - Unexpected event\r\n", __FUNCTION__, step);
+            return false;
+        }
+        return true;
+    }
+
+    if (_ut_events.size () != events_before + 1) {
+        ut_printf ("%s(): %s - %ld events, expected 1\r\n", __FUNCTION__, step,
+                   _ut_events.size () - events_before);
+        return false;
+    }
+
+    auto changes = _ut_events.back ().changes;
+
+    std::sort (changes.begin (), changes.end ());
+    std::sort (expected.begin (), expected.end ());
+
+    if (_ut_events.back ().overflow || changes != expected) {
+        ut_printf ("%s(): %s - %ld changes, expected %ld\r\n", __FUNCTION__, step,
+                   changes.size (), expected.size ());
+        return false;
+    }
+    if (events_before > 0 &&
+        _ut_events.back ().seq != _ut_events [events_before - 1].seq + 1) {
+        ut_printf ("%s(): %s - Sequence %lu not consecutive\r\n", __FUNCTION__, step,
+                   _ut_events.back ().seq);
+        return false;
+    }
+    return true;
+}
+
+bool nas_acl_ut_event_test ()
+{
+    nas_obj_id_t table_id = 0;
+    bool         ok = false;
+
+    nas_acl_event_publish_fn_set (ut_event_capture);
+    nas_acl_event_flush ();
+    _ut_events.clear ();
+
+    if (!ut_event_table_create (&table_id)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        nas_acl_event_publish_fn_set (NULL);
+        return false;
+    }
+
+    std::vector<nas_obj_id_t> entry_ids;
+    cps_api_transaction_params_t params;
+
+    do {
+        if (!ut_event_check ("Table create", 0,
+                             {ut_event_change_t {BASE_ACL_TABLE_OBJ, cps_api_oper_CREATE,
+                                                 table_id, table_id}})) {
+            break;
+        }
+
+        // One event for all the Entries of a transaction
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+        bool txn_ok = true;
+        for (uint32_t prio = 10; prio <= 30; prio += 10) {
+            txn_ok = txn_ok && ut_event_entry_create (&params, table_id, 0, prio);
+        }
+        txn_ok = txn_ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+        std::vector<ut_event_change_t> expected;
+        for (size_t idx = 0; txn_ok && idx < 3; idx++) {
+            auto obj = cps_api_object_list_get (params.change_list, idx);
+            auto entry_id = cps_api_object_attr_data_u64 (
+                                cps_api_get_key_data (obj, BASE_ACL_ENTRY_ID));
+            entry_ids.push_back (entry_id);
+            expected.push_back (ut_event_change_t {BASE_ACL_ENTRY_OBJ, cps_api_oper_CREATE,
+                                                   table_id, entry_id});
+        }
+        cps_api_transaction_close (&params);
+
+        if (!txn_ok || !ut_event_check ("Bulk create", _ut_events.size (), expected)) {
+            break;
+        }
+
+        // Nothing for a transaction that is rolled back
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+        txn_ok = ut_event_obj_delete (&params, BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                      BASE_ACL_ENTRY_ID, table_id, entry_ids [0]) &&
+                 ut_event_obj_delete (&params, BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                      BASE_ACL_ENTRY_ID, table_id, UT_EVENT_BAD_ENTRY) &&
+                 (nas_acl_ut_cps_api_commit (&params, true) != cps_api_ret_code_OK);
+        cps_api_transaction_close (&params);
+
+        if (!txn_ok || !ut_event_check ("Rollback", _ut_events.size (), {})) {
+            break;
+        }
+
+        // Entry created and deleted within the batch is not published
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+        txn_ok = ut_event_entry_create (&params, table_id, UT_EVENT_ENTRY_ID, 40) &&
+                 ut_event_obj_delete (&params, BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                      BASE_ACL_ENTRY_ID, table_id, UT_EVENT_ENTRY_ID) &&
+                 (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+        cps_api_transaction_close (&params);
+
+        if (!txn_ok || !ut_event_check ("Create and delete", _ut_events.size (), {})) {
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    // Entries and Table removed in one transaction - one event
+    std::vector<ut_event_change_t> expected;
+    size_t events_before = _ut_events.size ();
+
+    if (cps_api_transaction_init (&params) == cps_api_ret_code_OK) {
+        bool txn_ok = true;
+
+        for (auto entry_id: entry_ids) {
+            txn_ok = txn_ok &&
+                     ut_event_obj_delete (&params, BASE_ACL_ENTRY_OBJ,
+                                          BASE_ACL_ENTRY_TABLE_ID, BASE_ACL_ENTRY_ID,
+                                          table_id, entry_id);
+            expected.push_back (ut_event_change_t {BASE_ACL_ENTRY_OBJ, cps_api_oper_DELETE,
+                                                   table_id, entry_id});
+        }
+        txn_ok = txn_ok &&
+                 ut_event_obj_delete (&params, BASE_ACL_TABLE_OBJ, 0, BASE_ACL_TABLE_ID,
+                                      0, table_id) &&
+                 (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+        expected.push_back (ut_event_change_t {BASE_ACL_TABLE_OBJ, cps_api_oper_DELETE,
+                                               table_id, table_id});
+        cps_api_transaction_close (&params);
+
+        if (!txn_ok) {
+            ut_printf ("%s(): Cleanup failed\r\n", __FUNCTION__);
+            ok = false;
+        }
+    }
+
+    ok = ok && ut_event_check ("Bulk delete", events_before, expected);
+
+    nas_acl_event_publish_fn_set (NULL);
+    return ok;
+}
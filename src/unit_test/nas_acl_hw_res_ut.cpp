@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_switch_list.h"
+#include <functional>
+
+#define UT_HW_NPU           0
+#define UT_HW_MAX_ROWS      2
+#define UT_HW_MAX_COUNTERS  1
+
+typedef std::function<bool (cps_api_transaction_params_t*)> ut_hw_fill_fn_t;
+
+static cps_api_object_t ut_hw_obj_create (cps_api_attr_id_t obj_attr,
+                                           cps_api_attr_id_t table_attr,
+                                           nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+// Adds an Entry write to the transaction
+static bool ut_hw_entry_op (cps_api_transaction_params_t* params,
+                             cps_api_operation_types_t op, nas_obj_id_t table_id,
+                             nas_obj_id_t entry_id, uint32_t priority)
+{
+    auto obj = ut_hw_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+
+    if (obj == NULL) {
+        return false;
+    }
+
+    cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                          &entry_id, sizeof (uint64_t));
+
+    if (op == cps_api_oper_DELETE) {
+        return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+    }
+
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, priority);
+
+    if (op == cps_api_oper_SET) {
+        return (cps_api_set (params, obj) == cps_api_ret_code_OK);
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+    ut_entry.priority  = priority;
+    ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_L4_DST_PORT, {priority, 0xffff}});
+    ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+
+    if (!ut_fill_entry_match (obj, ut_entry) ||
+        !ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return false;
+    }
+
+    return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+}
+
+static const nas_acl_entry* ut_hw_find_entry (nas_obj_id_t table_id,
+                                               nas_obj_id_t entry_id)
+{
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    return s.find_entry (table_id, entry_id);
+}
+
+static bool ut_hw_commit (const ut_hw_fill_fn_t& fill)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    bool ok = fill (&params) &&
+              (nas_acl_ut_cps_api_commit (&params, true) == cps_api_ret_code_OK);
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+// Table limited to UT_HW_MAX_ROWS rows and UT_HW_MAX_COUNTERS Counters
+static bool ut_hw_table_create (nas_obj_id_t* table_id)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_hw_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+    bool ok = (obj != NULL);
+
+    if (ok) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 95);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_HW_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_L4_DST_PORT);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_MAX_ROWS, UT_HW_MAX_ROWS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_MAX_COUNTERS, UT_HW_MAX_COUNTERS);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+static bool ut_hw_obj_delete (cps_api_attr_id_t obj_attr, cps_api_attr_id_t table_attr,
+                              nas_obj_id_t table_id, cps_api_attr_id_t id_attr,
+                              nas_obj_id_t id)
+{
+    return ut_hw_commit ([=] (cps_api_transaction_params_t* params) {
+        auto obj = ut_hw_obj_create (obj_attr, table_attr, table_id);
+        if (obj == NULL) return false;
+
+        cps_api_set_key_data (obj, id_attr, cps_api_object_ATTR_T_U64,
+                              &id, sizeof (uint64_t));
+        return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+    });
+}
+
+static bool ut_hw_entry_create (nas_obj_id_t table_id, nas_obj_id_t entry_id)
+{
+    return ut_hw_commit ([=] (cps_api_transaction_params_t* params) {
+        return ut_hw_entry_op (params, cps_api_oper_CREATE, table_id, entry_id,
+                               10 + entry_id);
+    });
+}
+
+static bool ut_hw_counter_create (nas_obj_id_t table_id, nas_obj_id_t counter_id)
+{
+    return ut_hw_commit ([=] (cps_api_transaction_params_t* params) {
+        auto obj = ut_hw_obj_create (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID,
+                                     table_id);
+        if (obj == NULL) return false;
+
+        cps_api_set_key_data (obj, BASE_ACL_COUNTER_ID, cps_api_object_ATTR_T_U64,
+                              &counter_id, sizeof (uint64_t));
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_COUNTER_TYPES,
+                                     BASE_ACL_COUNTER_TYPE_PACKET);
+        return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+    });
+}
+
+// Rows used and free in the NPU as reported by a Table GET
+static bool ut_hw_get_rows (nas_obj_id_t table_id, uint32_t* used, uint32_t* free_rows)
+{
+    cps_api_get_params_t params;
+    bool ok = false;
+
+    if (cps_api_get_request_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_hw_obj_create (BASE_ACL_TABLE_OBJ, BASE_ACL_TABLE_ID, table_id);
+
+    if (obj != NULL && cps_api_object_list_append (params.filters, obj)) {
+
+        if (nas_acl_ut_cps_api_get (&params, 0) == cps_api_ret_code_OK &&
+            cps_api_object_list_size (params.list) == 1) {
+
+            auto tbl_obj = cps_api_object_list_get (params.list, 0);
+            cps_api_attr_id_t ids[3] = {BASE_ACL_TABLE_HW_USAGE, 0,
+                                        BASE_ACL_TABLE_HW_USAGE_ROWS_USED};
+            auto used_attr = cps_api_object_e_get (tbl_obj, ids, 3);
+
+            ids[2] = BASE_ACL_TABLE_HW_USAGE_ROWS_FREE;
+            auto free_attr = cps_api_object_e_get (tbl_obj, ids, 3);
+
+            if (used_attr != NULL && free_attr != NULL) {
+                *used = cps_api_object_attr_data_u32 (used_attr);
+                *free_rows = cps_api_object_attr_data_u32 (free_attr);
+                ok = true;
+            }
+        }
+    } else if (obj != NULL) {
+        cps_api_object_delete (obj);
+    }
+
+    cps_api_get_request_close (&params);
+    return ok;
+}
+
+bool nas_acl_ut_hw_res_test ()
+{
+    nas_obj_id_t    table_id = 0;
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+    bool            ok = false;
+
+    if (!ut_hw_table_create (&table_id)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    do {
+        // Table quota
+        if (!ut_hw_entry_create (table_id, 1) || !ut_hw_entry_create (table_id, 2)) {
+            ut_printf ("%s(): Entry create within quota failed\r\n", __FUNCTION__);
+            break;
+        }
+        if (ut_hw_entry_create (table_id, 3) || ut_hw_find_entry (table_id, 3) != NULL) {
+            ut_printf ("%s(): Entry create over quota not rejected\r\n", __FUNCTION__);
+            break;
+        }
+
+        uint32_t used = 0;
+        uint32_t free_rows = 0;
+
+        if (!ut_hw_get_rows (table_id, &used, &free_rows) ||
+            used != UT_HW_MAX_ROWS || free_rows != 0) {
+            ut_printf ("%s(): Bad usage in Table GET: used %d free %d\r\n",
+                       __FUNCTION__, used, free_rows);
+            break;
+        }
+
+        if (!ut_hw_counter_create (table_id, 1) || ut_hw_counter_create (table_id, 2) ||
+            s.table_hw_usage (table_id, UT_HW_NPU).counters != UT_HW_MAX_COUNTERS) {
+            ut_printf ("%s(): Counter quota not applied\r\n", __FUNCTION__);
+            break;
+        }
+
+        // NPU capacity applies across Tables
+        if (!ut_hw_obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                               BASE_ACL_ENTRY_ID, 2)) {
+            break;
+        }
+
+        auto cap = s.hw_capacity (UT_HW_NPU);
+        s.set_hw_capacity (UT_HW_NPU, {s.npu_hw_usage (UT_HW_NPU).rows, 0});
+
+        bool full_rejected = !ut_hw_entry_create (table_id, 2);
+
+        s.set_hw_capacity (UT_HW_NPU, cap);
+
+        if (!full_rejected || !ut_hw_entry_create (table_id, 2)) {
+            ut_printf ("%s(): NPU capacity not applied\r\n", __FUNCTION__);
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    for (nas_obj_id_t entry_id = 1; entry_id <= 3; entry_id++) {
+        if (ut_hw_find_entry (table_id, entry_id) != NULL) {
+            ok = ut_hw_obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                                   BASE_ACL_ENTRY_ID, entry_id) && ok;
+        }
+    }
+    if (s.find_counter (table_id, 1) != NULL) {
+        ok = ut_hw_obj_delete (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID, table_id,
+                               BASE_ACL_COUNTER_ID, 1) && ok;
+    }
+
+    auto usage = s.table_hw_usage (table_id, UT_HW_NPU);
+    if (usage.rows != 0 || usage.counters != 0) {
+        ut_printf ("%s(): Usage left after deletes\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    if (!ut_hw_obj_delete (BASE_ACL_TABLE_OBJ, 0, 0, BASE_ACL_TABLE_ID, table_id)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    return ok;
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_switch_list.h"
+#include "nas_acl_intf.h"
+#include <functional>
+#include <vector>
+
+#define UT_IF_NPU           0
+
+typedef std::function<bool (cps_api_transaction_params_t*)> ut_if_fill_fn_t;
+
+static cps_api_object_t ut_if_obj_create (cps_api_attr_id_t obj_attr,
+                                           cps_api_attr_id_t table_attr,
+                                           nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static bool ut_if_commit (const ut_if_fill_fn_t& fill)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    bool ok = fill (&params) &&
+              (nas_acl_ut_cps_api_commit (&params, true) == cps_api_ret_code_OK);
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+static bool ut_if_table_create (nas_obj_id_t* table_id)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_if_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+    bool ok = (obj != NULL);
+
+    if (ok) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 96);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_IF_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_IN_PORTS);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+static bool ut_if_obj_delete (cps_api_attr_id_t obj_attr, cps_api_attr_id_t table_attr,
+                              nas_obj_id_t table_id, cps_api_attr_id_t id_attr,
+                              nas_obj_id_t id)
+{
+    return ut_if_commit ([=] (cps_api_transaction_params_t* params) {
+        auto obj = ut_if_obj_create (obj_attr, table_attr, table_id);
+        if (obj == NULL) return false;
+
+        cps_api_set_key_data (obj, id_attr, cps_api_object_ATTR_T_U64,
+                              &id, sizeof (uint64_t));
+        return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+    });
+}
+
+// In-port and redirect-port of the Entry - 0 leaves it out
+static bool ut_if_entry_write (nas_obj_id_t table_id, nas_obj_id_t entry_id,
+                               hal_ifindex_t in_port, hal_ifindex_t redirect_port,
+                               bool create)
+{
+    return ut_if_commit ([&] (cps_api_transaction_params_t* params) {
+        auto obj = ut_if_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+        if (obj == NULL) return false;
+
+        ut_entry_t ut_entry {};
+
+        ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+        ut_entry.table_id  = table_id;
+        ut_entry.entry_id  = entry_id;
+
+        if (in_port != 0) {
+            ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_IN_PORTS,
+                                          {1, static_cast<uint32_t> (in_port)}});
+        }
+        if (redirect_port != 0) {
+            ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_REDIRECT_PORT,
+                                          {static_cast<uint32_t> (redirect_port)}});
+        } else {
+            ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+        }
+
+        cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                              &entry_id, sizeof (uint64_t));
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, 10 + entry_id);
+
+        if (!ut_fill_entry_match (obj, ut_entry) || !ut_fill_entry_action (obj, ut_entry)) {
+            cps_api_object_delete (obj);
+            return false;
+        }
+
+        return (((create) ? cps_api_create (params, obj) : cps_api_set (params, obj))
+                == cps_api_ret_code_OK);
+    });
+}
+
+static bool ut_if_check (nas_obj_id_t table_id, hal_ifindex_t ifindex,
+                         const std::vector<nas_obj_id_t>& expected)
+{
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+    nas_acl_entry_ref_list_t want;
+
+    for (auto entry_id: expected) {
+        want.push_back ({table_id, entry_id});
+    }
+
+    auto refs = s.if_entries (ifindex);
+    if (refs != want) {
+        ut_printf ("%s(): IfIndex %d in %ld Entries, expected %ld\r\n",
+                   __FUNCTION__, ifindex, refs.size (), want.size ());
+        return false;
+    }
+    return true;
+}
+
+bool nas_acl_ut_intf_reprogram_test ()
+{
+    nas_obj_id_t table_id = 0;
+    bool         ok = false;
+
+    if (!ut_if_table_create (&table_id)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    do {
+        if (!ut_if_entry_write (table_id, 1, 1, 2, true) ||
+            !ut_if_entry_write (table_id, 2, 0, 2, true) ||
+            !ut_if_entry_write (table_id, 3, 3, 0, true)) {
+            ut_printf ("%s(): Entry create failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        if (!ut_if_check (table_id, 1, {1}) ||
+            !ut_if_check (table_id, 2, {1, 2}) ||
+            !ut_if_check (table_id, 3, {3}) ||
+            !ut_if_check (table_id, 4, {})) {
+            break;
+        }
+
+        // Ports resolve as before - nothing to push to NDI
+        nas_acl_intf_stats_t stats {};
+        if (nas_acl_intf_reprogram (NAS_ACL_DEFAULT_SWITCH_ID (), 2, &stats)
+            != NAS_ACL_E_NONE ||
+            stats.unchanged != 2 || stats.reprogrammed != 0 || stats.failed != 0) {
+            ut_printf ("%s(): Reprogram %ld unchanged, %ld reprogrammed, %ld failed\r\n",
+                       __FUNCTION__, stats.unchanged, stats.reprogrammed, stats.failed);
+            break;
+        }
+
+        // Index follows modify and delete
+        if (!ut_if_entry_write (table_id, 1, 3, 0, false) ||
+            !ut_if_check (table_id, 1, {}) ||
+            !ut_if_check (table_id, 2, {2}) ||
+            !ut_if_check (table_id, 3, {1, 3})) {
+            break;
+        }
+
+        if (!ut_if_obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                               BASE_ACL_ENTRY_ID, 3) ||
+            !ut_if_check (table_id, 3, {1})) {
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    for (nas_obj_id_t entry_id = 1; entry_id <= 3; entry_id++) {
+        if (s.find_entry (table_id, entry_id) != NULL) {
+            ok = ut_if_obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                                   BASE_ACL_ENTRY_ID, entry_id) && ok;
+        }
+    }
+
+    if (!ut_if_obj_delete (BASE_ACL_TABLE_OBJ, 0, 0, BASE_ACL_TABLE_ID, table_id)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    return (ok && ut_if_check (table_id, 1, {}) && ut_if_check (table_id, 3, {}));
+}
+
+// Queued changes of an interface are coalesced and each refresh takes a
+// bounded number of interfaces
+bool nas_acl_ut_intf_refresh_test ()
+{
+    nas_obj_id_t table_id = 0;
+    bool         ok = false;
+
+    if (!ut_if_table_create (&table_id)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    // Drop changes queued by earlier tests
+    while (nas_acl_intf_refresh_pending () != 0);
+
+    do {
+        if (!ut_if_entry_write (table_id, 1, 0, 2, true)) {
+            ut_printf ("%s(): Entry create failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        for (int count = 0; count < 3; count++) {
+            nas_acl_intf_note_change (2);
+        }
+        nas_acl_intf_note_change (5);
+
+        size_t taken = nas_acl_intf_refresh_pending ();
+        if (taken != 2 || nas_acl_intf_refresh_pending () != 0) {
+            ut_printf ("%s(): %ld interfaces refreshed, expected 2\r\n",
+                       __FUNCTION__, taken);
+            break;
+        }
+
+        for (hal_ifindex_t ifindex = 1000;
+             ifindex <= 1000 + NAS_ACL_INTF_REFRESH_MAX; ifindex++) {
+            nas_acl_intf_note_change (ifindex);
+        }
+
+        taken = nas_acl_intf_refresh_pending ();
+        if (taken != NAS_ACL_INTF_REFRESH_MAX || nas_acl_intf_refresh_pending () != 1) {
+            ut_printf ("%s(): %ld interfaces in first refresh, expected %d\r\n",
+                       __FUNCTION__, taken, NAS_ACL_INTF_REFRESH_MAX);
+            break;
+        }
+
+        ok = ut_if_check (table_id, 2, {1});
+    } while (0);
+
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    if (s.find_entry (table_id, 1) != NULL) {
+        ok = ut_if_obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                               BASE_ACL_ENTRY_ID, 1) && ok;
+    }
+
+    if (!ut_if_obj_delete (BASE_ACL_TABLE_OBJ, 0, 0, BASE_ACL_TABLE_ID, table_id)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    return ok;
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_lock.h"
+#include "nas_acl_switch_list.h"
+#include <chrono>
+#include <future>
+
+#define UT_LOCK_NPU         0
+#define UT_LOCK_ENTRY_ID    100
+#define UT_LOCK_WAIT_MS     100
+
+static cps_api_object_t ut_lock_obj_create (cps_api_attr_id_t obj_attr,
+                                           cps_api_attr_id_t table_attr,
+                                           nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static bool ut_lock_table_op (nas_obj_id_t* table_id, bool create)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_lock_obj_create (BASE_ACL_TABLE_OBJ, (create) ? 0 : BASE_ACL_TABLE_ID,
+                                  *table_id);
+    bool ok = (obj != NULL);
+
+    if (ok && create) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 94);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_LOCK_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_L4_DST_PORT);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    } else if (ok) {
+        ok = (cps_api_delete (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok && create) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+// Adds an Entry write to the transaction
+static bool ut_lock_entry_op (cps_api_transaction_params_t* params,
+                             cps_api_operation_types_t op, nas_obj_id_t table_id,
+                             nas_obj_id_t entry_id, uint32_t priority)
+{
+    auto obj = ut_lock_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+
+    if (obj == NULL) {
+        return false;
+    }
+
+    cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                          &entry_id, sizeof (uint64_t));
+
+    if (op == cps_api_oper_DELETE) {
+        return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+    }
+
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, priority);
+
+    if (op == cps_api_oper_SET) {
+        return (cps_api_set (params, obj) == cps_api_ret_code_OK);
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+    ut_entry.priority  = priority;
+    ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_L4_DST_PORT, {priority, 0xffff}});
+    ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+
+    if (!ut_fill_entry_match (obj, ut_entry) ||
+        !ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return false;
+    }
+
+    return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+}
+
+static const nas_acl_entry* ut_lock_find_entry (nas_obj_id_t table_id,
+                                               nas_obj_id_t entry_id)
+{
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    return s.find_entry (table_id, entry_id);
+}
+
+// Creates or deletes an Entry from another thread
+static std::future<bool> ut_lock_entry_write_start (cps_api_operation_types_t op,
+                                                    nas_obj_id_t              table_id)
+{
+    return std::async (std::launch::async, [op, table_id] () {
+        cps_api_transaction_params_t params;
+
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            return false;
+        }
+        bool ok = ut_lock_entry_op (&params, op, table_id, UT_LOCK_ENTRY_ID, 10) &&
+                  (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+        cps_api_transaction_close (&params);
+
+        return ok;
+    });
+}
+
+static bool ut_lock_write_done (std::future<bool>& writer)
+{
+    return (writer.wait_for (std::chrono::milliseconds (UT_LOCK_WAIT_MS))
+            == std::future_status::ready);
+}
+
+bool nas_acl_ut_table_lock_test ()
+{
+    nas_obj_id_t table_ids [2] = {0, 0};
+    bool         ok = false;
+
+    if (!ut_lock_table_op (&table_ids [0], true) ||
+        !ut_lock_table_op (&table_ids [1], true)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        ut_lock_table_op (&table_ids [0], false);
+        return false;
+    }
+
+    do {
+        // Holding one Table does not hold up writes to the other
+        nas_acl_lock_scope_t scope (NAS_ACL_LOCK_TABLE, NAS_ACL_DEFAULT_SWITCH_ID (),
+                                    table_ids [0]);
+        scope.lock ();
+
+        auto other_writer = ut_lock_entry_write_start (cps_api_oper_CREATE, table_ids [1]);
+        bool other_done = ut_lock_write_done (other_writer);
+
+        auto same_writer = ut_lock_entry_write_start (cps_api_oper_CREATE, table_ids [0]);
+        bool same_done = ut_lock_write_done (same_writer);
+
+        scope.unlock ();
+
+        if (!other_done || same_done) {
+            ut_printf ("%s(): Write to other Table %s, to held Table %s\r\n", __FUNCTION__,
+                       (other_done) ? "done" : "blocked", (same_done) ? "done" : "blocked");
+            other_writer.wait ();
+            same_writer.wait ();
+            break;
+        }
+
+        if (!other_writer.get () || !same_writer.get () ||
+            ut_lock_find_entry (table_ids [0], UT_LOCK_ENTRY_ID) == NULL ||
+            ut_lock_find_entry (table_ids [1], UT_LOCK_ENTRY_ID) == NULL) {
+            ut_printf ("%s(): Entry create failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Switch lock holds up writes to all its Tables
+        nas_acl_lock_scope_t sw_scope (NAS_ACL_LOCK_SWITCH, NAS_ACL_DEFAULT_SWITCH_ID ());
+        sw_scope.lock ();
+
+        auto del_writer = ut_lock_entry_write_start (cps_api_oper_DELETE, table_ids [1]);
+        bool del_done = ut_lock_write_done (del_writer);
+
+        sw_scope.unlock ();
+
+        if (del_done || !del_writer.get () ||
+            ut_lock_find_entry (table_ids [1], UT_LOCK_ENTRY_ID) != NULL) {
+            ut_printf ("%s(): Write not held up by the Switch lock\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Locks of all the Tables are released in reverse
+        nas_acl_lock_scope_t tables_scope (NAS_ACL_LOCK_TABLES,
+                                           NAS_ACL_DEFAULT_SWITCH_ID ());
+        tables_scope.lock ();
+
+        auto tables_writer = ut_lock_entry_write_start (cps_api_oper_CREATE, table_ids [1]);
+        bool tables_done = ut_lock_write_done (tables_writer);
+
+        tables_scope.unlock ();
+
+        if (tables_done || !tables_writer.get () ||
+            ut_lock_find_entry (table_ids [1], UT_LOCK_ENTRY_ID) == NULL) {
+            ut_printf ("%s(): Write not held up by the Table locks\r\n", __FUNCTION__);
+            break;
+        }
+
+        // NDI calls wait for the NDI lock whatever Table they are for
+        nas_acl_ndi_mutex ().lock ();
+
+        auto ndi_writer = ut_lock_entry_write_start (cps_api_oper_DELETE, table_ids [0]);
+        bool ndi_done = ut_lock_write_done (ndi_writer);
+
+        nas_acl_ndi_mutex ().unlock ();
+
+        if (ndi_done || !ndi_writer.get () ||
+            ut_lock_find_entry (table_ids [0], UT_LOCK_ENTRY_ID) != NULL) {
+            ut_printf ("%s(): NDI call not held up by the NDI lock\r\n", __FUNCTION__);
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    for (auto table_id: table_ids) {
+        if (ut_lock_find_entry (table_id, UT_LOCK_ENTRY_ID) != NULL) {
+            auto writer = ut_lock_entry_write_start (cps_api_oper_DELETE, table_id);
+            ok = writer.get () && ok;
+        }
+        if (!ut_lock_table_op (&table_id, false)) {
+            ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_switch_list.h"
+
+// Ports are registered in NAS_ACL_UT_NUM_PORT_NPUS NPUs - If 1 is in
+// NPU 0 and If 9 is the same port in NPU 1
+#define UT_NPU_PORT_0       1
+#define UT_NPU_PORT_1       (UT_NPU_PORT_0 + NAS_ACL_UT_NUM_PORTS_PER_NPU)
+
+static cps_api_object_t ut_npu_obj_create (cps_api_attr_id_t obj_attr,
+                                            nas_obj_id_t      table_id,
+                                            nas_obj_id_t      entry_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (obj_attr == BASE_ACL_ENTRY_OBJ) {
+            cps_api_set_key_data (obj, BASE_ACL_ENTRY_TABLE_ID, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+            cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                                  &entry_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static bool ut_npu_commit (cps_api_object_t obj, cps_api_operation_types_t op)
+{
+    cps_api_transaction_params_t params;
+
+    if (obj == NULL) {
+        return false;
+    }
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        cps_api_object_delete (obj);
+        return false;
+    }
+
+    bool ok = (((op == cps_api_oper_CREATE) ? cps_api_create (&params, obj) :
+                (op == cps_api_oper_SET) ? cps_api_set (&params, obj) :
+                cps_api_delete (&params, obj)) == cps_api_ret_code_OK) &&
+              (nas_acl_ut_cps_api_commit (&params, true) == cps_api_ret_code_OK);
+
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+// Table in both the NPUs that have ports
+static bool ut_npu_table_create (nas_obj_id_t* table_id)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_npu_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+    bool ok = (obj != NULL);
+
+    if (ok) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 95);
+        for (npu_id_t npu = 0; npu < NAS_ACL_UT_NUM_PORT_NPUS; npu++) {
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, npu);
+        }
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_IN_PORTS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_OUT_PORTS);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+static bool ut_npu_entry_write (nas_obj_id_t table_id, nas_obj_id_t entry_id,
+                                const ut_entry_t& ut_entry, cps_api_operation_types_t op)
+{
+    auto obj = ut_npu_obj_create (BASE_ACL_ENTRY_OBJ, table_id, entry_id);
+    if (obj == NULL) {
+        return false;
+    }
+
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, 10 + entry_id);
+
+    if (!ut_fill_entry_match (obj, ut_entry) || !ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return false;
+    }
+    return ut_npu_commit (obj, op);
+}
+
+// The Entry must be in exactly the expected NPUs - both in its NPU list
+// and in the NDI Entries it was created with
+static bool ut_npu_check (nas_obj_id_t table_id, nas_obj_id_t entry_id,
+                          const ut_npu_list_t& expected)
+{
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+    auto entry_p = s.find_entry (table_id, entry_id);
+
+    if (entry_p == NULL) {
+        ut_printf ("%s(): Entry %ld not found\r\n", __FUNCTION__, entry_id);
+        return false;
+    }
+
+    ut_npu_list_t npus (entry_p->npu_list ().begin (), entry_p->npu_list ().end ());
+    ut_npu_list_t ndi_npus;
+
+    for (auto& ndi_kv: entry_p->ndi_entry_ids) {
+        ndi_npus.insert (ndi_kv.first);
+    }
+
+    if (npus != expected || ndi_npus != expected) {
+        ut_printf ("%s(): Entry %ld in %ld NPUs, %ld NDI Entries - expected %ld\r\n",
+                   __FUNCTION__, entry_id, npus.size (), ndi_npus.size (),
+                   expected.size ());
+        return false;
+    }
+    return true;
+}
+
+static ut_entry_t ut_npu_entry (nas_obj_id_t table_id, nas_obj_id_t entry_id)
+{
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+
+    return ut_entry;
+}
+
+bool nas_acl_ut_entry_npu_test ()
+{
+    nas_obj_id_t table_id = 0;
+
+    if (!ut_npu_table_create (&table_id)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    const ut_npu_list_t npu_0 {0};
+    const ut_npu_list_t npu_1 {1};
+    const ut_npu_list_t npu_all {0, 1};
+
+    bool ok = false;
+
+    do {
+        // Out-ports filter with a port in NPU 1 only
+        auto entry = ut_npu_entry (table_id, 1);
+        entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_OUT_PORTS, {1, UT_NPU_PORT_1}});
+        entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+
+        if (!ut_npu_entry_write (table_id, 1, entry, cps_api_oper_CREATE) ||
+            !ut_npu_check (table_id, 1, npu_1)) {
+            ut_printf ("%s(): Out-ports Entry not narrowed\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Out-ports in both NPUs and In-ports in NPU 0 - only NPU 0 has both
+        entry.filter_list.clear ();
+        entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_OUT_PORTS, {2, UT_NPU_PORT_0}});
+        entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_IN_PORTS, {1, UT_NPU_PORT_0}});
+
+        if (!ut_npu_entry_write (table_id, 1, entry, cps_api_oper_SET) ||
+            !ut_npu_check (table_id, 1, npu_0)) {
+            ut_printf ("%s(): Port filters not intersected\r\n", __FUNCTION__);
+            break;
+        }
+
+        // In-ports in NPU 0 and Out-ports in NPU 1 match nowhere
+        entry = ut_npu_entry (table_id, 2);
+        entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_IN_PORTS, {1, UT_NPU_PORT_0}});
+        entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_OUT_PORTS, {1, UT_NPU_PORT_1}});
+        entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+
+        if (ut_npu_entry_write (table_id, 2, entry, cps_api_oper_CREATE)) {
+            ut_printf ("%s(): Disjoint port filters accepted\r\n", __FUNCTION__);
+            break;
+        }
+        if (nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ()).find_entry (table_id, 2)
+            != NULL) {
+            ut_printf ("%s(): Rejected Entry was created\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Only a redirect to a port in NPU 1
+        entry = ut_npu_entry (table_id, 3);
+        entry.action_list.insert ({BASE_ACL_ACTION_TYPE_REDIRECT_PORT, {UT_NPU_PORT_1}});
+
+        if (!ut_npu_entry_write (table_id, 3, entry, cps_api_oper_CREATE) ||
+            !ut_npu_check (table_id, 3, npu_1)) {
+            ut_printf ("%s(): Redirect-port Entry not narrowed\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Port-list actions with ports in NPU 0 only
+        entry.action_list.clear ();
+        entry.action_list.insert ({BASE_ACL_ACTION_TYPE_REDIRECT_PORT_LIST,
+                                   {1, UT_NPU_PORT_0}});
+        entry.action_list.insert ({BASE_ACL_ACTION_TYPE_EGRESS_MASK, {1, UT_NPU_PORT_0}});
+
+        if (!ut_npu_entry_write (table_id, 3, entry, cps_api_oper_SET) ||
+            !ut_npu_check (table_id, 3, npu_0)) {
+            ut_printf ("%s(): Port-list Entry not narrowed\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Any other action applies in every NPU
+        entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+
+        if (!ut_npu_entry_write (table_id, 3, entry, cps_api_oper_SET) ||
+            !ut_npu_check (table_id, 3, npu_all)) {
+            ut_printf ("%s(): Entry with a non-port action narrowed\r\n", __FUNCTION__);
+            break;
+        }
+
+        // In-ports in NPU 0 and a redirect to NPU 1 - never narrowed to nothing
+        entry = ut_npu_entry (table_id, 4);
+        entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_IN_PORTS, {1, UT_NPU_PORT_0}});
+        entry.action_list.insert ({BASE_ACL_ACTION_TYPE_REDIRECT_PORT, {UT_NPU_PORT_1}});
+
+        if (!ut_npu_entry_write (table_id, 4, entry, cps_api_oper_CREATE) ||
+            !ut_npu_check (table_id, 4, npu_0)) {
+            ut_printf ("%s(): Entry narrowed to no NPU\r\n", __FUNCTION__);
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    for (nas_obj_id_t entry_id = 1; entry_id <= 4; entry_id++) {
+        ut_npu_commit (ut_npu_obj_create (BASE_ACL_ENTRY_OBJ, table_id, entry_id),
+                       cps_api_oper_DELETE);
+    }
+
+    auto obj = ut_npu_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+    if (obj != NULL) {
+        cps_api_set_key_data (obj, BASE_ACL_TABLE_ID, cps_api_object_ATTR_T_U64,
+                              &table_id, sizeof (uint64_t));
+    }
+    if (!ut_npu_commit (obj, cps_api_oper_DELETE)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    return ok;
+}
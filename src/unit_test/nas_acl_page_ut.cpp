@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_switch_list.h"
+#include <functional>
+#include <vector>
+
+#define UT_PG_NPU           0
+
+typedef std::function<bool (cps_api_transaction_params_t*)> ut_pg_fill_fn_t;
+
+typedef struct _ut_pg_obj_t {
+    cps_api_attr_id_t obj_attr;
+    cps_api_attr_id_t table_attr;
+    cps_api_attr_id_t id_attr;
+    cps_api_attr_id_t limit_attr;
+    cps_api_attr_id_t cursor_attr;
+} ut_pg_obj_t;
+
+static const ut_pg_obj_t _pg_entry = {BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                      BASE_ACL_ENTRY_ID, BASE_ACL_ENTRY_GET_LIMIT,
+                                      BASE_ACL_ENTRY_GET_CURSOR};
+static const ut_pg_obj_t _pg_counter = {BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID,
+                                        BASE_ACL_COUNTER_ID, BASE_ACL_COUNTER_GET_LIMIT,
+                                        BASE_ACL_COUNTER_GET_CURSOR};
+static const ut_pg_obj_t _pg_stats = {BASE_ACL_STATS_OBJ, BASE_ACL_STATS_TABLE_ID,
+                                      BASE_ACL_STATS_COUNTER_ID, BASE_ACL_STATS_GET_LIMIT,
+                                      BASE_ACL_STATS_GET_CURSOR};
+
+static cps_api_object_t ut_pg_obj_create (cps_api_attr_id_t obj_attr,
+                                           cps_api_attr_id_t table_attr,
+                                           nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+// Adds an Entry write to the transaction
+static bool ut_pg_entry_op (cps_api_transaction_params_t* params,
+                             cps_api_operation_types_t op, nas_obj_id_t table_id,
+                             nas_obj_id_t entry_id, uint32_t priority)
+{
+    auto obj = ut_pg_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+
+    if (obj == NULL) {
+        return false;
+    }
+
+    cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                          &entry_id, sizeof (uint64_t));
+
+    if (op == cps_api_oper_DELETE) {
+        return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+    }
+
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, priority);
+
+    if (op == cps_api_oper_SET) {
+        return (cps_api_set (params, obj) == cps_api_ret_code_OK);
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+    ut_entry.priority  = priority;
+    ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_L4_DST_PORT, {priority, 0xffff}});
+    ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+
+    if (!ut_fill_entry_match (obj, ut_entry) ||
+        !ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return false;
+    }
+
+    return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+}
+
+static bool ut_pg_commit (const ut_pg_fill_fn_t& fill)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    bool ok = fill (&params) &&
+              (nas_acl_ut_cps_api_commit (&params, true) == cps_api_ret_code_OK);
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+static bool ut_pg_table_create (nas_obj_id_t* table_id)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_pg_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+    bool ok = (obj != NULL);
+
+    if (ok) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 95);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_PG_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_L4_DST_PORT);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+static bool ut_pg_obj_delete (cps_api_attr_id_t obj_attr, cps_api_attr_id_t table_attr,
+                              nas_obj_id_t table_id, cps_api_attr_id_t id_attr,
+                              nas_obj_id_t id)
+{
+    return ut_pg_commit ([=] (cps_api_transaction_params_t* params) {
+        auto obj = ut_pg_obj_create (obj_attr, table_attr, table_id);
+        if (obj == NULL) return false;
+
+        cps_api_set_key_data (obj, id_attr, cps_api_object_ATTR_T_U64,
+                              &id, sizeof (uint64_t));
+        return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+    });
+}
+
+static bool ut_pg_entry_create (nas_obj_id_t table_id, nas_obj_id_t entry_id)
+{
+    return ut_pg_commit ([=] (cps_api_transaction_params_t* params) {
+        return ut_pg_entry_op (params, cps_api_oper_CREATE, table_id, entry_id,
+                               10 + entry_id);
+    });
+}
+
+static bool ut_pg_counter_create (nas_obj_id_t table_id, nas_obj_id_t counter_id)
+{
+    return ut_pg_commit ([=] (cps_api_transaction_params_t* params) {
+        auto obj = ut_pg_obj_create (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID,
+                                     table_id);
+        if (obj == NULL) return false;
+
+        cps_api_set_key_data (obj, BASE_ACL_COUNTER_ID, cps_api_object_ATTR_T_U64,
+                              &counter_id, sizeof (uint64_t));
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_COUNTER_TYPES,
+                                     BASE_ACL_COUNTER_TYPE_PACKET);
+        return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+    });
+}
+
+// One page of the GET - the cursor is empty at the start and once
+// the walk is done
+static bool ut_pg_get_page (const ut_pg_obj_t& pg, nas_obj_id_t table_id,
+                            uint32_t limit, std::vector<uint8_t>& cursor,
+                            std::vector<nas_obj_id_t>& ids)
+{
+    cps_api_get_params_t params;
+    bool ok = false;
+
+    if (cps_api_get_request_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_pg_obj_create (pg.obj_attr, pg.table_attr, table_id);
+
+    if (obj != NULL && cps_api_object_list_append (params.filters, obj)) {
+
+        cps_api_object_attr_add_u32 (obj, pg.limit_attr, limit);
+        if (!cursor.empty ()) {
+            cps_api_object_attr_add (obj, pg.cursor_attr, cursor.data (), cursor.size ());
+        }
+
+        if (nas_acl_ut_cps_api_get (&params, 0) == cps_api_ret_code_OK) {
+
+            size_t count = cps_api_object_list_size (params.list);
+            ok = (count <= limit);
+            cursor.clear ();
+
+            for (size_t idx = 0; ok && idx < count; idx++) {
+
+                auto page_obj = cps_api_object_list_get (params.list, idx);
+                auto id_attr = cps_api_get_key_data (page_obj, pg.id_attr);
+                auto cursor_attr = cps_api_object_attr_get (page_obj, pg.cursor_attr);
+
+                if (id_attr == NULL || (cursor_attr != NULL && idx != count - 1)) {
+                    ok = false;
+                    break;
+                }
+                ids.push_back (cps_api_object_attr_data_u64 (id_attr));
+
+                if (cursor_attr != NULL) {
+                    auto data = static_cast<uint8_t*>
+                        (cps_api_object_attr_data_bin (cursor_attr));
+                    cursor.assign (data, data + cps_api_object_attr_len (cursor_attr));
+                }
+            }
+        }
+    } else if (obj != NULL) {
+        cps_api_object_delete (obj);
+    }
+
+    cps_api_get_request_close (&params);
+    return ok;
+}
+
+// Walks all the pages - the hook runs after the first page
+static bool ut_pg_walk (const ut_pg_obj_t& pg, nas_obj_id_t table_id, uint32_t limit,
+                        std::vector<nas_obj_id_t>& ids,
+                        const std::function<bool ()>& hook = nullptr)
+{
+    std::vector<uint8_t> cursor;
+    size_t               pages = 0;
+
+    ids.clear ();
+
+    do {
+        if (!ut_pg_get_page (pg, table_id, limit, cursor, ids)) {
+            ut_printf ("%s(): GET of page %ld failed\r\n", __FUNCTION__, pages);
+            return false;
+        }
+        if (pages++ == 0 && hook && !hook ()) {
+            return false;
+        }
+    } while (!cursor.empty () && pages < 100);
+
+    return cursor.empty ();
+}
+
+static bool ut_pg_check_ids (const char* name, const std::vector<nas_obj_id_t>& ids,
+                             const std::vector<nas_obj_id_t>& expected)
+{
+    if (ids == expected) {
+        return true;
+    }
+
+    ut_printf ("%s(): %s walk returned %ld objects, expected %ld:",
+               __FUNCTION__, name, ids.size (), expected.size ());
+    for (auto id: ids) {
+        ut_printf (" %ld", id);
+    }
+    ut_printf ("\r\n");
+    return false;
+}
+
+bool nas_acl_ut_get_page_test ()
+{
+    nas_obj_id_t              table_id = 0;
+    std::vector<nas_obj_id_t> ids;
+    bool                      ok = false;
+
+    if (!ut_pg_table_create (&table_id)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    do {
+        bool created = true;
+        for (nas_obj_id_t entry_id = 2; entry_id <= 6; entry_id++) {
+            created = created && ut_pg_entry_create (table_id, entry_id);
+        }
+        for (nas_obj_id_t counter_id = 1; counter_id <= 3; counter_id++) {
+            created = created && ut_pg_counter_create (table_id, counter_id);
+        }
+        if (!created) {
+            ut_printf ("%s(): Create failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        if (!ut_pg_walk (_pg_entry, table_id, 2, ids) ||
+            !ut_pg_check_ids ("Entry", ids, {2, 3, 4, 5, 6})) {
+            break;
+        }
+
+        // A page that holds the rest has no cursor
+        if (!ut_pg_walk (_pg_entry, table_id, 5, ids) ||
+            !ut_pg_check_ids ("Entry", ids, {2, 3, 4, 5, 6})) {
+            break;
+        }
+
+        // Changes between pages - Entry 1 is behind the cursor
+        auto modify = [table_id] () {
+            return (ut_pg_obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                      table_id, BASE_ACL_ENTRY_ID, 5) &&
+                    ut_pg_entry_create (table_id, 1) &&
+                    ut_pg_entry_create (table_id, 7));
+        };
+
+        if (!ut_pg_walk (_pg_entry, table_id, 2, ids, modify) ||
+            !ut_pg_check_ids ("Entry", ids, {2, 3, 4, 6, 7})) {
+            break;
+        }
+
+        if (!ut_pg_walk (_pg_counter, table_id, 2, ids) ||
+            !ut_pg_check_ids ("Counter", ids, {1, 2, 3})) {
+            break;
+        }
+
+        if (!ut_pg_walk (_pg_stats, table_id, 1, ids) ||
+            !ut_pg_check_ids ("Stats", ids, {1, 2, 3})) {
+            break;
+        }
+
+        // A cursor that was not returned by a GET is rejected
+        std::vector<uint8_t> bad_cursor (3, 0);
+        if (ut_pg_get_page (_pg_entry, table_id, 2, bad_cursor, ids)) {
+            ut_printf ("%s(): Bad cursor not rejected\r\n", __FUNCTION__);
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    for (nas_obj_id_t entry_id = 1; entry_id <= 7; entry_id++) {
+        if (s.find_entry (table_id, entry_id) != NULL) {
+            ok = ut_pg_obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                                   BASE_ACL_ENTRY_ID, entry_id) && ok;
+        }
+    }
+    for (nas_obj_id_t counter_id = 1; counter_id <= 3; counter_id++) {
+        if (s.find_counter (table_id, counter_id) != NULL) {
+            ok = ut_pg_obj_delete (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID,
+                                   table_id, BASE_ACL_COUNTER_ID, counter_id) && ok;
+        }
+    }
+
+    if (!ut_pg_obj_delete (BASE_ACL_TABLE_OBJ, 0, 0, BASE_ACL_TABLE_ID, table_id)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    return ok;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_perf.h"
+#include <string>
+
+typedef struct _ut_perf_bucket_t {
+    uint64_t ns;
+    size_t   bucket;
+} ut_perf_bucket_t;
+
+static const std::vector<ut_perf_bucket_t> _perf_bucket_input =
+{
+    {0,             0},
+    {1,             1},
+    {2,             2},
+    {3,             2},
+    {4,             3},
+    {1023,          10},
+    {1024,          11},
+    {1ULL << 30,    31},
+    {UINT64_MAX,    NAS_ACL_PERF_HIST_BUCKETS - 1}, /* Clamped to last bucket */
+};
+
+bool nas_acl_ut_perf_hist_test ()
+{
+    nas_acl_perf_hist_t hist = {};
+
+    for (const auto& input: _perf_bucket_input) {
+
+        auto bucket = nas_acl_perf_bucket (input.ns);
+
+        if (bucket != input.bucket) {
+            ut_printf ("%s(): %lu ns in bucket %ld, expected %ld\r\n",
+                       __FUNCTION__, input.ns, bucket, input.bucket);
+            return false;
+        }
+        if (input.ns != UINT64_MAX) {
+            nas_acl_perf_hist_record (hist, input.ns);
+        }
+    }
+
+    uint64_t bucket_total = 0;
+    for (auto count: hist.bucket) {
+        bucket_total += count;
+    }
+
+    if (hist.count != _perf_bucket_input.size () - 1 ||
+        bucket_total != hist.count ||
+        hist.max_ns != (1ULL << 30) || hist.bucket[2] != 2) {
+        ut_printf ("%s(): Bad histogram count %lu max %lu\r\n",
+                   __FUNCTION__, hist.count, hist.max_ns);
+        return false;
+    }
+
+    return true;
+}
+
+// Earlier tests have created tables - so the Table create
+// and NDI histograms must be non-empty
+bool nas_acl_ut_perf_stats_get_test ()
+{
+    cps_api_get_params_t params;
+
+    if (cps_api_get_request_init (&params) != cps_api_ret_code_OK) {
+        ut_printf ("cps_api_get_request_init () failed. \r\n");
+        return false;
+    }
+
+    cps_api_object_t obj = cps_api_object_list_create_obj_and_append (params.filters);
+    if (obj == NULL) {
+        return false;
+    }
+
+    cps_api_key_from_attr_with_qual (cps_api_object_key (obj),
+                                     BASE_ACL_PERF_STATS_OBJ,
+                                     cps_api_qualifier_TARGET);
+
+    if (nas_acl_ut_cps_api_get (&params, 0) != cps_api_ret_code_OK) {
+        ut_printf ("cps_api_get () failed. \r\n");
+        return false;
+    }
+
+    bool table_create_found = false;
+    bool ndi_found = false;
+    size_t count = cps_api_object_list_size (params.list);
+
+    for (size_t idx = 0; idx < count; idx++) {
+
+        obj = cps_api_object_list_get (params.list, idx);
+
+        auto name_attr = cps_api_object_attr_get (obj, BASE_ACL_PERF_STATS_NAME);
+        auto count_attr = cps_api_object_attr_get (obj, BASE_ACL_PERF_STATS_COUNT);
+
+        if (name_attr == NULL || count_attr == NULL) {
+            ut_printf ("%s(): Missing attributes\r\n", __FUNCTION__);
+            return false;
+        }
+
+        std::string name =
+            static_cast<const char*> (cps_api_object_attr_data_bin (name_attr));
+        uint64_t    hist_count = cps_api_object_attr_data_u64 (count_attr);
+
+        ut_printf ("%s(): %s count %lu\r\n", __FUNCTION__, name.c_str (), hist_count);
+
+        if (hist_count == 0) {
+            return false;
+        }
+        if (name == "table/create/total") {
+            table_create_found = true;
+        }
+        if (name.compare (0, 4, "ndi/") == 0) {
+            ndi_found = true;
+        }
+    }
+
+    cps_api_get_request_close (&params);
+
+    return (table_create_found && ndi_found);
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_pool.h"
+#include <map>
+#include <vector>
+
+static const nas_acl_pool_stats_t* ut_pool_class_stats (
+                        const std::vector<nas_acl_pool_stats_t>& stats_list,
+                        size_t block_size)
+{
+    for (const auto& stats: stats_list) {
+        if (stats.block_size == block_size) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+bool nas_acl_ut_pool_test ()
+{
+    nas_acl_pool_t pool;
+
+    // Blocks of the same size class are reused after being freed
+    void* p1 = pool.alloc (20);
+    void* p2 = pool.alloc (32);
+    pool.free (p1, 20);
+    void* p3 = pool.alloc (24);
+
+    auto stats_list = pool.stats ();
+    auto stats_p = ut_pool_class_stats (stats_list, 32);
+
+    if (p3 != p1 || stats_p == nullptr || stats_list.size () != 1 ||
+        stats_p->slabs != 1 || stats_p->blocks_total != NAS_ACL_POOL_MIN_SLAB ||
+        stats_p->blocks_in_use != 2 || stats_p->allocs != 3 ||
+        stats_p->reused != 1) {
+        ut_printf ("%s(): Size class reuse failed\r\n", __FUNCTION__);
+        return false;
+    }
+    pool.free (p2, 32);
+    pool.free (p3, 24);
+
+    // Large allocations bypass the pool
+    void* big_p = pool.alloc (NAS_ACL_POOL_MAX_BLOCK + 1);
+    pool.free (big_p, NAS_ACL_POOL_MAX_BLOCK + 1);
+    if (pool.heap_allocs () != 1 || pool.stats ().size () != 1) {
+        ut_printf ("%s(): Heap allocation accounted in pool\r\n", __FUNCTION__);
+        return false;
+    }
+
+    // Container nodes erased and re-inserted come from the same slabs
+    typedef std::map<int, uint64_t, std::less<int>,
+                     nas_acl_pool_allocator_t<std::pair<const int, uint64_t>>> ut_map_t;
+    const size_t count = NAS_ACL_POOL_MIN_SLAB * 4;
+    {
+        ut_map_t m {ut_map_t::allocator_type (&pool)};
+
+        for (size_t idx = 0; idx < count; idx++) {
+            m[idx] = idx;
+        }
+        size_t slabs = 0;
+        for (const auto& stats: pool.stats ()) {
+            slabs += stats.slabs;
+        }
+
+        for (size_t round = 0; round < 4; round++) {
+            for (size_t idx = 0; idx < count; idx += 2) {
+                m.erase (idx);
+            }
+            for (size_t idx = 0; idx < count; idx += 2) {
+                m[idx] = round;
+            }
+        }
+
+        size_t slabs_after = 0;
+        for (const auto& stats: pool.stats ()) {
+            slabs_after += stats.slabs;
+        }
+        if (slabs_after != slabs || m.size () != count) {
+            ut_printf ("%s(): Slabs grew from %ld to %ld on node reuse\r\n",
+                       __FUNCTION__, slabs, slabs_after);
+            return false;
+        }
+    }
+
+    // Slabs stay at the max size however many a size class holds - more
+    // slabs than the bits a shift by the slab count can take
+    {
+        const size_t       max_slabs = (sizeof (size_t) * 8) + 4;
+        std::vector<void*> blocks;
+
+        while (true) {
+            stats_list = pool.stats ();
+            stats_p = ut_pool_class_stats (stats_list, NAS_ACL_POOL_CLASS_SIZE);
+            if (stats_p != nullptr && stats_p->slabs >= max_slabs) {
+                break;
+            }
+            blocks.push_back (pool.alloc (NAS_ACL_POOL_CLASS_SIZE));
+        }
+
+        size_t doubling_blocks = 0, doubling_slabs = 0;
+        for (size_t num_blocks = NAS_ACL_POOL_MIN_SLAB; num_blocks < NAS_ACL_POOL_MAX_SLAB;
+             num_blocks <<= 1) {
+            doubling_blocks += num_blocks;
+            doubling_slabs++;
+        }
+        if (stats_p->blocks_total != doubling_blocks +
+                (max_slabs - doubling_slabs) * NAS_ACL_POOL_MAX_SLAB) {
+            ut_printf ("%s(): %ld blocks in %ld slabs\r\n", __FUNCTION__,
+                       stats_p->blocks_total, stats_p->slabs);
+            return false;
+        }
+
+        for (auto block_p: blocks) {
+            pool.free (block_p, NAS_ACL_POOL_CLASS_SIZE);
+        }
+    }
+
+    for (const auto& stats: pool.stats ()) {
+        if (stats.blocks_in_use != 0) {
+            ut_printf ("%s(): %ld blocks of size %ld leaked\r\n", __FUNCTION__,
+                       stats.blocks_in_use, stats.block_size);
+            return false;
+        }
+    }
+
+    return true;
+}
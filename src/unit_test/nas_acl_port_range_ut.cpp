@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_port_range.h"
+#include <set>
+
+typedef struct _ut_port_range_t {
+    uint16_t min;
+    uint16_t max;
+    size_t   prefix_count; /* Expected size of the minimal cover */
+} ut_port_range_t;
+
+static const std::vector<ut_port_range_t> _port_range_input =
+{
+    {0,     65535, 1},
+    {80,    80,    1},
+    {1024,  65535, 6},
+    {0,     1023,  1},
+    {1,     65535, 16},
+    {0,     65534, 16},
+    {1,     65534, NAS_ACL_PORT_RANGE_MAX_PREFIXES}, /* Worst case */
+    {32767, 32768, 2},
+    {1023,  1024,  2},
+    {5000,  5100,  7},
+};
+
+// Every port in the range must be matched by exactly one prefix
+// and no port outside the range must be matched
+static bool ut_validate_port_cover (const ut_port_range_t& range,
+                                    const nas_acl_port_prefix_list_t& prefix_list)
+{
+    for (uint32_t port = 0; port <= UINT16_MAX; port++) {
+
+        size_t hits = 0;
+        for (const auto& prefix: prefix_list) {
+            if ((port & prefix.mask) == prefix.data) {
+                hits++;
+            }
+        }
+
+        size_t expected = (port >= range.min && port <= range.max) ? 1 : 0;
+
+        if (hits != expected) {
+            ut_printf ("%s(): Range %d - %d: Port %d matched by %ld prefixes\r\n",
+                       __FUNCTION__, range.min, range.max, port, hits);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool nas_acl_ut_port_range_expand_test ()
+{
+    for (const auto& range: _port_range_input) {
+
+        auto prefix_list = nas_acl_port_range_expand (range.min, range.max);
+
+        ut_printf ("%s(): Range %d - %d expanded to %ld prefixes\r\n",
+                   __FUNCTION__, range.min, range.max, prefix_list.size ());
+
+        if (prefix_list.size () != range.prefix_count) {
+            ut_printf ("%s(): Expected %ld prefixes\r\n",
+                       __FUNCTION__, range.prefix_count);
+            return false;
+        }
+
+        if (!ut_validate_port_cover (range, prefix_list)) {
+            return false;
+        }
+    }
+
+    if (!nas_acl_port_range_expand (100, 99).empty ()) {
+        ut_printf ("%s(): Invalid range was expanded\r\n", __FUNCTION__);
+        return false;
+    }
+
+    return true;
+}
+
+// Two worst case ranges (source and destination port) in the same entry
+bool nas_acl_ut_port_range_expn_test ()
+{
+    std::vector<nas_acl_port_prefix_list_t> expn_list {
+        nas_acl_port_range_expand (1, 65534),
+        nas_acl_port_range_expand (1024, 65535),
+    };
+
+    size_t expn_count = nas_acl_port_range_expn_count (expn_list);
+
+    if (expn_count != NAS_ACL_PORT_RANGE_MAX_PREFIXES * 6) {
+        ut_printf ("%s(): Unexpected NDI entry count %ld\r\n",
+                   __FUNCTION__, expn_count);
+        return false;
+    }
+
+    std::set<std::pair<uint32_t, uint32_t>> seen;
+    nas_acl_port_prefix_list_t prefixes;
+
+    for (size_t expn_idx = 0; expn_idx < expn_count; expn_idx++) {
+
+        nas_acl_port_range_expn_at (expn_list, expn_idx, prefixes);
+
+        if (prefixes.size () != expn_list.size ()) {
+            return false;
+        }
+
+        auto key = std::make_pair ((uint32_t) prefixes[0].data << 16 | prefixes[0].mask,
+                                   (uint32_t) prefixes[1].data << 16 | prefixes[1].mask);
+
+        if (!seen.insert (key).second) {
+            ut_printf ("%s(): Duplicate prefix combination at %ld\r\n",
+                       __FUNCTION__, expn_idx);
+            return false;
+        }
+    }
+
+    // No range filters - the entry is programmed as a single NDI entry
+    if (nas_acl_port_range_expn_count ({}) != 1) {
+        return false;
+    }
+
+    return true;
+}
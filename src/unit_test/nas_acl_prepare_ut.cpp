@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_switch_list.h"
+#include "nas_acl_prepare.h"
+#include <functional>
+
+#define UT_PR_NPU           0
+#define UT_PR_MAX_ROWS      2
+#define UT_PR_BAD_COUNTER   99
+// Table created by the transactions with its ID
+#define UT_PR_NEW_TABLE     (nas_acl_switch::NAS_ACL_TABLE_ID_MAX)
+
+typedef std::function<bool (cps_api_transaction_params_t*)> ut_pr_fill_fn_t;
+
+static cps_api_object_t ut_pr_obj_create (cps_api_attr_id_t obj_attr,
+                                           cps_api_attr_id_t table_attr,
+                                           nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+// Entry Create object. An In-port filter is not allowed by the Table.
+static cps_api_object_t ut_pr_entry_obj (nas_obj_id_t table_id, nas_obj_id_t entry_id,
+                                         bool in_port, nas_obj_id_t counter_id)
+{
+    auto obj = ut_pr_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+
+    if (in_port) {
+        ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_IN_PORTS, {1, 1}});
+    } else {
+        ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_L4_DST_PORT,
+                                      {static_cast<uint32_t> (entry_id), 0xffff}});
+    }
+    ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+    if (counter_id != 0) {
+        ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_COUNTER,
+                                      {static_cast<uint32_t> (counter_id)}});
+    }
+
+    cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                          &entry_id, sizeof (uint64_t));
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, 10 + entry_id);
+
+    if (!ut_fill_entry_match (obj, ut_entry) || !ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return NULL;
+    }
+    cps_api_object_set_type_operation (cps_api_object_key (obj), cps_api_oper_CREATE);
+
+    return obj;
+}
+
+static bool ut_pr_commit (const ut_pr_fill_fn_t& fill)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    bool ok = fill (&params) &&
+              (nas_acl_ut_cps_api_commit (&params, true) == cps_api_ret_code_OK);
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+// Table Create object limited to UT_PR_MAX_ROWS rows - ID generated if 0
+static cps_api_object_t ut_pr_table_obj (nas_obj_id_t table_id)
+{
+    auto obj = ut_pr_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+
+    if (obj != NULL) {
+        if (table_id != 0) {
+            cps_api_set_key_data (obj, BASE_ACL_TABLE_ID, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 94);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_PR_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_L4_DST_PORT);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_MAX_ROWS, UT_PR_MAX_ROWS);
+        cps_api_object_set_type_operation (cps_api_object_key (obj), cps_api_oper_CREATE);
+    }
+    return obj;
+}
+
+static bool ut_pr_table_create (nas_obj_id_t* table_id)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_pr_table_obj (0);
+    bool ok = (obj != NULL) && (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+static bool ut_pr_obj_delete (cps_api_attr_id_t obj_attr, cps_api_attr_id_t table_attr,
+                              nas_obj_id_t table_id, cps_api_attr_id_t id_attr,
+                              nas_obj_id_t id)
+{
+    return ut_pr_commit ([=] (cps_api_transaction_params_t* params) {
+        auto obj = ut_pr_obj_create (obj_attr, table_attr, table_id);
+        if (obj == NULL) return false;
+
+        cps_api_set_key_data (obj, id_attr, cps_api_object_ATTR_T_U64,
+                              &id, sizeof (uint64_t));
+        return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+    });
+}
+
+static cps_api_object_t ut_pr_counter_obj (nas_obj_id_t table_id, nas_obj_id_t counter_id)
+{
+    auto obj = ut_pr_obj_create (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID, table_id);
+
+    if (obj != NULL) {
+        cps_api_set_key_data (obj, BASE_ACL_COUNTER_ID, cps_api_object_ATTR_T_U64,
+                              &counter_id, sizeof (uint64_t));
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_COUNTER_TYPES,
+                                     BASE_ACL_COUNTER_TYPE_PACKET);
+        cps_api_object_set_type_operation (cps_api_object_key (obj), cps_api_oper_CREATE);
+    }
+    return obj;
+}
+
+static bool ut_pr_counter_add (cps_api_transaction_params_t* params,
+                               nas_obj_id_t table_id, nas_obj_id_t counter_id)
+{
+    auto obj = ut_pr_counter_obj (table_id, counter_id);
+
+    return (obj != NULL) && (cps_api_create (params, obj) == cps_api_ret_code_OK);
+}
+
+// Transaction of creates fails and no Entry reaches NDI
+static bool ut_pr_rejected (const char* what, nas_obj_id_t table_id,
+                            const std::vector<cps_api_object_t>& objs)
+{
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+    auto ndi_writes = ut_ndi_entry_write_count ();
+
+    bool ok = ut_pr_commit ([&] (cps_api_transaction_params_t* params) {
+        bool added = true;
+        for (auto obj: objs) {
+            added = added && (obj != NULL) &&
+                    (cps_api_create (params, obj) == cps_api_ret_code_OK);
+        }
+        return added;
+    });
+
+    if (ok || ut_ndi_entry_write_count () != ndi_writes ||
+        (s.find_table (table_id) != NULL && s.entry_list (table_id).size () != 0)) {
+        ut_printf ("%s(): %s not rejected before NDI\r\n", __FUNCTION__, what);
+        return false;
+    }
+    return true;
+}
+
+// Dry run of the objects - nothing is written
+static bool ut_pr_validate (const std::vector<cps_api_object_t>& objs,
+                            uint32_t* status, uint32_t* fail_index, uint32_t* checked)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_pr_obj_create (BASE_ACL_VALIDATE_OBJ, 0, 0);
+    bool ok = (obj != NULL);
+
+    for (auto acl_obj: objs) {
+        ok = ok && (acl_obj != NULL) &&
+             cps_api_object_attr_add (obj, BASE_ACL_VALIDATE_OBJECT,
+                                      cps_api_object_array (acl_obj),
+                                      cps_api_object_to_array_len (acl_obj));
+        if (acl_obj != NULL) {
+            cps_api_object_delete (acl_obj);
+        }
+    }
+
+    ok = ok && (cps_api_set (&params, obj) == cps_api_ret_code_OK) &&
+         (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+
+        auto attr_u32 = [obj] (cps_api_attr_id_t attr_id) -> uint32_t {
+            auto attr = cps_api_object_attr_get (obj, attr_id);
+            return (attr != NULL) ? cps_api_object_attr_data_u32 (attr) : UINT32_MAX;
+        };
+        *status     = attr_u32 (BASE_ACL_VALIDATE_STATUS);
+        *fail_index = attr_u32 (BASE_ACL_VALIDATE_FAILED_INDEX);
+        *checked    = attr_u32 (BASE_ACL_VALIDATE_CHECKED);
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+bool nas_acl_ut_txn_prepare_test ()
+{
+    nas_obj_id_t table_id = 0;
+    bool         ok = false;
+
+    if (!ut_pr_table_create (&table_id)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    nas_acl_prepare_enable (true);
+
+    do {
+        // Filter not allowed by the Table in the last object
+        if (!ut_pr_rejected ("Disallowed filter", table_id,
+                             {ut_pr_entry_obj (table_id, 1, false, 0),
+                              ut_pr_entry_obj (table_id, 2, true, 0)})) {
+            break;
+        }
+
+        if (!ut_pr_rejected ("Missing Counter", table_id,
+                             {ut_pr_entry_obj (table_id, 1, false, 0),
+                              ut_pr_entry_obj (table_id, 2, false, UT_PR_BAD_COUNTER)})) {
+            break;
+        }
+
+        // Each Entry fits, but not all of them
+        if (!ut_pr_rejected ("Table quota", table_id,
+                             {ut_pr_entry_obj (table_id, 1, false, 0),
+                              ut_pr_entry_obj (table_id, 2, false, 0),
+                              ut_pr_entry_obj (table_id, 3, false, 0)})) {
+            break;
+        }
+
+        // Counter created by the transaction is checked with the Entry
+        uint32_t status = 0, fail_index = 0, checked = 0;
+
+        if (!ut_pr_validate ({ut_pr_counter_obj (table_id, 1),
+                              ut_pr_entry_obj (table_id, 1, false, 1)},
+                             &status, &fail_index, &checked) ||
+            status != NAS_ACL_E_NONE || checked != 2) {
+            ut_printf ("%s(): Dry run of a new Counter status 0x%x, %u checked\r\n",
+                       __FUNCTION__, status, checked);
+            break;
+        }
+
+        // Table, Counter and Entries created together, the last one with a
+        // filter not allowed by the new Table
+        if (!ut_pr_rejected ("Disallowed filter in a new Table", UT_PR_NEW_TABLE,
+                             {ut_pr_table_obj (UT_PR_NEW_TABLE),
+                              ut_pr_counter_obj (UT_PR_NEW_TABLE, 1),
+                              ut_pr_entry_obj (UT_PR_NEW_TABLE, 1, false, 1),
+                              ut_pr_entry_obj (UT_PR_NEW_TABLE, 2, true, 1)}) ||
+            s.find_table (UT_PR_NEW_TABLE) != NULL) {
+            break;
+        }
+
+        if (!ut_pr_validate ({ut_pr_table_obj (UT_PR_NEW_TABLE),
+                              ut_pr_counter_obj (UT_PR_NEW_TABLE, 1),
+                              ut_pr_entry_obj (UT_PR_NEW_TABLE, 1, false, 1),
+                              ut_pr_entry_obj (UT_PR_NEW_TABLE, 2, false, 1)},
+                             &status, &fail_index, &checked) ||
+            status != NAS_ACL_E_NONE || checked != 4) {
+            ut_printf ("%s(): Dry run of a new Table status 0x%x, %u checked\r\n",
+                       __FUNCTION__, status, checked);
+            break;
+        }
+
+        if (!ut_pr_commit ([&] (cps_api_transaction_params_t* params) {
+                return (ut_pr_counter_add (params, table_id, 1) &&
+                        cps_api_create (params, ut_pr_entry_obj (table_id, 1, false, 1))
+                            == cps_api_ret_code_OK &&
+                        cps_api_create (params, ut_pr_entry_obj (table_id, 2, false, 0))
+                            == cps_api_ret_code_OK);
+            }) || s.entry_list (table_id).size () != 2) {
+            ut_printf ("%s(): Entries using a new Counter not created\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Dry run - the Table is full, so a Delete must come first
+        if (!ut_pr_validate ({ut_pr_entry_obj (table_id, 3, false, 0)},
+                             &status, &fail_index, &checked) ||
+            status != (uint32_t) NAS_ACL_E_FULL || fail_index != 0) {
+            ut_printf ("%s(): Dry run status 0x%x at %u, expected full\r\n",
+                       __FUNCTION__, status, fail_index);
+            break;
+        }
+
+        auto del_obj = ut_pr_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                         table_id);
+        nas_obj_id_t del_id = 2;
+        if (del_obj != NULL) {
+            cps_api_set_key_data (del_obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                                  &del_id, sizeof (uint64_t));
+            cps_api_object_set_type_operation (cps_api_object_key (del_obj),
+                                               cps_api_oper_DELETE);
+        }
+
+        if (!ut_pr_validate ({del_obj, ut_pr_entry_obj (table_id, 3, false, 0)},
+                             &status, &fail_index, &checked) ||
+            status != NAS_ACL_E_NONE || checked != 2) {
+            ut_printf ("%s(): Dry run status 0x%x, %u checked\r\n",
+                       __FUNCTION__, status, checked);
+            break;
+        }
+
+        ok = (s.entry_list (table_id).size () == 2 && s.find_entry (table_id, 3) == NULL);
+    } while (0);
+
+    for (nas_obj_id_t entry_id = 1; entry_id <= 3; entry_id++) {
+        if (s.find_entry (table_id, entry_id) != NULL) {
+            ok = ut_pr_obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                                   BASE_ACL_ENTRY_ID, entry_id) && ok;
+        }
+    }
+    if (s.find_counter (table_id, 1) != NULL) {
+        ok = ut_pr_obj_delete (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID, table_id,
+                               BASE_ACL_COUNTER_ID, 1) && ok;
+    }
+
+    if (!ut_pr_obj_delete (BASE_ACL_TABLE_OBJ, 0, 0, BASE_ACL_TABLE_ID, table_id)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    nas_acl_prepare_enable (false);
+
+    return ok;
+}
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_switch_list.h"
+#include <arpa/inet.h>
+#include <functional>
+#include <vector>
+
+#define UT_QR_NPU           0
+#define UT_QR_PORT          1
+
+typedef std::function<bool (cps_api_transaction_params_t*)> ut_qr_fill_fn_t;
+
+// Fields of a test Entry or query - 0 leaves the field out
+typedef struct _ut_qr_spec_t {
+    uint32_t dst_ip;
+    uint32_t prefix_len;
+    uint32_t tc;
+    uint32_t ifindex;
+} ut_qr_spec_t;
+
+static cps_api_object_t ut_qr_obj_create (cps_api_attr_id_t obj_attr,
+                                           cps_api_attr_id_t table_attr,
+                                           nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static bool ut_qr_commit (const ut_qr_fill_fn_t& fill)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    bool ok = fill (&params) &&
+              (nas_acl_ut_cps_api_commit (&params, true) == cps_api_ret_code_OK);
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+static bool ut_qr_table_create (nas_obj_id_t* table_id)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_qr_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+    bool ok = (obj != NULL);
+
+    if (ok) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 95);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_QR_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_DST_IP);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_IN_PORTS);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+static bool ut_qr_obj_delete (cps_api_attr_id_t obj_attr, cps_api_attr_id_t table_attr,
+                              nas_obj_id_t table_id, cps_api_attr_id_t id_attr,
+                              nas_obj_id_t id)
+{
+    return ut_qr_commit ([=] (cps_api_transaction_params_t* params) {
+        auto obj = ut_qr_obj_create (obj_attr, table_attr, table_id);
+        if (obj == NULL) return false;
+
+        cps_api_set_key_data (obj, id_attr, cps_api_object_ATTR_T_U64,
+                              &id, sizeof (uint64_t));
+        return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+    });
+}
+
+static bool ut_qr_add_dst_ip (cps_api_object_t obj, cps_api_attr_id_t list_index,
+                              uint32_t dst_ip, uint32_t prefix_len)
+{
+    auto map_info_p = nas_acl_get_filter_info (BASE_ACL_MATCH_TYPE_DST_IP);
+    if (map_info_p == NULL || map_info_p->child_list.size () < 2) {
+        return false;
+    }
+
+    uint32_t addr = htonl (dst_ip);
+    uint32_t mask = htonl ((prefix_len == 0) ? 0 : (0xffffffff << (32 - prefix_len)));
+    uint32_t match_type = BASE_ACL_MATCH_TYPE_DST_IP;
+
+    cps_api_attr_id_t ids[] = {BASE_ACL_ENTRY_MATCH, list_index,
+                               BASE_ACL_ENTRY_MATCH_TYPE, 0};
+    if (!cps_api_object_e_add (obj, ids, 3, cps_api_object_ATTR_T_U32,
+                               &match_type, sizeof (match_type))) {
+        return false;
+    }
+
+    ids[2] = map_info_p->val.attr_id;
+    ids[3] = map_info_p->child_list.data[0].attr_id;
+    if (!cps_api_object_e_add (obj, ids, 4, cps_api_object_ATTR_T_BIN,
+                               &addr, sizeof (addr))) {
+        return false;
+    }
+    ids[3] = map_info_p->child_list.data[1].attr_id;
+    return cps_api_object_e_add (obj, ids, 4, cps_api_object_ATTR_T_BIN,
+                                 &mask, sizeof (mask));
+}
+
+// Entry object - or query object without Entry ID and priority
+static cps_api_object_t ut_qr_entry_obj (nas_obj_id_t table_id, nas_obj_id_t entry_id,
+                                         const ut_qr_spec_t& spec)
+{
+    auto obj = ut_qr_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+
+    if (spec.ifindex != 0) {
+        ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_IN_PORTS, {1, spec.ifindex}});
+    }
+    if (spec.tc != 0) {
+        ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {spec.tc}});
+    }
+
+    bool ok = ut_fill_entry_match (obj, ut_entry) && ut_fill_entry_action (obj, ut_entry);
+
+    if (ok && spec.prefix_len != 0) {
+        ok = ut_qr_add_dst_ip (obj, ut_entry.filter_list.size (), spec.dst_ip,
+                               spec.prefix_len);
+    }
+
+    if (ok && entry_id != 0) {
+        cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                              &entry_id, sizeof (uint64_t));
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, 10 + entry_id);
+    }
+
+    if (!ok) {
+        cps_api_object_delete (obj);
+        return NULL;
+    }
+    return obj;
+}
+
+static bool ut_qr_entry_write (nas_obj_id_t table_id, nas_obj_id_t entry_id,
+                               const ut_qr_spec_t& spec, bool create)
+{
+    return ut_qr_commit ([&] (cps_api_transaction_params_t* params) {
+        auto obj = ut_qr_entry_obj (table_id, entry_id, spec);
+        if (obj == NULL) return false;
+
+        return (((create) ? cps_api_create (params, obj) : cps_api_set (params, obj))
+                == cps_api_ret_code_OK);
+    });
+}
+
+// Entry IDs returned by the query
+static bool ut_qr_query (nas_obj_id_t table_id, const ut_qr_spec_t& spec,
+                         std::vector<nas_obj_id_t>& ids)
+{
+    cps_api_get_params_t params;
+    bool ok = false;
+
+    ids.clear ();
+
+    if (cps_api_get_request_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_qr_entry_obj (table_id, 0, spec);
+
+    if (obj != NULL && cps_api_object_list_append (params.filters, obj)) {
+
+        if (spec.ifindex != 0 && spec.tc == 0 && spec.prefix_len == 0) {
+            // Interface query without a Match list
+            cps_api_object_attr_delete (obj, BASE_ACL_ENTRY_MATCH);
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_GET_IFINDEX, spec.ifindex);
+        }
+
+        if (nas_acl_ut_cps_api_get (&params, 0) == cps_api_ret_code_OK) {
+            ok = true;
+            for (size_t idx = 0; idx < cps_api_object_list_size (params.list); idx++) {
+                auto id_attr = cps_api_get_key_data (
+                    cps_api_object_list_get (params.list, idx), BASE_ACL_ENTRY_ID);
+                if (id_attr == NULL) {
+                    ok = false;
+                    break;
+                }
+                ids.push_back (cps_api_object_attr_data_u64 (id_attr));
+            }
+        }
+    } else if (obj != NULL) {
+        cps_api_object_delete (obj);
+    }
+
+    cps_api_get_request_close (&params);
+    return ok;
+}
+
+static bool ut_qr_check (nas_obj_id_t table_id, const char* name,
+                         const ut_qr_spec_t& spec,
+                         const std::vector<nas_obj_id_t>& expected)
+{
+    std::vector<nas_obj_id_t> ids;
+
+    if (!ut_qr_query (table_id, spec, ids)) {
+        ut_printf ("%s(): %s query failed\r\n", __FUNCTION__, name);
+        return false;
+    }
+    if (ids != expected) {
+        ut_printf ("%s(): %s query returned %ld Entries, expected %ld\r\n",
+                   __FUNCTION__, name, ids.size (), expected.size ());
+        return false;
+    }
+    return true;
+}
+
+static const uint32_t _net_10  = 0x0a000000;
+static const uint32_t _net_10_1 = 0x0a010000;
+static const uint32_t _net_10_2 = 0x0a020000;
+static const uint32_t _net_10_3 = 0x0a030000;
+static const uint32_t _net_11  = 0x0b000000;
+
+bool nas_acl_ut_entry_query_test ()
+{
+    nas_obj_id_t table_id = 0;
+    bool         ok = false;
+
+    if (!ut_qr_table_create (&table_id)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    do {
+        if (!ut_qr_entry_write (table_id, 1, {_net_10_1, 16, 1, 0}, true) ||
+            !ut_qr_entry_write (table_id, 2, {_net_10_2, 16, 2, UT_QR_PORT}, true) ||
+            !ut_qr_entry_write (table_id, 3, {_net_11, 8, 1, 0}, true) ||
+            !ut_qr_entry_write (table_id, 4, {_net_10, 8, 3, 0}, true)) {
+            ut_printf ("%s(): Entry create failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        if (!ut_qr_check (table_id, "10/8", {_net_10, 8, 0, 0}, {1, 2, 4}) ||
+            !ut_qr_check (table_id, "10.1/16", {_net_10_1, 16, 0, 0}, {1}) ||
+            !ut_qr_check (table_id, "TC 1", {0, 0, 1, 0}, {1, 3}) ||
+            !ut_qr_check (table_id, "10/8 and TC 1", {_net_10, 8, 1, 0}, {1}) ||
+            !ut_qr_check (table_id, "Port", {0, 0, 0, UT_QR_PORT}, {2})) {
+            break;
+        }
+
+        // Indexes follow modify and delete
+        if (!ut_qr_entry_write (table_id, 3, {_net_10_3, 16, 1, 0}, false) ||
+            !ut_qr_check (table_id, "10/8 after modify", {_net_10, 8, 0, 0}, {1, 2, 3, 4}) ||
+            !ut_qr_check (table_id, "11/8 after modify", {_net_11, 8, 0, 0}, {})) {
+            break;
+        }
+
+        if (!ut_qr_obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                               BASE_ACL_ENTRY_ID, 1) ||
+            !ut_qr_check (table_id, "TC 1 after delete", {0, 0, 1, 0}, {3})) {
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    for (nas_obj_id_t entry_id = 1; entry_id <= 4; entry_id++) {
+        if (s.find_entry (table_id, entry_id) != NULL) {
+            ok = ut_qr_obj_delete (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                                   BASE_ACL_ENTRY_ID, entry_id) && ok;
+        }
+    }
+
+    if (!ut_qr_obj_delete (BASE_ACL_TABLE_OBJ, 0, 0, BASE_ACL_TABLE_ID, table_id)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    return ok;
+}
@@ -0,0 +1,1070 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*!
+ * \file   nas_acl_soak_ut.cpp
+ * \brief  Randomized CPS transaction soak test with NDI failure injection
+ *
+ * A seeded stream of Entry and Counter create/modify/incremental update/
+ * delete transactions is run against a few tables. NDI failures are
+ * injected through the NDI stub. A transaction must fail exactly when an
+ * injected failure fired (or when it is invalid by construction), and after
+ * every step the NAS ACL cache, the ID generators and the NDI entries in
+ * the stub must match a reference model - i.e. failures rolled back cleanly.
+ */
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_perf.h"
+#include "nas_acl_switch_list.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <map>
+#include <set>
+
+#define NAS_ACL_UT_SOAK_NPU          0
+#define NAS_ACL_UT_SOAK_TABLES       4
+#define NAS_ACL_UT_SOAK_MAX_ENTRIES  48
+#define NAS_ACL_UT_SOAK_MAX_COUNTERS 8
+#define NAS_ACL_UT_SOAK_MAX_BATCH    6
+#define NAS_ACL_UT_SOAK_FAULT_PCT    15
+// Filter values and mask fit the narrowest pool field - the 6-bit DSCP
+#define NAS_ACL_UT_SOAK_FILTER_MASK  0x3f
+
+typedef std::map<BASE_ACL_MATCH_TYPE_t, uint32_t>  soak_filter_map_t;
+typedef std::map<BASE_ACL_ACTION_TYPE_t, uint32_t> soak_action_map_t;
+
+typedef struct _soak_entry_t {
+    uint32_t           priority;
+    soak_filter_map_t  filters;     /* Filter type -> byte value */
+    soak_action_map_t  actions;     /* Action type -> value, no counter */
+    nas_obj_id_t       counter_id;  /* 0 if no counter attached */
+} soak_entry_t;
+
+typedef struct _soak_table_t {
+    nas_obj_id_t                          table_id;
+    std::map<nas_obj_id_t, soak_entry_t>  entries;
+    std::set<nas_obj_id_t>                counters;
+    nas_obj_id_t                          max_entry_id;
+    nas_obj_id_t                          max_counter_id;
+} soak_table_t;
+
+typedef enum {
+    SOAK_FAULT_NONE,
+    SOAK_FAULT_ENTRY_CREATE,
+    SOAK_FAULT_ENTRY_DELETE,
+    SOAK_FAULT_PRIORITY,
+    SOAK_FAULT_FILTER,
+    SOAK_FAULT_ACTION,
+} soak_fault_t;
+
+typedef struct _soak_ctx_t {
+    uint32_t                   seed;
+    std::mt19937               rng;
+    std::vector<soak_table_t>  tables;
+    ut_ndi_entry_id_set_t      ndi_baseline;  /* NDI entries owned by other tests */
+    size_t                     step;
+    size_t                     commits;
+    size_t                     failed_commits;
+    size_t                     faults_fired;
+    uint64_t                   commit_ns;
+    uint64_t                   verify_ns;
+} soak_ctx_t;
+
+typedef bool (*soak_op_fn_t) (soak_ctx_t& ctx, soak_table_t& table);
+
+typedef struct _soak_op_t {
+    const char*   name;
+    soak_op_fn_t  fn;
+    double        weight;
+} soak_op_t;
+
+static const std::vector<BASE_ACL_MATCH_TYPE_t> _soak_filter_pool =
+{
+    BASE_ACL_MATCH_TYPE_SRC_IP,       BASE_ACL_MATCH_TYPE_DST_IP,
+    BASE_ACL_MATCH_TYPE_L4_SRC_PORT,  BASE_ACL_MATCH_TYPE_L4_DST_PORT,
+    BASE_ACL_MATCH_TYPE_IP_PROTOCOL,  BASE_ACL_MATCH_TYPE_DSCP,
+    BASE_ACL_MATCH_TYPE_ETHER_TYPE,   BASE_ACL_MATCH_TYPE_TTL,
+    BASE_ACL_MATCH_TYPE_TCP_FLAGS,    BASE_ACL_MATCH_TYPE_ICMP_TYPE,
+};
+
+static const std::vector<BASE_ACL_ACTION_TYPE_t> _soak_action_pool =
+{
+    BASE_ACL_ACTION_TYPE_SET_TC,             BASE_ACL_ACTION_TYPE_SET_DSCP,
+    BASE_ACL_ACTION_TYPE_SET_OUTER_VLAN_PRI, BASE_ACL_ACTION_TYPE_SET_INNER_VLAN_PRI,
+    BASE_ACL_ACTION_TYPE_DECREMENT_TTL,
+};
+
+static size_t soak_rand (soak_ctx_t& ctx, size_t lo, size_t hi)
+{
+    return std::uniform_int_distribution<size_t> {lo, hi} (ctx.rng);
+}
+
+template <typename C>
+static typename C::const_iterator soak_rand_pick (soak_ctx_t& ctx, const C& c)
+{
+    return std::next (c.begin (), soak_rand (ctx, 0, c.size () - 1));
+}
+
+static size_t soak_peak_rss_kb ()
+{
+    char   line [128];
+    size_t kb = 0;
+    FILE*  fp = fopen ("/proc/self/status", "r");
+
+    if (fp == NULL) {
+        return 0;
+    }
+    while (fgets (line, sizeof (line), fp) != NULL) {
+        if (sscanf (line, "VmHWM: %zu kB", &kb) == 1) {
+            break;
+        }
+    }
+    fclose (fp);
+
+    return kb;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// NDI failure injection - the stub hooks reset themselves once they fire
+/////////////////////////////////////////////////////////////////////////////
+
+static void soak_fault_arm (soak_fault_t fault, uint32_t type)
+{
+    switch (fault) {
+        case SOAK_FAULT_ENTRY_CREATE:
+            ut_simulate_ndi_entry_create_error () = NAS_ACL_UT_SOAK_NPU;
+            break;
+        case SOAK_FAULT_ENTRY_DELETE:
+            ut_simulate_ndi_entry_delete_error () = NAS_ACL_UT_SOAK_NPU;
+            break;
+        case SOAK_FAULT_PRIORITY:
+            ut_simulate_ndi_entry_priority_error () = NAS_ACL_UT_SOAK_NPU;
+            break;
+        case SOAK_FAULT_FILTER:
+            ut_simulate_ndi_entry_filter_error_npu () = NAS_ACL_UT_SOAK_NPU;
+            ut_simulate_ndi_entry_filter_error_ftype () = type;
+            break;
+        case SOAK_FAULT_ACTION:
+            ut_simulate_ndi_entry_action_error_npu () = NAS_ACL_UT_SOAK_NPU;
+            ut_simulate_ndi_entry_action_error_atype () = type;
+            break;
+        default:
+            break;
+    }
+}
+
+static bool soak_fault_fired (soak_fault_t fault)
+{
+    switch (fault) {
+        case SOAK_FAULT_ENTRY_CREATE:
+            return (ut_simulate_ndi_entry_create_error () == UT_RESET_NPU);
+        case SOAK_FAULT_ENTRY_DELETE:
+            return (ut_simulate_ndi_entry_delete_error () == UT_RESET_NPU);
+        case SOAK_FAULT_PRIORITY:
+            return (ut_simulate_ndi_entry_priority_error () == UT_RESET_NPU);
+        case SOAK_FAULT_FILTER:
+            return (ut_simulate_ndi_entry_filter_error_npu () == UT_RESET_NPU);
+        case SOAK_FAULT_ACTION:
+            return (ut_simulate_ndi_entry_action_error_npu () == UT_RESET_NPU);
+        default:
+            return false;
+    }
+}
+
+static void soak_fault_disarm ()
+{
+    ut_simulate_ndi_entry_create_error () = UT_RESET_NPU;
+    ut_simulate_ndi_entry_delete_error () = UT_RESET_NPU;
+    ut_simulate_ndi_entry_priority_error () = UT_RESET_NPU;
+    ut_simulate_ndi_entry_filter_error_npu () = UT_RESET_NPU;
+    ut_simulate_ndi_entry_filter_error_ftype () = UT_RESET_FTYPE;
+    ut_simulate_ndi_entry_action_error_npu () = UT_RESET_NPU;
+    ut_simulate_ndi_entry_action_error_atype () = UT_RESET_ATYPE;
+}
+
+static bool soak_inject (soak_ctx_t& ctx)
+{
+    return (soak_rand (ctx, 0, 99) < NAS_ACL_UT_SOAK_FAULT_PCT);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CPS object construction and commit
+/////////////////////////////////////////////////////////////////////////////
+
+static cps_api_object_t soak_obj_create (cps_api_attr_id_t obj_attr,
+                                         cps_api_attr_id_t table_attr,
+                                         nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static void soak_set_id (cps_api_object_t obj, cps_api_attr_id_t id_attr,
+                         nas_obj_id_t id)
+{
+    cps_api_set_key_data (obj, id_attr, cps_api_object_ATTR_T_U64,
+                          &id, sizeof (uint64_t));
+}
+
+static cps_api_object_t soak_entry_obj (nas_obj_id_t table_id, nas_obj_id_t entry_id,
+                                        const soak_entry_t& entry)
+{
+    auto obj = soak_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    if (entry_id != 0) {
+        soak_set_id (obj, BASE_ACL_ENTRY_ID, entry_id);
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+    ut_entry.priority  = entry.priority;
+
+    for (const auto& filter: entry.filters) {
+        ut_entry.filter_list.insert ({filter.first,
+                                      {filter.second, NAS_ACL_UT_SOAK_FILTER_MASK}});
+    }
+    for (const auto& action: entry.actions) {
+        ut_entry.action_list.insert ({action.first, {action.second}});
+    }
+    if (entry.counter_id != 0) {
+        ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_COUNTER,
+                                      {(uint32_t) entry.counter_id}});
+    }
+
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, entry.priority);
+
+    if (!ut_fill_entry_match (obj, ut_entry) ||
+        !ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return NULL;
+    }
+    return obj;
+}
+
+// Incremental update object for a single filter or action of an entry
+template <typename I, typename T>
+static cps_api_object_t soak_incr_obj (cps_api_attr_id_t obj_attr,
+                                       cps_api_attr_id_t type_attr,
+                                       const I& map_info, nas_obj_id_t table_id,
+                                       nas_obj_id_t entry_id, T type,
+                                       const uint32_t* val)
+{
+    auto obj = soak_obj_create (obj_attr, BASE_ACL_ENTRY_TABLE_ID, table_id);
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    uint32_t type_u32 = type;
+    soak_set_id (obj, BASE_ACL_ENTRY_ID, entry_id);
+    cps_api_set_key_data (obj, type_attr, cps_api_object_ATTR_T_U32,
+                          &type_u32, sizeof (uint32_t));
+
+    if (val != NULL) {
+        ut_attr_id_list_t parent_list {map_info.val.attr_id};
+
+        if (!ut_copy_data_to_obj (parent_list, map_info.child_list, obj,
+                                  map_info.val.data_type, map_info.val.data_len,
+                                  {*val, NAS_ACL_UT_SOAK_FILTER_MASK})) {
+            cps_api_object_delete (obj);
+            return NULL;
+        }
+    }
+    return obj;
+}
+
+// Builds a transaction with fill_fn and commits it with rollback.
+// Returns false only if the transaction could not be built.
+template <typename F>
+static bool soak_commit (soak_ctx_t& ctx, F fill_fn, cps_api_return_code_t* rc,
+                         std::vector<nas_obj_id_t>* ret_ids = NULL,
+                         cps_api_attr_id_t ret_id_attr = 0)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    if (!fill_fn (&params)) {
+        ut_printf ("%s(): Failed to build transaction\r\n", __FUNCTION__);
+        cps_api_transaction_close (&params);
+        return false;
+    }
+
+    uint64_t start_ns = nas_acl_perf_now_ns ();
+    *rc = nas_acl_ut_cps_api_commit (&params, true);
+    ctx.commit_ns += nas_acl_perf_now_ns () - start_ns;
+    ctx.commits++;
+
+    if (*rc == cps_api_ret_code_OK && ret_ids != NULL) {
+        size_t count = cps_api_object_list_size (params.change_list);
+        for (size_t idx = 0; idx < count; idx++) {
+            auto obj = cps_api_object_list_get (params.change_list, idx);
+            auto attr = cps_api_get_key_data (obj, ret_id_attr);
+            ret_ids->push_back (cps_api_object_attr_data_u64 (attr));
+        }
+    }
+
+    cps_api_transaction_close (&params);
+    return true;
+}
+
+static bool soak_check_result (soak_ctx_t& ctx, const char* op,
+                               cps_api_return_code_t rc, bool expect_ok)
+{
+    if (rc != cps_api_ret_code_OK) {
+        ctx.failed_commits++;
+    }
+    if ((rc == cps_api_ret_code_OK) != expect_ok) {
+        ut_printf ("%s(): Step %zu: %s %s unexpectedly\r\n", __FUNCTION__,
+                   ctx.step, op, (expect_ok) ? "failed" : "succeeded");
+        return false;
+    }
+    return true;
+}
+
+// Disarms the fault and returns whether the commit outcome matched
+static bool soak_check_fault (soak_ctx_t& ctx, const char* op,
+                              cps_api_return_code_t rc, soak_fault_t fault)
+{
+    bool fired = soak_fault_fired (fault);
+
+    soak_fault_disarm ();
+    if (fired) {
+        ctx.faults_fired++;
+    }
+    return soak_check_result (ctx, op, rc, !fired);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Randomized operations - each commits one transaction and updates the
+// reference model only if the transaction succeeded
+/////////////////////////////////////////////////////////////////////////////
+
+static void soak_rand_entry (soak_ctx_t& ctx, const soak_table_t& table,
+                             soak_entry_t& entry)
+{
+    entry.priority = soak_rand (ctx, 1, 0xffff);
+    entry.filters.clear ();
+    entry.actions.clear ();
+    entry.counter_id = 0;
+
+    size_t num_filters = soak_rand (ctx, 1, 4);
+    while (entry.filters.size () < num_filters) {
+        entry.filters [*soak_rand_pick (ctx, _soak_filter_pool)] =
+            soak_rand (ctx, 1, NAS_ACL_UT_SOAK_FILTER_MASK);
+    }
+
+    size_t num_actions = soak_rand (ctx, 1, 3);
+    while (entry.actions.size () < num_actions) {
+        entry.actions [*soak_rand_pick (ctx, _soak_action_pool)] = soak_rand (ctx, 0, 7);
+    }
+
+    if (!table.counters.empty () && soak_rand (ctx, 0, 1)) {
+        entry.counter_id = *soak_rand_pick (ctx, table.counters);
+    }
+}
+
+static bool soak_entry_create (soak_ctx_t& ctx, soak_table_t& table)
+{
+    if (table.entries.size () >= NAS_ACL_UT_SOAK_MAX_ENTRIES) {
+        return true;
+    }
+
+    soak_entry_t entry;
+    soak_rand_entry (ctx, table, entry);
+
+    auto fault = (soak_inject (ctx)) ? SOAK_FAULT_ENTRY_CREATE : SOAK_FAULT_NONE;
+    soak_fault_arm (fault, 0);
+
+    std::vector<nas_obj_id_t> ids;
+    cps_api_return_code_t     rc;
+
+    if (!soak_commit (ctx, [&] (cps_api_transaction_params_t* params) {
+            auto obj = soak_entry_obj (table.table_id, 0, entry);
+            return (obj != NULL && cps_api_create (params, obj) == cps_api_ret_code_OK);
+        }, &rc, &ids, BASE_ACL_ENTRY_ID)) {
+        soak_fault_disarm ();
+        return false;
+    }
+
+    if (!soak_check_fault (ctx, "Entry create", rc, fault)) {
+        return false;
+    }
+    if (rc == cps_api_ret_code_OK) {
+        table.entries [ids.at (0)] = entry;
+        table.max_entry_id = std::max (table.max_entry_id, ids.at (0));
+    }
+    return true;
+}
+
+// Several entries in one transaction. The last one optionally refers to a
+// non-existent counter so that the earlier creates have to be rolled back.
+static bool soak_batch_create (soak_ctx_t& ctx, soak_table_t& table)
+{
+    size_t num = soak_rand (ctx, 2, NAS_ACL_UT_SOAK_MAX_BATCH);
+
+    if (table.entries.size () + num > NAS_ACL_UT_SOAK_MAX_ENTRIES) {
+        return true;
+    }
+
+    std::vector<soak_entry_t> batch (num);
+    for (auto& entry: batch) {
+        soak_rand_entry (ctx, table, entry);
+    }
+
+    nas_obj_id_t bad_counter_id = nas_acl_switch::NAS_ACL_ENTRY_ID_MAX - 1;
+    bool invalid = (soak_rand (ctx, 0, 1) && table.counters.count (bad_counter_id) == 0);
+    if (invalid) {
+        batch.back ().counter_id = bad_counter_id;
+    }
+
+    std::vector<nas_obj_id_t> ids;
+    cps_api_return_code_t     rc;
+
+    if (!soak_commit (ctx, [&] (cps_api_transaction_params_t* params) {
+            for (const auto& entry: batch) {
+                auto obj = soak_entry_obj (table.table_id, 0, entry);
+                if (obj == NULL || cps_api_create (params, obj) != cps_api_ret_code_OK) {
+                    return false;
+                }
+            }
+            return true;
+        }, &rc, &ids, BASE_ACL_ENTRY_ID)) {
+        return false;
+    }
+
+    if (!soak_check_result (ctx, "Entry batch create", rc, !invalid)) {
+        return false;
+    }
+    if (rc == cps_api_ret_code_OK) {
+        for (size_t idx = 0; idx < num; idx++) {
+            table.entries [ids.at (idx)] = batch [idx];
+            table.max_entry_id = std::max (table.max_entry_id, ids.at (idx));
+        }
+    }
+    return true;
+}
+
+static bool soak_entry_modify (soak_ctx_t& ctx, soak_table_t& table)
+{
+    if (table.entries.empty ()) {
+        return true;
+    }
+
+    nas_obj_id_t entry_id = soak_rand_pick (ctx, table.entries)->first;
+    soak_entry_t entry;
+    soak_rand_entry (ctx, table, entry);
+
+    auto fault = SOAK_FAULT_NONE;
+    uint32_t type = 0;
+
+    if (soak_inject (ctx)) {
+        switch (soak_rand (ctx, 0, 2)) {
+            case 0:
+                fault = SOAK_FAULT_PRIORITY;
+                break;
+            case 1:
+                fault = SOAK_FAULT_FILTER;
+                type = soak_rand_pick (ctx, entry.filters)->first;
+                break;
+            default:
+                fault = SOAK_FAULT_ACTION;
+                type = soak_rand_pick (ctx, entry.actions)->first;
+                break;
+        }
+    }
+    soak_fault_arm (fault, type);
+
+    cps_api_return_code_t rc;
+
+    if (!soak_commit (ctx, [&] (cps_api_transaction_params_t* params) {
+            auto obj = soak_entry_obj (table.table_id, entry_id, entry);
+            return (obj != NULL && cps_api_set (params, obj) == cps_api_ret_code_OK);
+        }, &rc)) {
+        soak_fault_disarm ();
+        return false;
+    }
+
+    if (!soak_check_fault (ctx, "Entry modify", rc, fault)) {
+        return false;
+    }
+    if (rc == cps_api_ret_code_OK) {
+        table.entries [entry_id] = entry;
+    }
+    return true;
+}
+
+static bool soak_filter_incr_upd (soak_ctx_t& ctx, soak_table_t& table)
+{
+    if (table.entries.empty ()) {
+        return true;
+    }
+
+    auto& entry_kv = *std::next (table.entries.begin (),
+                                 soak_rand (ctx, 0, table.entries.size () - 1));
+    auto& filters = entry_kv.second.filters;
+
+    auto ftype = *soak_rand_pick (ctx, _soak_filter_pool);
+    uint32_t val = soak_rand (ctx, 1, NAS_ACL_UT_SOAK_FILTER_MASK);
+    auto op = cps_api_oper_SET;
+
+    if (filters.count (ftype) == 0) {
+        op = cps_api_oper_CREATE;
+    } else if (filters.size () > 1 && soak_rand (ctx, 0, 2) == 0) {
+        op = cps_api_oper_DELETE;
+    }
+
+    auto fault = (soak_inject (ctx)) ? SOAK_FAULT_FILTER : SOAK_FAULT_NONE;
+    soak_fault_arm (fault, ftype);
+
+    cps_api_return_code_t rc;
+
+    if (!soak_commit (ctx, [&] (cps_api_transaction_params_t* params) {
+            auto obj = soak_incr_obj (BASE_ACL_ENTRY_MATCH, BASE_ACL_ENTRY_MATCH_TYPE,
+                                      *nas_acl_get_filter_info (ftype), table.table_id,
+                                      entry_kv.first, ftype,
+                                      (op == cps_api_oper_DELETE) ? NULL: &val);
+            if (obj == NULL) return false;
+
+            return (((op == cps_api_oper_CREATE) ? cps_api_create (params, obj) :
+                     (op == cps_api_oper_DELETE) ? cps_api_delete (params, obj) :
+                     cps_api_set (params, obj)) == cps_api_ret_code_OK);
+        }, &rc)) {
+        soak_fault_disarm ();
+        return false;
+    }
+
+    if (!soak_check_fault (ctx, "Filter incremental update", rc, fault)) {
+        return false;
+    }
+    if (rc == cps_api_ret_code_OK) {
+        if (op == cps_api_oper_DELETE) {
+            filters.erase (ftype);
+        } else {
+            filters [ftype] = val;
+        }
+    }
+    return true;
+}
+
+static bool soak_action_incr_upd (soak_ctx_t& ctx, soak_table_t& table)
+{
+    if (table.entries.empty ()) {
+        return true;
+    }
+
+    auto& entry_kv = *std::next (table.entries.begin (),
+                                 soak_rand (ctx, 0, table.entries.size () - 1));
+    auto& actions = entry_kv.second.actions;
+
+    auto atype = *soak_rand_pick (ctx, _soak_action_pool);
+    uint32_t val = soak_rand (ctx, 0, 7);
+    auto op = cps_api_oper_SET;
+
+    if (actions.count (atype) == 0) {
+        op = cps_api_oper_CREATE;
+    } else if (actions.size () > 1 && soak_rand (ctx, 0, 2) == 0) {
+        op = cps_api_oper_DELETE;
+    }
+
+    auto fault = (soak_inject (ctx)) ? SOAK_FAULT_ACTION : SOAK_FAULT_NONE;
+    soak_fault_arm (fault, atype);
+
+    cps_api_return_code_t rc;
+
+    if (!soak_commit (ctx, [&] (cps_api_transaction_params_t* params) {
+            auto obj = soak_incr_obj (BASE_ACL_ENTRY_ACTION, BASE_ACL_ENTRY_ACTION_TYPE,
+                                      *nas_acl_get_action_info (atype), table.table_id,
+                                      entry_kv.first, atype,
+                                      (op == cps_api_oper_DELETE) ? NULL: &val);
+            if (obj == NULL) return false;
+
+            return (((op == cps_api_oper_CREATE) ? cps_api_create (params, obj) :
+                     (op == cps_api_oper_DELETE) ? cps_api_delete (params, obj) :
+                     cps_api_set (params, obj)) == cps_api_ret_code_OK);
+        }, &rc)) {
+        soak_fault_disarm ();
+        return false;
+    }
+
+    if (!soak_check_fault (ctx, "Action incremental update", rc, fault)) {
+        return false;
+    }
+    if (rc == cps_api_ret_code_OK) {
+        if (op == cps_api_oper_DELETE) {
+            actions.erase (atype);
+        } else {
+            actions [atype] = val;
+        }
+    }
+    return true;
+}
+
+static bool soak_entry_delete (soak_ctx_t& ctx, soak_table_t& table)
+{
+    if (table.entries.empty ()) {
+        return true;
+    }
+
+    nas_obj_id_t entry_id = soak_rand_pick (ctx, table.entries)->first;
+
+    auto fault = (soak_inject (ctx)) ? SOAK_FAULT_ENTRY_DELETE : SOAK_FAULT_NONE;
+    soak_fault_arm (fault, 0);
+
+    cps_api_return_code_t rc;
+
+    if (!soak_commit (ctx, [&] (cps_api_transaction_params_t* params) {
+            auto obj = soak_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                        table.table_id);
+            if (obj == NULL) return false;
+
+            soak_set_id (obj, BASE_ACL_ENTRY_ID, entry_id);
+            return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+        }, &rc)) {
+        soak_fault_disarm ();
+        return false;
+    }
+
+    if (!soak_check_fault (ctx, "Entry delete", rc, fault)) {
+        return false;
+    }
+    if (rc == cps_api_ret_code_OK) {
+        table.entries.erase (entry_id);
+    }
+    return true;
+}
+
+static bool soak_counter_create (soak_ctx_t& ctx, soak_table_t& table)
+{
+    if (table.counters.size () >= NAS_ACL_UT_SOAK_MAX_COUNTERS) {
+        return true;
+    }
+
+    std::vector<nas_obj_id_t> ids;
+    cps_api_return_code_t     rc;
+
+    if (!soak_commit (ctx, [&] (cps_api_transaction_params_t* params) {
+            auto obj = soak_obj_create (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID,
+                                        table.table_id);
+            if (obj == NULL) return false;
+
+            cps_api_object_attr_add_u32 (obj, BASE_ACL_COUNTER_TYPES,
+                                         BASE_ACL_COUNTER_TYPE_PACKET);
+            return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+        }, &rc, &ids, BASE_ACL_COUNTER_ID)) {
+        return false;
+    }
+
+    if (!soak_check_result (ctx, "Counter create", rc, true)) {
+        return false;
+    }
+    table.counters.insert (ids.at (0));
+    table.max_counter_id = std::max (table.max_counter_id, ids.at (0));
+    return true;
+}
+
+// Counters still referred to by an entry cannot be deleted
+static bool soak_counter_delete (soak_ctx_t& ctx, soak_table_t& table)
+{
+    if (table.counters.empty ()) {
+        return true;
+    }
+
+    nas_obj_id_t counter_id = *soak_rand_pick (ctx, table.counters);
+    bool in_use = std::any_of (table.entries.begin (), table.entries.end (),
+                               [&] (const std::pair<const nas_obj_id_t, soak_entry_t>& kv) {
+                                   return (kv.second.counter_id == counter_id);
+                               });
+
+    cps_api_return_code_t rc;
+
+    if (!soak_commit (ctx, [&] (cps_api_transaction_params_t* params) {
+            auto obj = soak_obj_create (BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID,
+                                        table.table_id);
+            if (obj == NULL) return false;
+
+            soak_set_id (obj, BASE_ACL_COUNTER_ID, counter_id);
+            return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+        }, &rc)) {
+        return false;
+    }
+
+    if (!soak_check_result (ctx, "Counter delete", rc, !in_use)) {
+        return false;
+    }
+    if (rc == cps_api_ret_code_OK) {
+        table.counters.erase (counter_id);
+    }
+    return true;
+}
+
+static const soak_op_t _soak_ops [] = {
+    {"entry-create",          soak_entry_create,    30},
+    {"entry-batch-create",    soak_batch_create,     6},
+    {"entry-modify",          soak_entry_modify,    15},
+    {"filter-incr-upd",       soak_filter_incr_upd, 15},
+    {"action-incr-upd",       soak_action_incr_upd, 10},
+    {"entry-delete",          soak_entry_delete,    16},
+    {"counter-create",        soak_counter_create,   5},
+    {"counter-delete",        soak_counter_delete,   3},
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Invariants - NAS ACL cache, ID generators and NDI stub against the model
+/////////////////////////////////////////////////////////////////////////////
+
+static bool soak_entry_matches (const nas_acl_entry& entry, const soak_entry_t& model)
+{
+    size_t num_actions = model.actions.size () + ((model.counter_id != 0) ? 1 : 0);
+
+    if (entry.priority () != model.priority ||
+        entry.counter_id () != model.counter_id ||
+        entry.get_filter_list ().size () != model.filters.size () ||
+        entry.get_action_list ().size () != num_actions) {
+        return false;
+    }
+    for (const auto& filter: model.filters) {
+        if (entry.get_filter_list ().count (filter.first) == 0) return false;
+    }
+    for (const auto& action: model.actions) {
+        if (entry.get_action_list ().count (action.first) == 0) return false;
+    }
+    return true;
+}
+
+static bool soak_verify_table (soak_ctx_t& ctx, nas_acl_switch& sw,
+                               const soak_table_t& table,
+                               ut_ndi_entry_id_set_t& ndi_owned)
+{
+    auto table_id = table.table_id;
+
+    if (sw.find_table (table_id) == NULL) {
+        ut_printf ("Table %ld missing\r\n", table_id);
+        return false;
+    }
+    if (sw.entry_list (table_id).size () != table.entries.size () ||
+        sw.counter_list (table_id).size () != table.counters.size ()) {
+        ut_printf ("Table %ld: %ld entries %ld counters, expected %ld %ld\r\n",
+                   table_id, sw.entry_list (table_id).size (),
+                   sw.counter_list (table_id).size (),
+                   table.entries.size (), table.counters.size ());
+        return false;
+    }
+
+    for (const auto& entry_kv: table.entries) {
+
+        auto entry_p = sw.find_entry (table_id, entry_kv.first);
+
+        if (entry_p == NULL || !soak_entry_matches (*entry_p, entry_kv.second)) {
+            ut_printf ("Table %ld Entry %ld does not match model\r\n",
+                       table_id, entry_kv.first);
+            return false;
+        }
+        if (sw.reserve_entry_id_in_table (table_id, entry_kv.first)) {
+            sw.release_entry_id_in_table (table_id, entry_kv.first);
+            ut_printf ("Table %ld Entry ID %ld free while in use\r\n",
+                       table_id, entry_kv.first);
+            return false;
+        }
+
+        // Exactly one set of NDI entries per NPU, not shared with any entry
+        for (auto npu_id: entry_p->npu_list ()) {
+            if (entry_p->ndi_entry_ids.count (npu_id) == 0) {
+                ut_printf ("Table %ld Entry %ld not in NPU %d\r\n",
+                           table_id, entry_kv.first, npu_id);
+                return false;
+            }
+            for (auto ndi_entry_id: entry_p->ndi_entry_id_list (npu_id)) {
+                if (!ndi_owned.insert ({npu_id, ndi_entry_id}).second) {
+                    ut_printf ("NPU %d NDI Entry %ld used twice\r\n", npu_id, ndi_entry_id);
+                    return false;
+                }
+            }
+        }
+    }
+
+    for (auto counter_id: table.counters) {
+
+        std::set<nas_obj_id_t> refs;
+        for (const auto& entry_kv: table.entries) {
+            if (entry_kv.second.counter_id == counter_id) {
+                refs.insert (entry_kv.first);
+            }
+        }
+
+        auto counter_p = sw.find_counter (table_id, counter_id);
+        if (counter_p == NULL || counter_p->refs () != refs) {
+            ut_printf ("Table %ld Counter %ld missing or bad references\r\n",
+                       table_id, counter_id);
+            return false;
+        }
+        if (sw.reserve_counter_id_in_table (table_id, counter_id)) {
+            sw.release_counter_id_in_table (table_id, counter_id);
+            ut_printf ("Table %ld Counter ID %ld free while in use\r\n",
+                       table_id, counter_id);
+            return false;
+        }
+    }
+
+    // A random ID that is not in the model must be free - else an ID
+    // was leaked by a failed or rolled back transaction
+    nas_obj_id_t probe = soak_rand (ctx, 1, table.max_entry_id + 1);
+    if (table.entries.count (probe) == 0) {
+        if (!sw.reserve_entry_id_in_table (table_id, probe)) {
+            ut_printf ("Table %ld Entry ID %ld leaked\r\n", table_id, probe);
+            return false;
+        }
+        sw.release_entry_id_in_table (table_id, probe);
+    }
+
+    probe = soak_rand (ctx, 1, table.max_counter_id + 1);
+    if (table.counters.count (probe) == 0) {
+        if (!sw.reserve_counter_id_in_table (table_id, probe)) {
+            ut_printf ("Table %ld Counter ID %ld leaked\r\n", table_id, probe);
+            return false;
+        }
+        sw.release_counter_id_in_table (table_id, probe);
+    }
+
+    return true;
+}
+
+static bool soak_verify (soak_ctx_t& ctx)
+{
+    uint64_t start_ns = nas_acl_perf_now_ns ();
+    bool     rc = true;
+
+    try {
+        auto& sw = nas_acl_get_switch (NAS_ACL_UT_DEF_SWITCH_ID);
+        ut_ndi_entry_id_set_t ndi_owned;
+
+        for (const auto& table: ctx.tables) {
+            if (!soak_verify_table (ctx, sw, table, ndi_owned)) {
+                rc = false;
+                break;
+            }
+        }
+
+        // No NDI entries leaked or lost by failed transactions
+        if (rc) {
+            ut_ndi_entry_id_set_t expected {ctx.ndi_baseline};
+            expected.insert (ndi_owned.begin (), ndi_owned.end ());
+
+            if (expected.size () != ctx.ndi_baseline.size () + ndi_owned.size () ||
+                expected != ut_ndi_entry_live_ids ()) {
+                ut_printf ("NDI entries: %ld in stub, expected %ld\r\n",
+                           ut_ndi_entry_live_ids ().size (), expected.size ());
+                rc = false;
+            }
+        }
+    } catch (nas::base_exception& e) {
+        ut_printf ("%s(): %s\r\n", __FUNCTION__, e.err_msg.c_str ());
+        rc = false;
+    }
+
+    ctx.verify_ns += nas_acl_perf_now_ns () - start_ns;
+    return rc;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Setup and teardown
+/////////////////////////////////////////////////////////////////////////////
+
+static bool soak_tables_create (soak_ctx_t& ctx)
+{
+    for (size_t idx = 0; idx < NAS_ACL_UT_SOAK_TABLES; idx++) {
+
+        std::vector<nas_obj_id_t> ids;
+        cps_api_return_code_t     rc;
+
+        if (!soak_commit (ctx, [&] (cps_api_transaction_params_t* params) {
+                auto obj = soak_obj_create (BASE_ACL_TABLE_OBJ, 0, 0);
+                if (obj == NULL) return false;
+
+                cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE,
+                                             BASE_ACL_STAGE_INGRESS);
+                cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 100 + idx);
+                cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST,
+                                             NAS_ACL_UT_SOAK_NPU);
+                for (auto ftype: _soak_filter_pool) {
+                    cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                                 ftype);
+                }
+                return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+            }, &rc, &ids, BASE_ACL_TABLE_ID)) {
+            return false;
+        }
+
+        if (!soak_check_result (ctx, "Table create", rc, true)) {
+            return false;
+        }
+        ctx.tables.push_back ({ids.at (0), {}, {}, 0, 0});
+    }
+    return true;
+}
+
+static bool soak_delete_obj (soak_ctx_t& ctx, cps_api_attr_id_t obj_attr,
+                             cps_api_attr_id_t table_attr, cps_api_attr_id_t id_attr,
+                             nas_obj_id_t table_id, nas_obj_id_t id)
+{
+    cps_api_return_code_t rc;
+
+    if (!soak_commit (ctx, [&] (cps_api_transaction_params_t* params) {
+            auto obj = soak_obj_create (obj_attr, table_attr, table_id);
+            if (obj == NULL) return false;
+
+            soak_set_id (obj, id_attr, id);
+            return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+        }, &rc)) {
+        return false;
+    }
+    return soak_check_result (ctx, "Teardown delete", rc, true);
+}
+
+// Deletes everything and checks that all IDs ever handed out are free again
+static bool soak_teardown (soak_ctx_t& ctx)
+{
+    auto& sw = nas_acl_get_switch (NAS_ACL_UT_DEF_SWITCH_ID);
+
+    for (auto& table: ctx.tables) {
+
+        for (const auto& entry_kv: table.entries) {
+            if (!soak_delete_obj (ctx, BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID,
+                                  BASE_ACL_ENTRY_ID, table.table_id, entry_kv.first)) {
+                return false;
+            }
+        }
+        table.entries.clear ();
+
+        for (auto counter_id: table.counters) {
+            if (!soak_delete_obj (ctx, BASE_ACL_COUNTER_OBJ, BASE_ACL_COUNTER_TABLE_ID,
+                                  BASE_ACL_COUNTER_ID, table.table_id, counter_id)) {
+                return false;
+            }
+        }
+        table.counters.clear ();
+
+        for (nas_obj_id_t id = 1; id <= table.max_entry_id; id++) {
+            if (!sw.reserve_entry_id_in_table (table.table_id, id)) {
+                ut_printf ("Table %ld Entry ID %ld leaked\r\n", table.table_id, id);
+                return false;
+            }
+            sw.release_entry_id_in_table (table.table_id, id);
+        }
+        for (nas_obj_id_t id = 1; id <= table.max_counter_id; id++) {
+            if (!sw.reserve_counter_id_in_table (table.table_id, id)) {
+                ut_printf ("Table %ld Counter ID %ld leaked\r\n", table.table_id, id);
+                return false;
+            }
+            sw.release_counter_id_in_table (table.table_id, id);
+        }
+
+        if (!soak_delete_obj (ctx, BASE_ACL_TABLE_OBJ, 0, BASE_ACL_TABLE_ID,
+                              0, table.table_id)) {
+            return false;
+        }
+    }
+    ctx.tables.clear ();
+
+    if (ut_ndi_entry_live_ids () != ctx.ndi_baseline) {
+        ut_printf ("%ld NDI entries left behind\r\n",
+                   ut_ndi_entry_live_ids ().size () - ctx.ndi_baseline.size ());
+        return false;
+    }
+    return true;
+}
+
+bool nas_acl_ut_soak_test (uint32_t seed, size_t steps)
+{
+    soak_ctx_t ctx {};
+
+    ctx.seed = seed;
+    ctx.rng.seed (seed);
+    ctx.ndi_baseline = ut_ndi_entry_live_ids ();
+
+    ut_printf ("---------- ACL Soak TEST STARTED - seed %u steps %ld ------------\r\n",
+               seed, steps);
+
+    soak_fault_disarm ();
+
+    if (!soak_tables_create (ctx) || !soak_verify (ctx)) {
+        return false;
+    }
+
+    std::vector<double> weights;
+    for (const auto& op: _soak_ops) {
+        weights.push_back (op.weight);
+    }
+    std::discrete_distribution<size_t> op_dist (weights.begin (), weights.end ());
+    std::vector<size_t> op_count (weights.size ());
+
+    uint64_t start_ns = nas_acl_perf_now_ns ();
+
+    for (ctx.step = 0; ctx.step < steps; ctx.step++) {
+
+        auto& table = ctx.tables.at (soak_rand (ctx, 0, ctx.tables.size () - 1));
+        auto  op = op_dist (ctx.rng);
+
+        op_count [op]++;
+
+        if (!_soak_ops [op].fn (ctx, table) || !soak_verify (ctx)) {
+            ut_printf ("Soak FAILED at step %ld (%s on Table %ld), seed %u\r\n",
+                       ctx.step, _soak_ops [op].name, table.table_id, seed);
+            return false;
+        }
+    }
+
+    uint64_t elapsed_ns = nas_acl_perf_now_ns () - start_ns;
+
+    printf ("ACL soak: seed %u, %zu steps, %zu commits (%zu failed, %zu NDI faults)"
+            " in %.3f ms\r\n", seed, steps, ctx.commits, ctx.failed_commits,
+            ctx.faults_fired, elapsed_ns / 1e6);
+    printf ("    %.0f commits/s, commit %.3f ms, verify %.3f ms, peak RSS %zu kB\r\n",
+            (elapsed_ns) ? (ctx.commits * 1e9) / elapsed_ns : 0,
+            ctx.commit_ns / 1e6, ctx.verify_ns / 1e6, soak_peak_rss_kb ());
+    for (size_t op = 0; op < op_count.size (); op++) {
+        ut_printf ("    %-22s %zu\r\n", _soak_ops [op].name, op_count [op]);
+    }
+
+    if (!soak_teardown (ctx)) {
+        return false;
+    }
+
+    ut_printf ("********** ACL Soak TEST PASSED ********** .\r\n\n");
+    return true;
+}
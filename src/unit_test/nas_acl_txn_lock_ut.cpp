@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_switch_list.h"
+#include <chrono>
+#include <future>
+#include <vector>
+
+#define UT_TXN_NPU          0
+#define UT_TXN_ENTRY_ID     100
+#define UT_TXN_UNDO_ID      200
+#define UT_TXN_BAD_ENTRY    4000
+#define UT_TXN_WAIT_MS      100
+
+static cps_api_object_t ut_txn_obj_create (cps_api_attr_id_t obj_attr,
+                                           cps_api_attr_id_t table_attr,
+                                           nas_obj_id_t      table_id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static bool ut_txn_table_op (nas_obj_id_t* table_id, bool create)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_txn_obj_create (BASE_ACL_TABLE_OBJ, (create) ? 0 : BASE_ACL_TABLE_ID,
+                                  *table_id);
+    bool ok = (obj != NULL);
+
+    if (ok && create) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 93);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_TXN_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_L4_DST_PORT);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    } else if (ok) {
+        ok = (cps_api_delete (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok && create) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+// Adds an Entry write to the transaction
+static bool ut_txn_entry_op (cps_api_transaction_params_t* params,
+                             cps_api_operation_types_t op, nas_obj_id_t table_id,
+                             nas_obj_id_t entry_id, uint32_t priority)
+{
+    auto obj = ut_txn_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id);
+
+    if (obj == NULL) {
+        return false;
+    }
+
+    cps_api_set_key_data (obj, BASE_ACL_ENTRY_ID, cps_api_object_ATTR_T_U64,
+                          &entry_id, sizeof (uint64_t));
+
+    if (op == cps_api_oper_DELETE) {
+        return (cps_api_delete (params, obj) == cps_api_ret_code_OK);
+    }
+
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, priority);
+
+    if (op == cps_api_oper_SET) {
+        return (cps_api_set (params, obj) == cps_api_ret_code_OK);
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+    ut_entry.priority  = priority;
+    ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_L4_DST_PORT, {priority, 0xffff}});
+    ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+
+    if (!ut_fill_entry_match (obj, ut_entry) ||
+        !ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return false;
+    }
+
+    return (cps_api_create (params, obj) == cps_api_ret_code_OK);
+}
+
+static const nas_acl_entry* ut_txn_find_entry (nas_obj_id_t table_id,
+                                               nas_obj_id_t entry_id)
+{
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    return s.find_entry (table_id, entry_id);
+}
+
+// Stands in for a reader - returns once it gets the NAS ACL lock
+static std::future<void> ut_txn_reader_start ()
+{
+    return std::async (std::launch::async, [] () {
+        nas_acl_lock ();
+        nas_acl_unlock ();
+    });
+}
+
+static bool ut_txn_reader_done (std::future<void>& reader)
+{
+    return (reader.wait_for (std::chrono::milliseconds (UT_TXN_WAIT_MS))
+            == std::future_status::ready);
+}
+
+// Writes the transaction one object at a time - as the CPS commit does -
+// and checks that a reader is held off until the last object is written
+static bool ut_txn_write_checked (cps_api_transaction_params_t* params)
+{
+    size_t count = cps_api_object_list_size (params->change_list);
+    std::future<void> reader;
+
+    for (size_t index = 0; index < count; index++) {
+
+        if (nas_acl_cps_api_write (NULL, params, index) != cps_api_ret_code_OK) {
+            ut_printf ("%s(): Write %ld failed\r\n", __FUNCTION__, index);
+            return false;
+        }
+
+        if (index == 0) {
+            reader = ut_txn_reader_start ();
+        }
+
+        if (index + 1 < count && ut_txn_reader_done (reader)) {
+            ut_printf ("%s(): Reader ran after write %ld\r\n", __FUNCTION__, index);
+            return false;
+        }
+    }
+
+    return ut_txn_reader_done (reader);
+}
+
+bool nas_acl_ut_txn_lock_test ()
+{
+    nas_obj_id_t                  table_id = 0;
+    std::vector<nas_obj_id_t>     entry_ids;
+    cps_api_transaction_params_t  params;
+    bool                          ok = false;
+
+    if (!ut_txn_table_op (&table_id, true)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    nas_acl_txn_lock_enable (true);
+
+    do {
+        // Lock is held from the first to the last object of the transaction
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+        bool txn_ok = true;
+        for (uint32_t idx = 0; idx < 3; idx++) {
+            txn_ok = txn_ok && ut_txn_entry_op (&params, cps_api_oper_CREATE, table_id,
+                                                UT_TXN_ENTRY_ID + idx, 10 + idx);
+        }
+        if (txn_ok) {
+            txn_ok = (nas_acl_ut_is_on_target ()) ?
+                     (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK) :
+                     ut_txn_write_checked (&params);
+        }
+        cps_api_transaction_close (&params);
+
+        if (!txn_ok) {
+            ut_printf ("%s(): Transaction create failed\r\n", __FUNCTION__);
+            break;
+        }
+        for (uint32_t idx = 0; idx < 3; idx++) {
+            entry_ids.push_back (UT_TXN_ENTRY_ID + idx);
+        }
+
+        bool all_found = true;
+        for (auto entry_id: entry_ids) {
+            all_found = all_found && (ut_txn_find_entry (table_id, entry_id) != NULL);
+        }
+        if (!all_found) {
+            ut_printf ("%s(): Entries not created\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Failed transaction is rolled back per object and releases the lock
+        if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+            break;
+        }
+        txn_ok = ut_txn_entry_op (&params, cps_api_oper_CREATE, table_id,
+                                  UT_TXN_UNDO_ID, 20) &&
+                 ut_txn_entry_op (&params, cps_api_oper_SET, table_id,
+                                  UT_TXN_ENTRY_ID, 25) &&
+                 ut_txn_entry_op (&params, cps_api_oper_SET, table_id,
+                                  UT_TXN_BAD_ENTRY, 30) &&
+                 (nas_acl_ut_cps_api_commit (&params, true) != cps_api_ret_code_OK);
+        cps_api_transaction_close (&params);
+
+        auto reader = ut_txn_reader_start ();
+        auto mod_p  = ut_txn_find_entry (table_id, UT_TXN_ENTRY_ID);
+
+        if (!txn_ok || !ut_txn_reader_done (reader) ||
+            ut_txn_find_entry (table_id, UT_TXN_UNDO_ID) != NULL ||
+            mod_p == NULL || mod_p->priority () != 10) {
+            ut_printf ("%s(): Failed transaction not rolled back\r\n", __FUNCTION__);
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    if (cps_api_transaction_init (&params) == cps_api_ret_code_OK) {
+        bool txn_ok = true;
+
+        for (auto entry_id: entry_ids) {
+            txn_ok = txn_ok && ut_txn_entry_op (&params, cps_api_oper_DELETE, table_id,
+                                                entry_id, 0);
+        }
+        txn_ok = txn_ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+        cps_api_transaction_close (&params);
+
+        if (!txn_ok) {
+            ut_printf ("%s(): Entry delete failed\r\n", __FUNCTION__);
+            ok = false;
+        }
+    }
+
+    nas_acl_txn_lock_enable (false);
+
+    if (!ut_txn_table_op (&table_id, false)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    return ok;
+}
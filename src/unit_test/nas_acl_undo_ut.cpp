@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_db_ut.h"
+#include "nas_acl_switch_list.h"
+#include "nas_acl_undo.h"
+#include <algorithm>
+
+#define UT_UNDO_NPU         0
+#define UT_UNDO_BAD_ENTRY   0xFFFF
+// Any category other than ACL
+#define UT_UNDO_OTHER_CAT   (cps_api_obj_CAT_BASE_ACL + 1)
+
+static cps_api_object_t ut_undo_obj_create (cps_api_attr_id_t obj_attr,
+                                             cps_api_attr_id_t table_attr,
+                                             nas_obj_id_t      table_id,
+                                             cps_api_attr_id_t id_attr,
+                                             nas_obj_id_t      id)
+{
+    cps_api_object_t obj = cps_api_object_create ();
+
+    if (obj != NULL) {
+        cps_api_key_from_attr_with_qual (cps_api_object_key (obj), obj_attr,
+                                         cps_api_qualifier_TARGET);
+        if (table_attr != 0) {
+            cps_api_set_key_data (obj, table_attr, cps_api_object_ATTR_T_U64,
+                                  &table_id, sizeof (uint64_t));
+        }
+        if (id_attr != 0) {
+            cps_api_set_key_data (obj, id_attr, cps_api_object_ATTR_T_U64,
+                                  &id, sizeof (uint64_t));
+        }
+    }
+    return obj;
+}
+
+static bool ut_undo_write (cps_api_object_t obj, cps_api_operation_types_t op)
+{
+    cps_api_transaction_params_t params;
+
+    if (obj == NULL) {
+        return false;
+    }
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        cps_api_object_delete (obj);
+        return false;
+    }
+
+    bool ok = (((op == cps_api_oper_CREATE) ? cps_api_create (&params, obj) :
+                (op == cps_api_oper_SET) ? cps_api_set (&params, obj) :
+                cps_api_delete (&params, obj)) == cps_api_ret_code_OK) &&
+              (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+// Entry with In-port filter and a Set TC action
+static cps_api_object_t ut_undo_entry_obj (nas_obj_id_t table_id, nas_obj_id_t entry_id,
+                                           uint32_t priority, hal_ifindex_t in_port)
+{
+    auto obj = ut_undo_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                                   BASE_ACL_ENTRY_ID, entry_id);
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    ut_entry_t ut_entry {};
+
+    ut_entry.switch_id = NAS_ACL_UT_DEF_SWITCH_ID;
+    ut_entry.table_id  = table_id;
+    ut_entry.entry_id  = entry_id;
+    ut_entry.filter_list.insert ({BASE_ACL_MATCH_TYPE_IN_PORTS,
+                                  {1, static_cast<uint32_t> (in_port)}});
+    ut_entry.action_list.insert ({BASE_ACL_ACTION_TYPE_SET_TC, {1}});
+
+    cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, priority);
+
+    if (!ut_fill_entry_match (obj, ut_entry) || !ut_fill_entry_action (obj, ut_entry)) {
+        cps_api_object_delete (obj);
+        return NULL;
+    }
+    return obj;
+}
+
+static bool ut_undo_table_create (nas_obj_id_t* table_id)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    auto obj = ut_undo_obj_create (BASE_ACL_TABLE_OBJ, 0, 0, 0, 0);
+    bool ok = (obj != NULL);
+
+    if (ok) {
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_STAGE, BASE_ACL_STAGE_INGRESS);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_PRIORITY, 97);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_NPU_ID_LIST, UT_UNDO_NPU);
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_TABLE_ALLOWED_MATCH_FIELDS,
+                                     BASE_ACL_MATCH_TYPE_IN_PORTS);
+        ok = (cps_api_create (&params, obj) == cps_api_ret_code_OK);
+    }
+
+    ok = ok && (nas_acl_ut_cps_api_commit (&params, false) == cps_api_ret_code_OK);
+
+    if (ok) {
+        obj = cps_api_object_list_get (params.change_list, 0);
+        *table_id = cps_api_object_attr_data_u64 (cps_api_get_key_data (obj,
+                                                                        BASE_ACL_TABLE_ID));
+    }
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+static bool ut_undo_entry_check (nas_obj_id_t table_id, nas_obj_id_t entry_id,
+                                 uint32_t priority, hal_ifindex_t in_port)
+{
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+    auto entry_p = s.find_entry (table_id, entry_id);
+
+    if (entry_p == NULL || entry_p->priority () != priority) {
+        ut_printf ("%s(): Entry %ld not restored\r\n", __FUNCTION__, entry_id);
+        return false;
+    }
+
+    auto refs = s.if_entries (in_port);
+    if (std::find (refs.begin (), refs.end (), nas_acl_entry_ref_t {table_id, entry_id})
+        == refs.end ()) {
+        ut_printf ("%s(): Entry %ld lost In-port %d\r\n", __FUNCTION__, entry_id, in_port);
+        return false;
+    }
+    return true;
+}
+
+// Modify and Delete leave only the key in the prev object; the rollback
+// of a failed transaction restores the Entries from the undo journal
+static bool ut_undo_failed_txn (nas_obj_id_t table_id)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    bool ok = false;
+
+    do {
+        auto obj = ut_undo_entry_obj (table_id, 1, 50, 3);
+        if (obj == NULL || cps_api_set (&params, obj) != cps_api_ret_code_OK) {
+            break;
+        }
+        obj = ut_undo_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                                  BASE_ACL_ENTRY_ID, 2);
+        if (obj == NULL || cps_api_delete (&params, obj) != cps_api_ret_code_OK) {
+            break;
+        }
+        obj = ut_undo_obj_create (BASE_ACL_ENTRY_OBJ, BASE_ACL_ENTRY_TABLE_ID, table_id,
+                                  BASE_ACL_ENTRY_ID, UT_UNDO_BAD_ENTRY);
+        if (obj == NULL) {
+            break;
+        }
+        cps_api_object_attr_add_u32 (obj, BASE_ACL_ENTRY_PRIORITY, 1);
+        if (cps_api_set (&params, obj) != cps_api_ret_code_OK) {
+            break;
+        }
+
+        if (nas_acl_cps_api_write (NULL, &params, 0) != cps_api_ret_code_OK ||
+            nas_acl_cps_api_write (NULL, &params, 1) != cps_api_ret_code_OK) {
+            ut_printf ("%s(): Entry write failed\r\n", __FUNCTION__);
+            break;
+        }
+        if (nas_acl_undo_size () != 2) {
+            ut_printf ("%s(): %ld undo records, expected 2\r\n", __FUNCTION__,
+                       nas_acl_undo_size ());
+            break;
+        }
+
+        bool key_only = true;
+        for (size_t index = 0; index < 2; index++) {
+            auto prev = cps_api_object_list_get (params.prev, index);
+
+            if (prev == NULL ||
+                cps_api_object_attr_get (prev, BASE_ACL_ENTRY_PRIORITY) != NULL) {
+                ut_printf ("%s(): Entry serialized in prev %ld\r\n", __FUNCTION__, index);
+                key_only = false;
+            }
+        }
+        if (!key_only) {
+            break;
+        }
+
+        if (nas_acl_cps_api_write (NULL, &params, 2) == cps_api_ret_code_OK) {
+            ut_printf ("%s(): Bad Entry write succeeded\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Undo in reverse order - as cps_api_commit does
+        if (nas_acl_cps_api_rollback (NULL, &params, 1) != cps_api_ret_code_OK ||
+            nas_acl_cps_api_rollback (NULL, &params, 0) != cps_api_ret_code_OK) {
+            ut_printf ("%s(): Rollback failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Rollback of the first ACL object ends the transaction
+        ok = (nas_acl_undo_size () == 0);
+    } while (0);
+
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+// A rollback can come after the last ACL object if other objects follow -
+// the journal fills the prev objects before it is dropped
+static bool ut_undo_other_obj_follows (nas_obj_id_t table_id)
+{
+    cps_api_transaction_params_t params;
+
+    if (cps_api_transaction_init (&params) != cps_api_ret_code_OK) {
+        return false;
+    }
+
+    bool ok = false;
+
+    do {
+        auto obj = ut_undo_entry_obj (table_id, 1, 31, 5);
+        if (obj == NULL || cps_api_set (&params, obj) != cps_api_ret_code_OK) {
+            break;
+        }
+        obj = cps_api_object_create ();
+        if (obj == NULL) {
+            break;
+        }
+        cps_api_key_init (cps_api_object_key (obj), cps_api_qualifier_TARGET,
+                          UT_UNDO_OTHER_CAT, 1, 0);
+        if (cps_api_set (&params, obj) != cps_api_ret_code_OK) {
+            break;
+        }
+
+        if (nas_acl_cps_api_write (NULL, &params, 0) != cps_api_ret_code_OK) {
+            ut_printf ("%s(): Entry write failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        auto prev = cps_api_object_list_get (params.prev, 0);
+        if (nas_acl_undo_size () != 0 || prev == NULL ||
+            cps_api_object_attr_get (prev, BASE_ACL_ENTRY_PRIORITY) == NULL) {
+            ut_printf ("%s(): Prev not filled at the last ACL object\r\n", __FUNCTION__);
+            break;
+        }
+
+        // The other object failed
+        if (nas_acl_cps_api_rollback (NULL, &params, 0) != cps_api_ret_code_OK) {
+            ut_printf ("%s(): Rollback failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    cps_api_transaction_close (&params);
+
+    return ok;
+}
+
+bool nas_acl_ut_undo_journal_test ()
+{
+    nas_obj_id_t table_id = 0;
+    bool         ok = false;
+
+    if (!ut_undo_table_create (&table_id)) {
+        ut_printf ("%s(): Table create failed\r\n", __FUNCTION__);
+        return false;
+    }
+
+    do {
+        if (!ut_undo_write (ut_undo_entry_obj (table_id, 1, 11, 1), cps_api_oper_CREATE) ||
+            !ut_undo_write (ut_undo_entry_obj (table_id, 2, 12, 2), cps_api_oper_CREATE)) {
+            ut_printf ("%s(): Entry create failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        if (!ut_undo_failed_txn (table_id) ||
+            !ut_undo_entry_check (table_id, 1, 11, 1) ||
+            !ut_undo_entry_check (table_id, 2, 12, 2)) {
+            break;
+        }
+
+        // Records of a successful transaction are dropped at its end
+        if (!ut_undo_write (ut_undo_entry_obj (table_id, 1, 21, 4), cps_api_oper_SET) ||
+            nas_acl_undo_size () != 0) {
+            ut_printf ("%s(): Undo records outlived the transaction\r\n", __FUNCTION__);
+            break;
+        }
+
+        if (!ut_undo_entry_check (table_id, 1, 21, 4) ||
+            !ut_undo_other_obj_follows (table_id)) {
+            break;
+        }
+
+        ok = ut_undo_entry_check (table_id, 1, 21, 4);
+    } while (0);
+
+    nas_acl_switch& s = nas_acl_get_switch (NAS_ACL_DEFAULT_SWITCH_ID ());
+
+    for (nas_obj_id_t entry_id = 1; entry_id <= 2; entry_id++) {
+        if (s.find_entry (table_id, entry_id) != NULL) {
+            ok = ut_undo_write (ut_undo_obj_create (BASE_ACL_ENTRY_OBJ,
+                                                    BASE_ACL_ENTRY_TABLE_ID, table_id,
+                                                    BASE_ACL_ENTRY_ID, entry_id),
+                                cps_api_oper_DELETE) && ok;
+        }
+    }
+
+    if (!ut_undo_write (ut_undo_obj_create (BASE_ACL_TABLE_OBJ, 0, 0,
+                                            BASE_ACL_TABLE_ID, table_id),
+                        cps_api_oper_DELETE)) {
+        ut_printf ("%s(): Table delete failed\r\n", __FUNCTION__);
+        ok = false;
+    }
+
+    // Table delete dropped the records of the Entry deletes before it
+    return (ok && nas_acl_undo_size () == 0);
+}
@@ -63,6 +63,20 @@ int& ut_simulate_ndi_entry_action_error_atype ()
     return _ut_simulate_ndi_entry_action_error_atype;
 }
 
+static ut_ndi_entry_id_set_t _ut_ndi_entry_live_ids;
+
+const ut_ndi_entry_id_set_t& ut_ndi_entry_live_ids ()
+{
+    return _ut_ndi_entry_live_ids;
+}
+
+static size_t _ut_ndi_entry_write_count = 0;
+
+size_t ut_ndi_entry_write_count ()
+{
+    return _ut_ndi_entry_write_count;
+}
+
 t_std_error ndi_acl_table_create (npu_id_t npu, const ndi_acl_table_t* t,
                                   ndi_obj_id_t* id)
 {
@@ -95,6 +109,7 @@ t_std_error ndi_acl_entry_create (npu_id_t npu, const ndi_acl_entry_t* e,
 {
     static int count = 0;
     count ++;
+    _ut_ndi_entry_write_count++;
     if (ut_simulate_ndi_entry_create_error() == npu) {
         ut_printf (" >>> Simulate Entry Create NDI failure for NPU %d\r\n", npu);
         ut_simulate_ndi_entry_create_error() = UT_RESET_NPU;
@@ -103,23 +118,27 @@ t_std_error ndi_acl_entry_create (npu_id_t npu, const ndi_acl_entry_t* e,
     ut_printf ("%s: npu %d, filter count %ld entry prio %d return id %d\n", __FUNCTION__,
             npu, e->filter_count, e->priority, count);
     *id = count;
+    _ut_ndi_entry_live_ids.insert ({npu, *id});
     return STD_ERR_OK;
 }
 
 t_std_error ndi_acl_entry_delete (npu_id_t npu, ndi_obj_id_t id)
 {
+    _ut_ndi_entry_write_count++;
     if (ut_simulate_ndi_entry_delete_error() == npu) {
         ut_printf (" >>> Simulate Entry Delete NDI failure for NPU %d\r\n", npu);
         ut_simulate_ndi_entry_delete_error() = UT_RESET_NPU;
         return STD_ERR (NPU, FAIL, 0);
     }
     ut_printf ("%s: npu %d, entry id %ld\n", __FUNCTION__, npu, id);
+    _ut_ndi_entry_live_ids.erase ({npu, id});
     return STD_ERR_OK;
 }
 t_std_error ndi_acl_entry_set_priority (npu_id_t npu,
                                         ndi_obj_id_t id,
                                         uint_t prio)
 {
+    _ut_ndi_entry_write_count++;
     if (ut_simulate_ndi_entry_priority_error() == npu) {
         ut_printf (" >>> Simulate Entry Priority set NDI failure for NPU %d\r\n", npu);
         ut_simulate_ndi_entry_priority_error() = UT_RESET_NPU;
@@ -133,6 +152,7 @@ t_std_error ndi_acl_entry_set_filter (npu_id_t npu,
                                       ndi_obj_id_t id,
                                       ndi_acl_entry_filter_t *filter_p)
 {
+    _ut_ndi_entry_write_count++;
     if (ut_simulate_ndi_entry_filter_error_npu() == npu &&
         ut_simulate_ndi_entry_filter_error_ftype() == filter_p->filter_type)
     {
@@ -156,6 +176,7 @@ t_std_error ndi_acl_entry_disable_filter (npu_id_t npu,
                                           ndi_obj_id_t id,
                                           BASE_ACL_MATCH_TYPE_t filter_id)
 {
+    _ut_ndi_entry_write_count++;
     if (ut_simulate_ndi_entry_filter_error_npu() == npu &&
         ut_simulate_ndi_entry_filter_error_ftype() == filter_id)
     {
@@ -175,6 +196,7 @@ t_std_error ndi_acl_entry_set_action (npu_id_t npu_id,
                                       ndi_obj_id_t ndi_entry_id,
                                       ndi_acl_entry_action_t *action_p)
 {
+    _ut_ndi_entry_write_count++;
     if (ut_simulate_ndi_entry_action_error_npu() == npu_id &&
         ut_simulate_ndi_entry_action_error_atype() == action_p->action_type)
     {
@@ -211,6 +233,7 @@ t_std_error ndi_acl_entry_disable_action (npu_id_t npu_id,
                                           ndi_obj_id_t ndi_entry_id,
                                           BASE_ACL_ACTION_TYPE_t action_id)
 {
+    _ut_ndi_entry_write_count++;
     ut_printf ("%s: npu %d, entry id %ld action %s\n", __FUNCTION__, npu_id, ndi_entry_id,
                nas_acl_action_type_name (action_id));
     return STD_ERR_OK;
@@ -23,7 +23,7 @@ void intf_init (npu_id_t num_npus, npu_port_t num_ports);
 void  nas_acl_ut_env_init ()
 {
     nas_switch_init();
-    intf_init (NAS_ACL_UT_MAX_NPUS, NAS_ACL_UT_NUM_PORTS_PER_NPU);
+    intf_init (NAS_ACL_UT_NUM_PORT_NPUS, NAS_ACL_UT_NUM_PORTS_PER_NPU);
 }
 
 cps_api_return_code_t
@@ -48,13 +48,11 @@ nas_acl_ut_cps_api_commit (cps_api_transaction_params_t *param,
 
     if ((rc != cps_api_ret_code_OK) && (rollback_required == true)) {
 
-        max = index;
+        // Undo the objects already committed in reverse order - as
+        // cps_api_commit does. The original failure is returned.
+        while (index-- > 0) {
 
-        for (index = 0 ; index < max ; ++index ) {
-
-            rc = nas_acl_cps_api_write (NULL, param, index);
-
-            if (rc != cps_api_ret_code_OK) {
+            if (nas_acl_cps_api_rollback (NULL, param, index) != cps_api_ret_code_OK) {
                 ut_printf ("%s(): ROLLBACK failed. Index - %d.\r\n",
                            __FUNCTION__, index);
             }
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ * LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+#include "nas_acl_cps_ut.h"
+#include "nas_acl_switch.h"
+#include "nas_acl_warm.h"
+#include <stdio.h>
+#include <unistd.h>
+
+#define UT_WARM_FILE        "/tmp/nas_acl_ut_warm.ckpt"
+#define UT_WARM_TABLE_ID    1
+#define UT_WARM_NDI_ID      0x1234
+
+static void ut_warm_table_init (nas_acl_table& table, ndi_acl_priority_t priority)
+{
+    table.set_table_id (UT_WARM_TABLE_ID);
+    table.set_stage (BASE_ACL_STAGE_INGRESS);
+    table.set_priority (priority);
+    table.set_allowed_filter (BASE_ACL_MATCH_TYPE_SRC_IP);
+}
+
+// Checkpoint left by the previous run, with one Table in NPU 0
+static bool ut_warm_file_create (uint64_t cfg_hash)
+{
+    nas_acl_warm_hdr_t hdr = {NAS_ACL_WARM_MAGIC, NAS_ACL_WARM_VERSION,
+                              sizeof (nas_acl_warm_rec_t), 2, 0};
+    nas_acl_warm_rec_t recs[2] = {};
+
+    recs[1].obj_type = NAS_ACL_WARM_OBJ_TABLE;
+    recs[1].table_id = UT_WARM_TABLE_ID;
+    recs[1].obj_id = UT_WARM_TABLE_ID;
+    recs[1].cfg_hash = cfg_hash;
+    recs[1].ndi_id = UT_WARM_NDI_ID;
+
+    FILE* fp = fopen (UT_WARM_FILE, "w");
+    if (fp == NULL) {
+        return false;
+    }
+    bool ok = (fwrite (&hdr, sizeof (hdr), 1, fp) == 1 &&
+               fwrite (recs, sizeof (recs), 1, fp) == 1);
+    fclose (fp);
+
+    return ok;
+}
+
+bool nas_acl_ut_warm_test ()
+{
+    nas_acl_switch s {NAS_ACL_DEFAULT_SWITCH_ID ()};
+    s.add_npu (0);
+
+    nas_acl_table table {&s};
+    ut_warm_table_init (table, 5);
+
+    bool ok = false;
+    std::vector<ndi_obj_id_t> ndi_ids;
+
+    do {
+        if (!ut_warm_file_create (nas_acl_warm_table_hash (table)) ||
+            !nas_acl_warm_open (UT_WARM_FILE, true) ||
+            !nas_acl_warm_is_reconciling ()) {
+            ut_printf ("%s(): Checkpoint load failed\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Replayed Table takes over the NDI table - no NDI call
+        ndi_acl_table_t ndi_tbl = {};
+        table.push_create_obj_to_npu (0, &ndi_tbl);
+
+        if (table.get_ndi_obj_id (0) != UT_WARM_NDI_ID) {
+            ut_printf ("%s(): Table not adopted\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Saving the Table checkpoints it for the next restart
+        s.save_table (std::move (table));
+
+        if (!nas_acl_warm_open (UT_WARM_FILE, true) ||
+            !nas_acl_warm_adopt (NAS_ACL_WARM_OBJ_TABLE, s.id (), UT_WARM_TABLE_ID,
+                                 UT_WARM_TABLE_ID, 0,
+                                 nas_acl_warm_table_hash (s.get_table (UT_WARM_TABLE_ID)),
+                                 ndi_ids) ||
+            ndi_ids.size () != 1 || ndi_ids[0] != UT_WARM_NDI_ID) {
+            ut_printf ("%s(): Saved Table not adopted\r\n", __FUNCTION__);
+            break;
+        }
+
+        // A Table with a different configuration is created again
+        nas_acl_table table_mod {&s};
+        ut_warm_table_init (table_mod, 6);
+        ndi_ids.clear ();
+
+        if (!ut_warm_file_create (nas_acl_warm_table_hash (s.get_table (UT_WARM_TABLE_ID))) ||
+            !nas_acl_warm_open (UT_WARM_FILE, true) ||
+            nas_acl_warm_adopt (NAS_ACL_WARM_OBJ_TABLE, s.id (), UT_WARM_TABLE_ID,
+                                UT_WARM_TABLE_ID, 0, nas_acl_warm_table_hash (table_mod),
+                                ndi_ids) ||
+            !ndi_ids.empty ()) {
+            ut_printf ("%s(): Modified Table adopted\r\n", __FUNCTION__);
+            break;
+        }
+
+        // Cold start discards the checkpoint
+        if (!nas_acl_warm_open (UT_WARM_FILE, false) ||
+            nas_acl_warm_is_reconciling ()) {
+            ut_printf ("%s(): Cold start kept the checkpoint\r\n", __FUNCTION__);
+            break;
+        }
+
+        ok = true;
+    } while (0);
+
+    nas_acl_warm_close ();
+    unlink (UT_WARM_FILE);
+
+    return ok;
+}